@@ -0,0 +1,451 @@
+/*
+ * Copyright (c) 2006-2021, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-19     Sherman      first version
+ */
+
+/*
+ * Host HAL for Linux gateways over the i2c-dev interface. Each transaction is
+ * one I2C_RDWR ioctl carrying the slave address in its messages, so there is
+ * no I2C_SLAVE call per address and a read is one system call, not a write()
+ * and a read(). The kernel runs the messages of one ioctl back to back with
+ * the adapter locked, which also keeps other processes out of a read.
+ *
+ * The system calls go through hal_linux_io_t so a test can run the HAL
+ * against an in-process fake bus and clock, see tools/zmod_linux_fake.c.
+ *
+ * Not part of the RT-Thread build; compile it together with the driver on
+ * the host and define ZMOD4XXX_USING_HAL_LINUX so zmod4xxx_hal.h picks it up.
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <linux/i2c.h>
+#include <linux/i2c-dev.h>
+#ifdef ZMOD4XXX_USING_BUS
+#include <pthread.h>
+#include <stdint.h>
+#endif
+
+#include "hal_linux.h"
+
+static int linux_sys_open(void *ctx, const char *path)
+{
+    (void)ctx;
+    return open(path, O_RDWR | O_CLOEXEC);
+}
+
+static int linux_sys_close(void *ctx, int fd)
+{
+    (void)ctx;
+    return close(fd);
+}
+
+static int linux_sys_ioctl(void *ctx, int fd, unsigned long req, void *arg)
+{
+    (void)ctx;
+    return ioctl(fd, req, arg);
+}
+
+static uint64_t linux_sys_now_ns(void *ctx)
+{
+    struct timespec ts;
+
+    (void)ctx;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+static void linux_sys_sleep_until_ns(void *ctx, uint64_t t)
+{
+    struct timespec ts;
+
+    (void)ctx;
+    ts.tv_sec = (time_t)(t / 1000000000ULL);
+    ts.tv_nsec = (long)(t % 1000000000ULL);
+    /* the deadline is absolute, so a signal only costs the restart */
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL) == EINTR)
+    {
+    }
+}
+
+static const hal_linux_io_t linux_sys =
+{
+    linux_sys_open,
+    linux_sys_close,
+    linux_sys_ioctl,
+    linux_sys_now_ns,
+    linux_sys_sleep_until_ns,
+    NULL,
+};
+
+static hal_linux_io_t linux_io =
+{
+    linux_sys_open,
+    linux_sys_close,
+    linux_sys_ioctl,
+    linux_sys_now_ns,
+    linux_sys_sleep_until_ns,
+    NULL,
+};
+static int linux_fd = -1;
+static hal_linux_stats_t linux_stats;
+
+/* writes queued by a batch, sent ahead of the next read */
+static struct i2c_msg linux_msgs[ZMOD4XXX_LINUX_BATCH_MSGS];
+static uint8_t linux_pool[ZMOD4XXX_LINUX_BATCH_BYTES];
+static uint32_t linux_nmsgs;
+static uint32_t linux_used;
+static uint32_t linux_batch;
+static int8_t linux_err; /* of queued writes, not reported yet */
+
+static uint64_t linux_period_ns;
+static uint64_t linux_period_next;
+
+static int8_t linux_transfer(struct i2c_msg *msgs, uint32_t n)
+{
+    struct i2c_rdwr_ioctl_data data;
+    uint32_t i;
+
+    data.msgs = msgs;
+    data.nmsgs = n;
+    linux_stats.ioctls++;
+    linux_stats.msgs += n;
+    for (i = 0; i < n; i++)
+    {
+        linux_stats.bytes += msgs[i].len;
+    }
+    if (linux_io.ioctl(linux_io.ctx, linux_fd, I2C_RDWR, &data) < 0)
+    {
+        linux_stats.errors++;
+        return ERROR_I2C;
+    }
+    return ZMOD4XXX_OK;
+}
+
+static void linux_flush(void)
+{
+    if (linux_nmsgs == 0)
+    {
+        return;
+    }
+    if (linux_transfer(linux_msgs, linux_nmsgs))
+    {
+        linux_err = ERROR_I2C;
+    }
+    linux_nmsgs = 0;
+    linux_used = 0;
+}
+
+/* the error of queued writes, once */
+static int8_t linux_pending(void)
+{
+    int8_t ret = linux_err;
+
+    linux_err = ZMOD4XXX_OK;
+    return ret;
+}
+
+/**
+ * @brief Sleep for some time. Depending on target and application this can \n
+ *        be used to go into power down or to do task switching.
+ * @param [in] ms will sleep for at least this number of milliseconds
+ */
+static void linux_sleep(uint32_t ms)
+{
+    linux_flush();
+    linux_stats.sleeps++;
+    linux_io.sleep_until_ns(linux_io.ctx,
+                            linux_io.now_ns(linux_io.ctx) + (uint64_t)ms * 1000000ULL);
+}
+
+/**
+ * @brief Read a register over I2C
+ * @param [in] i2c_addr 7-bit I2C slave address of the ZMOD45xx
+ * @param [in] reg_addr address of internal register to read
+ * @param [out] buf destination buffer; must have at least a size of len*uint8_t
+ * @param [in] len number of bytes to read
+ * @return error code
+ */
+static int8_t linux_i2c_read(uint8_t i2c_addr, uint8_t reg_addr, uint8_t *buf, uint8_t len)
+{
+    struct i2c_msg local[2];
+    struct i2c_msg *m = local;
+    int8_t ret;
+
+    linux_stats.transfers++;
+    if (linux_nmsgs + 2 > ZMOD4XXX_LINUX_BATCH_MSGS)
+    {
+        linux_flush();
+    }
+    if (linux_nmsgs)
+    {
+        m = &linux_msgs[linux_nmsgs];
+    }
+    m[0].addr = i2c_addr;
+    m[0].flags = 0;
+    m[0].len = 1;
+    m[0].buf = &reg_addr;
+    m[1].addr = i2c_addr;
+    m[1].flags = I2C_M_RD;
+    m[1].len = len;
+    m[1].buf = buf;
+
+    if (m == local)
+    {
+        ret = linux_transfer(local, 2);
+    }
+    else
+    {
+        ret = linux_transfer(linux_msgs, linux_nmsgs + 2);
+        linux_nmsgs = 0;
+        linux_used = 0;
+    }
+    if (linux_pending())
+    {
+        ret = ERROR_I2C;
+    }
+    return ret;
+}
+
+/**
+ * @brief Write a register over I2C
+ * @param [in] i2c_addr 7-bit I2C slave address of the ZMOD4xxx
+ * @param [in] reg_addr address of internal register to write
+ * @param [in] buf source buffer; must have at least a size of len*uint8_t
+ * @param [in] len number of bytes to write
+ * @return error code
+ */
+static int8_t linux_i2c_write(uint8_t i2c_addr, uint8_t reg_addr, uint8_t *buf, uint8_t len)
+{
+    uint8_t local[1 + 255];
+    struct i2c_msg msg;
+    uint8_t *p = local;
+    int8_t ret;
+
+    linux_stats.transfers++;
+    if (linux_batch)
+    {
+        if (linux_nmsgs + 1 > ZMOD4XXX_LINUX_BATCH_MSGS ||
+            linux_used + 1 + len > ZMOD4XXX_LINUX_BATCH_BYTES)
+        {
+            linux_flush();
+        }
+        p = &linux_pool[linux_used];
+        linux_used += 1 + len;
+    }
+    p[0] = reg_addr;
+    memcpy(p + 1, buf, len);
+    msg.addr = i2c_addr;
+    msg.flags = 0;
+    msg.len = (uint16_t)(1 + len);
+    msg.buf = p;
+
+    if (linux_batch)
+    {
+        linux_msgs[linux_nmsgs++] = msg;
+        return linux_pending();
+    }
+    ret = linux_transfer(&msg, 1);
+    if (linux_pending())
+    {
+        ret = ERROR_I2C;
+    }
+    return ret;
+}
+
+int8_t hal_linux_open(const char *path, const hal_linux_io_t *io)
+{
+    unsigned long funcs = 0;
+
+    hal_linux_close();
+    linux_io = io ? *io : linux_sys;
+    memset(&linux_stats, 0, sizeof(linux_stats));
+    linux_err = ZMOD4XXX_OK;
+    linux_batch = 0;
+    linux_period_ns = 0;
+
+    linux_fd = linux_io.open(linux_io.ctx, path);
+    if (linux_fd < 0)
+    {
+        return ERROR_I2C;
+    }
+    /* I2C_RDWR needs an adapter that does plain I2C, not only SMBus */
+    if (linux_io.ioctl(linux_io.ctx, linux_fd, I2C_FUNCS, &funcs) < 0 ||
+        !(funcs & I2C_FUNC_I2C))
+    {
+        hal_linux_close();
+        return ERROR_I2C;
+    }
+    return ZMOD4XXX_OK;
+}
+
+void hal_linux_close(void)
+{
+    if (linux_fd < 0)
+    {
+        return;
+    }
+    linux_flush();
+    linux_io.close(linux_io.ctx, linux_fd);
+    linux_fd = -1;
+}
+
+void hal_linux_batch_begin(void)
+{
+    linux_batch++;
+}
+
+int8_t hal_linux_batch_end(void)
+{
+    if (linux_batch && --linux_batch)
+    {
+        return ZMOD4XXX_OK;
+    }
+    linux_flush();
+    return linux_pending();
+}
+
+void hal_linux_period(uint32_t period_ms)
+{
+    uint64_t p = (uint64_t)period_ms * 1000000ULL;
+    uint64_t now, missed;
+
+    if (p == 0)
+    {
+        return;
+    }
+    linux_flush();
+    now = linux_io.now_ns(linux_io.ctx);
+    if (p != linux_period_ns)
+    {
+        linux_period_ns = p;
+        linux_period_next = now;
+    }
+    linux_period_next += p;
+    if (now >= linux_period_next)
+    {
+        missed = (now - linux_period_next) / p + 1;
+        linux_stats.overruns += (uint32_t)missed;
+        linux_period_next += missed * p;
+    }
+    linux_stats.sleeps++;
+    linux_io.sleep_until_ns(linux_io.ctx, linux_period_next);
+}
+
+const hal_linux_stats_t *hal_linux_stats(void)
+{
+    return &linux_stats;
+}
+
+int8_t init_hardware(zmod4xxx_dev_t *dev)
+{
+    if (linux_fd < 0 && hal_linux_open(ZMOD4XXX_LINUX_I2C_DEV, NULL))
+    {
+        return ERROR_I2C;
+    }
+    dev->read = linux_i2c_read;
+    dev->write = linux_i2c_write;
+    dev->delay_ms = linux_sleep;
+    return ZMOD4XXX_OK;
+}
+
+int8_t is_key_pressed(void)
+{
+    return 0;
+}
+
+int8_t deinit_hardware(void)
+{
+    hal_linux_close();
+    return ZMOD4XXX_OK;
+}
+
+uint32_t hal_get_time_ms(void)
+{
+    return (uint32_t)(linux_io.now_ns(linux_io.ctx) / 1000000ULL);
+}
+
+uint32_t hal_get_time_us(void)
+{
+    return (uint32_t)(linux_io.now_ns(linux_io.ctx) / 1000ULL);
+}
+
+void hal_delay_us(uint32_t us)
+{
+    linux_io.sleep_until_ns(linux_io.ctx,
+                            linux_io.now_ns(linux_io.ctx) + (uint64_t)us * 1000ULL);
+}
+
+#ifdef ZMOD4XXX_USING_BUS
+static pthread_mutex_t linux_bus_lock;
+static uint8_t linux_bus_ready;
+
+static int8_t linux_bus_take(void *ctx, uint32_t timeout_ms)
+{
+    pthread_mutex_t *lock = (pthread_mutex_t *)ctx;
+    struct timespec ts;
+
+    if (timeout_ms == 0)
+    {
+        return pthread_mutex_trylock(lock) ? ERROR_I2C : ZMOD4XXX_OK;
+    }
+    /* pthread_mutex_timedlock() waits on CLOCK_REALTIME */
+    clock_gettime(CLOCK_REALTIME, &ts);
+    ts.tv_sec += timeout_ms / 1000;
+    ts.tv_nsec += (long)(timeout_ms % 1000) * 1000000L;
+    if (ts.tv_nsec >= 1000000000L)
+    {
+        ts.tv_sec++;
+        ts.tv_nsec -= 1000000000L;
+    }
+    return pthread_mutex_timedlock(lock, &ts) ? ERROR_I2C : ZMOD4XXX_OK;
+}
+
+static void linux_bus_release(void *ctx)
+{
+    pthread_mutex_unlock((pthread_mutex_t *)ctx);
+}
+
+static void *linux_bus_self(void)
+{
+    return (void *)(uintptr_t)pthread_self();
+}
+
+int8_t hal_bus_init(zmod4xxx_bus_t *bus, const char *name)
+{
+    pthread_mutexattr_t attr;
+    zmod4xxx_bus_ops_t ops;
+
+    if (!linux_bus_ready)
+    {
+        pthread_mutexattr_init(&attr);
+        /* a sampling thread of high priority must not wait on a low one */
+        pthread_mutexattr_setprotocol(&attr, PTHREAD_PRIO_INHERIT);
+        if (pthread_mutex_init(&linux_bus_lock, &attr))
+        {
+            pthread_mutexattr_destroy(&attr);
+            return ERROR_NULL_PTR;
+        }
+        pthread_mutexattr_destroy(&attr);
+        linux_bus_ready = 1;
+    }
+    ops.ctx = &linux_bus_lock;
+    ops.take = linux_bus_take;
+    ops.release = linux_bus_release;
+    ops.self = linux_bus_self;
+    ops.clock_us = hal_get_time_us;
+    zmod4xxx_bus_init(bus, name, &ops);
+    return ZMOD4XXX_OK;
+}
+#endif /* ZMOD4XXX_USING_BUS */
@@ -0,0 +1,173 @@
+/*
+ * Copyright (c) 2006-2021, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-19     Sherman      first version
+ */
+
+#ifndef _HAL_LINUX_H
+#define _HAL_LINUX_H
+
+#include "zmod4xxx_types.h"
+#ifdef ZMOD4XXX_USING_BUS
+#include "zmod4xxx_bus.h"
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifndef ZMOD4XXX_LINUX_I2C_DEV
+#define ZMOD4XXX_LINUX_I2C_DEV  "/dev/i2c-1" /**< bus init_hardware() opens */
+#endif
+#define ZMOD4XXX_LINUX_BATCH_MSGS   (16)  /**< messages in one ioctl, at most 42 */
+#define ZMOD4XXX_LINUX_BATCH_BYTES  (512) /**< bytes of queued writes */
+
+/**
+ * @brief System calls of the HAL, to be replaced by an in-process fake
+ *
+ * The defaults are open(2), close(2), ioctl(2), clock_gettime(2) and
+ * clock_nanosleep(2) with TIMER_ABSTIME, all on CLOCK_MONOTONIC. ioctl is
+ * called with I2C_FUNCS and I2C_RDWR only.
+ */
+typedef struct {
+    int (*open)(void *ctx, const char *path);
+    int (*close)(void *ctx, int fd);
+    int (*ioctl)(void *ctx, int fd, unsigned long req, void *arg);
+    uint64_t (*now_ns)(void *ctx); /**< monotonic nanoseconds */
+    void (*sleep_until_ns)(void *ctx, uint64_t t); /**< return at now_ns() >= t */
+    void *ctx; /**< passed to every call */
+} hal_linux_io_t;
+
+/**
+ * @brief System call counters
+ */
+typedef struct {
+    uint32_t transfers; /**< reads and writes of the driver */
+    uint32_t ioctls; /**< I2C_RDWR calls */
+    uint32_t msgs; /**< I2C messages in them */
+    uint32_t bytes; /**< payload and register bytes in them */
+    uint32_t errors; /**< failed I2C_RDWR calls */
+    uint32_t sleeps; /**< calls to delay_ms and hal_linux_period() */
+    uint32_t overruns; /**< periods missed by hal_linux_period() */
+} hal_linux_stats_t;
+
+/**
+ * @brief   Open an I2C bus for init_hardware()
+ * @param   [in] path character device, e.g. "/dev/i2c-1"
+ * @param   [in] io system calls, copied; NULL for the real ones
+ * @return  error code
+ * @retval  0 success
+ * @retval  ERROR_I2C the bus cannot be opened or has no plain I2C
+ * @note    Every transaction is one I2C_RDWR ioctl: a read is the register
+ *          write and the read joined by a repeated start, a write is the
+ *          register and the data in one message. delay_ms sleeps to an
+ *          absolute deadline taken when it is called, so a signal does not
+ *          stretch it.
+ */
+int8_t hal_linux_open(const char *path, const hal_linux_io_t *io);
+
+/**
+ * @brief   Close the bus
+ */
+void hal_linux_close(void);
+
+/**
+ * @brief   Queue the writes that follow instead of sending each at once
+ * @note    Queued writes go out in one ioctl together with the next read,
+ *          before the next delay_ms, or at hal_linux_batch_end(), with
+ *          repeated starts between them. A failed ioctl fails the read that
+ *          sent it; writes sent by a delay report their error at the next
+ *          transaction or at hal_linux_batch_end(). Batches nest. The
+ *          queue is shared, so a batch belongs to one thread at a time, e.g.
+ *          inside a ZMOD4XXX_BUS_BEGIN() section.
+ */
+void hal_linux_batch_begin(void);
+
+/**
+ * @brief   Send what is queued and end a batch
+ * @return  error code
+ * @retval  0 success
+ * @retval  ERROR_I2C a queued write failed
+ */
+int8_t hal_linux_batch_end(void);
+
+/**
+ * @brief   Sleep to the next point of a fixed period, e.g. the sample rate
+ * @param   [in] period_ms period; the first call, or one with a new period,
+ *          starts the timeline now
+ * @note    Deadlines are multiples of the period from the start, so the
+ *          time the cycle itself takes does not add up into drift as with
+ *          delay_ms. A call that comes later than a whole period skips the
+ *          missed points and counts them as overruns.
+ */
+void hal_linux_period(uint32_t period_ms);
+
+/**
+ * @brief   Get the system call counters
+ * @return  counters
+ */
+const hal_linux_stats_t *hal_linux_stats(void);
+
+/**
+ * @brief   Initialize the target hardware
+ * @param   [in] dev pointer to the device
+ * @return  error code
+ * @retval  0 success
+ * @retval  "!= 0" error
+ * @note    Opens ZMOD4XXX_LINUX_I2C_DEV unless hal_linux_open() was called.
+ */
+int8_t init_hardware(zmod4xxx_dev_t *dev);
+
+/**
+ * @brief   Check if any key is pressed
+ * @retval  0 there is no key
+ */
+int8_t is_key_pressed(void);
+
+/**
+ * @brief   deinitialize target hardware
+ * @return  error code
+ * @retval  0 success
+ */
+int8_t deinit_hardware(void);
+
+/**
+ * @brief   Milliseconds on the clock that delay_ms sleeps on
+ * @return  monotonic milliseconds
+ */
+uint32_t hal_get_time_ms(void);
+
+/**
+ * @brief   Microseconds for latency measurements
+ * @return  monotonic microseconds, wrapping at 2^32
+ */
+uint32_t hal_get_time_us(void);
+
+/**
+ * @brief   Wait for a short time, e.g. a bus retry backoff
+ * @param   [in] us microseconds to wait at least
+ */
+void hal_delay_us(uint32_t us);
+
+#ifdef ZMOD4XXX_USING_BUS
+/**
+ * @brief   Set up a process-local lock of the bus for zmod4xxx_bus_attach()
+ * @param   [out] bus bus
+ * @param   [in] name name for reports
+ * @return  error code
+ * @retval  0 success
+ * @note    A pthread mutex with priority inheritance. Other processes are
+ *          kept apart by the kernel, which runs each ioctl as a whole.
+ */
+int8_t hal_bus_init(zmod4xxx_bus_t *bus, const char *name);
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _HAL_LINUX_H */
@@ -6,14 +6,29 @@
  * Change Logs:
  * Date           Author       Notes
  * 2021-11-15     Sherman      first version
+ * 2026-10-19     Sherman      add hal_get_time_ms, hal_get_time_us
+ * 2026-10-19     Sherman      add hal_delay_us
+ * 2026-10-19     Sherman      add hal_bus_init
+ * 2026-10-19     Sherman      microseconds from SysTick, sleep long backoffs
  */
 
 #include "hal_rtthread.h"
 
 #include <rtthread.h>
+#include <rthw.h>
 #include <rtdevice.h>
 #include <rtdbg.h>
 
+#if (defined(__ARM_ARCH_PROFILE) && (__ARM_ARCH_PROFILE == 'M')) || \
+    defined(__TARGET_ARCH_6S_M) || defined(__TARGET_ARCH_7_M) || defined(__TARGET_ARCH_7E_M)
+/* SysTick, which drives the tick of the Cortex-M BSPs, and its pending bit */
+#define HAL_SYST_LOAD       (*(volatile rt_uint32_t *)0xE000E014UL)
+#define HAL_SYST_VAL        (*(volatile rt_uint32_t *)0xE000E018UL)
+#define HAL_SCB_ICSR        (*(volatile rt_uint32_t *)0xE000ED04UL)
+#define HAL_ICSR_PENDSTSET  (1UL << 26)
+#define HAL_USING_SYSTICK
+#endif
+
 #define ZMOD4410_NAME      "i2c1"
 struct rt_i2c_bus_device *i2c_bus;
 
@@ -164,3 +179,106 @@ int8_t deinit_hardware(void)
 {
     return ZMOD4XXX_OK;
 }
+
+/**
+ * @brief   Milliseconds on the clock that delay_ms sleeps on
+ * @return  system uptime in milliseconds
+ */
+uint32_t hal_get_time_ms(void)
+{
+    return (uint32_t)((rt_uint64_t)rt_tick_get() * 1000 / RT_TICK_PER_SECOND);
+}
+
+/**
+ * @brief   Microseconds for latency measurements and bus statistics
+ * @return  system uptime in microseconds, wrapping at 2^32
+ * @note    On Cortex-M the tick is refined with the SysTick counter, which
+ *          counts down from LOAD to 0 once per tick. Elsewhere it is tick
+ *          based; a BSP with a free running timer should override this.
+ */
+RT_WEAK uint32_t hal_get_time_us(void)
+{
+#ifdef HAL_USING_SYSTICK
+    rt_base_t level;
+    rt_tick_t tick;
+    rt_uint32_t load, val;
+
+    level = rt_hw_interrupt_disable();
+    tick = rt_tick_get();
+    load = HAL_SYST_LOAD + 1;
+    val = HAL_SYST_VAL;
+    if (HAL_SCB_ICSR & HAL_ICSR_PENDSTSET)
+    {
+        /* wrapped, but the tick interrupt has not counted it yet */
+        tick++;
+        val = HAL_SYST_VAL;
+    }
+    rt_hw_interrupt_enable(level);
+    if (load > 1 && val < load)
+    {
+        return (uint32_t)((rt_uint64_t)tick * 1000000 / RT_TICK_PER_SECOND +
+                          (rt_uint64_t)(load - val) * 1000000 /
+                          ((rt_uint64_t)RT_TICK_PER_SECOND * load));
+    }
+    return (uint32_t)((rt_uint64_t)tick * 1000000 / RT_TICK_PER_SECOND);
+#else
+    return (uint32_t)((rt_uint64_t)rt_tick_get() * 1000000 / RT_TICK_PER_SECOND);
+#endif
+}
+
+/**
+ * @brief   Wait for a short time, e.g. a bus retry backoff
+ * @param   [in] us microseconds to wait at least
+ * @note    A wait shorter than a tick spins in rt_hw_us_delay() of the BSP,
+ *          a longer one sleeps in rt_thread_mdelay(), so a backoff never
+ *          spins away a tick at the caller's priority.
+ */
+RT_WEAK void hal_delay_us(uint32_t us)
+{
+    if (us >= 1000000UL / RT_TICK_PER_SECOND)
+    {
+        rt_thread_mdelay((rt_int32_t)((us + 999) / 1000));
+    }
+    else if (us)
+    {
+        rt_hw_us_delay(us);
+    }
+}
+
+#ifdef ZMOD4XXX_USING_BUS
+static int8_t rtthread_bus_take(void *ctx, uint32_t timeout_ms)
+{
+    struct rt_i2c_bus_device *bus = (struct rt_i2c_bus_device *)ctx;
+    rt_int32_t ticks = timeout_ms ? rt_tick_from_millisecond(timeout_ms) : RT_WAITING_NO;
+
+    return rt_mutex_take(&bus->lock, ticks) == RT_EOK ? ZMOD4XXX_OK : ERROR_I2C;
+}
+
+static void rtthread_bus_release(void *ctx)
+{
+    rt_mutex_release(&((struct rt_i2c_bus_device *)ctx)->lock);
+}
+
+static void *rtthread_bus_self(void)
+{
+    return rt_thread_self();
+}
+
+int8_t hal_bus_init(zmod4xxx_bus_t *bus, const char *name)
+{
+    zmod4xxx_bus_ops_t ops;
+
+    ops.ctx = rt_device_find(name);
+    if (ops.ctx == RT_NULL)
+    {
+        LOG_E("can't find %s device!", name);
+        return ERROR_NULL_PTR;
+    }
+    ops.take = rtthread_bus_take;
+    ops.release = rtthread_bus_release;
+    ops.self = rtthread_bus_self;
+    ops.clock_us = hal_get_time_us;
+    zmod4xxx_bus_init(bus, name, &ops);
+    return ZMOD4XXX_OK;
+}
+#endif /* ZMOD4XXX_USING_BUS */
@@ -6,6 +6,9 @@
  * Change Logs:
  * Date           Author       Notes
  * 2021-11-15     Sherman      first version
+ * 2026-10-19     Sherman      add hal_get_time_ms, hal_get_time_us
+ * 2026-10-19     Sherman      add hal_bus_init
+ * 2026-10-19     Sherman      microseconds from SysTick, sleep long backoffs
  */
 
 #ifndef _HAL_RTTHREAD_H
@@ -13,6 +16,9 @@
 
 #include <rtthread.h>
 #include "zmod4xxx_types.h"
+#ifdef ZMOD4XXX_USING_BUS
+#include "zmod4xxx_bus.h"
+#endif
 
 #ifdef __cplusplus
 extern "C" {
@@ -42,6 +48,43 @@ int8_t is_key_pressed(void);
  */
 int8_t deinit_hardware(void);
 
+/**
+ * @brief   Milliseconds on the clock that delay_ms sleeps on
+ * @return  system uptime in milliseconds
+ */
+uint32_t hal_get_time_ms(void);
+
+/**
+ * @brief   Microseconds for latency measurements and bus statistics
+ * @return  system uptime in microseconds, wrapping at 2^32
+ * @note    Tick and SysTick counter on Cortex-M, the tick elsewhere; weak,
+ *          so a BSP with a free running timer can override it.
+ */
+uint32_t hal_get_time_us(void);
+
+/**
+ * @brief   Wait for a short time, e.g. a bus retry backoff
+ * @param   [in] us microseconds to wait at least
+ * @note    Spins in rt_hw_us_delay() below one tick and sleeps from one
+ *          tick on.
+ */
+void hal_delay_us(uint32_t us);
+
+#ifdef ZMOD4XXX_USING_BUS
+/**
+ * @brief   Set up the lock of an I2C bus for zmod4xxx_bus_attach()
+ * @param   [out] bus bus
+ * @param   [in] name name of the I2C bus device, e.g. "i2c1"
+ * @return  error code
+ * @retval  0 success
+ * @retval  ERROR_NULL_PTR no such bus
+ * @note    The lock is the mutex of the bus device, which rt_i2c_transfer()
+ *          takes too, so every driver on the bus is arbitrated with the
+ *          sensor, with the priority inheritance of rt_mutex.
+ */
+int8_t hal_bus_init(zmod4xxx_bus_t *bus, const char *name);
+#endif
+
 #ifdef __cplusplus
 }
 #endif
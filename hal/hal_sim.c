@@ -0,0 +1,613 @@
+/*
+ * Copyright (c) 2006-2021, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-19     Sherman      first version
+ * 2026-10-19     Sherman      add fault injection
+ * 2026-10-19     Sherman      add sleep timer and bus time
+ * 2026-10-19     Sherman      add access by instance
+ * 2026-10-19     Sherman      add ZMOD4XXX_SIM_MODEL_ONLY
+ * 2026-10-19     Sherman      remove the sleep timer
+ */
+
+/*
+ * Host HAL backed by simulated ZMOD4410 sensors. delay_ms does not sleep: it
+ * advances the virtual clock of the sensor last addressed, and the sequencer
+ * of each sensor finishes on that same clock. Simulated runs therefore take
+ * only as long as the driver code itself.
+ *
+ * Not part of the RT-Thread build; compile it together with the driver on
+ * the host and define ZMOD4XXX_USING_HAL_SIM so zmod4xxx_hal.h picks it up.
+ * With ZMOD4XXX_SIM_MODEL_ONLY only the sensor model is built, to sit behind
+ * another HAL, e.g. the fake bus of tools/zmod_linux_fake.c.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "hal_sim.h"
+
+#define SIM_ADDR_ERROR  (0xB7)
+#define SIM_ADDR_RESULT (0x97)
+#define SIM_ADDR_S      (0x68)
+#define SIM_INIT_S_LEN  (4)
+#define SIM_MOX_LR      (1500)
+#define SIM_MOX_ER      (60000)
+#define SIM_DEFAULT_ADDR (0x32)
+#define SIM_CMD_START   (0x80)
+
+static const uint8_t sim_pid[ZMOD4XXX_LEN_PID] = { 0x23, 0x10 };
+static const uint8_t sim_conf[ZMOD4XXX_LEN_CONF] = {
+    0x1E, 0x8F, 0x24, 0x1B, 0x4C, 0x4E };
+static const uint8_t sim_prod_data[] = {
+    0x01, 0x5A, 0x3C, 0x7F, 0x12, 0x00, 0x40 };
+static const uint8_t sim_tracking[ZMOD4XXX_LEN_TRACKING] = {
+    0x00, 0x00, 0x12, 0x34, 0x56, 0x78 };
+
+static zmod4xxx_sim_t *sim_bus[128];
+static zmod4xxx_sim_t *sim_current;
+#ifndef ZMOD4XXX_SIM_MODEL_ONLY
+static zmod4xxx_sim_t sim_default;
+#endif
+
+static const char *const sim_fault_names[ZMOD4XXX_SIM_FAULT_TYPE_MAX] = {
+    "nack", "stuck", "por", "conflict", "truncate", "stretch",
+};
+
+static uint32_t sim_rand(zmod4xxx_sim_t *sim)
+{
+    uint32_t x = sim->rng;
+
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    sim->rng = x;
+    return x;
+}
+
+static uint32_t sim_fault_rand(zmod4xxx_sim_t *sim)
+{
+    uint32_t x = sim->fault_rng;
+
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    sim->fault_rng = x;
+    return x;
+}
+
+static int sim_running(const zmod4xxx_sim_t *sim)
+{
+    return sim->now_us < sim->seq_end_us || sim->now_us < sim->stuck_end_us;
+}
+
+static void sim_fault_trigger(zmod4xxx_sim_t *sim, const zmod4xxx_sim_fault_t *f)
+{
+    sim->stats.faults++;
+    sim->stats.last_fault_us = sim->now_us;
+    sim->stats.last_fault = f->type;
+
+    switch (f->type)
+    {
+    case ZMOD4XXX_SIM_FAULT_NACK:
+        sim->nack_left += f->count ? f->count : 1;
+        break;
+    case ZMOD4XXX_SIM_FAULT_STUCK:
+        sim->stuck_end_us = sim->now_us + f->duration_ms * 1000ULL;
+        break;
+    case ZMOD4XXX_SIM_FAULT_POR:
+        /* volatile configuration is gone, sequencer stopped */
+        memset(&sim->regs[0x40], 0, 0x30);
+        sim->s_len = 0;
+        sim->seq_end_us = sim->now_us;
+        sim->result_valid = 0;
+        sim->regs[0xB7] |= STATUS_POR_EVENT_MASK;
+        break;
+    case ZMOD4XXX_SIM_FAULT_CONFLICT:
+        sim->seq_end_us = sim->now_us;
+        sim->result_valid = 0;
+        sim->regs[0xB7] |= STATUS_ACCESS_CONFLICT_MASK;
+        break;
+    case ZMOD4XXX_SIM_FAULT_TRUNCATE:
+        sim->truncate_left += f->count ? f->count : 1;
+        sim->truncate_keep = f->param;
+        break;
+    case ZMOD4XXX_SIM_FAULT_STRETCH:
+        sim->stretch_us = f->param;
+        sim->stretch_end_us = sim->now_us + f->duration_ms * 1000ULL;
+        break;
+    default:
+        break;
+    }
+}
+
+/* run before every transaction; returns 0 to let it through */
+static int8_t sim_fault_step(zmod4xxx_sim_t *sim)
+{
+    uint8_t i;
+
+    for (i = 0; i < sim->fault_count; i++)
+    {
+        zmod4xxx_sim_fault_t *f = &sim->faults[i];
+
+        if (f->rate_ppm)
+        {
+            if (sim_fault_rand(sim) % 1000000 < f->rate_ppm)
+            {
+                sim_fault_trigger(sim, f);
+            }
+        }
+        else if (!f->fired && sim->now_us >= f->at_ms * 1000ULL)
+        {
+            f->fired = 1;
+            sim_fault_trigger(sim, f);
+        }
+    }
+
+    if (sim->now_us < sim->stretch_end_us)
+    {
+        sim->now_us += sim->stretch_us;
+    }
+    if (sim->nack_left)
+    {
+        sim->nack_left--;
+        return ERROR_I2C;
+    }
+    return ZMOD4XXX_OK;
+}
+
+/* results are latched when the sequence starts and read back after it ends */
+static void sim_start_sequence(zmod4xxx_sim_t *sim)
+{
+    uint8_t *r = &sim->regs[SIM_ADDR_RESULT];
+    uint16_t span = SIM_MOX_ER - SIM_MOX_LR;
+    uint8_t i;
+
+    /* nothing to run after a reset wiped the sequencer tables */
+    if (sim->s_len == 0)
+    {
+        memset(r, 0, RSLT_MAX);
+        sim->result_valid = 0;
+        return;
+    }
+
+    sim->stats.sequences++;
+    sim->result_valid = 1;
+    if (sim->s_len <= SIM_INIT_S_LEN)
+    {
+        sim->seq_end_us = sim->now_us + ZMOD4XXX_SIM_INIT_MS * 1000ULL;
+        r[0] = (uint8_t)(SIM_MOX_LR >> 8);
+        r[1] = (uint8_t)SIM_MOX_LR;
+        r[2] = (uint8_t)(SIM_MOX_ER >> 8);
+        r[3] = (uint8_t)SIM_MOX_ER;
+        return;
+    }
+
+    sim->seq_end_us = sim->now_us + ZMOD4XXX_SIM_MEAS_MS * 1000ULL;
+    for (i = 0; i < RSLT_MAX / 2; i++)
+    {
+        int32_t level = sim->level[i] + (int32_t)(sim_rand(sim) % 33) - 16;
+
+        if (level < SIM_MOX_LR + span / 20)
+        {
+            level = SIM_MOX_LR + span / 20;
+        }
+        else if (level > SIM_MOX_ER - span / 20)
+        {
+            level = SIM_MOX_ER - span / 20;
+        }
+        sim->level[i] = (uint16_t)level;
+        r[2 * i] = (uint8_t)(level >> 8);
+        r[2 * i + 1] = (uint8_t)level;
+    }
+}
+
+static uint8_t sim_status(const zmod4xxx_sim_t *sim)
+{
+    uint8_t steps = sim->s_len / 2;
+    uint8_t st = (uint8_t)((steps ? steps - 1 : 0) & STATUS_LAST_SEQ_STEP_MASK);
+
+    if (sim_running(sim))
+    {
+        st |= STATUS_SEQUENCER_RUNNING_MASK;
+    }
+    return st;
+}
+
+/* start, register, repeated start, address and data bytes, 9 clocks each */
+static void sim_bus_time(zmod4xxx_sim_t *sim, uint8_t len, uint8_t read)
+{
+    uint32_t bytes = 2u + len + (read ? 1u : 0u);
+
+    sim->stats.bus_ns += (bytes * 9u + 2u) * (1000000000ULL / ZMOD4XXX_SIM_I2C_HZ);
+}
+
+/**
+ * @brief Sleep for some time. Depending on target and application this can \n
+ *        be used to go into power down or to do task switching.
+ * @param [in] ms will sleep for at least this number of milliseconds
+ */
+static void sim_sleep(uint32_t ms)
+{
+    if (sim_current == NULL)
+    {
+        return;
+    }
+    sim_current->now_us += ms * 1000ULL;
+    sim_current->stats.sleeps++;
+    sim_current->stats.slept_ms += ms;
+}
+
+/**
+ * @brief Read a register of the simulated sensor
+ * @param [in] i2c_addr 7-bit I2C slave address of the ZMOD45xx
+ * @param [in] reg_addr address of internal register to read
+ * @param [out] buf destination buffer; must have at least a size of len*uint8_t
+ * @param [in] len number of bytes to read
+ * @return error code
+ */
+static int8_t sim_i2c_read(uint8_t i2c_addr, uint8_t reg_addr, uint8_t *buf, uint8_t len)
+{
+    zmod4xxx_sim_t *sim = sim_bus[i2c_addr & 0x7F];
+
+    if (sim == NULL)
+    {
+        return ERROR_I2C;
+    }
+    sim_current = sim;
+    return zmod4xxx_sim_read(sim, reg_addr, buf, len);
+}
+
+/**
+ * @brief Write a register of the simulated sensor
+ * @param [in] i2c_addr 7-bit I2C slave address of the ZMOD4xxx
+ * @param [in] reg_addr address of internal register to write
+ * @param [in] buf source buffer; must have at least a size of len*uint8_t
+ * @param [in] len number of bytes to write
+ * @return error code
+ */
+static int8_t sim_i2c_write(uint8_t i2c_addr, uint8_t reg_addr, uint8_t *buf, uint8_t len)
+{
+    zmod4xxx_sim_t *sim = sim_bus[i2c_addr & 0x7F];
+
+    if (sim == NULL)
+    {
+        return ERROR_I2C;
+    }
+    sim_current = sim;
+    return zmod4xxx_sim_write(sim, reg_addr, buf, len);
+}
+
+int8_t zmod4xxx_sim_read(zmod4xxx_sim_t *sim, uint8_t reg_addr, uint8_t *buf, uint8_t len)
+{
+    uint16_t i;
+
+    sim->stats.reads++;
+    if (sim_fault_step(sim))
+    {
+        return ERROR_I2C;
+    }
+    sim->stats.read_bytes += len;
+    sim_bus_time(sim, len, 1);
+
+    for (i = 0; i < len; i++)
+    {
+        uint8_t reg = (uint8_t)(reg_addr + i);
+
+        if (reg == ZMOD4XXX_ADDR_STATUS)
+        {
+            buf[i] = sim_status(sim);
+        }
+        else
+        {
+            buf[i] = sim->regs[reg];
+        }
+    }
+    /* the error event register is cleared on read */
+    if (reg_addr <= SIM_ADDR_ERROR && reg_addr + len > SIM_ADDR_ERROR)
+    {
+        sim->regs[SIM_ADDR_ERROR] = 0;
+    }
+    if (sim->truncate_left && len > sim->truncate_keep)
+    {
+        sim->truncate_left--;
+        memset(&buf[sim->truncate_keep], 0xFF, len - sim->truncate_keep);
+    }
+    return ZMOD4XXX_OK;
+}
+
+int8_t zmod4xxx_sim_write(zmod4xxx_sim_t *sim, uint8_t reg_addr, const uint8_t *buf, uint8_t len)
+{
+    uint16_t i;
+
+    sim->stats.writes++;
+    if (sim_fault_step(sim))
+    {
+        return ERROR_I2C;
+    }
+    sim->stats.write_bytes += len;
+    sim_bus_time(sim, len, 0);
+
+    if (reg_addr == ZMOD4XXX_ADDR_CMD && len == 1)
+    {
+        if (buf[0] & SIM_CMD_START)
+        {
+            sim_start_sequence(sim);
+        }
+        else
+        {
+            sim->seq_end_us = sim->now_us;
+        }
+        return ZMOD4XXX_OK;
+    }
+    if (reg_addr == SIM_ADDR_S)
+    {
+        sim->s_len = len;
+    }
+    for (i = 0; i < len; i++)
+    {
+        sim->regs[(uint8_t)(reg_addr + i)] = buf[i];
+    }
+    return ZMOD4XXX_OK;
+}
+
+void zmod4xxx_sim_init(zmod4xxx_sim_t *sim, uint8_t i2c_addr, uint32_t seed)
+{
+    uint8_t i;
+
+    memset(sim, 0, sizeof(*sim));
+    sim->i2c_addr = i2c_addr & 0x7F;
+    sim->rng = seed ? seed : 0x2545F491;
+    sim->fault_rng = sim->rng ^ 0x9E3779B9;
+
+    memcpy(&sim->regs[ZMOD4XXX_ADDR_PID], sim_pid, sizeof(sim_pid));
+    memcpy(&sim->regs[ZMOD4XXX_ADDR_CONF], sim_conf, sizeof(sim_conf));
+    memcpy(&sim->regs[ZMOD4XXX_ADDR_PROD_DATA], sim_prod_data, sizeof(sim_prod_data));
+    memcpy(&sim->regs[ZMOD4XXX_ADDR_TRACKING], sim_tracking, sizeof(sim_tracking));
+    /* a fresh power-up reports a POR event until the register is read */
+    sim->regs[SIM_ADDR_ERROR] = STATUS_POR_EVENT_MASK;
+
+    for (i = 0; i < RSLT_MAX / 2; i++)
+    {
+        sim->level[i] = (uint16_t)(SIM_MOX_LR +
+                                   sim_rand(sim) % (SIM_MOX_ER - SIM_MOX_LR));
+    }
+}
+
+int8_t zmod4xxx_sim_fault_add(zmod4xxx_sim_t *sim, const zmod4xxx_sim_fault_t *fault)
+{
+    if (fault->type >= ZMOD4XXX_SIM_FAULT_TYPE_MAX)
+    {
+        return ERROR_INIT_OUT_OF_RANGE;
+    }
+    if (sim->fault_count == ZMOD4XXX_SIM_FAULT_MAX)
+    {
+        return ERROR_INIT_OUT_OF_RANGE;
+    }
+    sim->faults[sim->fault_count] = *fault;
+    sim->faults[sim->fault_count].fired = 0;
+    sim->fault_count++;
+    return ZMOD4XXX_OK;
+}
+
+const char *zmod4xxx_sim_fault_name(uint8_t type)
+{
+    return type < ZMOD4XXX_SIM_FAULT_TYPE_MAX ? sim_fault_names[type] : "none";
+}
+
+static const char *sim_skip_space(const char *p)
+{
+    while (*p == ' ' || *p == '\t')
+    {
+        p++;
+    }
+    return p;
+}
+
+/* compare a word of p, ending at whitespace, '=' or NUL, with name */
+static int sim_word_is(const char *p, const char *name)
+{
+    size_t n = strlen(name);
+
+    return strncmp(p, name, n) == 0 &&
+           (p[n] == '\0' || p[n] == ' ' || p[n] == '\t' || p[n] == '=' ||
+            p[n] == '\n' || p[n] == '\r');
+}
+
+int8_t zmod4xxx_sim_fault_parse(const char *line, zmod4xxx_sim_fault_t *fault)
+{
+    const char *p = sim_skip_space(line);
+    char *end;
+    uint8_t t;
+
+    memset(fault, 0, sizeof(*fault));
+    fault->type = ZMOD4XXX_SIM_FAULT_TYPE_MAX;
+    if (*p == '\0' || *p == '#' || *p == '\n' || *p == '\r')
+    {
+        return ZMOD4XXX_OK;
+    }
+
+    if (sim_word_is(p, "rand"))
+    {
+        p += 4;
+    }
+    else
+    {
+        fault->at_ms = (uint32_t)strtoul(p, &end, 0);
+        if (end == p)
+        {
+            return ERROR_INIT_OUT_OF_RANGE;
+        }
+        p = end;
+    }
+
+    p = sim_skip_space(p);
+    for (t = 0; t < ZMOD4XXX_SIM_FAULT_TYPE_MAX; t++)
+    {
+        if (sim_word_is(p, sim_fault_names[t]))
+        {
+            break;
+        }
+    }
+    if (t == ZMOD4XXX_SIM_FAULT_TYPE_MAX)
+    {
+        return ERROR_INIT_OUT_OF_RANGE;
+    }
+    p += strlen(sim_fault_names[t]);
+
+    for (p = sim_skip_space(p); *p && *p != '\n' && *p != '\r'; p = sim_skip_space(end))
+    {
+        uint32_t *dst;
+
+        if (sim_word_is(p, "count"))
+        {
+            dst = &fault->count;
+        }
+        else if (sim_word_is(p, "for"))
+        {
+            dst = &fault->duration_ms;
+        }
+        else if (sim_word_is(p, "keep") || sim_word_is(p, "us"))
+        {
+            dst = &fault->param;
+        }
+        else if (sim_word_is(p, "rate"))
+        {
+            dst = &fault->rate_ppm;
+        }
+        else
+        {
+            return ERROR_INIT_OUT_OF_RANGE;
+        }
+        p = strchr(p, '=');
+        if (p == NULL)
+        {
+            return ERROR_INIT_OUT_OF_RANGE;
+        }
+        *dst = (uint32_t)strtoul(p + 1, &end, 0);
+        if (end == p + 1)
+        {
+            return ERROR_INIT_OUT_OF_RANGE;
+        }
+    }
+
+    if (sim_word_is(sim_skip_space(line), "rand") && fault->rate_ppm == 0)
+    {
+        return ERROR_INIT_OUT_OF_RANGE;
+    }
+    fault->type = t;
+    return ZMOD4XXX_OK;
+}
+
+int8_t zmod4xxx_sim_attach(zmod4xxx_sim_t *sim, zmod4xxx_dev_t *dev)
+{
+    if (sim_bus[sim->i2c_addr] != NULL && sim_bus[sim->i2c_addr] != sim)
+    {
+        return ERROR_INIT_OUT_OF_RANGE;
+    }
+    sim_bus[sim->i2c_addr] = sim;
+    sim_current = sim;
+
+    dev->i2c_addr = sim->i2c_addr;
+    dev->read = sim_i2c_read;
+    dev->write = sim_i2c_write;
+    dev->delay_ms = sim_sleep;
+    return ZMOD4XXX_OK;
+}
+
+void zmod4xxx_sim_detach(zmod4xxx_sim_t *sim)
+{
+    if (sim_bus[sim->i2c_addr] == sim)
+    {
+        sim_bus[sim->i2c_addr] = NULL;
+    }
+    if (sim_current == sim)
+    {
+        sim_current = NULL;
+    }
+}
+
+void zmod4xxx_sim_select(zmod4xxx_sim_t *sim)
+{
+    sim_current = sim;
+}
+
+uint64_t zmod4xxx_sim_time_us(const zmod4xxx_sim_t *sim)
+{
+    return sim->now_us;
+}
+
+void zmod4xxx_sim_set_time_us(zmod4xxx_sim_t *sim, uint64_t us)
+{
+    if (us > sim->now_us)
+    {
+        sim->now_us = us;
+    }
+}
+
+#ifndef ZMOD4XXX_SIM_MODEL_ONLY
+/**
+ * @brief   Initialize the target hardware
+ * @param   [in] dev pointer to the device
+ * @return  error code
+ * @retval  0 success
+ * @retval  "!= 0" error
+ */
+int8_t init_hardware(zmod4xxx_dev_t *dev)
+{
+    zmod4xxx_sim_init(&sim_default, SIM_DEFAULT_ADDR, 0);
+    return zmod4xxx_sim_attach(&sim_default, dev);
+}
+
+/**
+ * @brief   Check if any key is pressed
+ * @retval  1 pressed
+ * @retval  0 not pressed
+ */
+int8_t is_key_pressed(void)
+{
+    return 0;
+}
+
+/**
+ * @brief   deinitialize target hardware
+ * @return  error code
+ * @retval  0 success
+ * @retval  "!= 0" error
+ */
+int8_t deinit_hardware(void)
+{
+    zmod4xxx_sim_detach(&sim_default);
+    return ZMOD4XXX_OK;
+}
+
+uint32_t hal_get_time_ms(void)
+{
+    if (sim_current == NULL)
+    {
+        return 0;
+    }
+    return (uint32_t)(sim_current->now_us / 1000);
+}
+
+uint32_t hal_get_time_us(void)
+{
+    if (sim_current == NULL)
+    {
+        return 0;
+    }
+    return (uint32_t)sim_current->now_us;
+}
+
+void hal_delay_us(uint32_t us)
+{
+    if (sim_current == NULL)
+    {
+        return;
+    }
+    sim_current->now_us += us;
+}
+#endif /* ZMOD4XXX_SIM_MODEL_ONLY */
@@ -0,0 +1,256 @@
+/*
+ * Copyright (c) 2006-2021, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-19     Sherman      first version
+ * 2026-10-19     Sherman      add fault injection
+ * 2026-10-19     Sherman      add sleep timer and bus time
+ * 2026-10-19     Sherman      add access by instance
+ * 2026-10-19     Sherman      remove the sleep timer
+ */
+
+#ifndef _HAL_SIM_H
+#define _HAL_SIM_H
+
+#include "zmod4xxx.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* sequencer run times of the simulated ZMOD4410 */
+#define ZMOD4XXX_SIM_INIT_MS    (100)
+#define ZMOD4XXX_SIM_MEAS_MS    (1000)
+
+#define ZMOD4XXX_SIM_I2C_HZ     (400000) /**< bus clock for bus_ns */
+
+#define ZMOD4XXX_SIM_FAULT_MAX  (16)
+
+/**
+ * @brief Faults the simulated bus can inject
+ */
+typedef enum {
+    ZMOD4XXX_SIM_FAULT_NACK = 0, /**< transactions fail with ERROR_I2C */
+    ZMOD4XXX_SIM_FAULT_STUCK, /**< status keeps reporting the sequencer running */
+    ZMOD4XXX_SIM_FAULT_POR, /**< power-on reset: configuration lost, 0xB7 POR bit */
+    ZMOD4XXX_SIM_FAULT_CONFLICT, /**< running sequence aborted, 0xB7 conflict bit */
+    ZMOD4XXX_SIM_FAULT_TRUNCATE, /**< reads succeed but return 0xFF after keep bytes */
+    ZMOD4XXX_SIM_FAULT_STRETCH, /**< every transaction is held for us microseconds */
+    ZMOD4XXX_SIM_FAULT_TYPE_MAX
+} zmod4xxx_sim_fault_type;
+
+/**
+ * @brief One scheduled or random fault
+ */
+typedef struct {
+    uint8_t type; /**< zmod4xxx_sim_fault_type */
+    uint8_t fired; /**< set once a scheduled fault has triggered */
+    uint32_t at_ms; /**< virtual time the fault triggers at */
+    uint32_t rate_ppm; /**< if not 0, chance per transaction instead of at_ms */
+    uint32_t count; /**< NACK, TRUNCATE: transactions affected */
+    uint32_t duration_ms; /**< STUCK, STRETCH: how long the fault lasts */
+    uint32_t param; /**< TRUNCATE: bytes kept, STRETCH: microseconds */
+} zmod4xxx_sim_fault_t;
+
+/**
+ * @brief Bus traffic seen by one simulated sensor
+ */
+typedef struct {
+    uint32_t reads; /**< read transactions */
+    uint32_t writes; /**< write transactions */
+    uint32_t read_bytes; /**< payload bytes read */
+    uint32_t write_bytes; /**< payload bytes written */
+    uint32_t sleeps; /**< calls to delay_ms */
+    uint64_t slept_ms; /**< virtual time spent in delay_ms */
+    uint32_t sequences; /**< sequencer runs started */
+    uint64_t bus_ns; /**< time the transactions occupy the bus */
+    uint32_t faults; /**< faults triggered */
+    uint64_t last_fault_us; /**< virtual time of the last fault */
+    uint8_t last_fault; /**< type of the last fault */
+} zmod4xxx_sim_stats_t;
+
+/**
+ * @brief One simulated ZMOD4410 with its own virtual clock
+ */
+typedef struct {
+    uint8_t i2c_addr; /**< address the instance answers on */
+    uint8_t regs[256]; /**< register file */
+    uint8_t s_len; /**< length of the last sequencer table written */
+    uint64_t now_us; /**< virtual clock */
+    uint64_t seq_end_us; /**< sequencer busy until this time */
+    uint32_t rng; /**< xorshift state, drives the ADC values */
+    uint16_t level[RSLT_MAX / 2]; /**< current ADC level per channel */
+    uint8_t result_valid; /**< result registers hold a completed measurement */
+    zmod4xxx_sim_stats_t stats;
+
+    /* fault injection */
+    zmod4xxx_sim_fault_t faults[ZMOD4XXX_SIM_FAULT_MAX];
+    uint8_t fault_count;
+    uint32_t fault_rng; /**< separate stream so faults do not shift the data */
+    uint32_t nack_left;
+    uint32_t truncate_left;
+    uint32_t truncate_keep;
+    uint32_t stretch_us;
+    uint64_t stretch_end_us;
+    uint64_t stuck_end_us;
+} zmod4xxx_sim_t;
+
+/**
+ * @brief   Power on a simulated sensor
+ * @param   [out] sim instance
+ * @param   [in] i2c_addr 7-bit address the instance answers on
+ * @param   [in] seed seed of the ADC value generator, 0 picks a default
+ */
+void zmod4xxx_sim_init(zmod4xxx_sim_t *sim, uint8_t i2c_addr, uint32_t seed);
+
+/**
+ * @brief   Schedule a fault
+ * @param   [in] sim instance
+ * @param   [in] fault fault to add; copied
+ * @return  error code
+ * @retval  0 success
+ * @retval  "!= 0" error
+ */
+int8_t zmod4xxx_sim_fault_add(zmod4xxx_sim_t *sim, const zmod4xxx_sim_fault_t *fault);
+
+/**
+ * @brief   Parse one line of a fault script
+ *
+ *  "<at_ms> <type> [key=value]..." schedules a fault at a virtual time,
+ *  "rand <type> rate=<ppm> [key=value]..." triggers it at random, seeded by
+ *  zmod4xxx_sim_init(). Types: nack, stuck, por, conflict, truncate, stretch.
+ *  Keys: count, for (milliseconds), keep (bytes), us (microseconds).
+ *  Empty lines and lines starting with '#' are accepted and yield no fault.
+ *
+ * @param   [in] line text to parse
+ * @param   [out] fault parsed fault, type is ZMOD4XXX_SIM_FAULT_TYPE_MAX
+ *          for lines without one
+ * @return  error code
+ * @retval  0 success
+ * @retval  "!= 0" syntax error
+ */
+int8_t zmod4xxx_sim_fault_parse(const char *line, zmod4xxx_sim_fault_t *fault);
+
+/**
+ * @brief   Name of a fault type as used in scripts
+ * @param   [in] type zmod4xxx_sim_fault_type
+ * @return  name
+ */
+const char *zmod4xxx_sim_fault_name(uint8_t type);
+
+/**
+ * @brief   Put a simulated sensor on the bus and point a device at it
+ * @param   [in] sim instance; addresses must be unique on the bus
+ * @param   [out] dev device; i2c_addr and the function pointers are set
+ * @return  error code
+ * @retval  0 success
+ * @retval  "!= 0" error
+ */
+int8_t zmod4xxx_sim_attach(zmod4xxx_sim_t *sim, zmod4xxx_dev_t *dev);
+
+/**
+ * @brief   Remove a simulated sensor from the bus
+ * @param   [in] sim instance
+ */
+void zmod4xxx_sim_detach(zmod4xxx_sim_t *sim);
+
+/**
+ * @brief   Make an instance the one that delay_ms and hal_get_time_ms act on
+ * @param   [in] sim instance
+ * @note    Every bus access selects the addressed instance, so this is only
+ *          needed before sleeping without talking to the sensor first.
+ */
+void zmod4xxx_sim_select(zmod4xxx_sim_t *sim);
+
+/**
+ * @brief   Read the virtual clock of an instance
+ * @param   [in] sim instance
+ * @return  microseconds since zmod4xxx_sim_init()
+ */
+uint64_t zmod4xxx_sim_time_us(const zmod4xxx_sim_t *sim);
+
+/**
+ * @brief   Set the virtual clock of an instance, e.g. to an executor's time
+ * @param   [in] sim instance
+ * @param   [in] us microseconds, not before the current time
+ */
+void zmod4xxx_sim_set_time_us(zmod4xxx_sim_t *sim, uint64_t us);
+
+/**
+ * @brief   Read registers of an instance without going through the bus
+ * @param   [in] sim instance
+ * @param   [in] reg_addr address of the first register
+ * @param   [out] buf destination
+ * @param   [in] len number of bytes
+ * @return  error code
+ * @retval  0 success
+ * @retval  "!= 0" an injected fault
+ * @note    With the instance passed in, any number of instances can be
+ *          driven, from any number of threads as long as each instance is
+ *          used by one thread only.
+ */
+int8_t zmod4xxx_sim_read(zmod4xxx_sim_t *sim, uint8_t reg_addr, uint8_t *buf, uint8_t len);
+
+/**
+ * @brief   Write registers of an instance without going through the bus
+ * @param   [in] sim instance
+ * @param   [in] reg_addr address of the first register
+ * @param   [in] buf source
+ * @param   [in] len number of bytes
+ * @return  error code
+ * @retval  0 success
+ * @retval  "!= 0" an injected fault
+ */
+int8_t zmod4xxx_sim_write(zmod4xxx_sim_t *sim, uint8_t reg_addr, const uint8_t *buf, uint8_t len);
+
+/**
+ * @brief   Initialize the target hardware
+ * @param   [in] dev pointer to the device
+ * @return  error code
+ * @retval  0 success
+ * @retval  "!= 0" error
+ * @note    Attaches a default instance at the ZMOD4410 address.
+ */
+int8_t init_hardware(zmod4xxx_dev_t *dev);
+
+/**
+ * @brief   Check if any key is pressed
+ * @retval  1 pressed
+ * @retval  0 not pressed
+ */
+int8_t is_key_pressed(void);
+
+/**
+ * @brief   deinitialize target hardware
+ * @return  error code
+ * @retval  0 success
+ * @retval  "!= 0" error
+ */
+int8_t deinit_hardware(void);
+
+/**
+ * @brief   Milliseconds on the clock that delay_ms advances
+ * @return  virtual time of the selected instance
+ */
+uint32_t hal_get_time_ms(void);
+
+/**
+ * @brief   Microseconds on the clock that delay_ms advances
+ * @return  virtual time of the selected instance, wrapping at 2^32
+ */
+uint32_t hal_get_time_us(void);
+
+/**
+ * @brief   Advance the virtual clock by a short wait, e.g. a bus retry backoff
+ * @param   [in] us microseconds to wait at least
+ */
+void hal_delay_us(uint32_t us);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _HAL_SIM_H */
@@ -6,14 +6,22 @@
  * Change Logs:
  * Date           Author       Notes
  * 2021-11-15     Sherman      first version
+ * 2026-10-19     Sherman      add simulated host HAL
+ * 2026-10-19     Sherman      add Linux host HAL
  */
 
 #ifndef _ZMOD4XXX_HAL_H_
 #define _ZMOD4XXX_HAL_H_
 
+#if defined(ZMOD4XXX_USING_HAL_SIM)
+#include "hal_sim.h"
+#elif defined(ZMOD4XXX_USING_HAL_LINUX)
+#include "hal_linux.h"
+#else
 #define PKG_USING_ZMOD4410 
 #ifdef PKG_USING_ZMOD4410
 #include "hal_rtthread.h"
 #endif
+#endif
 
 #endif /* _ZMOD4XXX_HAL_H_ */
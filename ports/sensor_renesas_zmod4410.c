@@ -6,21 +6,75 @@
  * Change Logs:
  * Date           Author       Notes
  * 2020-11-03     Sherman      the first version
+ * 2026-10-19     Sherman      move result scaling to zmod4410_scale.h
+ * 2026-10-19     Sherman      add I2C statistics
+ * 2026-10-19     Sherman      add trace points
+ * 2026-10-19     Sherman      recover from POR and access conflict events
+ * 2026-10-19     Sherman      add I2C retry policy
+ * 2026-10-19     Sherman      add runtime switchable measurement modes
+ * 2026-10-19     Sherman      run sleep timer modes without host starts
+ * 2026-10-19     Sherman      add adaptive sampling
+ * 2026-10-19     Sherman      add threshold and rate rules
+ * 2026-10-19     Sherman      add windowed statistics
+ * 2026-10-19     Sherman      add compressed history
+ * 2026-10-19     Sherman      add batch samples for the uplink
+ * 2026-10-19     Sherman      add deferred binary logging
+ * 2026-10-19     Sherman      add background cleaning
+ * 2026-10-19     Sherman      add sensor health tracking
+ * 2026-10-19     Sherman      time stamp samples at sequencer completion
+ * 2026-10-19     Sherman      lock the shared bus per transaction
+ * 2026-10-19     Sherman      remove the sleep timer path
+ * 2026-10-19     Sherman      keep low power samples out of the algorithm
+ * 2026-10-19     Sherman      measure in a thread of the port with rules
+ * 2026-10-19     Sherman      pass the sample time to the health tracker
+ * 2026-10-19     Sherman      report sleeps inside a bus section as violations
+ * 2026-10-19     Sherman      share the status wait with the host tools
+ * 2026-10-19     Sherman      show bus lock timeouts in zmod_stats and zmod_retry
+ * 2026-10-19     Sherman      correct the note on retry backoffs under a bus section
+ * 2026-10-19     Sherman      report no reading when a polled sample fails
  */
 
 #include <stdint.h>
 #include <stdlib.h>
 
 #include "sensor_renesas_zmod4410.h"
+#include "zmod4410_scale.h"
 #include "zmod4410_config_iaq2.h"
 #include "zmod4xxx.h"
+#include "zmod4xxx_adapt.h"
+#include "zmod4xxx_bus.h"
+#include "zmod4xxx_clean.h"
+#include "zmod4xxx_dlog.h"
+#include "zmod4xxx_health.h"
+#include "zmod4xxx_jitter.h"
+#include "zmod4xxx_recover.h"
+#include "zmod4xxx_retry.h"
+#include "zmod4xxx_stats.h"
+#include "zmod4xxx_trace.h"
+#include "zmod4xxx_wait.h"
 #include "zmod4xxx_hal.h"
 #include "iaq_2nd_gen.h"
 
+#ifdef ZMOD4XXX_USING_HISTORY
+#include <time.h>
+#endif
+#if defined(ZMOD4XXX_USING_HISTORY) || defined(ZMOD4XXX_USING_CLEAN)
+#include <fal.h>
+#endif
+#ifdef ZMOD4XXX_USING_HEALTH
+#include <math.h>
+#endif
+
 #define DBG_TAG "sensor.zmod4410"
 #define DBG_LVL DBG_INFO
 #include <rtdbg.h>
 
+/* with rules a thread of the port measures, see sensor_renesas_zmod4410.h */
+#if defined(ZMOD4XXX_USING_RULES) && !defined(ZMOD4410_ACQ_NO_THREAD) && \
+    !defined(ZMOD4410_ACQ_THREAD)
+#define ZMOD4410_ACQ_THREAD
+#endif
+
 #define SENSOR_ETOH_RANGE_MAX (100)
 #define SENSOR_ETOH_RANGE_MIN (0)
 
@@ -41,9 +95,656 @@ struct zmod4410_device
     rt_uint8_t zmod4xxx_status;
     rt_uint8_t prod_data[ZMOD4410_PROD_DATA_LEN];
     iaq_2nd_gen_handle_t algo_handle;
+    zmod4xxx_recover_t recover;
+    const zmod4xxx_mode_t *mode;
+    zmod4xxx_stamp_t stamp; /* of the sample in progress */
+    zmod4xxx_wait_t wait; /* learns the run time of a host started sequence */
+    rt_uint32_t sample_ts; /* rt_sensor_get_ts() at stamp.done_us */
+    rt_uint32_t sample_ms; /* hal_get_time_ms() at stamp.done_us */
+    iaq_2nd_gen_results_t results; /* outputs of the last sample */
+    rt_uint8_t have_results;
+#ifdef ZMOD4XXX_USING_ADAPT
+    zmod4xxx_adapt_t adapt;
+    iaq_2nd_gen_results_t held;
+    rt_uint8_t low_power; /* started every ZMOD4410_ADAPT_LOW_WAIT_MS */
+#endif
 };
 static struct zmod4410_device zmod4410_dev;
 
+#ifdef ZMOD4XXX_USING_RETRY
+static const zmod4xxx_retry_policy_t zmod4410_retry_policy =
+{
+    ZMOD4XXX_RETRY_ATTEMPTS,
+    ZMOD4XXX_RETRY_BACKOFF_US,
+    ZMOD4XXX_RETRY_BACKOFF_MAX_US,
+    hal_delay_us,
+};
+#endif
+
+#ifdef ZMOD4XXX_USING_WINDOW
+static zmod4xxx_window_t zmod4410_windows[ZMOD4410_WINDOW_MAX][ZMOD4XXX_CH_MAX];
+
+/* histogram ranges per output: IAQ index, TVOC mg/m^3, EtOH ppm, eCO2 ppm */
+static const float zmod4410_window_range[ZMOD4XXX_CH_MAX][2] =
+{
+    { 0.0f, 5.0f }, { 0.0f, 10.0f }, { 0.0f, 20.0f }, { 400.0f, 2400.0f },
+};
+
+static void zmod4410_window_init(void)
+{
+    zmod4xxx_window_config_t cfg;
+    rt_uint8_t ch;
+
+    for (ch = 0; ch < ZMOD4XXX_CH_MAX; ch++)
+    {
+        cfg.lo = zmod4410_window_range[ch][0];
+        cfg.hi = zmod4410_window_range[ch][1];
+
+        cfg.bucket_ms = 5000;
+        cfg.buckets = 12;
+        cfg.alpha = 0.1f;
+        zmod4xxx_window_init(&zmod4410_windows[ZMOD4410_WINDOW_1MIN][ch], &cfg);
+
+        cfg.bucket_ms = 60000;
+        cfg.buckets = 15;
+        cfg.alpha = 0.01f;
+        zmod4xxx_window_init(&zmod4410_windows[ZMOD4410_WINDOW_15MIN][ch], &cfg);
+    }
+}
+
+static void zmod4410_window_add(const iaq_2nd_gen_results_t *results)
+{
+    float values[ZMOD4XXX_CH_MAX];
+    rt_uint32_t now = hal_get_time_ms();
+    rt_uint8_t win, ch;
+
+    values[ZMOD4XXX_CH_IAQ] = results->iaq;
+    values[ZMOD4XXX_CH_TVOC] = results->tvoc;
+    values[ZMOD4XXX_CH_ETOH] = results->etoh;
+    values[ZMOD4XXX_CH_ECO2] = results->eco2;
+
+    rt_enter_critical();
+    for (win = 0; win < ZMOD4410_WINDOW_MAX; win++)
+    {
+        for (ch = 0; ch < ZMOD4XXX_CH_MAX; ch++)
+        {
+            zmod4xxx_window_add(&zmod4410_windows[win][ch], values[ch], now);
+        }
+    }
+    rt_exit_critical();
+}
+
+rt_err_t zmod4410_window_get(rt_uint8_t window, rt_uint8_t channel,
+                             zmod4xxx_window_result_t *res)
+{
+    if (window >= ZMOD4410_WINDOW_MAX || channel >= ZMOD4XXX_CH_MAX || res == RT_NULL)
+    {
+        return -RT_EINVAL;
+    }
+    rt_enter_critical();
+    zmod4xxx_window_get(&zmod4410_windows[window][channel], hal_get_time_ms(), res);
+    rt_exit_critical();
+    return RT_EOK;
+}
+#endif /* ZMOD4XXX_USING_WINDOW */
+
+#ifdef ZMOD4XXX_USING_HISTORY
+#ifndef ZMOD4410_HISTORY_PART
+#define ZMOD4410_HISTORY_PART       "zmod_hist"
+#endif
+#ifndef ZMOD4410_HISTORY_PERIOD_S
+#define ZMOD4410_HISTORY_PERIOD_S   (60)
+#endif
+#ifdef ZMOD4410_HISTORY_LOG_RCDA
+#define ZMOD4410_HISTORY_CHANNELS   (5)
+#else
+#define ZMOD4410_HISTORY_CHANNELS   (4)
+#endif
+#define ZMOD4410_HISTORY_PAGE       (ZMOD4XXX_HISTORY_PAGE_SIZE)
+
+static const struct fal_partition *zmod4410_hist_part;
+static rt_uint32_t zmod4410_hist_blk;
+static zmod4xxx_history_t zmod4410_history;
+static struct rt_mutex zmod4410_hist_lock;
+static rt_uint32_t zmod4410_hist_last;
+
+static int zmod4410_hist_read(void *ctx, uint32_t page, uint32_t off,
+                              void *buf, uint32_t len)
+{
+    return fal_partition_read(zmod4410_hist_part, page * ZMOD4410_HISTORY_PAGE + off,
+                              buf, len) < 0;
+}
+
+static int zmod4410_hist_prog(void *ctx, uint32_t page, const void *buf, uint32_t len)
+{
+    return fal_partition_write(zmod4410_hist_part, page * ZMOD4410_HISTORY_PAGE,
+                               buf, len) < 0;
+}
+
+/* pages are programmed in order, so a block is erased when its first page
+ * comes up */
+static int zmod4410_hist_erase(void *ctx, uint32_t page)
+{
+    rt_uint32_t off = page * ZMOD4410_HISTORY_PAGE;
+
+    if (off % zmod4410_hist_blk)
+    {
+        return 0;
+    }
+    return fal_partition_erase(zmod4410_hist_part, off,
+                               zmod4410_hist_blk > ZMOD4410_HISTORY_PAGE ?
+                               zmod4410_hist_blk : ZMOD4410_HISTORY_PAGE) < 0;
+}
+
+static void zmod4410_history_init(void)
+{
+    const struct fal_partition *part;
+    const struct fal_flash_dev *flash;
+    zmod4xxx_history_flash_t ops =
+    {
+        zmod4410_hist_read,
+        zmod4410_hist_prog,
+        zmod4410_hist_erase,
+        RT_NULL,
+        0,
+    };
+    rt_int8_t ret;
+
+    part = fal_partition_find(ZMOD4410_HISTORY_PART);
+    if (part == RT_NULL)
+    {
+        LOG_W("no partition %s, history disabled", ZMOD4410_HISTORY_PART);
+        return;
+    }
+    flash = fal_flash_device_find(part->flash_name);
+    zmod4410_hist_blk = flash ? flash->blk_size : ZMOD4410_HISTORY_PAGE;
+    ops.pages = part->len / ZMOD4410_HISTORY_PAGE;
+
+    zmod4410_hist_part = part;
+    rt_mutex_init(&zmod4410_hist_lock, "zmodhist", RT_IPC_FLAG_PRIO);
+    ret = zmod4xxx_history_init(&zmod4410_history, &ops, ZMOD4410_HISTORY_CHANNELS);
+    if (ret)
+    {
+        LOG_W("Error %d when mounting the history, history disabled", ret);
+        zmod4410_hist_part = RT_NULL;
+        rt_mutex_detach(&zmod4410_hist_lock);
+    }
+}
+
+static void zmod4410_history_add(const iaq_2nd_gen_results_t *results)
+{
+    zmod4xxx_history_sample_t s;
+    rt_uint32_t now = (rt_uint32_t)time(RT_NULL);
+
+    if (zmod4410_hist_part == RT_NULL ||
+        (zmod4410_hist_last && now - zmod4410_hist_last < ZMOD4410_HISTORY_PERIOD_S))
+    {
+        return;
+    }
+    zmod4410_hist_last = now;
+
+    rt_memset(&s, 0, sizeof(s));
+    s.ts = now;
+    s.v[0] = results->iaq;
+    s.v[1] = results->tvoc;
+    s.v[2] = results->etoh;
+    s.v[3] = results->eco2;
+#ifdef ZMOD4410_HISTORY_LOG_RCDA
+    s.v[4] = results->log_rcda;
+#endif
+    rt_mutex_take(&zmod4410_hist_lock, RT_WAITING_FOREVER);
+    if (zmod4xxx_history_append(&zmod4410_history, &s))
+    {
+        LOG_W("history sample not stored");
+    }
+    rt_mutex_release(&zmod4410_hist_lock);
+}
+
+rt_err_t zmod4410_history_query(rt_uint32_t t0, rt_uint32_t t1,
+                                zmod4xxx_history_cb_t cb, void *ctx)
+{
+    rt_int8_t ret;
+
+    if (zmod4410_hist_part == RT_NULL)
+    {
+        return -RT_ENOSYS;
+    }
+    rt_mutex_take(&zmod4410_hist_lock, RT_WAITING_FOREVER);
+    ret = zmod4xxx_history_query(&zmod4410_history, t0, t1, cb, ctx);
+    rt_mutex_release(&zmod4410_hist_lock);
+    return ret ? -RT_ERROR : RT_EOK;
+}
+
+rt_err_t zmod4410_history_aggregate(rt_uint32_t t0, rt_uint32_t t1,
+                                    zmod4xxx_history_agg_t *agg)
+{
+    rt_int8_t ret;
+
+    if (zmod4410_hist_part == RT_NULL)
+    {
+        return -RT_ENOSYS;
+    }
+    rt_mutex_take(&zmod4410_hist_lock, RT_WAITING_FOREVER);
+    ret = zmod4xxx_history_aggregate(&zmod4410_history, t0, t1, agg);
+    rt_mutex_release(&zmod4410_hist_lock);
+    return ret ? -RT_ERROR : RT_EOK;
+}
+
+rt_err_t zmod4410_history_flush(void)
+{
+    rt_int8_t ret;
+
+    if (zmod4410_hist_part == RT_NULL)
+    {
+        return -RT_ENOSYS;
+    }
+    rt_mutex_take(&zmod4410_hist_lock, RT_WAITING_FOREVER);
+    ret = zmod4xxx_history_flush(&zmod4410_history);
+    rt_mutex_release(&zmod4410_hist_lock);
+    return ret ? -RT_ERROR : RT_EOK;
+}
+#endif /* ZMOD4XXX_USING_HISTORY */
+
+#ifdef ZMOD4XXX_USING_HEALTH
+static zmod4xxx_health_t zmod4410_health;
+
+/* every result has resistances, log_rcda only once the algorithm is stable */
+static void zmod4410_health_update(const iaq_2nd_gen_results_t *results, rt_int8_t algo_ret)
+{
+    rt_uint8_t prev = zmod4410_health.flags, flags;
+
+    rt_enter_critical();
+    flags = zmod4xxx_health_update(&zmod4410_health, results->rmox,
+                                   sizeof(results->rmox) / sizeof(results->rmox[0]),
+                                   algo_ret == IAQ_2ND_GEN_OK ? results->log_rcda : NAN,
+                                   zmod4410_dev.sample_ms);
+    rt_exit_critical();
+    if (flags == prev)
+    {
+        return;
+    }
+#ifdef ZMOD4XXX_USING_DLOG
+    zmod4xxx_dlog(ZMOD4XXX_DLOG_HEALTH, 3, (uint32_t)flags, (uint32_t)zmod4410_health.latched,
+                  ZMOD4XXX_DLOG_F(zmod4xxx_health_drift(&zmod4410_health)));
+#else
+    LOG_W("health flags 0x%02x, latched 0x%02x", flags, zmod4410_health.latched);
+#endif
+}
+
+rt_err_t zmod4410_health_get(zmod4xxx_health_t *h)
+{
+    rt_enter_critical();
+    *h = zmod4410_health;
+    rt_exit_critical();
+    return zmod4410_health.samples ? RT_EOK : -RT_EEMPTY;
+}
+
+void zmod4410_health_clear(void)
+{
+    rt_enter_critical();
+    zmod4xxx_health_clear(&zmod4410_health);
+    rt_exit_critical();
+}
+#endif /* ZMOD4XXX_USING_HEALTH */
+
+#ifdef ZMOD4XXX_USING_BATCH
+static zmod4xxx_batch_sample_t zmod4410_batch;
+
+static void zmod4410_batch_set(const iaq_2nd_gen_results_t *results, rt_int8_t algo_ret)
+{
+    rt_enter_critical();
+    zmod4410_batch.seq++;
+    zmod4410_batch.ts = zmod4410_dev.sample_ts;
+    zmod4410_batch.flags = algo_ret == IAQ_2ND_GEN_OK ? ZMOD4XXX_BATCH_F_VALID
+                                                      : ZMOD4XXX_BATCH_F_STABILIZING;
+#ifdef ZMOD4XXX_USING_HEALTH
+    if (zmod4410_health.flags)
+    {
+        zmod4410_batch.flags |= ZMOD4XXX_BATCH_F_HEALTH;
+    }
+#endif
+    zmod4410_batch.v[0] = (int32_t)ZMOD4410_SCALE_IAQ(results->iaq);
+    zmod4410_batch.v[1] = (int32_t)ZMOD4410_SCALE_TVOC(results->tvoc);
+    zmod4410_batch.v[2] = (int32_t)ZMOD4410_SCALE_ETOH(results->etoh);
+    zmod4410_batch.v[3] = (int32_t)ZMOD4410_SCALE_ECO2(results->eco2);
+    rt_exit_critical();
+}
+
+rt_err_t zmod4410_batch_last(zmod4xxx_batch_sample_t *s)
+{
+    rt_err_t result = RT_EOK;
+
+    rt_enter_critical();
+    if (zmod4410_batch.seq == 0)
+    {
+        result = -RT_EEMPTY;
+    }
+    else
+    {
+        *s = zmod4410_batch;
+    }
+    rt_exit_critical();
+    return result;
+}
+#endif /* ZMOD4XXX_USING_BATCH */
+
+#ifdef ZMOD4XXX_USING_DLOG
+/*
+ * The sensor thread only stores records; this thread formats them. Define
+ * ZMOD4410_DLOG_NO_THREAD to drain the ring with zmod4xxx_dlog_read() and
+ * zmod4xxx_dlog_pack() and format on the host instead.
+ */
+#ifndef ZMOD4410_DLOG_PERIOD_MS
+#define ZMOD4410_DLOG_PERIOD_MS     (500)
+#endif
+#ifndef ZMOD4410_DLOG_PRIORITY
+#define ZMOD4410_DLOG_PRIORITY      (RT_THREAD_PRIORITY_MAX - 2)
+#endif
+#ifndef ZMOD4410_DLOG_STACK_SIZE
+#define ZMOD4410_DLOG_STACK_SIZE    (1024)
+#endif
+
+#ifndef ZMOD4410_DLOG_NO_THREAD
+static void zmod4410_dlog_entry(void *param)
+{
+    zmod4xxx_dlog_rec_t rec;
+    char line[128];
+    rt_uint32_t lost = 0;
+
+    for (;;)
+    {
+        while (zmod4xxx_dlog_read(&rec))
+        {
+            zmod4xxx_dlog_format(&rec, line, sizeof(line));
+            rt_kprintf("[%u] %s\n", rec.ts, line);
+        }
+        if (zmod4xxx_dlog_lost() != lost)
+        {
+            rt_kprintf("[zmod4410] %u log records lost\n", zmod4xxx_dlog_lost() - lost);
+            lost = zmod4xxx_dlog_lost();
+        }
+        rt_thread_mdelay(ZMOD4410_DLOG_PERIOD_MS);
+    }
+}
+#endif /* ZMOD4410_DLOG_NO_THREAD */
+
+static void zmod4410_dlog_init(void)
+{
+    zmod4xxx_dlog_init(hal_get_time_ms);
+#ifndef ZMOD4410_DLOG_NO_THREAD
+    {
+        rt_thread_t tid = rt_thread_create("zmod_log", zmod4410_dlog_entry, RT_NULL,
+                                           ZMOD4410_DLOG_STACK_SIZE,
+                                           ZMOD4410_DLOG_PRIORITY, 20);
+        if (tid == RT_NULL)
+        {
+            LOG_W("no log thread, records are kept in the ring only");
+            return;
+        }
+        rt_thread_startup(tid);
+    }
+#endif
+}
+#endif /* ZMOD4XXX_USING_DLOG */
+
+#ifdef ZMOD4XXX_USING_CLEAN
+/*
+ * The cleaning runs once in the life of a sensor, about ten minutes, in a
+ * thread of its own; measurements are refused until it is done. Its record
+ * is kept in the FAL partition ZMOD4410_CLEAN_PART, without which cleaning
+ * is disabled and measurements are not held back. Define
+ * ZMOD4410_CLEAN_MANUAL to start it with zmod4410_clean_start() or
+ * "zmod_clean start" instead of at init.
+ */
+#ifndef ZMOD4410_CLEAN_PART
+#define ZMOD4410_CLEAN_PART         "zmod_clean"
+#endif
+#ifndef ZMOD4410_CLEAN_PRIORITY
+#define ZMOD4410_CLEAN_PRIORITY     (RT_THREAD_PRIORITY_MAX - 3)
+#endif
+#ifndef ZMOD4410_CLEAN_STACK_SIZE
+#define ZMOD4410_CLEAN_STACK_SIZE   (1024)
+#endif
+
+static const struct fal_partition *zmod4410_clean_part;
+static zmod4xxx_clean_t zmod4410_clean;
+static rt_thread_t zmod4410_clean_tid;
+static volatile rt_uint8_t zmod4410_clean_gate; /* measurements may start */
+
+static int zmod4410_clean_load(void *ctx, void *buf, uint32_t len)
+{
+    return fal_partition_read(zmod4410_clean_part, 0, buf, len) < 0;
+}
+
+static int zmod4410_clean_store(void *ctx, const void *buf, uint32_t len)
+{
+    if (fal_partition_erase(zmod4410_clean_part, 0, len) < 0)
+    {
+        return 1;
+    }
+    return fal_partition_write(zmod4410_clean_part, 0, buf, len) < 0;
+}
+
+static void zmod4410_clean_entry(void *param)
+{
+    rt_int8_t ret;
+
+    ret = zmod4xxx_clean_run(&zmod4410_clean);
+    if (ret && zmod4xxx_clean_ready(&zmod4410_clean))
+    {
+        LOG_E("Error %d during cleaning, measurements stay disabled", ret);
+        goto exit;
+    }
+    if (ret)
+    {
+        LOG_W("Error %d when storing the cleaning record", ret);
+    }
+
+    /* the procedure leaves its own configuration in the sensor */
+    ret = zmod4xxx_prepare_sensor(&zmod4410_dev.dev);
+    if (ret == ZMOD4XXX_OK)
+    {
+        ret = zmod4xxx_recover_init(&zmod4410_dev.dev, &zmod4410_dev.recover,
+                                    hal_get_time_ms);
+    }
+    if (ret)
+    {
+        LOG_E("Error %d during preparation of the sensor after cleaning", ret);
+        goto exit;
+    }
+    zmod4410_clean_gate = 1;
+    LOG_I("sensor cleaned");
+exit:
+    zmod4410_clean_tid = RT_NULL;
+}
+
+rt_err_t zmod4410_clean_start(void)
+{
+    rt_thread_t tid;
+
+    if (zmod4410_clean_part == RT_NULL)
+    {
+        return -RT_ENOSYS;
+    }
+    if (zmod4410_clean_gate || zmod4410_clean_tid != RT_NULL)
+    {
+        return -RT_EBUSY;
+    }
+    tid = rt_thread_create("zmod_cln", zmod4410_clean_entry, RT_NULL,
+                           ZMOD4410_CLEAN_STACK_SIZE, ZMOD4410_CLEAN_PRIORITY, 20);
+    if (tid == RT_NULL)
+    {
+        return -RT_ENOMEM;
+    }
+    zmod4410_clean_tid = tid;
+    rt_thread_startup(tid);
+    return RT_EOK;
+}
+
+rt_err_t zmod4410_clean_progress(zmod4xxx_clean_progress_t *p)
+{
+    if (zmod4410_clean_part == RT_NULL)
+    {
+        return -RT_ENOSYS;
+    }
+    zmod4xxx_clean_progress(&zmod4410_clean, p);
+    return RT_EOK;
+}
+
+static void zmod4410_clean_init(void)
+{
+    zmod4xxx_clean_nv_t nv =
+    {
+        zmod4410_clean_load,
+        zmod4410_clean_store,
+        RT_NULL,
+    };
+    rt_int8_t ret;
+
+    zmod4410_clean_part = fal_partition_find(ZMOD4410_CLEAN_PART);
+    if (zmod4410_clean_part == RT_NULL)
+    {
+        LOG_W("no partition %s, cleaning disabled", ZMOD4410_CLEAN_PART);
+        zmod4410_clean_gate = 1;
+        return;
+    }
+    ret = zmod4xxx_clean_init(&zmod4410_clean, &zmod4410_dev.dev, &nv, hal_get_time_ms);
+    if (ret)
+    {
+        LOG_E("Error %d when loading the cleaning record, measurements disabled", ret);
+        return;
+    }
+    if (zmod4xxx_clean_ready(&zmod4410_clean) == ZMOD4XXX_OK)
+    {
+        zmod4410_clean_gate = 1;
+        return;
+    }
+    if (zmod4410_clean.rec.state == ZMOD4XXX_CLEAN_FAILED)
+    {
+        LOG_E("cleaning failed %u times, measurements disabled", zmod4410_clean.rec.attempts);
+        return;
+    }
+    if (zmod4410_clean.rec.state == ZMOD4XXX_CLEAN_RUNNING)
+    {
+        LOG_W("cleaning was interrupted, it runs again");
+    }
+#ifndef ZMOD4410_CLEAN_MANUAL
+    ret = zmod4410_clean_start();
+    if (ret)
+    {
+        LOG_E("Error %d when starting the cleaning", ret);
+    }
+#endif
+}
+#endif /* ZMOD4XXX_USING_CLEAN */
+
+#ifndef ZMOD4410_POLL_FINE_MS
+#define ZMOD4410_POLL_FINE_MS       ZMOD4XXX_WAIT_FINE_MS
+#endif
+#define ZMOD4410_POLL_TIMEOUT_MS    (ZMOD4410_IAQ2_COUNTER_LIMIT * ZMOD4XXX_WAIT_POLL_MS)
+
+#ifdef ZMOD4410_INT_PIN
+/* The INT pin goes low when the sequencer is done, e.g. "P104" */
+static struct rt_semaphore zmod4410_int_sem;
+static volatile rt_uint32_t zmod4410_int_us;
+static rt_uint8_t zmod4410_int_ok;
+
+static void zmod4410_int_isr(void *args)
+{
+    zmod4410_int_us = hal_get_time_us();
+    rt_sem_release(&zmod4410_int_sem);
+}
+
+static void zmod4410_int_init(void)
+{
+    rt_base_t pin = rt_pin_get(ZMOD4410_INT_PIN);
+
+    rt_sem_init(&zmod4410_int_sem, "zmod_int", 0, RT_IPC_FLAG_PRIO);
+    rt_pin_mode(pin, PIN_MODE_INPUT_PULLUP);
+    if (rt_pin_attach_irq(pin, PIN_IRQ_MODE_FALLING, zmod4410_int_isr, RT_NULL) != RT_EOK ||
+        rt_pin_irq_enable(pin, PIN_IRQ_ENABLE) != RT_EOK)
+    {
+        LOG_W("INT pin %s not usable, polling the status", ZMOD4410_INT_PIN);
+        return;
+    }
+    zmod4410_int_ok = 1;
+}
+#endif /* ZMOD4410_INT_PIN */
+
+/*
+ * Wait for the sequence started at stamp.start_us and stamp its end. With
+ * the INT pin the ISR has the time, else zmod4xxx_wait_done() polls the
+ * status around the learned end of the run, as zmod_bench checks it.
+ */
+static rt_int8_t zmod4410_wait_done(rt_uint32_t *polls)
+{
+    uint32_t n = 0;
+    rt_int8_t ret;
+
+#ifdef ZMOD4410_INT_PIN
+    zmod4xxx_stamp_t *s = &zmod4410_dev.stamp;
+
+    if (zmod4410_int_ok)
+    {
+        (*polls)++;
+        if (rt_sem_take(&zmod4410_int_sem,
+                        rt_tick_from_millisecond(ZMOD4410_POLL_TIMEOUT_MS)) != RT_EOK)
+        {
+            return ERROR_GAS_TIMEOUT;
+        }
+        s->done_us = zmod4410_int_us;
+        s->err_us = 0;
+        return ZMOD4XXX_OK;
+    }
+#endif
+    /* rt_uint32_t need not be the uint32_t of the libc */
+    ret = zmod4xxx_wait_done(&zmod4410_dev.dev, &zmod4410_dev.wait, &zmod4410_dev.stamp,
+                             &zmod4410_dev.zmod4xxx_status, &n);
+    *polls += n;
+    return ret;
+}
+
+#ifdef ZMOD4XXX_USING_JITTER
+static zmod4xxx_jitter_t zmod4410_jitter;
+
+rt_err_t zmod4410_jitter_get(zmod4xxx_jitter_t *j)
+{
+    rt_enter_critical();
+    *j = zmod4410_jitter;
+    rt_exit_critical();
+    return j->latency.count ? RT_EOK : -RT_EEMPTY;
+}
+
+void zmod4410_jitter_reset(void)
+{
+    rt_enter_critical();
+    zmod4xxx_jitter_init(&zmod4410_jitter);
+    rt_exit_critical();
+}
+#endif /* ZMOD4XXX_USING_JITTER */
+
+#ifdef ZMOD4XXX_USING_BUS
+static zmod4xxx_bus_t zmod4410_bus;
+
+rt_err_t zmod4410_bus_get(zmod4xxx_bus_stats_t *st)
+{
+    if (zmod4410_bus.name == RT_NULL)
+    {
+        return -RT_ENOSYS;
+    }
+    zmod4xxx_bus_get(&zmod4410_bus, st);
+    return RT_EOK;
+}
+
+void zmod4410_bus_reset(void)
+{
+    if (zmod4410_bus.name != RT_NULL)
+    {
+        zmod4xxx_bus_reset(&zmod4410_bus);
+    }
+}
+#endif /* ZMOD4XXX_USING_BUS */
+
 static rt_err_t _zmod4410_init(struct rt_sensor_intf *intf)
 {
     rt_int8_t ret;
@@ -61,9 +762,45 @@ static rt_err_t _zmod4410_init(struct rt_sensor_intf *intf)
 
     zmod4410_dev.dev.i2c_addr = ZMOD4410_I2C_ADDR;
     zmod4410_dev.dev.pid = ZMOD4410_PID;
-    zmod4410_dev.dev.init_conf = &zmod_sensor_type[INIT];
-    zmod4410_dev.dev.meas_conf = &zmod_sensor_type[MEASUREMENT];
+    zmod4410_dev.mode = zmod4410_mode_get(ZMOD4410_MODE_IAQ_2ND_GEN);
+    zmod4410_dev.dev.init_conf = zmod4410_dev.mode->init_conf;
+    zmod4410_dev.dev.meas_conf = zmod4410_dev.mode->meas_conf;
     zmod4410_dev.dev.prod_data = zmod4410_dev.prod_data;
+    zmod4xxx_wait_init(&zmod4410_dev.wait, ZMOD4410_POLL_FINE_MS, ZMOD4410_POLL_TIMEOUT_MS,
+                       hal_get_time_us);
+
+#ifdef ZMOD4XXX_USING_BUS
+    /* innermost, so a retry backoff between single transactions runs with
+     * the bus free; inside a section the retry layer skips the backoff */
+    ret = hal_bus_init(&zmod4410_bus, intf->dev_name);
+    if (!ret)
+    {
+        ret = zmod4xxx_bus_attach(&zmod4410_dev.dev, &zmod4410_bus);
+    }
+    if (ret)
+    {
+        LOG_W("Error %d when attaching the bus lock", ret);
+    }
+#endif
+    ret = zmod4xxx_stats_attach(&zmod4410_dev.dev, hal_get_time_us);
+    if (ret)
+    {
+        LOG_W("Error %d when attaching I2C statistics", ret);
+    }
+    ret = zmod4xxx_retry_attach(&zmod4410_dev.dev, &zmod4410_retry_policy);
+    if (ret)
+    {
+        LOG_W("Error %d when attaching I2C retry policy", ret);
+    }
+    zmod4xxx_trace_init(hal_get_time_us);
+#ifdef ZMOD4XXX_USING_DLOG
+    zmod4410_dlog_init();
+#endif
+    ret = zmod4xxx_trace_attach(&zmod4410_dev.dev);
+    if (ret)
+    {
+        LOG_W("Error %d when attaching I2C trace", ret);
+    }
 
     ret = zmod4xxx_read_sensor_info(&zmod4410_dev.dev);
     if (ret)
@@ -72,83 +809,251 @@ static rt_err_t _zmod4410_init(struct rt_sensor_intf *intf)
         goto exit;
     }
 
-    /* Preperation of sensor */
-    ret = zmod4xxx_prepare_sensor(&zmod4410_dev.dev);
-    if (ret)
+    /* Preperation of sensor */
+    ret = zmod4xxx_prepare_sensor(&zmod4410_dev.dev);
+    if (ret)
+    {
+        LOG_E("Error %d during preparation of the sensor, exiting program!\n",ret);
+        goto exit;
+    }
+
+    ret = zmod4xxx_recover_init(&zmod4410_dev.dev, &zmod4410_dev.recover,
+                                hal_get_time_ms);
+    if (ret)
+    {
+        LOG_E("Error %d when caching the sensor configuration, exiting program!\n", ret);
+        goto exit;
+    }
+
+    /* One time initialization of the algorithm */
+    ret = init_iaq_2nd_gen(&zmod4410_dev.algo_handle);
+    if (ret)
+    {
+        LOG_E("Error %d when initializing algorithm, exiting program!\n", ret);
+        goto exit;
+    }
+    zmod4xxx_adapt_init(&zmod4410_dev.adapt, RT_NULL, hal_get_time_ms());
+#ifdef ZMOD4XXX_USING_WINDOW
+    zmod4410_window_init();
+#endif
+#ifdef ZMOD4XXX_USING_HISTORY
+    zmod4410_history_init();
+#endif
+#ifdef ZMOD4XXX_USING_CLEAN
+    zmod4410_clean_init();
+#endif
+#ifdef ZMOD4XXX_USING_HEALTH
+    zmod4xxx_health_init(&zmod4410_health, RT_NULL);
+#endif
+#ifdef ZMOD4410_INT_PIN
+    zmod4410_int_init();
+#endif
+#ifdef ZMOD4XXX_USING_JITTER
+    zmod4xxx_jitter_init(&zmod4410_jitter);
+#endif
+
+    return RT_EOK;
+exit:
+    return -RT_ERROR;
+}
+
+#ifdef ZMOD4XXX_USING_ADAPT
+#ifndef ZMOD4410_ADAPT_LOW_WAIT_MS
+#define ZMOD4410_ADAPT_LOW_WAIT_MS  (89000) /* about one sample in 90 s */
+#endif
+
+/* Follow the air quality with the sampling rate. There is no low power
+ * table set, so low power runs the IAQ 2nd Gen tables with a long host
+ * wait. While the algorithm stabilizes again after low power the last
+ * valid outputs are published. */
+static void zmod4410_adapt(iaq_2nd_gen_results_t *results, rt_int8_t algo_ret)
+{
+    rt_uint8_t action;
+
+    action = zmod4xxx_adapt_update(&zmod4410_dev.adapt, results->iaq, results->tvoc,
+                                   algo_ret == IAQ_2ND_GEN_OK, hal_get_time_ms());
+    if (algo_ret == IAQ_2ND_GEN_OK)
+    {
+        zmod4410_dev.held = *results;
+    }
+    else if (zmod4410_dev.adapt.held)
+    {
+        *results = zmod4410_dev.held;
+    }
+
+    if (action == ZMOD4XXX_ADAPT_TO_LOW)
+    {
+        LOG_I("air quality flat, dropping to low power");
+        zmod4410_dev.low_power = 1;
+    }
+    else if (action == ZMOD4XXX_ADAPT_TO_FULL)
+    {
+        LOG_I("air quality changing, back to full rate");
+        zmod4410_dev.low_power = 0;
+        init_iaq_2nd_gen(&zmod4410_dev.algo_handle);
+    }
+}
+
+/* IAQ 2nd Gen needs a sample every 3 s, so low power samples skip it. The
+ * controller follows their resistances and the last full rate outputs are
+ * published again, not as valid. */
+static void zmod4410_adapt_low(rt_uint8_t *adc_result, iaq_2nd_gen_results_t *results)
+{
+    float rmox[16];
+    rt_uint8_t action;
+
+    zmod4xxx_calc_rmox(&zmod4410_dev.dev, adc_result, rmox);
+    action = zmod4xxx_adapt_update_low(&zmod4410_dev.adapt, rmox,
+                                       zmod4410_dev.dev.meas_conf->r.len / 2,
+                                       hal_get_time_ms());
+    *results = zmod4410_dev.held;
+    if (action == ZMOD4XXX_ADAPT_TO_FULL)
+    {
+        LOG_I("air quality changing, back to full rate");
+        zmod4410_dev.low_power = 0;
+        init_iaq_2nd_gen(&zmod4410_dev.algo_handle);
+    }
+}
+#endif /* ZMOD4XXX_USING_ADAPT */
+
+#ifdef ZMOD4XXX_USING_RULES
+struct zmod4410_rule_sub
+{
+    rt_event_t event;
+    rt_uint32_t set;
+    rt_mailbox_t mb;
+};
+static zmod4xxx_rule_set_t zmod4410_rules;
+static struct zmod4410_rule_sub zmod4410_rule_subs[ZMOD4XXX_RULE_MAX];
+
+int zmod4410_rule_add(const zmod4xxx_rule_t *rule, rt_event_t event,
+                      rt_uint32_t set, rt_mailbox_t mb)
+{
+    rt_int8_t id;
+
+    if (rule == RT_NULL || (event == RT_NULL && mb == RT_NULL))
+    {
+        return -RT_EINVAL;
+    }
+    rt_enter_critical();
+    id = zmod4xxx_rule_add(&zmod4410_rules, rule);
+    if (id >= 0)
+    {
+        zmod4410_rule_subs[id].event = event;
+        zmod4410_rule_subs[id].set = set;
+        zmod4410_rule_subs[id].mb = mb;
+    }
+    rt_exit_critical();
+    if (id < 0)
+    {
+        return -RT_ERROR;
+    }
+    return id;
+}
+
+void zmod4410_rule_remove(int id)
+{
+    rt_enter_critical();
+    zmod4xxx_rule_remove(&zmod4410_rules, (rt_int8_t)id);
+    rt_exit_critical();
+}
+
+/* evaluate the rules and tell the subscribers of the ones that changed */
+static void zmod4410_rules_eval(const iaq_2nd_gen_results_t *results, rt_uint32_t now_ms)
+{
+    float values[ZMOD4XXX_CH_MAX];
+    struct zmod4410_rule_sub subs[ZMOD4XXX_RULE_MAX];
+    rt_uint32_t changed, active;
+    rt_uint8_t id;
+
+    values[ZMOD4XXX_CH_IAQ] = results->iaq;
+    values[ZMOD4XXX_CH_TVOC] = results->tvoc;
+    values[ZMOD4XXX_CH_ETOH] = results->etoh;
+    values[ZMOD4XXX_CH_ECO2] = results->eco2;
+
+    rt_enter_critical();
+    changed = zmod4xxx_rule_eval(&zmod4410_rules, values, now_ms);
+    active = zmod4410_rules.active;
+    if (changed)
     {
-        LOG_E("Error %d during preparation of the sensor, exiting program!\n",ret);
-        goto exit;
+        rt_memcpy(subs, zmod4410_rule_subs, sizeof(subs));
     }
+    rt_exit_critical();
 
-    /* One time initialization of the algorithm */
-    ret = init_iaq_2nd_gen(&zmod4410_dev.algo_handle);
-    if (ret)
+    for (id = 0; changed; id++, changed >>= 1)
     {
-        LOG_E("Error %d when initializing algorithm, exiting program!\n", ret);
-        goto exit;
+        if (!(changed & 1))
+        {
+            continue;
+        }
+        if (subs[id].event != RT_NULL && (active & (1UL << id)))
+        {
+            rt_event_send(subs[id].event, subs[id].set);
+        }
+        if (subs[id].mb != RT_NULL)
+        {
+            rt_mb_send(subs[id].mb, ZMOD4410_RULE_MSG(id, active & (1UL << id)));
+        }
     }
-
-    return RT_EOK;
-exit:
-    return -RT_ERROR;
 }
+#endif /* ZMOD4XXX_USING_RULES */
 
-static void zmod4410_polling_get_data(rt_sensor_t sensor, struct rt_sensor_data *data)
+/* run one measurement cycle and keep its outputs in zmod4410_dev.results */
+static rt_int8_t zmod4410_sample(void)
 {
-    RT_ASSERT(sensor != RT_NULL);
-    RT_ASSERT(data != RT_NULL);
-    rt_uint8_t ret;
+    rt_int8_t ret;
     /* Sensor target variables */
     rt_uint8_t adc_result[32] = { 0 };
     iaq_2nd_gen_results_t algo_results;
     /* Counter to check POR Event */
     rt_uint32_t polling_counter = 0;
+    rt_uint32_t trace_cycle, trace_t0;
+    /* the outputs belong to this sample, not held from an earlier one */
+    rt_uint8_t fresh = 1;
 
+    trace_cycle = zmod4xxx_trace_now();
+#ifdef ZMOD4410_INT_PIN
+    rt_sem_control(&zmod4410_int_sem, RT_IPC_CMD_RESET, RT_NULL);
+#endif
     ret = zmod4xxx_start_measurement(&zmod4410_dev.dev);
+    zmod4410_dev.stamp.start_us = hal_get_time_us();
     if (ret)
     {
         LOG_E("Error %d when starting measurement, exiting program!", ret);
         goto exit;
     }
 
-    /* Instead of polling STATUS REGISTER, the INTERRUPT PIN can be used.
-        * For more information, please look at Interrupt Usage chapter
-        * in Programming Manual */
-    do
-    {
-        ret = zmod4xxx_read_status(&zmod4410_dev.dev, &zmod4410_dev.zmod4xxx_status);
-        if (ret)
-        {
-            LOG_E(
-                "Error %d during read of sensor status, exiting program!",
-                ret);
-            goto exit;
-        }
-        /* Increase polling counter */
-        polling_counter++;
-        /* Delay for 200 milliseconds */
-        zmod4410_dev.dev.delay_ms(200);
-    }
-    while ((zmod4410_dev.zmod4xxx_status & STATUS_SEQUENCER_RUNNING_MASK) &&
-            (polling_counter <= ZMOD4410_IAQ2_COUNTER_LIMIT));
+    /* the INT pin with ZMOD4410_INT_PIN, else the status register */
+    trace_t0 = zmod4xxx_trace_now();
+    ret = zmod4410_wait_done(&polling_counter);
+    zmod4xxx_trace_record(ZMOD4XXX_TRACE_POLL, zmod4410_dev.dev.i2c_addr,
+                          trace_t0, polling_counter);
 
     /* Check if timeout has occured */
-    if (ZMOD4410_IAQ2_COUNTER_LIMIT <= polling_counter)
+    if (ret == ERROR_GAS_TIMEOUT)
     {
-        ret = zmod4xxx_check_error_event(&zmod4410_dev.dev);
+        ret = zmod4xxx_recover_check(&zmod4410_dev.dev, &zmod4410_dev.recover);
         if (ret)
         {
             LOG_E("Error %d during read of sensor status, exiting program!", ret);
             goto exit;
         }
+        ret = ERROR_GAS_TIMEOUT;
         LOG_E("Error %d, exiting program!\n", ret);
         goto exit;
     }
-    else
+    else if (ret)
     {
-        polling_counter = 0;
+        LOG_E("Error %d during read of sensor status, exiting program!", ret);
+        goto exit;
     }
 
+    /* the sample belongs to the completion, not to its publication after
+     * the ADC read and the algorithm */
+    zmod4410_dev.sample_ts = rt_sensor_get_ts() -
+                             (hal_get_time_us() - zmod4410_dev.stamp.done_us) / 1000;
+    zmod4410_dev.sample_ms = hal_get_time_ms() -
+                             (hal_get_time_us() - zmod4410_dev.stamp.done_us) / 1000;
     ret = zmod4xxx_read_adc_result(&zmod4410_dev.dev, adc_result);
     if (ret)
     {
@@ -156,8 +1061,31 @@ static void zmod4410_polling_get_data(rt_sensor_t sensor, struct rt_sensor_data
         goto exit;
     }
 
-    /* calculate the algorithm */
-    ret = calc_iaq_2nd_gen(&zmod4410_dev.algo_handle, &zmod4410_dev.dev, adc_result, &algo_results);
+    /* After a POR or an access conflict the results are not valid. The
+     * sensor is reconfigured and the algorithm keeps its state. */
+    ret = zmod4xxx_recover_check(&zmod4410_dev.dev, &zmod4410_dev.recover);
+    if (ret)
+    {
+        LOG_W("Error %d, sensor reconfigured, sample dropped", ret);
+        goto exit;
+    }
+
+#ifdef ZMOD4XXX_USING_ADAPT
+    if (zmod4410_dev.low_power)
+    {
+        zmod4410_adapt_low(adc_result, &algo_results);
+        fresh = 0;
+        ret = IAQ_2ND_GEN_STABILIZATION;
+    }
+    else
+#endif
+    {
+        /* calculate the algorithm */
+        trace_t0 = zmod4xxx_trace_now();
+        ret = calc_iaq_2nd_gen(&zmod4410_dev.algo_handle, &zmod4410_dev.dev, adc_result, &algo_results);
+        zmod4xxx_trace_record(ZMOD4XXX_TRACE_ALGO, zmod4410_dev.dev.i2c_addr,
+                              trace_t0, ret);
+    }
     if ((ret != IAQ_2ND_GEN_OK) && (ret != IAQ_2ND_GEN_STABILIZATION))
     {
         LOG_E("Error %d when calculating algorithm, exiting program!\n", ret);
@@ -166,30 +1094,64 @@ static void zmod4410_polling_get_data(rt_sensor_t sensor, struct rt_sensor_data
     }
     else
     {
-        switch (sensor->info.type)
+#ifdef ZMOD4XXX_USING_HEALTH
+        if (fresh)
         {
-        case RT_SENSOR_CLASS_ETOH:
-            data->data.etoh = algo_results.etoh * 1000;
-            break;
-
-        case RT_SENSOR_CLASS_TVOC:
-            data->data.tvoc = algo_results.tvoc * 1000;
-            break;
-
-        case RT_SENSOR_CLASS_ECO2:
-            data->data.eco2 = algo_results.eco2;
-            break;
-
-        case RT_SENSOR_CLASS_IAQ:
-            data->data.iaq = algo_results.iaq * 10;
-            break;
-
-        default:
-            break;
+            zmod4410_health_update(&algo_results, ret);
+        }
+#endif
+#ifdef ZMOD4XXX_USING_ADAPT
+        if (fresh)
+        {
+            zmod4410_adapt(&algo_results, ret);
+        }
+#endif
+#ifdef ZMOD4XXX_USING_RULES
+        if (ret == IAQ_2ND_GEN_OK)
+        {
+            zmod4410_rules_eval(&algo_results, zmod4410_dev.sample_ms);
         }
-        data->timestamp = rt_sensor_get_ts();
+#endif
+#ifdef ZMOD4XXX_USING_WINDOW
+        if (ret == IAQ_2ND_GEN_OK)
+        {
+            zmod4410_window_add(&algo_results);
+        }
+#endif
+#ifdef ZMOD4XXX_USING_HISTORY
+        if (ret == IAQ_2ND_GEN_OK)
+        {
+            zmod4410_history_add(&algo_results);
+        }
+#endif
+#ifdef ZMOD4XXX_USING_BATCH
+        if (fresh)
+        {
+            zmod4410_batch_set(&algo_results, ret);
+        }
+#endif
+        trace_t0 = zmod4xxx_trace_now();
+        rt_enter_critical();
+        zmod4410_dev.results = algo_results;
+        zmod4410_dev.have_results = 1;
+        rt_exit_critical();
+        zmod4410_dev.stamp.publish_us = hal_get_time_us();
+#ifdef ZMOD4XXX_USING_JITTER
+        rt_enter_critical();
+        zmod4xxx_jitter_add(&zmod4410_jitter, &zmod4410_dev.stamp);
+        rt_exit_critical();
+#endif
 
-        if (ret == IAQ_2ND_GEN_STABILIZATION)
+#ifdef ZMOD4XXX_USING_DLOG
+        zmod4xxx_dlog(!fresh ? ZMOD4XXX_DLOG_LOW :
+                      ret == IAQ_2ND_GEN_STABILIZATION ? ZMOD4XXX_DLOG_WARMUP
+                                                       : ZMOD4XXX_DLOG_VALID, 0);
+#else
+        if (!fresh)
+        {
+            LOG_I("Low power, outputs held");
+        }
+        else if (ret == IAQ_2ND_GEN_STABILIZATION)
         {
             LOG_I("Warmup!");
         }
@@ -197,13 +1159,116 @@ static void zmod4410_polling_get_data(rt_sensor_t sensor, struct rt_sensor_data
         {
             LOG_I("Valid!");
         }
+#endif
+        zmod4xxx_trace_record(ZMOD4XXX_TRACE_PUBLISH, zmod4410_dev.dev.i2c_addr,
+                              trace_t0, 0);
+        zmod4xxx_recover_sample(&zmod4410_dev.recover);
     }
-    /* wait 1.99 seconds before starting the next measurement */
-    zmod4410_dev.dev.delay_ms(1990);
+    zmod4xxx_trace_record(ZMOD4XXX_TRACE_CYCLE, zmod4410_dev.dev.i2c_addr,
+                          trace_cycle, ZMOD4XXX_OK);
+    /* wait before starting the next measurement, 1.99 seconds in IAQ 2nd Gen */
+#ifdef ZMOD4XXX_USING_ADAPT
+    if (zmod4410_dev.low_power)
+    {
+        zmod4410_dev.dev.delay_ms(ZMOD4410_ADAPT_LOW_WAIT_MS);
+        return ZMOD4XXX_OK;
+    }
+#endif
+    if (zmod4410_dev.mode->wait_ms)
+    {
+        zmod4410_dev.dev.delay_ms(zmod4410_dev.mode->wait_ms);
+    }
+    return ZMOD4XXX_OK;
 
 exit:
-    return;
+#ifdef ZMOD4XXX_USING_JITTER
+    zmod4xxx_jitter_gap(&zmod4410_jitter);
+#endif
+    zmod4xxx_stats_error(&zmod4410_dev.dev, ret);
+    zmod4xxx_trace_record(ZMOD4XXX_TRACE_CYCLE, zmod4410_dev.dev.i2c_addr,
+                          trace_cycle, ret);
+    return ret;
+}
+
+/* copy the outputs of the last sample into the data of one sensor device */
+static void zmod4410_fill(rt_sensor_t sensor, struct rt_sensor_data *data)
+{
+    iaq_2nd_gen_results_t results;
+    rt_uint32_t ts;
+
+    rt_enter_critical();
+    results = zmod4410_dev.results;
+    ts = zmod4410_dev.sample_ts;
+    rt_exit_critical();
+
+    switch (sensor->info.type)
+    {
+    case RT_SENSOR_CLASS_ETOH:
+        data->data.etoh = ZMOD4410_SCALE_ETOH(results.etoh);
+        break;
+
+    case RT_SENSOR_CLASS_TVOC:
+        data->data.tvoc = ZMOD4410_SCALE_TVOC(results.tvoc);
+        break;
+
+    case RT_SENSOR_CLASS_ECO2:
+        data->data.eco2 = ZMOD4410_SCALE_ECO2(results.eco2);
+        break;
+
+    case RT_SENSOR_CLASS_IAQ:
+        data->data.iaq = ZMOD4410_SCALE_IAQ(results.iaq);
+        break;
+
+    default:
+        break;
+    }
+    data->timestamp = ts;
+}
+
+#ifdef ZMOD4410_ACQ_THREAD
+#ifndef ZMOD4410_ACQ_PRIORITY
+#define ZMOD4410_ACQ_PRIORITY       (RT_THREAD_PRIORITY_MAX / 2)
+#endif
+#ifndef ZMOD4410_ACQ_STACK_SIZE
+#define ZMOD4410_ACQ_STACK_SIZE     (2048)
+#endif
+#ifndef ZMOD4410_ACQ_ERROR_MS
+#define ZMOD4410_ACQ_ERROR_MS       (1000) /* pause after a failed cycle */
+#endif
+
+static void zmod4410_acq_entry(void *param)
+{
+    for (;;)
+    {
+#ifdef ZMOD4XXX_USING_CLEAN
+        if (!zmod4410_clean_gate)
+        {
+            rt_thread_mdelay(ZMOD4410_ACQ_ERROR_MS);
+            continue;
+        }
+#endif
+        if (zmod4410_sample())
+        {
+            rt_thread_mdelay(ZMOD4410_ACQ_ERROR_MS);
+        }
+    }
+}
+
+static rt_err_t zmod4410_acq_init(void)
+{
+    rt_thread_t tid;
+
+    tid = rt_thread_create("zmod_acq", zmod4410_acq_entry, RT_NULL,
+                           ZMOD4410_ACQ_STACK_SIZE, ZMOD4410_ACQ_PRIORITY, 20);
+    if (tid == RT_NULL)
+    {
+        LOG_E("no acquisition thread");
+        return -RT_ENOMEM;
+    }
+    rt_thread_startup(tid);
+    return RT_EOK;
 }
+#endif /* ZMOD4410_ACQ_THREAD */
 
 static rt_size_t zmod4410_fetch_data(struct rt_sensor_device *sensor,
                                      void *buf,
@@ -211,19 +1276,87 @@ static rt_size_t zmod4410_fetch_data(struct rt_sensor_device *sensor,
 {
     RT_ASSERT(buf);
 
-    if (sensor->config.mode == RT_SENSOR_MODE_POLLING)
+#ifdef ZMOD4XXX_USING_CLEAN
+    /* no measurement before the sensor is cleaned */
+    if (!zmod4410_clean_gate)
     {
-        zmod4410_polling_get_data(sensor, buf);
-        return 1;
+        return 0;
     }
-    else
+#endif
+    if (sensor->config.mode != RT_SENSOR_MODE_POLLING)
+    {
+        return 0;
+    }
+#ifdef ZMOD4410_ACQ_THREAD
+    /* the acquisition thread measures, a read takes its last sample */
+    if (!zmod4410_dev.have_results)
+    {
+        return 0;
+    }
+#else
+    /* buf is left alone, so a failed sample is no reading */
+    if (zmod4410_sample())
+    {
         return 0;
+    }
+#endif
+    zmod4410_fill(sensor, buf);
+    return 1;
+}
+
+static rt_err_t zmod4410_set_meas_mode(rt_uint8_t id)
+{
+    const zmod4xxx_mode_t *mode = zmod4410_mode_get(id);
+    rt_uint8_t written;
+    rt_int8_t ret;
+
+    if (mode == RT_NULL)
+    {
+        return -RT_EINVAL;
+    }
+#ifdef ZMOD4XXX_USING_CLEAN
+    if (!zmod4410_clean_gate)
+    {
+        return -RT_EBUSY;
+    }
+#endif
+    if (mode == zmod4410_dev.mode)
+    {
+        return RT_EOK;
+    }
+    ret = zmod4xxx_mode_apply(&zmod4410_dev.dev, mode, &written);
+    if (ret)
+    {
+        LOG_E("Error %d when switching to mode %s", ret, mode->name);
+        return -RT_ERROR;
+    }
+    ret = zmod4xxx_recover_init(&zmod4410_dev.dev, &zmod4410_dev.recover,
+                                hal_get_time_ms);
+    if (ret)
+    {
+        LOG_W("Error %d when caching the sensor configuration", ret);
+    }
+    zmod4410_dev.mode = mode;
+    zmod4xxx_wait_reset(&zmod4410_dev.wait);
+#ifdef ZMOD4XXX_USING_JITTER
+    zmod4410_jitter_reset();
+#endif
+    LOG_I("mode %s, tables written 0x%02X", mode->name, written);
+    return RT_EOK;
 }
 
 static rt_err_t zmod4410_control(struct rt_sensor_device *sensor, int cmd, void *args)
 {
     rt_err_t result = RT_EOK;
 
+    switch (cmd)
+    {
+    case ZMOD4410_CTRL_SET_MEAS_MODE:
+        result = zmod4410_set_meas_mode((rt_uint8_t)(rt_ubase_t)args);
+        break;
+    default:
+        break;
+    }
     return result;
 }
 
@@ -233,6 +1366,381 @@ static struct rt_sensor_ops sensor_ops =
     zmod4410_control
 };
 
+static void zmod_mode(int argc, char **argv)
+{
+    const zmod4xxx_mode_t *mode;
+    rt_uint8_t id;
+
+    if (argc < 2)
+    {
+        rt_kprintf("mode %s\n", zmod4410_dev.mode ? zmod4410_dev.mode->name : "none");
+        return;
+    }
+    for (id = 0; id < ZMOD4410_MODE_MAX; id++)
+    {
+        mode = zmod4410_mode_get(id);
+        if (mode != RT_NULL && !rt_strcmp(argv[1], mode->name))
+        {
+            zmod4410_set_meas_mode(id);
+            return;
+        }
+    }
+    rt_kprintf("unknown mode %s\n", argv[1]);
+}
+MSH_CMD_EXPORT(zmod_mode, zmod4410 measurement mode: zmod_mode [iaq2]);
+
+static void zmod_recover(int argc, char **argv)
+{
+    const zmod4xxx_recover_t *rec = &zmod4410_dev.recover;
+
+    rt_kprintf("por events   %u\n", rec->por_events);
+    rt_kprintf("conflicts    %u\n", rec->conflicts);
+    rt_kprintf("recoveries   %u\n", rec->recoveries);
+    rt_kprintf("failures     %u\n", rec->failures);
+    rt_kprintf("downtime ms  %u (last %u)%s\n", rec->downtime_ms,
+               rec->last_downtime_ms, rec->down ? ", down now" : "");
+}
+MSH_CMD_EXPORT(zmod_recover, zmod4410 POR and access conflict recovery metrics);
+
+#ifdef ZMOD4XXX_USING_ADAPT
+static void zmod_adapt(int argc, char **argv)
+{
+    const zmod4xxx_adapt_t *ad = &zmod4410_dev.adapt;
+    static const char *const names[ZMOD4XXX_ADAPT_LEVEL_MAX] = { "full", "low" };
+    rt_uint8_t i;
+
+    rt_kprintf("level %s%s\n", names[ad->level],
+               ad->stabilizing ? ", stabilizing" : "");
+    rt_kprintf("level  time s     samples    switches\n");
+    for (i = 0; i < ZMOD4XXX_ADAPT_LEVEL_MAX; i++)
+    {
+        rt_kprintf("%-6s %-10u %-10u %u\n", names[i],
+                   (rt_uint32_t)(ad->time_ms[i] / 1000), ad->samples[i],
+                   ad->switches[i]);
+    }
+    rt_kprintf("held samples %u\n", ad->held);
+}
+MSH_CMD_EXPORT(zmod_adapt, zmod4410 adaptive sampling levels and counters);
+#endif /* ZMOD4XXX_USING_ADAPT */
+
+#ifdef ZMOD4XXX_USING_RULES
+static void zmod_rules(int argc, char **argv)
+{
+    static const char *const channels[ZMOD4XXX_CH_MAX] = { "iaq", "tvoc", "etoh", "eco2" };
+    static const char *const kinds[] = { "above", "below", "rise", "fall" };
+    const zmod4xxx_rule_state_t *st;
+    rt_uint8_t id;
+
+    rt_kprintf("id ch   kind  threshold  active fired\n");
+    for (id = 0; id < ZMOD4XXX_RULE_MAX; id++)
+    {
+        st = &zmod4410_rules.rules[id];
+        if (!st->used)
+        {
+            continue;
+        }
+        rt_kprintf("%-2u %-4s %-5s %-10d %-6u %u\n", id, channels[st->rule.channel],
+                   kinds[st->rule.kind], (int)(st->rule.threshold * 1000),
+                   st->active, st->fired);
+    }
+    rt_kprintf("thresholds in 1/1000\n");
+}
+MSH_CMD_EXPORT(zmod_rules, zmod4410 threshold and rate rules);
+#endif /* ZMOD4XXX_USING_RULES */
+
+#ifdef ZMOD4XXX_USING_WINDOW
+static void zmod_window(int argc, char **argv)
+{
+    static const char *const channels[ZMOD4XXX_CH_MAX] = { "iaq", "tvoc", "etoh", "eco2" };
+    zmod4xxx_window_result_t res;
+    rt_uint8_t win = ZMOD4410_WINDOW_1MIN;
+    rt_uint8_t ch;
+
+    if (argc > 1 && !rt_strcmp(argv[1], "15"))
+    {
+        win = ZMOD4410_WINDOW_15MIN;
+    }
+    rt_kprintf("%s window, values in 1/1000\n", win == ZMOD4410_WINDOW_1MIN ? "1 min" : "15 min");
+    rt_kprintf("ch   count  min      max      mean     ewma     p50      p90      p99\n");
+    for (ch = 0; ch < ZMOD4XXX_CH_MAX; ch++)
+    {
+        zmod4410_window_get(win, ch, &res);
+        rt_kprintf("%-4s %-6u %-8d %-8d %-8d %-8d %-8d %-8d %d\n", channels[ch], res.count,
+                   (int)(res.min * 1000), (int)(res.max * 1000), (int)(res.mean * 1000),
+                   (int)(res.ewma * 1000), (int)(res.p50 * 1000), (int)(res.p90 * 1000),
+                   (int)(res.p99 * 1000));
+    }
+}
+MSH_CMD_EXPORT(zmod_window, zmod4410 windowed statistics: zmod_window [1|15]);
+#endif /* ZMOD4XXX_USING_WINDOW */
+
+#ifdef ZMOD4XXX_USING_HISTORY
+static void zmod_history(int argc, char **argv)
+{
+    static const char *const channels[] = { "iaq", "tvoc", "etoh", "eco2", "rcda" };
+    zmod4xxx_history_agg_t agg;
+    rt_uint32_t now = (rt_uint32_t)time(RT_NULL);
+    rt_uint32_t hours = 24;
+    rt_uint8_t ch;
+
+    if (argc > 1 && !rt_strcmp(argv[1], "flush"))
+    {
+        rt_kprintf("flush %s\n", zmod4410_history_flush() == RT_EOK ? "ok" : "failed");
+        return;
+    }
+    if (argc > 1)
+    {
+        hours = atoi(argv[1]);
+    }
+    if (zmod4410_history_aggregate(now - hours * 3600, now, &agg) != RT_EOK)
+    {
+        rt_kprintf("history not available\n");
+        return;
+    }
+    rt_kprintf("last %u h: %u samples, values in 1/1000\n", hours, agg.count);
+    rt_kprintf("ch   min        max        mean\n");
+    for (ch = 0; ch < ZMOD4410_HISTORY_CHANNELS && agg.count; ch++)
+    {
+        rt_kprintf("%-4s %-10d %-10d %d\n", channels[ch], (int)(agg.min[ch] * 1000),
+                   (int)(agg.max[ch] * 1000), (int)(agg.mean[ch] * 1000));
+    }
+    rt_kprintf("stored %u samples in %u pages, %u flash errors\n",
+               zmod4410_history.samples, zmod4410_history.pages_written,
+               zmod4410_history.errors);
+}
+MSH_CMD_EXPORT(zmod_history, zmod4410 history rollup: zmod_history [hours|flush]);
+#endif /* ZMOD4XXX_USING_HISTORY */
+
+#ifdef ZMOD4XXX_USING_CLEAN
+static void zmod_clean(int argc, char **argv)
+{
+    static const char *const names[] = { "none", "running", "done", "failed" };
+    zmod4xxx_clean_progress_t p;
+    rt_err_t ret;
+
+    if (argc > 1 && !rt_strcmp(argv[1], "start"))
+    {
+        ret = zmod4410_clean_start();
+        if (ret)
+        {
+            rt_kprintf("cleaning not started: %d\n", ret);
+        }
+        return;
+    }
+    if (zmod4410_clean_progress(&p))
+    {
+        rt_kprintf("cleaning disabled, no partition %s\n", ZMOD4410_CLEAN_PART);
+        return;
+    }
+    rt_kprintf("state %s%s, attempts %u, last error %d\n",
+               p.state < 4 ? names[p.state] : "?", p.busy ? " (in progress)" : "",
+               p.attempts, p.result);
+    rt_kprintf("%u%%, elapsed %u s, eta %u s, measurements %s\n", p.percent,
+               p.elapsed_ms / 1000, p.eta_ms / 1000,
+               zmod4410_clean_gate ? "enabled" : "disabled");
+}
+MSH_CMD_EXPORT(zmod_clean, zmod4410 cleaning progress: zmod_clean [start]);
+#endif /* ZMOD4XXX_USING_CLEAN */
+
+#ifdef ZMOD4XXX_USING_HEALTH
+static void zmod_health(int argc, char **argv)
+{
+    static const char *const names[] =
+    {
+        "drift", "shift", "saturated", "heater", "stuck", "invalid"
+    };
+    zmod4xxx_health_t h;
+    rt_uint8_t i;
+
+    if (argc > 1 && !rt_strcmp(argv[1], "clear"))
+    {
+        zmod4410_health_clear();
+        return;
+    }
+    if (zmod4410_health_get(&h))
+    {
+        rt_kprintf("no samples yet\n");
+        return;
+    }
+    rt_kprintf("samples %u, clamped low %u high %u, values in 1/1000\n", h.samples,
+               h.clamp_lo, h.clamp_hi);
+    rt_kprintf("saturation %d, log_rcda drift %d, short-term %d, profile span %d\n",
+               (int)(h.sat * 1000), (int)(zmod4xxx_health_drift(&h) * 1000),
+               (int)((h.rcda_fast - h.rcda_slow) * 1000), (int)(h.span_mean * 1000));
+    for (i = 0; i < sizeof(names) / sizeof(names[0]); i++)
+    {
+        if ((h.flags | h.latched) & (1 << i))
+        {
+            rt_kprintf("%-10s %s\n", names[i], h.flags & (1 << i) ? "now" : "latched");
+        }
+    }
+}
+MSH_CMD_EXPORT(zmod_health, zmod4410 sensor health: zmod_health [clear]);
+#endif /* ZMOD4XXX_USING_HEALTH */
+
+#ifdef ZMOD4XXX_USING_JITTER
+static void zmod_jitter(int argc, char **argv)
+{
+    static const char *const names[] = { "period", "latency", "error" };
+    zmod4xxx_jitter_t j;
+    zmod4xxx_jitter_stat_t st;
+    rt_uint8_t i;
+
+    if (argc > 1 && !rt_strcmp(argv[1], "reset"))
+    {
+        zmod4410_jitter_reset();
+        return;
+    }
+    if (zmod4410_jitter_get(&j))
+    {
+        rt_kprintf("no samples yet\n");
+        return;
+    }
+    rt_kprintf("%-8s %8s %8s %8s %8s %8s (us)\n", "", "count", "mean", "jitter", "min", "max");
+    for (i = 0; i < 3; i++)
+    {
+        zmod4xxx_jitter_get(i == 0 ? &j.period : i == 1 ? &j.latency : &j.error, &st);
+        rt_kprintf("%-8s %8u %8u %8u %8u %8u\n", names[i], st.count, st.mean, st.std,
+                   st.min, st.max);
+    }
+}
+MSH_CMD_EXPORT(zmod_jitter, zmod4410 sample timing: zmod_jitter [reset]);
+#endif /* ZMOD4XXX_USING_JITTER */
+
+#ifdef ZMOD4XXX_USING_BUS
+static void zmod_bus(int argc, char **argv)
+{
+    zmod4xxx_bus_stats_t st;
+    rt_uint8_t i;
+
+    if (argc > 1 && !rt_strcmp(argv[1], "reset"))
+    {
+        zmod4410_bus_reset();
+        return;
+    }
+    if (zmod4410_bus_get(&st))
+    {
+        rt_kprintf("no bus lock\n");
+        return;
+    }
+    rt_kprintf("locks %u, contended %u, timeouts %u, sections %u, sleep violations %u\n",
+               st.locks, st.contended, st.timeouts, st.sections, st.sleep_violations);
+    rt_kprintf("wait mean %u us max %u us, hold mean %u us max %u us\n",
+               st.locks ? (rt_uint32_t)(st.wait_us / st.locks) : 0, st.wait_max_us,
+               st.locks ? (rt_uint32_t)(st.hold_us / st.locks) : 0, st.hold_max_us);
+    rt_kprintf("%-12s %10s %10s\n", "us", "wait", "hold");
+    for (i = 0; i < ZMOD4XXX_BUS_BUCKETS; i++)
+    {
+        if (st.wait_hist[i] || st.hold_hist[i])
+        {
+            rt_kprintf("< %-10u %10u %10u\n", 1U << i, st.wait_hist[i], st.hold_hist[i]);
+        }
+    }
+}
+MSH_CMD_EXPORT(zmod_bus, zmod4410 bus lock statistics: zmod_bus [reset]);
+#endif /* ZMOD4XXX_USING_BUS */
+
+#ifdef ZMOD4XXX_USING_STATS
+static void zmod_stats(int argc, char **argv)
+{
+    const zmod4xxx_stats_t *st = zmod4xxx_stats_get(zmod4410_dev.dev.i2c_addr);
+    rt_uint8_t i, b;
+
+    if (st == RT_NULL)
+    {
+        rt_kprintf("zmod4410 statistics not attached\n");
+        return;
+    }
+    if (argc > 1 && !rt_strcmp(argv[1], "reset"))
+    {
+        zmod4xxx_stats_reset(st->i2c_addr);
+        return;
+    }
+
+    rt_kprintf("addr 0x%02X\n", st->i2c_addr);
+    rt_kprintf("reg  dir calls      bytes      errors  max_us  latency log2(us) buckets\n");
+    for (i = 0; i < st->reg_count; i++)
+    {
+        const zmod4xxx_reg_stats_t *rs = &st->regs[i];
+
+        rt_kprintf("0x%02X %s  %-10u %-10u %-7u %-7u", rs->reg, rs->write ? "W" : "R",
+                   rs->calls, rs->bytes, rs->errors, rs->max_us);
+        for (b = 0; b < ZMOD4XXX_STATS_BUCKETS; b++)
+        {
+            rt_kprintf(" %u", rs->hist[b]);
+        }
+        rt_kprintf("\n");
+    }
+    if (st->overflow)
+    {
+        rt_kprintf("untracked transactions: %u\n", st->overflow);
+    }
+    rt_kprintf("errors:");
+    for (i = 1; i < ZMOD4XXX_STATS_ERR_MAX; i++)
+    {
+        /* the driver codes always, those of the modules when they occurred */
+        if (i <= -ERROR_NULL_PTR || st->err[i])
+        {
+            rt_kprintf(" %d:%u", -i, st->err[i]);
+        }
+    }
+    rt_kprintf("\n");
+}
+MSH_CMD_EXPORT(zmod_stats, zmod4410 I2C statistics: zmod_stats [reset]);
+#endif /* ZMOD4XXX_USING_STATS */
+
+#ifdef ZMOD4XXX_USING_RETRY
+static void zmod_retry(int argc, char **argv)
+{
+    static const char *const names[ZMOD4XXX_RETRY_OP_MAX] =
+    {
+        "status", "read", "event", "cmd", "write",
+    };
+    const zmod4xxx_retry_stats_t *st = zmod4xxx_retry_get(zmod4410_dev.dev.i2c_addr);
+    rt_uint8_t i;
+
+    if (st == RT_NULL)
+    {
+        rt_kprintf("zmod4410 retry policy not attached\n");
+        return;
+    }
+    if (argc > 1 && !rt_strcmp(argv[1], "reset"))
+    {
+        zmod4xxx_retry_reset(st->i2c_addr);
+        return;
+    }
+
+    rt_kprintf("op     calls      retries    recovered  failed     unsafe     confirmed  lock\n");
+    for (i = 0; i < ZMOD4XXX_RETRY_OP_MAX; i++)
+    {
+        const zmod4xxx_retry_op_stats_t *op = &st->ops[i];
+
+        rt_kprintf("%-6s %-10u %-10u %-10u %-10u %-10u %-10u %u\n", names[i], op->calls,
+                   op->retries, op->recovered, op->failed, op->unsafe, op->confirmed,
+                   op->lock_timeouts);
+    }
+}
+MSH_CMD_EXPORT(zmod_retry, zmod4410 I2C retry counters: zmod_retry [reset]);
+#endif /* ZMOD4XXX_USING_RETRY */
+
+#ifdef ZMOD4XXX_USING_TRACE
+static void zmod_trace_out(void *ctx, const char *str)
+{
+    rt_kprintf("%s", str);
+}
+
+static void zmod_trace(int argc, char **argv)
+{
+    if (argc > 1 && !rt_strcmp(argv[1], "clear"))
+    {
+        zmod4xxx_trace_clear();
+        return;
+    }
+    zmod4xxx_trace_dump_json(zmod_trace_out, RT_NULL);
+}
+MSH_CMD_EXPORT(zmod_trace, zmod4410 trace as Chrome trace JSON: zmod_trace [clear]);
+#endif /* ZMOD4XXX_USING_TRACE */
+
 int rt_hw_zmod4410_init(const char *name, struct rt_sensor_config *cfg)
 {
     rt_int8_t result;
@@ -347,6 +1855,10 @@ int rt_hw_zmod4410_init(const char *name, struct rt_sensor_config *cfg)
 
     if (RT_EOK != _zmod4410_init(&cfg->intf))
         goto __exit;
+#ifdef ZMOD4410_ACQ_THREAD
+    if (RT_EOK != zmod4410_acq_init())
+        goto __exit;
+#endif
 
     return RT_EOK;
 
@@ -6,6 +6,16 @@
  * Change Logs:
  * Date           Author       Notes
  * 2020-11-16     Sherman      the first version
+ * 2026-10-19     Sherman      add ZMOD4410_CTRL_SET_MEAS_MODE
+ * 2026-10-19     Sherman      add threshold and rate rules
+ * 2026-10-19     Sherman      add windowed statistics
+ * 2026-10-19     Sherman      add compressed history
+ * 2026-10-19     Sherman      add batch samples for the uplink
+ * 2026-10-19     Sherman      add background cleaning
+ * 2026-10-19     Sherman      add sensor health tracking
+ * 2026-10-19     Sherman      add sample timing statistics
+ * 2026-10-19     Sherman      add bus lock statistics
+ * 2026-10-19     Sherman      add the acquisition thread
  */
 
 #ifndef SENSOR_RENESAS_ZMOD4410_H__
@@ -13,6 +23,207 @@
 
 #include "sensor.h"
 
+/* switch the measurement mode, args is a zmod4410_mode_id cast to a pointer */
+#define ZMOD4410_CTRL_SET_MEAS_MODE (RT_SENSOR_CTRL_USER_CMD_START + 1)
+
 int rt_hw_zmod4410_init(const char *name, struct rt_sensor_config *cfg);
 
+/*
+ * A read of a sensor device runs a whole measurement cycle, about 3 s, and
+ * the rules, windows, history and health see only the samples read. With
+ * ZMOD4XXX_USING_RULES, or ZMOD4410_ACQ_THREAD defined, the port measures
+ * in a thread of its own instead: every sample is taken and evaluated
+ * whether anyone reads or not, and a read returns the outputs of the last
+ * sample, or nothing before the first one. Define ZMOD4410_ACQ_NO_THREAD to
+ * keep measuring in the read; the rules then need a reader polling the
+ * sensor at the sample rate of the mode.
+ */
+
+#ifdef ZMOD4XXX_USING_RULES
+#include "zmod4xxx_rule.h"
+
+/* mailbox message of a rule change: id in bits 0-7, bit 8 set if it fired */
+#define ZMOD4410_RULE_MSG(id, active)   ((rt_ubase_t)(id) | ((active) ? 0x100 : 0))
+#define ZMOD4410_RULE_MSG_ID(msg)       ((int)((msg) & 0xFF))
+#define ZMOD4410_RULE_MSG_ACTIVE(msg)   ((int)(((msg) >> 8) & 1))
+
+/**
+ * @brief   Register a rule evaluated on every valid sample
+ * @param   [in] rule rule, copied
+ * @param   [in] event event to send set to when the rule fires, may be RT_NULL
+ * @param   [in] set event flags to send
+ * @param   [in] mb mailbox to get ZMOD4410_RULE_MSG() on every change, may be RT_NULL
+ * @return  id of the rule, -RT_EINVAL without a subscriber, or -RT_ERROR if
+ *          the rule is invalid or ZMOD4XXX_RULE_MAX rules are registered
+ */
+int zmod4410_rule_add(const zmod4xxx_rule_t *rule, rt_event_t event,
+                      rt_uint32_t set, rt_mailbox_t mb);
+
+/**
+ * @brief   Unregister a rule
+ * @param   [in] id id returned by zmod4410_rule_add()
+ */
+void zmod4410_rule_remove(int id);
+#endif /* ZMOD4XXX_USING_RULES */
+
+#ifdef ZMOD4XXX_USING_WINDOW
+#include "zmod4xxx_rule.h" /* zmod4xxx_channel */
+#include "zmod4xxx_window.h"
+
+#define ZMOD4410_WINDOW_1MIN    (0) /**< last minute, 12 buckets of 5 s */
+#define ZMOD4410_WINDOW_15MIN   (1) /**< last 15 minutes, 15 buckets of 1 min */
+#define ZMOD4410_WINDOW_MAX     (2)
+
+/**
+ * @brief   Get the aggregates of one output over one window
+ * @param   [in] window ZMOD4410_WINDOW_*
+ * @param   [in] channel zmod4xxx_channel
+ * @param   [out] res aggregates of the valid samples in the window
+ * @return  RT_EOK or -RT_EINVAL
+ */
+rt_err_t zmod4410_window_get(rt_uint8_t window, rt_uint8_t channel,
+                             zmod4xxx_window_result_t *res);
+#endif /* ZMOD4XXX_USING_WINDOW */
+
+#ifdef ZMOD4XXX_USING_HISTORY
+#include "zmod4xxx_history.h"
+
+/*
+ * The history is kept in the FAL partition ZMOD4410_HISTORY_PART, one valid
+ * sample per ZMOD4410_HISTORY_PERIOD_S, time stamped with time(). Channels
+ * are IAQ, TVOC, EtOH and eCO2, and log_rcda with ZMOD4410_HISTORY_LOG_RCDA.
+ */
+
+/**
+ * @brief   Walk the stored samples of a time range, oldest first
+ * @param   [in] t0 first time of the range, seconds since the epoch
+ * @param   [in] t1 last time of the range
+ * @param   [in] cb called for each sample, with the history locked
+ * @param   [in] ctx passed to cb
+ * @return  RT_EOK, -RT_ENOSYS without a partition or -RT_ERROR
+ */
+rt_err_t zmod4410_history_query(rt_uint32_t t0, rt_uint32_t t1,
+                                zmod4xxx_history_cb_t cb, void *ctx);
+
+/**
+ * @brief   Aggregate the stored samples of a time range
+ * @param   [in] t0 first time of the range, seconds since the epoch
+ * @param   [in] t1 last time of the range
+ * @param   [out] agg aggregates
+ * @return  RT_EOK, -RT_ENOSYS without a partition or -RT_ERROR
+ */
+rt_err_t zmod4410_history_aggregate(rt_uint32_t t0, rt_uint32_t t1,
+                                    zmod4xxx_history_agg_t *agg);
+
+/**
+ * @brief   Write the samples not yet in flash, e.g. before power down
+ * @return  RT_EOK, -RT_ENOSYS without a partition or -RT_ERROR
+ */
+rt_err_t zmod4410_history_flush(void);
+#endif /* ZMOD4XXX_USING_HISTORY */
+
+#ifdef ZMOD4XXX_USING_BATCH
+#include "zmod4xxx_batch.h"
+
+/**
+ * @brief   Get the latest sample, ready for zmod4xxx_batch_add()
+ * @param   [out] s sample; seq counts every algorithm result, so a gap shows
+ *          results the caller missed and an unchanged seq a repeated read
+ * @return  RT_EOK or -RT_EEMPTY before the first result
+ */
+rt_err_t zmod4410_batch_last(zmod4xxx_batch_sample_t *s);
+#endif /* ZMOD4XXX_USING_BATCH */
+
+#ifdef ZMOD4XXX_USING_CLEAN
+#include "zmod4xxx_clean.h"
+
+/*
+ * Until the sensor is cleaned the sensor devices read no data and the
+ * measurement mode cannot be switched.
+ */
+
+/**
+ * @brief   Start the cleaning in a low priority thread, e.g. with
+ *          ZMOD4410_CLEAN_MANUAL defined
+ * @return  RT_EOK, -RT_ENOSYS without a partition, -RT_EBUSY if cleaned
+ *          or running, or -RT_ENOMEM
+ */
+rt_err_t zmod4410_clean_start(void);
+
+/**
+ * @brief   Get the progress of the cleaning
+ * @param   [out] p progress and ETA
+ * @return  RT_EOK or -RT_ENOSYS without a partition
+ */
+rt_err_t zmod4410_clean_progress(zmod4xxx_clean_progress_t *p);
+#endif /* ZMOD4XXX_USING_CLEAN */
+
+#ifdef ZMOD4XXX_USING_HEALTH
+#include "zmod4xxx_health.h"
+
+/*
+ * Every algorithm result updates the health tracker; with
+ * ZMOD4XXX_USING_BATCH a sample carries ZMOD4XXX_BATCH_F_HEALTH while any
+ * flag is raised.
+ */
+
+/**
+ * @brief   Get a copy of the health tracker
+ * @param   [out] h tracker, flags and latched hold ZMOD4XXX_HEALTH_F_*
+ * @return  RT_EOK or -RT_EEMPTY before the first result
+ */
+rt_err_t zmod4410_health_get(zmod4xxx_health_t *h);
+
+/**
+ * @brief   Reset the latched health flags, e.g. after they were reported
+ */
+void zmod4410_health_clear(void);
+#endif /* ZMOD4XXX_USING_HEALTH */
+
+#ifdef ZMOD4XXX_USING_JITTER
+#include "zmod4xxx_jitter.h"
+
+/*
+ * A sample is time stamped when the sequencer is found done: on the INT pin
+ * with ZMOD4410_INT_PIN, else by polling the status every
+ * ZMOD4410_POLL_FINE_MS around the learned end of the run. The timestamp
+ * of the sensor data and of the batch sample is that time.
+ */
+
+/**
+ * @brief   Get a copy of the timing statistics
+ * @param   [out] j statistics, to read with zmod4xxx_jitter_get()
+ * @return  RT_EOK or -RT_EEMPTY before the first result
+ */
+rt_err_t zmod4410_jitter_get(zmod4xxx_jitter_t *j);
+
+/**
+ * @brief   Restart the timing statistics, also done on a mode switch
+ */
+void zmod4410_jitter_reset(void);
+#endif /* ZMOD4XXX_USING_JITTER */
+
+#ifdef ZMOD4XXX_USING_BUS
+#include "zmod4xxx_bus.h"
+
+/*
+ * Every transaction of the sensor takes the mutex of its I2C bus, the one
+ * other drivers on the bus take in rt_i2c_transfer(), and the tables of a
+ * run are written in one section. The lock is never held while the driver
+ * waits for the sensor.
+ */
+
+/**
+ * @brief   Get the lock statistics of the sensor's bus
+ * @param   [out] st statistics
+ * @return  RT_EOK or -RT_ENOSYS without a bus lock
+ */
+rt_err_t zmod4410_bus_get(zmod4xxx_bus_stats_t *st);
+
+/**
+ * @brief   Clear the lock statistics
+ */
+void zmod4410_bus_reset(void);
+#endif /* ZMOD4XXX_USING_BUS */
+
 #endif
@@ -0,0 +1,27 @@
+/*
+ * Copyright (c) 2006-2021, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-19     Sherman      first version
+ */
+
+#ifndef ZMOD4410_SCALE_H__
+#define ZMOD4410_SCALE_H__
+
+/*
+ * Fixed-point scaling of the algorithm outputs into the integer fields of
+ * struct rt_sensor_data:
+ *   EtOH  ppm     -> ppb
+ *   TVOC  mg/m^3  -> ug/m^3
+ *   eCO2  ppm     -> ppm
+ *   IAQ   index   -> 0.1 index
+ */
+#define ZMOD4410_SCALE_ETOH(x)  ((x) * 1000)
+#define ZMOD4410_SCALE_TVOC(x)  ((x) * 1000)
+#define ZMOD4410_SCALE_ECO2(x)  (x)
+#define ZMOD4410_SCALE_IAQ(x)   ((x) * 10)
+
+#endif
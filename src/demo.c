@@ -18,6 +18,7 @@
 #include "zmod4410_config_iaq2.h"
 #include "zmod4xxx.h"
 #include "zmod4xxx_cleaning.h"
+#include "zmod4xxx_dlog.h"
 #include "zmod4xxx_hal.h"
 #include "iaq_2nd_gen.h"
 
@@ -147,6 +148,24 @@ static int demo()
             goto exit;
             /* IAQ 2nd Gen algorithm skips first 60 samples for stabilization */
         } else {
+#ifdef ZMOD4XXX_USING_DLOG
+            /* four records instead of 20 formatted lines, printed by
+             * zmod_log_entry() */
+            uint32_t w[13];
+            for (int i = 0; i < 13; i++) {
+                w[i] = ZMOD4XXX_DLOG_F(algo_results.rmox[i] / 1e3);
+            }
+            zmod4xxx_dlog_args(ZMOD4XXX_DLOG_RMOX_LO, w, 7);
+            zmod4xxx_dlog_args(ZMOD4XXX_DLOG_RMOX_HI, w + 7, 6);
+            zmod4xxx_dlog(ZMOD4XXX_DLOG_RESULT, 5,
+                          ZMOD4XXX_DLOG_F(algo_results.etoh),
+                          ZMOD4XXX_DLOG_F(algo_results.tvoc),
+                          ZMOD4XXX_DLOG_F(algo_results.eco2),
+                          ZMOD4XXX_DLOG_F(algo_results.iaq),
+                          ZMOD4XXX_DLOG_F(algo_results.log_rcda));
+            zmod4xxx_dlog(ret == IAQ_2ND_GEN_STABILIZATION ?
+                          ZMOD4XXX_DLOG_WARMUP : ZMOD4XXX_DLOG_VALID, 0);
+#else
             printf("*********** Measurements ***********\n");
             for (int i = 0; i < 13; i++) {
                 printf(" Rmox[%d] = ", i);
@@ -163,6 +182,7 @@ static int demo()
                 printf("Valid!\n");
             }
             printf("************************************\n");
+#endif
         }
 
         /* wait 1.99 seconds before starting the next measurement */
@@ -189,6 +209,34 @@ exit:
 }
 
 #include <rtthread.h>
+
+#ifdef ZMOD4XXX_USING_DLOG
+static volatile int zmod_demo_done;
+
+/* the only dlog reader; formats and prints at a lower priority than demo() */
+static void zmod_log_entry(void *param)
+{
+    zmod4xxx_dlog_rec_t rec;
+    char line[128];
+    int done;
+
+    for (;;)
+    {
+        done = zmod_demo_done;
+        while (zmod4xxx_dlog_read(&rec))
+        {
+            zmod4xxx_dlog_format(&rec, line, sizeof(line));
+            printf("%s\n", line);
+        }
+        if (done)
+        {
+            break;
+        }
+        rt_thread_mdelay(500);
+    }
+}
+#endif
+
 void zmod_entry(void *param)
 {
     int ret = demo();
@@ -196,11 +244,26 @@ void zmod_entry(void *param)
     {
         printf("\r\nzmod demo return %d \r\n",ret);
     }
+#ifdef ZMOD4XXX_USING_DLOG
+    zmod_demo_done = 1;
+#endif
 }
 
 void zmod_demo()
 {
-    rt_thread_t tid = rt_thread_create("zmod",zmod_entry, RT_NULL, 2048, 10, 50);
+    rt_thread_t tid;
+
+#ifdef ZMOD4XXX_USING_DLOG
+    /* stamp records in milliseconds, before the reader and demo() start */
+    zmod_demo_done = 0;
+    zmod4xxx_dlog_init(hal_get_time_ms);
+    tid = rt_thread_create("zmodlog", zmod_log_entry, RT_NULL, 2048, 20, 50);
+    if(tid)
+    {
+        rt_thread_startup(tid);
+    }
+#endif
+    tid = rt_thread_create("zmod",zmod_entry, RT_NULL, 2048, 10, 50);
     if(tid)
     {
         rt_thread_startup(tid);
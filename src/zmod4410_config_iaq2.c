@@ -0,0 +1,66 @@
+/*******************************************************************************
+ * Copyright (c) 2021 Renesas Electronics Corporation
+ * All Rights Reserved.
+ *
+ * This code is proprietary to Renesas, and is license pursuant to the terms and
+ * conditions that may be accessed at:
+ * https://www.renesas.com/eu/en/document/msc/renesas-software-license-terms-gas-sensor-software
+ *
+ ******************************************************************************/
+
+/**
+ * @file zmod4410_config_iaq2.c
+ * @brief Configuration tables of the zmod4410 module and its measurement modes
+ * @version 2.2.0
+ * @author Renesas Electronics Corporation
+ */
+
+#include "zmod4410_config_iaq2.h"
+
+const uint8_t data_set_4410i[] = { ZMOD4410_INIT_DATA_SET };
+
+const uint8_t data_set_4410_iaq_2nd_gen[] = { ZMOD4410_IAQ2_DATA_SET };
+
+const zmod4xxx_conf zmod_sensor_type[] = {
+    [INIT] = {
+        .start = 0x80,
+        .h = { .addr = ZMOD4410_H_ADDR, .len = 2, .data_buf = &data_set_4410i[0]},
+        .d = { .addr = ZMOD4410_D_ADDR, .len = 2, .data_buf = &data_set_4410i[2]},
+        .m = { .addr = ZMOD4410_M_ADDR, .len = 2, .data_buf = &data_set_4410i[4]},
+        .s = { .addr = ZMOD4410_S_ADDR, .len = 4, .data_buf = &data_set_4410i[6]},
+        .r = { .addr = 0x97, .len = 4},
+    },
+
+    [MEASUREMENT] = {
+        .start = 0x80,
+        .h = {.addr = ZMOD4410_H_ADDR, .len = 16, .data_buf = &data_set_4410_iaq_2nd_gen[0]},
+        .d = {.addr = ZMOD4410_D_ADDR, .len = 8, .data_buf = &data_set_4410_iaq_2nd_gen[16]},
+        .m = {.addr = ZMOD4410_M_ADDR, .len = 4, .data_buf = &data_set_4410_iaq_2nd_gen[24]},
+        .s = {.addr = ZMOD4410_S_ADDR, .len = 32, .data_buf = &data_set_4410_iaq_2nd_gen[28]},
+        .r = {.addr = 0x97, .len = 32},
+        .prod_data_len = ZMOD4410_PROD_DATA_LEN,
+    },
+};
+
+/*
+ * Only modes with measurement tables from Renesas are listed. Slots left
+ * empty in between are looked up as unknown.
+ */
+static const zmod4xxx_mode_t zmod4410_modes[ZMOD4410_MODE_MAX] = {
+    [ZMOD4410_MODE_IAQ_2ND_GEN] = {
+        .id = ZMOD4410_MODE_IAQ_2ND_GEN,
+        .name = "iaq2",
+        .init_conf = &zmod_sensor_type[INIT],
+        .meas_conf = &zmod_sensor_type[MEASUREMENT],
+        .wait_ms = ZMOD4410_IAQ2_WAIT_MS,
+    },
+};
+
+const zmod4xxx_mode_t *zmod4410_mode_get(uint8_t id)
+{
+    if (id >= ZMOD4410_MODE_MAX || zmod4410_modes[id].meas_conf == NULL)
+    {
+        return NULL;
+    }
+    return &zmod4410_modes[id];
+}
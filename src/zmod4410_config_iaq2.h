@@ -20,6 +20,7 @@
 
 #include <stdio.h>
 #include <zmod4xxx_types.h>
+#include "zmod4xxx_mode.h"
 
 #define INIT        0
 #define MEASUREMENT 1
@@ -34,51 +35,62 @@
 
 #define ZMOD4410_PROD_DATA_LEN 7
 
+/* < Sequencer data sets, shared by the C tables and zmod4xxx.hpp > */
+#define ZMOD4410_INIT_DATA_SET \
+    0x00, 0x50, \
+    0x00, 0x28, 0xC3, 0xE3, \
+    0x00, 0x00, 0x80, 0x40
+
+#define ZMOD4410_IAQ2_DATA_SET \
+    0x00, 0x50, 0xFF, 0x38, \
+    0xFE, 0xD4, 0xFE, 0x70, \
+    0xFE, 0x0C, 0xFD, 0xA8, \
+    0xFD, 0x44, 0xFC, 0xE0, \
+    0x00, 0x52, 0x02, 0x67, \
+    0x00, 0xCD, 0x03, 0x34, \
+    0x23, 0x03, 0xA3, 0x43, \
+    0x00, 0x00, 0x06, 0x49, \
+    0x06, 0x4A, 0x06, 0x4B, \
+    0x06, 0x4C, 0x06, 0x4D, \
+    0x06, 0x4E, 0x06, 0x97, \
+    0x06, 0xD7, 0x06, 0x57, \
+    0x06, 0x4E, 0x06, 0x4D, \
+    0x06, 0x4C, 0x06, 0x4B, \
+    0x06, 0x4A, 0x86, 0x59
+
 /* < Define limit of counter > */
 #define ZMOD4410_IAQ2_COUNTER_LIMIT 10U
 
-uint8_t data_set_4410i[] = {
-                                0x00, 0x50,
-                                0x00, 0x28, 0xC3, 0xE3,
-                                0x00, 0x00, 0x80, 0x40};
-
-uint8_t data_set_4410_iaq_2nd_gen[] = {
-                                       0x00, 0x50, 0xFF, 0x38,
-                                       0xFE, 0xD4, 0xFE, 0x70,
-                                       0xFE, 0x0C, 0xFD, 0xA8,
-                                       0xFD, 0x44, 0xFC, 0xE0,
-                                       0x00, 0x52, 0x02, 0x67,
-                                       0x00, 0xCD, 0x03, 0x34,
-                                       0x23, 0x03, 0xA3, 0x43,
-                                       0x00, 0x00, 0x06, 0x49,
-                                       0x06, 0x4A, 0x06, 0x4B,
-                                       0x06, 0x4C, 0x06, 0x4D,
-                                       0x06, 0x4E, 0x06, 0x97,
-                                       0x06, 0xD7, 0x06, 0x57,
-                                       0x06, 0x4E, 0x06, 0x4D,
-                                       0x06, 0x4C, 0x06, 0x4B,
-                                       0x06, 0x4A, 0x86, 0x59};
-
-
-zmod4xxx_conf zmod_sensor_type[] = {
-    [INIT] = {
-        .start = 0x80,
-        .h = { .addr = ZMOD4410_H_ADDR, .len = 2, .data_buf = &data_set_4410i[0]},
-        .d = { .addr = ZMOD4410_D_ADDR, .len = 2, .data_buf = &data_set_4410i[2]},
-        .m = { .addr = ZMOD4410_M_ADDR, .len = 2, .data_buf = &data_set_4410i[4]},
-        .s = { .addr = ZMOD4410_S_ADDR, .len = 4, .data_buf = &data_set_4410i[6]},
-        .r = { .addr = 0x97, .len = 4},
-    },
-
-    [MEASUREMENT] = {
-        .start = 0x80,
-        .h = {.addr = ZMOD4410_H_ADDR, .len = 16, .data_buf = &data_set_4410_iaq_2nd_gen[0]},
-        .d = {.addr = ZMOD4410_D_ADDR, .len = 8, .data_buf = &data_set_4410_iaq_2nd_gen[16]},
-        .m = {.addr = ZMOD4410_M_ADDR, .len = 4, .data_buf = &data_set_4410_iaq_2nd_gen[24]},
-        .s = {.addr = ZMOD4410_S_ADDR, .len = 32, .data_buf = &data_set_4410_iaq_2nd_gen[28]},
-        .r = {.addr = 0x97, .len = 32},
-        .prod_data_len = ZMOD4410_PROD_DATA_LEN,
-    },
-};
+/* < Host wait after the results in IAQ 2nd Gen mode > */
+#define ZMOD4410_IAQ2_WAIT_MS 1990U
+
+/**
+ * @brief Measurement modes of the ZMOD4410, the index in the registry
+ *
+ * A mode is added together with the tables Renesas publishes for it.
+ */
+typedef enum {
+    ZMOD4410_MODE_IAQ_2ND_GEN = 0,
+    ZMOD4410_MODE_MAX
+} zmod4410_mode_id;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+extern const uint8_t data_set_4410i[];
+extern const uint8_t data_set_4410_iaq_2nd_gen[];
+extern const zmod4xxx_conf zmod_sensor_type[MEASUREMENT + 1];
+
+/**
+ * @brief   Look up a measurement mode
+ * @param   [in] id zmod4410_mode_id
+ * @return  mode or NULL for an unknown id
+ */
+const zmod4xxx_mode_t *zmod4410_mode_get(uint8_t id);
+
+#ifdef __cplusplus
+}
+#endif
 
 #endif //_ZMOD4410_CONFIG_IAQ_2ND_GEN_H
@@ -16,17 +16,22 @@
  */
 
 #include "zmod4xxx.h"
+#include "zmod4xxx_bus.h"
+#include "zmod4xxx_trace.h"
 
 zmod4xxx_err zmod4xxx_read_status(zmod4xxx_dev_t *dev, uint8_t *status)
 {
     int8_t ret;
     uint8_t st;
+    ZMOD4XXX_TRACE_BEGIN();
 
     ret = dev->read(dev->i2c_addr, ZMOD4XXX_ADDR_STATUS, &st, 1);
     if (0 != ret) {
+        ZMOD4XXX_TRACE_END(ZMOD4XXX_TRACE_STATUS, dev->i2c_addr, ERROR_I2C);
         return ERROR_I2C;
     }
     *status = st;
+    ZMOD4XXX_TRACE_END(ZMOD4XXX_TRACE_STATUS, dev->i2c_addr, st);
     return ZMOD4XXX_OK;
 }
 
@@ -133,7 +138,7 @@ zmod4xxx_err zmod4xxx_read_tracking_number(zmod4xxx_dev_t *dev,
     return ZMOD4XXX_OK;
 }
 
-zmod4xxx_err zmod4xxx_calc_factor(zmod4xxx_conf *conf, uint8_t *hsp,
+zmod4xxx_err zmod4xxx_calc_factor(const zmod4xxx_conf *conf, uint8_t *hsp,
                                   uint8_t *config)
 {
     int16_t hsp_temp[HSP_MAX];
@@ -154,58 +159,64 @@ zmod4xxx_err zmod4xxx_calc_factor(zmod4xxx_conf *conf, uint8_t *hsp,
     return ZMOD4XXX_OK;
 }
 
-zmod4xxx_err zmod4xxx_init_sensor(zmod4xxx_dev_t *dev)
+/* every table write of the package goes through here, one bus section */
+zmod4xxx_err zmod4xxx_write_conf(zmod4xxx_dev_t *dev, const zmod4xxx_conf *conf,
+                                 uint8_t tables, uint8_t *hsp,
+                                 const uint8_t *start)
+{
+    zmod4xxx_err ret;
+
+    ret = ZMOD4XXX_BUS_BEGIN(dev);
+    if (ret) {
+        return ret;
+    }
+    if (((tables & ZMOD4XXX_CONF_H) &&
+         dev->write(dev->i2c_addr, conf->h.addr, hsp, conf->h.len)) ||
+        ((tables & ZMOD4XXX_CONF_D) &&
+         dev->write(dev->i2c_addr, conf->d.addr, (uint8_t *)conf->d.data_buf,
+                    conf->d.len)) ||
+        ((tables & ZMOD4XXX_CONF_M) &&
+         dev->write(dev->i2c_addr, conf->m.addr, (uint8_t *)conf->m.data_buf,
+                    conf->m.len)) ||
+        ((tables & ZMOD4XXX_CONF_S) &&
+         dev->write(dev->i2c_addr, conf->s.addr, (uint8_t *)conf->s.data_buf,
+                    conf->s.len)) ||
+        (start != NULL &&
+         dev->write(dev->i2c_addr, ZMOD4XXX_ADDR_CMD, (uint8_t *)start, 1))) {
+        ret = ERROR_I2C;
+    }
+    ZMOD4XXX_BUS_END(dev);
+    return ret;
+}
+
+zmod4xxx_err zmod4xxx_run_init(zmod4xxx_dev_t *dev, uint8_t *hsp,
+                               uint16_t polls_max)
 {
     int8_t i2c_ret;
     zmod4xxx_err api_ret;
-    uint8_t hsp[HSP_MAX * 2];
     uint8_t data_r[RSLT_MAX];
     uint8_t zmod4xxx_status;
+    uint16_t i = 0;
 
-    i2c_ret = dev->read(dev->i2c_addr, 0xB7, data_r, 1);
-    if (i2c_ret) {
-        return ERROR_I2C;
-    }
-
-    api_ret = zmod4xxx_calc_factor(dev->init_conf, hsp, dev->config);
+    api_ret = zmod4xxx_write_conf(dev, dev->init_conf, ZMOD4XXX_CONF_ALL, hsp,
+                                  &dev->init_conf->start);
     if (api_ret) {
         return api_ret;
     }
-
-    i2c_ret = dev->write(dev->i2c_addr, dev->init_conf->h.addr, hsp,
-                         dev->init_conf->h.len);
-    if (i2c_ret) {
-        return ERROR_I2C;
-    }
-    i2c_ret = dev->write(dev->i2c_addr, dev->init_conf->d.addr,
-                         dev->init_conf->d.data_buf, dev->init_conf->d.len);
-    if (i2c_ret) {
-        return ERROR_I2C;
-    }
-    i2c_ret = dev->write(dev->i2c_addr, dev->init_conf->m.addr,
-                         dev->init_conf->m.data_buf, dev->init_conf->m.len);
-    if (i2c_ret) {
-        return ERROR_I2C;
-    }
-    i2c_ret = dev->write(dev->i2c_addr, dev->init_conf->s.addr,
-                         dev->init_conf->s.data_buf, dev->init_conf->s.len);
-    if (i2c_ret) {
-        return ERROR_I2C;
-    }
-
-    i2c_ret =
-        dev->write(dev->i2c_addr, ZMOD4XXX_ADDR_CMD, &dev->init_conf->start, 1);
-    if (i2c_ret) {
-        return ERROR_I2C;
-    }
     /* This section can be change with interrupt for microcontrollers */
     do {
         api_ret = zmod4xxx_read_status(dev, &zmod4xxx_status);
         if (api_ret) {
             return api_ret;
         }
+        i++;
         dev->delay_ms(50);
-    } while (zmod4xxx_status & STATUS_SEQUENCER_RUNNING_MASK);
+    } while ((zmod4xxx_status & STATUS_SEQUENCER_RUNNING_MASK) &&
+             (i < polls_max));
+
+    if (zmod4xxx_status & STATUS_SEQUENCER_RUNNING_MASK) {
+        return ERROR_GAS_TIMEOUT;
+    }
 
     i2c_ret = dev->read(dev->i2c_addr, dev->init_conf->r.addr, data_r,
                         dev->init_conf->r.len);
@@ -218,62 +229,67 @@ zmod4xxx_err zmod4xxx_init_sensor(zmod4xxx_dev_t *dev)
     return ZMOD4XXX_OK;
 }
 
-zmod4xxx_err zmod4xxx_init_measurement(zmod4xxx_dev_t *dev)
+zmod4xxx_err zmod4xxx_init_sensor(zmod4xxx_dev_t *dev)
 {
     int8_t i2c_ret;
     zmod4xxx_err api_ret;
     uint8_t hsp[HSP_MAX * 2];
+    uint8_t data_r[1];
 
-    api_ret = zmod4xxx_calc_factor(dev->meas_conf, hsp, dev->config);
-    if (api_ret) {
-        return api_ret;
-    }
-
-    i2c_ret = dev->write(dev->i2c_addr, dev->meas_conf->h.addr, hsp,
-                         dev->meas_conf->h.len);
-    if (i2c_ret) {
-        return ERROR_I2C;
-    }
-    i2c_ret = dev->write(dev->i2c_addr, dev->meas_conf->d.addr,
-                         dev->meas_conf->d.data_buf, dev->meas_conf->d.len);
+    i2c_ret = dev->read(dev->i2c_addr, 0xB7, data_r, 1);
     if (i2c_ret) {
         return ERROR_I2C;
     }
-    i2c_ret = dev->write(dev->i2c_addr, dev->meas_conf->m.addr,
-                         dev->meas_conf->m.data_buf, dev->meas_conf->m.len);
-    if (i2c_ret) {
-        return ERROR_I2C;
+
+    api_ret = zmod4xxx_calc_factor(dev->init_conf, hsp, dev->config);
+    if (api_ret) {
+        return api_ret;
     }
-    i2c_ret = dev->write(dev->i2c_addr, dev->meas_conf->s.addr,
-                         dev->meas_conf->s.data_buf, dev->meas_conf->s.len);
-    if (i2c_ret) {
-        return ERROR_I2C;
+    return zmod4xxx_run_init(dev, hsp, ZMOD4XXX_INIT_POLL_MAX);
+}
+
+zmod4xxx_err zmod4xxx_init_measurement(zmod4xxx_dev_t *dev)
+{
+    zmod4xxx_err api_ret;
+    uint8_t hsp[HSP_MAX * 2];
+
+    api_ret = zmod4xxx_calc_factor(dev->meas_conf, hsp, dev->config);
+    if (api_ret) {
+        return api_ret;
     }
-    return ZMOD4XXX_OK;
+
+    return zmod4xxx_write_conf(dev, dev->meas_conf, ZMOD4XXX_CONF_ALL, hsp,
+                               NULL);
 }
 
 zmod4xxx_err zmod4xxx_start_measurement(zmod4xxx_dev_t *dev)
 {
     int8_t ret;
+    ZMOD4XXX_TRACE_BEGIN();
 
-    ret =
-        dev->write(dev->i2c_addr, ZMOD4XXX_ADDR_CMD, &dev->meas_conf->start, 1);
+    ret = dev->write(dev->i2c_addr, ZMOD4XXX_ADDR_CMD,
+                     (uint8_t *)&dev->meas_conf->start, 1);
     if (ret) {
+        ZMOD4XXX_TRACE_END(ZMOD4XXX_TRACE_START, dev->i2c_addr, ERROR_I2C);
         return ERROR_I2C;
     }
+    ZMOD4XXX_TRACE_END(ZMOD4XXX_TRACE_START, dev->i2c_addr, ZMOD4XXX_OK);
     return ZMOD4XXX_OK;
 }
 
 zmod4xxx_err zmod4xxx_read_adc_result(zmod4xxx_dev_t *dev, uint8_t *adc_result)
 {
     int8_t ret;
+    ZMOD4XXX_TRACE_BEGIN();
 
     ret = dev->read(dev->i2c_addr, dev->meas_conf->r.addr, adc_result,
                     dev->meas_conf->r.len);
     if (ret) {
+        ZMOD4XXX_TRACE_END(ZMOD4XXX_TRACE_ADC_READ, dev->i2c_addr, ERROR_I2C);
         return ERROR_I2C;
     }
 
+    ZMOD4XXX_TRACE_END(ZMOD4XXX_TRACE_ADC_READ, dev->i2c_addr, ZMOD4XXX_OK);
     return ZMOD4XXX_OK;
 }
 
@@ -284,6 +300,7 @@ zmod4xxx_err zmod4xxx_calc_rmox(zmod4xxx_dev_t *dev, uint8_t *adc_result,
     uint16_t adc_value = 0;
     float *p = rmox;
     float rmox_local = 0;
+    ZMOD4XXX_TRACE_BEGIN();
 
     for (i = 0; i < dev->meas_conf->r.len; i = i + 2) {
         adc_value = (((uint16_t)(adc_result[i])) << 8);
@@ -302,23 +319,22 @@ zmod4xxx_err zmod4xxx_calc_rmox(zmod4xxx_dev_t *dev, uint8_t *adc_result,
             p++;
         }
     }
+    ZMOD4XXX_TRACE_END(ZMOD4XXX_TRACE_CALC_RMOX, dev->i2c_addr, ZMOD4XXX_OK);
     return ZMOD4XXX_OK;
 }
 
 zmod4xxx_err zmod4xxx_prepare_sensor(zmod4xxx_dev_t *dev)
 {
     zmod4xxx_err ret;
+    ZMOD4XXX_TRACE_BEGIN();
 
     ret = zmod4xxx_init_sensor(dev);
-    if (ret) {
-        return ret;
-    }
-    dev->delay_ms(50);
-    ret = zmod4xxx_init_measurement(dev);
-    if (ret) {
-        return ret;
+    if (!ret) {
+        dev->delay_ms(50);
+        ret = zmod4xxx_init_measurement(dev);
     }
-    return ZMOD4XXX_OK;
+    ZMOD4XXX_TRACE_END(ZMOD4XXX_TRACE_PREPARE, dev->i2c_addr, ret);
+    return ret;
 }
 
 zmod4xxx_err zmod4xxx_read_rmox(zmod4xxx_dev_t *dev, uint8_t *adc_result,
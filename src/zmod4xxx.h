@@ -20,6 +20,10 @@
 
 #include "zmod4xxx_types.h"
 
+#ifdef __cplusplus
+extern "C" {
+#endif
+
 #define ZMOD4XXX_ADDR_PID       (0x00)
 #define ZMOD4XXX_ADDR_CONF      (0x20)
 #define ZMOD4XXX_ADDR_PROD_DATA (0x26)
@@ -34,6 +38,15 @@
 #define HSP_MAX  (8)
 #define RSLT_MAX (32)
 
+#define ZMOD4XXX_CONF_H   (1 << 0) /**< heater table */
+#define ZMOD4XXX_CONF_D   (1 << 1) /**< delay table */
+#define ZMOD4XXX_CONF_M   (1 << 2) /**< measurement table */
+#define ZMOD4XXX_CONF_S   (1 << 3) /**< sequencer table */
+#define ZMOD4XXX_CONF_ALL (0x0F)   /**< all tables of a configuration */
+
+/** status polls of 50 ms for the init run of zmod4xxx_init_sensor() */
+#define ZMOD4XXX_INIT_POLL_MAX (1000)
+
 #define STATUS_SEQUENCER_RUNNING_MASK   (0x80) /**< Sequencer is running */
 #define STATUS_SLEEP_TIMER_ENABLED_MASK (0x40) /**< SleepTimer_enabled */
 #define STATUS_ALARM_MASK               (0x20) /**< Alarm */
@@ -106,9 +119,42 @@ zmod4xxx_err zmod4xxx_read_tracking_number(zmod4xxx_dev_t *dev,
  * @return error code
  * @retval 0 success
  */
-zmod4xxx_err zmod4xxx_calc_factor(zmod4xxx_conf *conf, uint8_t *hsp,
+zmod4xxx_err zmod4xxx_calc_factor(const zmod4xxx_conf *conf, uint8_t *hsp,
                                   uint8_t *config);
 
+/**
+ * @brief   Write tables of a configuration as one bus section
+ * @param   [in] dev pointer to the device
+ * @param   [in] conf configuration
+ * @param   [in] tables ZMOD4XXX_CONF_* bits of the tables to write
+ * @param   [in] hsp heater set points of conf from zmod4xxx_calc_factor(),
+ *          only read with ZMOD4XXX_CONF_H
+ * @param   [in] start command written last in the same section, or NULL
+ * @return  error code
+ * @retval  0 success
+ * @retval  "!= 0" error
+ * @note    No other user of the bus comes between the writes, see
+ *          zmod4xxx_bus_begin().
+ */
+zmod4xxx_err zmod4xxx_write_conf(zmod4xxx_dev_t *dev, const zmod4xxx_conf *conf,
+                                 uint8_t tables, uint8_t *hsp,
+                                 const uint8_t *start);
+
+/**
+ * @brief   Run the init configuration and read mox_lr and mox_er
+ * @param   [in] dev pointer to the device
+ * @param   [in] hsp heater set points of dev->init_conf
+ * @param   [in] polls_max status polls of 50 ms before giving up
+ * @return  error code
+ * @retval  0 success
+ * @retval  ERROR_GAS_TIMEOUT the run did not end within polls_max polls
+ * @retval  "!= 0" error
+ * @note    The error event register is not touched, so it also serves a
+ *          reconfiguration after the event has been read.
+ */
+zmod4xxx_err zmod4xxx_run_init(zmod4xxx_dev_t *dev, uint8_t *hsp,
+                               uint16_t polls_max);
+
 /**
  * @brief   Initialize the sensor after power on.
  * @param   [in] dev pointer to the device
@@ -181,4 +227,8 @@ zmod4xxx_err zmod4xxx_prepare_sensor(zmod4xxx_dev_t *dev);
 zmod4xxx_err zmod4xxx_read_rmox(zmod4xxx_dev_t *dev, uint8_t *adc_result,
                                 float *rmox);
 
+#ifdef __cplusplus
+}
+#endif
+
 #endif // _ZMOD4XXX_H
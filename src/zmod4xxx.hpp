@@ -0,0 +1,477 @@
+/*
+ * Copyright (c) 2006-2021, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-19     Sherman      first version
+ * 2026-10-19     Sherman      bus sections, trace spans and a bounded init run as in C
+ */
+
+/*
+ * Header-only C++17 layer over zmod4xxx.h. A measurement configuration is a
+ * constexpr object whose table lengths are part of its type, so result and
+ * set point buffers are sized and the heater table is decoded at compile
+ * time. The bus is a template parameter instead of function pointers:
+ *
+ *   struct my_hal
+ *   {
+ *       int8_t read(uint8_t i2c_addr, uint8_t reg, uint8_t *buf, uint8_t len);
+ *       int8_t write(uint8_t i2c_addr, uint8_t reg, uint8_t *buf, uint8_t len);
+ *       void delay_ms(uint32_t ms);
+ *   };
+ *
+ *   zmod4xxx::sensor<my_hal, zmod4xxx::zmod4410::init, zmod4xxx::zmod4410::iaq2> s;
+ *
+ * A HAL whose functions are visible inlines into the driver; c_hal wraps
+ * the function pointers of an existing C HAL. Errors are zmod4xxx_err, as
+ * in C, and the sensor keeps a zmod4xxx_dev_t for the gas algorithms.
+ * Table writes are bus sections and the calls record trace spans, the same
+ * as the C functions they mirror.
+ */
+
+#ifndef _ZMOD4XXX_HPP
+#define _ZMOD4XXX_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+#include "zmod4xxx.h"
+#include "zmod4xxx_bus.h"
+#include "zmod4xxx_trace.h"
+#include "zmod4410_config_iaq2.h"
+
+namespace zmod4xxx
+{
+
+/**
+ * @brief One sequencer table of N bytes
+ */
+template <std::size_t N>
+struct table
+{
+    static constexpr std::size_t size = N;
+    uint8_t addr;
+    std::array<uint8_t, N> data;
+};
+
+/**
+ * @brief   Cut a table out of a data set at compile time
+ * @tparam  Off first byte in the data set
+ * @tparam  N length of the table
+ */
+template <std::size_t Off, std::size_t N, std::size_t L>
+constexpr table<N> slice(uint8_t addr, const std::array<uint8_t, L> &set)
+{
+    static_assert(Off + N <= L, "table out of the data set");
+    table<N> t{addr, {}};
+    for (std::size_t i = 0; i < N; i++)
+    {
+        t.data[i] = set[Off + i];
+    }
+    return t;
+}
+
+/**
+ * @brief A measurement configuration, the compile-time zmod4xxx_conf
+ * @tparam H, D, M, S lengths of the heater, delay, measurement and
+ *         sequencer tables
+ * @tparam R length of the result registers
+ */
+template <std::size_t H, std::size_t D, std::size_t M, std::size_t S, std::size_t R>
+struct config
+{
+    static_assert(H % 2 == 0 && H / 2 <= HSP_MAX, "heater table of 16 bit set points");
+    static_assert(R % 2 == 0 && R <= RSLT_MAX, "results of 16 bit ADC values");
+
+    static constexpr std::size_t hsp_len = H;
+    static constexpr std::size_t result_len = R;
+    static constexpr std::size_t rmox_len = R / 2;
+
+    using adc_t = std::array<uint8_t, R>;
+    using rmox_t = std::array<float, R / 2>;
+
+    uint8_t start;
+    table<H> h;
+    table<D> d;
+    table<M> m;
+    table<S> s;
+    uint8_t r_addr;
+    uint8_t prod_data_len;
+    const zmod4xxx_conf *c; /**< the same configuration for the C API */
+
+    /**
+     * @brief   Heater set points of the table, decoded at compile time
+     */
+    constexpr std::array<int16_t, H / 2> heater() const
+    {
+        std::array<int16_t, H / 2> t{};
+        for (std::size_t i = 0; i < H / 2; i++)
+        {
+            t[i] = (int16_t)((h.data[2 * i] << 8) + h.data[2 * i + 1]);
+        }
+        return t;
+    }
+};
+
+namespace zmod4410
+{
+
+inline constexpr std::array<uint8_t, 10> init_set{ZMOD4410_INIT_DATA_SET};
+inline constexpr std::array<uint8_t, 60> iaq2_set{ZMOD4410_IAQ2_DATA_SET};
+
+/** configuration of the init run, zmod_sensor_type[INIT] */
+inline constexpr config<2, 2, 2, 4, 4> init{
+    0x80,
+    slice<0, 2>(ZMOD4410_H_ADDR, init_set),
+    slice<2, 2>(ZMOD4410_D_ADDR, init_set),
+    slice<4, 2>(ZMOD4410_M_ADDR, init_set),
+    slice<6, 4>(ZMOD4410_S_ADDR, init_set),
+    0x97,
+    0,
+    &zmod_sensor_type[INIT],
+};
+
+/** IAQ 2nd Gen measurement, zmod_sensor_type[MEASUREMENT] */
+inline constexpr config<16, 8, 4, 32, 32> iaq2{
+    0x80,
+    slice<0, 16>(ZMOD4410_H_ADDR, iaq2_set),
+    slice<16, 8>(ZMOD4410_D_ADDR, iaq2_set),
+    slice<24, 4>(ZMOD4410_M_ADDR, iaq2_set),
+    slice<28, 32>(ZMOD4410_S_ADDR, iaq2_set),
+    0x97,
+    ZMOD4410_PROD_DATA_LEN,
+    &zmod_sensor_type[MEASUREMENT],
+};
+
+} /* namespace zmod4410 */
+
+/**
+ * @brief HAL over the function pointers of a C HAL, e.g. init_hardware()
+ */
+struct c_hal
+{
+    zmod4xxx_i2c_ptr_t rd = nullptr;
+    zmod4xxx_i2c_ptr_t wr = nullptr;
+    zmod4xxx_delay_ptr_p delay = nullptr;
+
+    c_hal() = default;
+    explicit c_hal(const zmod4xxx_dev_t &dev) : rd(dev.read), wr(dev.write), delay(dev.delay_ms) {}
+
+    int8_t read(uint8_t i2c_addr, uint8_t reg, uint8_t *buf, uint8_t len)
+    {
+        return rd(i2c_addr, reg, buf, len);
+    }
+    int8_t write(uint8_t i2c_addr, uint8_t reg, uint8_t *buf, uint8_t len)
+    {
+        return wr(i2c_addr, reg, buf, len);
+    }
+    void delay_ms(uint32_t ms)
+    {
+        delay(ms);
+    }
+};
+
+/**
+ * @brief A ZMOD4xxx with its configurations fixed at compile time
+ * @tparam Hal bus and delay, see the top of this file
+ * @tparam Init configuration of the init run
+ * @tparam Meas configuration of a measurement
+ */
+template <class Hal, const auto &Init, const auto &Meas>
+class sensor
+{
+public:
+    using meas_t = std::remove_cv_t<std::remove_reference_t<decltype(Meas)>>;
+    using adc_t = typename meas_t::adc_t;
+    using rmox_t = typename meas_t::rmox_t;
+
+    static constexpr uint32_t poll_max = 1000;
+
+    /**
+     * @param   [in] hal bus, copied
+     * @param   [in] i2c_addr address of the sensor
+     * @param   [in] pid expected product id
+     */
+    explicit sensor(const Hal &hal = Hal(), uint8_t i2c_addr = ZMOD4410_I2C_ADDR,
+                    uint16_t pid = ZMOD4410_PID)
+        : hal_(hal), dev_{}
+    {
+        dev_.i2c_addr = i2c_addr;
+        dev_.pid = pid;
+        dev_.init_conf = Init.c;
+        dev_.meas_conf = Meas.c;
+        dev_.prod_data = prod_data_.data();
+    }
+
+    /* dev_.prod_data points into the object */
+    sensor(const sensor &) = delete;
+    sensor &operator=(const sensor &) = delete;
+
+    Hal &hal()
+    {
+        return hal_;
+    }
+
+    /**
+     * @brief   The device as the C API and the gas algorithms see it
+     * @note    read, write and delay_ms are NULL; the sensor never calls them.
+     *          init_conf and meas_conf are the C tables of Init and Meas.
+     */
+    zmod4xxx_dev_t *c_dev()
+    {
+        return &dev_;
+    }
+
+    /**
+     * @brief   zmod4xxx_read_sensor_info()
+     */
+    zmod4xxx_err read_sensor_info()
+    {
+        uint8_t cmd = 0, status = 0x80;
+        uint8_t pid[ZMOD4XXX_LEN_PID];
+        uint32_t i;
+
+        for (i = 0; i < poll_max && (status & 0x80); i++)
+        {
+            if (hal_.write(dev_.i2c_addr, ZMOD4XXX_ADDR_CMD, &cmd, 1) ||
+                hal_.read(dev_.i2c_addr, ZMOD4XXX_ADDR_STATUS, &status, 1))
+            {
+                return ERROR_I2C;
+            }
+            hal_.delay_ms(200);
+        }
+        if (status & 0x80)
+        {
+            return ERROR_GAS_TIMEOUT;
+        }
+        if (hal_.read(dev_.i2c_addr, ZMOD4XXX_ADDR_PID, pid, sizeof(pid)))
+        {
+            return ERROR_I2C;
+        }
+        if (dev_.pid != pid[0] * 256 + pid[1])
+        {
+            return ERROR_SENSOR_UNSUPPORTED;
+        }
+        if (hal_.read(dev_.i2c_addr, ZMOD4XXX_ADDR_CONF, dev_.config, ZMOD4XXX_LEN_CONF) ||
+            hal_.read(dev_.i2c_addr, ZMOD4XXX_ADDR_PROD_DATA, prod_data_.data(),
+                      Meas.prod_data_len))
+        {
+            return ERROR_I2C;
+        }
+        return ZMOD4XXX_OK;
+    }
+
+    /**
+     * @brief   Heater set points of a configuration for this sensor,
+     *          zmod4xxx_calc_factor()
+     */
+    template <const auto &Conf>
+    std::array<uint8_t, Conf.hsp_len> calc_factor() const
+    {
+        constexpr auto heater = Conf.heater();
+        std::array<uint8_t, heater.size() * 2> hsp{};
+        const uint8_t *config = dev_.config;
+        float hspf;
+
+        for (std::size_t i = 0; i < heater.size(); i++)
+        {
+            hspf = (-((float)config[2] * 256.0F + config[3]) *
+                    ((config[4] + 640.0F) * (config[5] + heater[i]) - 512000.0F)) /
+                   12288000.0F;
+            hsp[2 * i] = (uint8_t)((uint16_t)hspf >> 8);
+            hsp[2 * i + 1] = (uint8_t)((uint16_t)hspf & 0x00FF);
+        }
+        return hsp;
+    }
+
+    /**
+     * @brief   zmod4xxx_prepare_sensor(): init run, then the measurement tables
+     * @retval  ERROR_GAS_TIMEOUT the init run did not end within poll_max polls
+     */
+    zmod4xxx_err prepare()
+    {
+        zmod4xxx_err ret;
+        ZMOD4XXX_TRACE_BEGIN();
+
+        ret = init_run();
+        if (!ret)
+        {
+            hal_.delay_ms(50);
+            ret = write_tables<Meas>(nullptr);
+        }
+        ZMOD4XXX_TRACE_END(ZMOD4XXX_TRACE_PREPARE, dev_.i2c_addr, ret);
+        return ret;
+    }
+
+    /**
+     * @brief   zmod4xxx_start_measurement()
+     */
+    zmod4xxx_err start()
+    {
+        zmod4xxx_err ret;
+        ZMOD4XXX_TRACE_BEGIN();
+
+        ret = hal_.write(dev_.i2c_addr, ZMOD4XXX_ADDR_CMD, (uint8_t *)&Meas.start, 1)
+                  ? ERROR_I2C : ZMOD4XXX_OK;
+        ZMOD4XXX_TRACE_END(ZMOD4XXX_TRACE_START, dev_.i2c_addr, ret);
+        return ret;
+    }
+
+    /**
+     * @brief   zmod4xxx_read_status()
+     */
+    zmod4xxx_err status(uint8_t &st)
+    {
+        ZMOD4XXX_TRACE_BEGIN();
+
+        if (hal_.read(dev_.i2c_addr, ZMOD4XXX_ADDR_STATUS, &st, 1))
+        {
+            ZMOD4XXX_TRACE_END(ZMOD4XXX_TRACE_STATUS, dev_.i2c_addr, ERROR_I2C);
+            return ERROR_I2C;
+        }
+        ZMOD4XXX_TRACE_END(ZMOD4XXX_TRACE_STATUS, dev_.i2c_addr, st);
+        return ZMOD4XXX_OK;
+    }
+
+    /**
+     * @brief   zmod4xxx_check_error_event()
+     */
+    zmod4xxx_err check_error_event()
+    {
+        uint8_t ev;
+
+        if (hal_.read(dev_.i2c_addr, 0xB7, &ev, 1))
+        {
+            return ERROR_I2C;
+        }
+        if (ev & STATUS_ACCESS_CONFLICT_MASK)
+        {
+            return ERROR_ACCESS_CONFLICT;
+        }
+        return (ev & STATUS_POR_EVENT_MASK) ? ERROR_POR_EVENT : ZMOD4XXX_OK;
+    }
+
+    /**
+     * @brief   zmod4xxx_read_adc_result()
+     */
+    zmod4xxx_err read_adc(adc_t &adc)
+    {
+        zmod4xxx_err ret;
+        ZMOD4XXX_TRACE_BEGIN();
+
+        ret = hal_.read(dev_.i2c_addr, Meas.r_addr, adc.data(), adc.size()) ? ERROR_I2C
+                                                                            : ZMOD4XXX_OK;
+        ZMOD4XXX_TRACE_END(ZMOD4XXX_TRACE_ADC_READ, dev_.i2c_addr, ret);
+        return ret;
+    }
+
+    /**
+     * @brief   zmod4xxx_calc_rmox(), with the same clamps of 1e-3 and 10e9
+     */
+    void calc_rmox(const adc_t &adc, rmox_t &rmox) const
+    {
+        uint16_t adc_value;
+        ZMOD4XXX_TRACE_BEGIN();
+
+        for (std::size_t i = 0; i < rmox.size(); i++)
+        {
+            adc_value = (uint16_t)((adc[2 * i] << 8) | adc[2 * i + 1]);
+            if (0.0 > (adc_value - dev_.mox_lr))
+            {
+                rmox[i] = 1e-3;
+            }
+            else if (0.0 >= (dev_.mox_er - adc_value))
+            {
+                rmox[i] = 10e9;
+            }
+            else
+            {
+                rmox[i] = dev_.config[0] * 1e3 * (float)(adc_value - dev_.mox_lr) /
+                          (float)(dev_.mox_er - adc_value);
+            }
+        }
+        ZMOD4XXX_TRACE_END(ZMOD4XXX_TRACE_CALC_RMOX, dev_.i2c_addr, ZMOD4XXX_OK);
+    }
+
+private:
+    /* zmod4xxx_init_sensor() */
+    zmod4xxx_err init_run()
+    {
+        uint8_t data_r[Init.result_len];
+        uint8_t status;
+        zmod4xxx_err ret;
+        uint32_t i;
+
+        if (hal_.read(dev_.i2c_addr, 0xB7, data_r, 1))
+        {
+            return ERROR_I2C;
+        }
+        ret = write_tables<Init>(&Init.start);
+        if (ret)
+        {
+            return ret;
+        }
+        for (i = 0; i < poll_max; i++)
+        {
+            ret = this->status(status);
+            if (ret)
+            {
+                return ret;
+            }
+            hal_.delay_ms(50);
+            if (!(status & STATUS_SEQUENCER_RUNNING_MASK))
+            {
+                break;
+            }
+        }
+        if (i == poll_max)
+        {
+            return ERROR_GAS_TIMEOUT;
+        }
+
+        if (hal_.read(dev_.i2c_addr, Init.r_addr, data_r, sizeof(data_r)))
+        {
+            return ERROR_I2C;
+        }
+        dev_.mox_lr = (uint16_t)(data_r[0] << 8) | data_r[1];
+        dev_.mox_er = (uint16_t)(data_r[2] << 8) | data_r[3];
+        return ZMOD4XXX_OK;
+    }
+
+    /* the tables of a run and its start, if any, go out as one bus section */
+    template <const auto &Conf>
+    zmod4xxx_err write_tables(const uint8_t *start)
+    {
+        auto hsp = calc_factor<Conf>();
+        zmod4xxx_err ret;
+
+        ret = ZMOD4XXX_BUS_BEGIN(&dev_);
+        if (ret)
+        {
+            return ret;
+        }
+        if (hal_.write(dev_.i2c_addr, Conf.h.addr, hsp.data(), hsp.size()) ||
+            hal_.write(dev_.i2c_addr, Conf.d.addr, (uint8_t *)Conf.d.data.data(), Conf.d.size) ||
+            hal_.write(dev_.i2c_addr, Conf.m.addr, (uint8_t *)Conf.m.data.data(), Conf.m.size) ||
+            hal_.write(dev_.i2c_addr, Conf.s.addr, (uint8_t *)Conf.s.data.data(), Conf.s.size) ||
+            (start != nullptr &&
+             hal_.write(dev_.i2c_addr, ZMOD4XXX_ADDR_CMD, (uint8_t *)start, 1)))
+        {
+            ret = ERROR_I2C;
+        }
+        ZMOD4XXX_BUS_END(&dev_);
+        return ret;
+    }
+
+    Hal hal_;
+    zmod4xxx_dev_t dev_;
+    std::array<uint8_t, Meas.prod_data_len> prod_data_{};
+};
+
+} /* namespace zmod4xxx */
+
+#endif /* _ZMOD4XXX_HPP */
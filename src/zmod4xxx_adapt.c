@@ -0,0 +1,151 @@
+/*
+ * Copyright (c) 2006-2021, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-19     Sherman      first version
+ * 2026-10-19     Sherman      leave low power on rmox
+ */
+
+/*
+ * Adaptive sampling. The controller looks at the algorithm outputs at full
+ * rate and at the resistances at low power, and tells the caller when to
+ * change mode; applying the mode and restarting the algorithm stay with the
+ * caller, which knows the sensor and the library.
+ */
+
+#ifndef ZMOD4XXX_USING_ADAPT
+#define ZMOD4XXX_USING_ADAPT
+#endif
+
+#include <math.h>
+#include <string.h>
+
+#include "zmod4xxx_adapt.h"
+
+static const zmod4xxx_adapt_config_t adapt_default = {
+    ZMOD4XXX_ADAPT_IAQ_BAND,
+    ZMOD4XXX_ADAPT_TVOC_BAND,
+    ZMOD4XXX_ADAPT_RMOX_BAND,
+    ZMOD4XXX_ADAPT_CALM_MS,
+};
+
+/* start a new flat stretch at this sample */
+static void adapt_restart(zmod4xxx_adapt_t *ad, float iaq, float tvoc,
+                          uint32_t now_ms)
+{
+    ad->iaq_min = ad->iaq_max = iaq;
+    ad->tvoc_min = ad->tvoc_max = tvoc;
+    ad->calm_since_ms = now_ms;
+}
+
+void zmod4xxx_adapt_init(zmod4xxx_adapt_t *ad, const zmod4xxx_adapt_config_t *cfg,
+                         uint32_t now_ms)
+{
+    memset(ad, 0, sizeof(*ad));
+    ad->cfg = cfg ? *cfg : adapt_default;
+    ad->level = ZMOD4XXX_ADAPT_FULL;
+    ad->stabilizing = 1;
+    ad->last_ms = now_ms;
+}
+
+static void adapt_account(zmod4xxx_adapt_t *ad, uint32_t now_ms)
+{
+    ad->time_ms[ad->level] += (uint32_t)(now_ms - ad->last_ms);
+    ad->last_ms = now_ms;
+    ad->samples[ad->level]++;
+}
+
+uint8_t zmod4xxx_adapt_update(zmod4xxx_adapt_t *ad, float iaq, float tvoc,
+                              uint8_t valid, uint32_t now_ms)
+{
+    if (ad->level != ZMOD4XXX_ADAPT_FULL)
+    {
+        return ZMOD4XXX_ADAPT_STAY;
+    }
+    adapt_account(ad, now_ms);
+
+    if (!valid)
+    {
+        if (ad->switches[ZMOD4XXX_ADAPT_FULL])
+        {
+            ad->held++;
+        }
+        return ZMOD4XXX_ADAPT_STAY;
+    }
+    if (ad->stabilizing)
+    {
+        ad->stabilizing = 0;
+        adapt_restart(ad, iaq, tvoc, now_ms);
+        return ZMOD4XXX_ADAPT_STAY;
+    }
+
+    if (iaq < ad->iaq_min)
+    {
+        ad->iaq_min = iaq;
+    }
+    if (iaq > ad->iaq_max)
+    {
+        ad->iaq_max = iaq;
+    }
+    if (tvoc < ad->tvoc_min)
+    {
+        ad->tvoc_min = tvoc;
+    }
+    if (tvoc > ad->tvoc_max)
+    {
+        ad->tvoc_max = tvoc;
+    }
+    if (ad->iaq_max - ad->iaq_min > ad->cfg.iaq_enter ||
+        ad->tvoc_max - ad->tvoc_min > ad->cfg.tvoc_enter)
+    {
+        adapt_restart(ad, iaq, tvoc, now_ms);
+        return ZMOD4XXX_ADAPT_STAY;
+    }
+    if ((uint32_t)(now_ms - ad->calm_since_ms) < ad->cfg.calm_ms)
+    {
+        return ZMOD4XXX_ADAPT_STAY;
+    }
+
+    ad->ref_set = 0;
+    ad->level = ZMOD4XXX_ADAPT_LOW;
+    ad->switches[ZMOD4XXX_ADAPT_LOW]++;
+    return ZMOD4XXX_ADAPT_TO_LOW;
+}
+
+uint8_t zmod4xxx_adapt_update_low(zmod4xxx_adapt_t *ad, const float *rmox,
+                                  uint8_t n, uint32_t now_ms)
+{
+    float sum = 0;
+    uint8_t i;
+
+    if (ad->level != ZMOD4XXX_ADAPT_LOW || n == 0)
+    {
+        return ZMOD4XXX_ADAPT_STAY;
+    }
+    adapt_account(ad, now_ms);
+
+    for (i = 0; i < n; i++)
+    {
+        sum += log10f(rmox[i]);
+    }
+    sum /= n;
+
+    if (!ad->ref_set)
+    {
+        ad->rmox_ref = sum;
+        ad->ref_set = 1;
+        return ZMOD4XXX_ADAPT_STAY;
+    }
+    if (fabsf(sum - ad->rmox_ref) <= ad->cfg.rmox_exit)
+    {
+        return ZMOD4XXX_ADAPT_STAY;
+    }
+
+    ad->level = ZMOD4XXX_ADAPT_FULL;
+    ad->switches[ZMOD4XXX_ADAPT_FULL]++;
+    ad->stabilizing = 1;
+    return ZMOD4XXX_ADAPT_TO_FULL;
+}
@@ -0,0 +1,140 @@
+/*
+ * Copyright (c) 2006-2021, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-19     Sherman      first version
+ * 2026-10-19     Sherman      leave low power on rmox
+ */
+
+#ifndef _ZMOD4XXX_ADAPT_H
+#define _ZMOD4XXX_ADAPT_H
+
+#include "zmod4xxx_types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifndef ZMOD4XXX_ADAPT_IAQ_BAND
+#define ZMOD4XXX_ADAPT_IAQ_BAND  (0.3f) /**< default IAQ spread still flat */
+#endif
+#ifndef ZMOD4XXX_ADAPT_TVOC_BAND
+#define ZMOD4XXX_ADAPT_TVOC_BAND (0.1f) /**< default TVOC spread still flat, mg/m^3 */
+#endif
+#ifndef ZMOD4XXX_ADAPT_RMOX_BAND
+#define ZMOD4XXX_ADAPT_RMOX_BAND (0.1f) /**< default log10 rmox change of low power, decades */
+#endif
+#ifndef ZMOD4XXX_ADAPT_CALM_MS
+#define ZMOD4XXX_ADAPT_CALM_MS   (3600000UL) /**< default flat time before low power */
+#endif
+
+/**
+ * @brief Sampling levels of the controller
+ */
+typedef enum {
+    ZMOD4XXX_ADAPT_FULL = 0, /**< full rate, e.g. IAQ 2nd Gen every 3 s */
+    ZMOD4XXX_ADAPT_LOW, /**< low power, the same tables with a long host wait */
+    ZMOD4XXX_ADAPT_LEVEL_MAX
+} zmod4xxx_adapt_level;
+
+/**
+ * @brief What the caller has to do after an update
+ */
+typedef enum {
+    ZMOD4XXX_ADAPT_STAY = 0, /**< keep the current mode */
+    ZMOD4XXX_ADAPT_TO_LOW, /**< switch to the low power mode */
+    ZMOD4XXX_ADAPT_TO_FULL, /**< switch to full rate and restart the algorithm */
+} zmod4xxx_adapt_action;
+
+/**
+ * @brief Controller configuration
+ *
+ * The algorithm outputs count as flat while their spread stays inside the
+ * enter band. After calm_ms of flat outputs the controller drops to low
+ * power. The algorithm has no outputs there, as it needs its full sample
+ * rate, so the controller follows the mean log10 rmox of the low power
+ * samples instead. It goes back to full rate once that leaves the exit band
+ * around the first low power sample, which is taken at the low rate and so
+ * is the only fair reference.
+ */
+typedef struct {
+    float iaq_enter; /**< largest IAQ spread that is flat */
+    float tvoc_enter; /**< largest TVOC spread that is flat, mg/m^3 */
+    float rmox_exit; /**< mean log10 rmox change that ends low power, decades */
+    uint32_t calm_ms; /**< flat time before dropping to low power */
+} zmod4xxx_adapt_config_t;
+
+/**
+ * @brief Controller state and counters
+ */
+typedef struct {
+    zmod4xxx_adapt_config_t cfg;
+    uint8_t level; /**< zmod4xxx_adapt_level */
+    uint8_t stabilizing; /**< back at full rate, algorithm not valid yet */
+    float iaq_min, iaq_max; /**< spread since calm_since_ms */
+    float tvoc_min, tvoc_max;
+    uint8_t ref_set; /**< rmox_ref holds the first low power sample */
+    float rmox_ref; /**< mean log10 rmox at low power, log10 Ohm */
+    uint32_t calm_since_ms; /**< start of the current flat stretch */
+    uint32_t last_ms; /**< time of the last update */
+    uint64_t time_ms[ZMOD4XXX_ADAPT_LEVEL_MAX]; /**< time spent per level */
+    uint32_t samples[ZMOD4XXX_ADAPT_LEVEL_MAX]; /**< samples per level */
+    uint32_t switches[ZMOD4XXX_ADAPT_LEVEL_MAX]; /**< switches into each level */
+    uint32_t held; /**< samples spent re-stabilizing at full rate */
+} zmod4xxx_adapt_t;
+
+#ifdef ZMOD4XXX_USING_ADAPT
+
+/**
+ * @brief   Start a controller at full rate
+ * @param   [out] ad controller, cleared
+ * @param   [in] cfg configuration, copied; NULL for the defaults
+ * @param   [in] now_ms current time
+ */
+void zmod4xxx_adapt_init(zmod4xxx_adapt_t *ad, const zmod4xxx_adapt_config_t *cfg,
+                         uint32_t now_ms);
+
+/**
+ * @brief   Feed one full rate sample of the algorithm outputs
+ * @param   [in,out] ad controller
+ * @param   [in] iaq IAQ index of the sample
+ * @param   [in] tvoc TVOC of the sample, mg/m^3
+ * @param   [in] valid 0 while the algorithm is stabilizing
+ * @param   [in] now_ms current time
+ * @return  zmod4xxx_adapt_action
+ * @note    After ZMOD4XXX_ADAPT_TO_FULL the caller restarts the algorithm.
+ *          Until it reports valid samples again, stabilizing is set and
+ *          the caller can keep publishing the last valid outputs.
+ */
+uint8_t zmod4xxx_adapt_update(zmod4xxx_adapt_t *ad, float iaq, float tvoc,
+                              uint8_t valid, uint32_t now_ms);
+
+/**
+ * @brief   Feed one low power sample
+ * @param   [in,out] ad controller
+ * @param   [in] rmox resistances of the sample, Ohm
+ * @param   [in] n number of resistances
+ * @param   [in] now_ms current time
+ * @return  zmod4xxx_adapt_action
+ * @note    Low power samples do not go through the algorithm and have no
+ *          valid outputs; the caller keeps publishing the last ones.
+ */
+uint8_t zmod4xxx_adapt_update_low(zmod4xxx_adapt_t *ad, const float *rmox,
+                                  uint8_t n, uint32_t now_ms);
+
+#else
+
+#define zmod4xxx_adapt_init(ad, cfg, now_ms)                 ((void)0)
+#define zmod4xxx_adapt_update(ad, iaq, tvoc, valid, now_ms)  (ZMOD4XXX_ADAPT_STAY)
+#define zmod4xxx_adapt_update_low(ad, rmox, n, now_ms)       (ZMOD4XXX_ADAPT_STAY)
+
+#endif /* ZMOD4XXX_USING_ADAPT */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _ZMOD4XXX_ADAPT_H */
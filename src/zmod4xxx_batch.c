@@ -0,0 +1,273 @@
+/*
+ * Copyright (c) 2006-2021, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-19     Sherman      first version
+ */
+
+/*
+ * Batch frames for the uplink, see zmod4xxx_batch.h for the layout. Plain
+ * C without the RTOS, so the same file decodes frames on a Linux host.
+ */
+
+#include <string.h>
+
+#include "zmod4xxx_batch.h"
+
+static uint16_t batch_crc16(const uint8_t *buf, uint32_t len)
+{
+    uint16_t crc = 0xFFFF;
+    uint8_t k;
+
+    while (len--)
+    {
+        crc ^= (uint16_t)(*buf++ << 8);
+        for (k = 0; k < 8; k++)
+        {
+            crc = (crc & 0x8000) ? (uint16_t)((crc << 1) ^ 0x1021) : (uint16_t)(crc << 1);
+        }
+    }
+    return crc;
+}
+
+static int batch_put(zmod4xxx_batch_enc_t *enc, uint32_t v)
+{
+    do
+    {
+        if (enc->len >= enc->cap)
+        {
+            return -1;
+        }
+        enc->buf[enc->len++] = (uint8_t)((v & 0x7F) | (v > 0x7F ? 0x80 : 0));
+        v >>= 7;
+    }
+    while (v);
+    return 0;
+}
+
+static int batch_put_s(zmod4xxx_batch_enc_t *enc, int32_t v)
+{
+    return batch_put(enc, ((uint32_t)v << 1) ^ (uint32_t)(v >> 31));
+}
+
+static int batch_get(zmod4xxx_batch_dec_t *dec, uint32_t *v)
+{
+    uint8_t shift = 0, b;
+
+    *v = 0;
+    do
+    {
+        if (dec->pos >= dec->len || shift > 28)
+        {
+            return -1;
+        }
+        b = dec->buf[dec->pos++];
+        *v |= (uint32_t)(b & 0x7F) << shift;
+        shift += 7;
+    }
+    while (b & 0x80);
+    return 0;
+}
+
+static int batch_get_s(zmod4xxx_batch_dec_t *dec, int32_t *v)
+{
+    uint32_t u;
+
+    if (batch_get(dec, &u))
+    {
+        return -1;
+    }
+    *v = (int32_t)(u >> 1) ^ -(int32_t)(u & 1);
+    return 0;
+}
+
+zmod4xxx_err zmod4xxx_batch_begin(zmod4xxx_batch_enc_t *enc, uint8_t *buf, uint32_t cap)
+{
+    if (enc == NULL || buf == NULL)
+    {
+        return ERROR_NULL_PTR;
+    }
+    if (cap < ZMOD4XXX_BATCH_HDR_LEN + 2)
+    {
+        return ERROR_BATCH_SPACE;
+    }
+    memset(enc, 0, sizeof(*enc));
+    enc->buf = buf;
+    /* keep room for the CRC */
+    enc->cap = (cap > 0xFFFF ? 0xFFFF : cap) - 2;
+    buf[0] = ZMOD4XXX_BATCH_MAGIC;
+    buf[1] = ZMOD4XXX_BATCH_VERSION;
+    buf[2] = ZMOD4XXX_BATCH_CH_MAX;
+    buf[3] = 0;
+    enc->len = ZMOD4XXX_BATCH_HDR_LEN;
+    return ZMOD4XXX_OK;
+}
+
+zmod4xxx_err zmod4xxx_batch_add(zmod4xxx_batch_enc_t *enc, const zmod4xxx_batch_sample_t *s)
+{
+    zmod4xxx_batch_enc_t save = *enc;
+    uint32_t gap;
+    int32_t delta;
+    uint8_t flags, c;
+    int err = 0;
+
+    if (enc->count == UINT8_MAX)
+    {
+        return ERROR_BATCH_SPACE;
+    }
+    if (enc->count == 0)
+    {
+        err |= batch_put(enc, s->seq);
+        err |= batch_put(enc, s->ts);
+        enc->prev_seq = s->seq - 1;
+        enc->prev_ts = s->ts;
+    }
+
+    gap = s->seq - enc->prev_seq;
+    flags = s->flags & ZMOD4XXX_BATCH_F_SAMPLE;
+    if (gap != 1)
+    {
+        flags |= ZMOD4XXX_BATCH_F_GAP;
+    }
+    if (enc->len < enc->cap)
+    {
+        enc->buf[enc->len++] = flags;
+    }
+    else
+    {
+        err = 1;
+    }
+    if (gap != 1)
+    {
+        err |= batch_put(enc, gap - 1);
+    }
+    delta = (int32_t)(s->ts - enc->prev_ts);
+    err |= batch_put_s(enc, delta - enc->prev_delta);
+    for (c = 0; c < ZMOD4XXX_BATCH_CH_MAX; c++)
+    {
+        err |= batch_put_s(enc, (int32_t)((uint32_t)s->v[c] - (uint32_t)enc->prev_v[c]));
+        enc->prev_v[c] = s->v[c];
+    }
+    if (err)
+    {
+        *enc = save;
+        return ERROR_BATCH_SPACE;
+    }
+    enc->prev_seq = s->seq;
+    enc->prev_ts = s->ts;
+    enc->prev_delta = delta;
+    enc->count++;
+    return ZMOD4XXX_OK;
+}
+
+uint32_t zmod4xxx_batch_end(zmod4xxx_batch_enc_t *enc)
+{
+    uint16_t crc;
+    uint32_t len = enc->len + 2;
+
+    if (enc->count == 0)
+    {
+        return 0;
+    }
+    enc->buf[3] = enc->count;
+    enc->buf[4] = (uint8_t)len;
+    enc->buf[5] = (uint8_t)(len >> 8);
+    crc = batch_crc16(enc->buf, enc->len);
+    enc->buf[enc->len] = (uint8_t)crc;
+    enc->buf[enc->len + 1] = (uint8_t)(crc >> 8);
+    return len;
+}
+
+zmod4xxx_err zmod4xxx_batch_open(zmod4xxx_batch_dec_t *dec, const uint8_t *buf,
+                                 uint32_t len, uint32_t *frame_len)
+{
+    uint32_t flen;
+    uint16_t crc;
+
+    if (dec == NULL || buf == NULL)
+    {
+        return ERROR_NULL_PTR;
+    }
+    if (len < ZMOD4XXX_BATCH_HDR_LEN + 2 || buf[0] != ZMOD4XXX_BATCH_MAGIC ||
+        buf[1] != ZMOD4XXX_BATCH_VERSION || buf[2] == 0)
+    {
+        return ERROR_BATCH_FORMAT;
+    }
+    flen = buf[4] | ((uint32_t)buf[5] << 8);
+    if (flen < ZMOD4XXX_BATCH_HDR_LEN + 2 || flen > len)
+    {
+        return ERROR_BATCH_FORMAT;
+    }
+    crc = (uint16_t)(buf[flen - 2] | (buf[flen - 1] << 8));
+    if (crc != batch_crc16(buf, flen - 2))
+    {
+        return ERROR_BATCH_FORMAT;
+    }
+
+    memset(dec, 0, sizeof(*dec));
+    dec->buf = buf;
+    dec->len = flen - 2;
+    dec->pos = ZMOD4XXX_BATCH_HDR_LEN;
+    dec->channels = buf[2];
+    dec->count = buf[3];
+    if (frame_len != NULL)
+    {
+        *frame_len = flen;
+    }
+    return ZMOD4XXX_OK;
+}
+
+int8_t zmod4xxx_batch_next(zmod4xxx_batch_dec_t *dec, zmod4xxx_batch_sample_t *s)
+{
+    zmod4xxx_batch_sample_t *p = &dec->prev;
+    uint32_t gap = 0;
+    int32_t dod, d;
+    uint8_t flags, c;
+
+    if (dec->index == dec->count)
+    {
+        return 0;
+    }
+    if (dec->index == 0)
+    {
+        if (batch_get(dec, &p->seq) || batch_get(dec, &p->ts))
+        {
+            return ERROR_BATCH_FORMAT;
+        }
+        p->seq--;
+    }
+    if (dec->pos >= dec->len)
+    {
+        return ERROR_BATCH_FORMAT;
+    }
+    flags = dec->buf[dec->pos++];
+    if ((flags & ZMOD4XXX_BATCH_F_GAP) && batch_get(dec, &gap))
+    {
+        return ERROR_BATCH_FORMAT;
+    }
+    if (batch_get_s(dec, &dod))
+    {
+        return ERROR_BATCH_FORMAT;
+    }
+    dec->prev_delta += dod;
+    p->seq += gap + 1;
+    p->ts += (uint32_t)dec->prev_delta;
+    p->flags = flags & ZMOD4XXX_BATCH_F_SAMPLE;
+    for (c = 0; c < dec->channels; c++)
+    {
+        if (batch_get_s(dec, &d))
+        {
+            return ERROR_BATCH_FORMAT;
+        }
+        if (c < ZMOD4XXX_BATCH_CH_MAX)
+        {
+            p->v[c] = (int32_t)((uint32_t)p->v[c] + (uint32_t)d);
+        }
+    }
+    dec->index++;
+    *s = *p;
+    return 1;
+}
@@ -0,0 +1,150 @@
+/*
+ * Copyright (c) 2006-2021, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-19     Sherman      first version
+ */
+
+#ifndef _ZMOD4XXX_BATCH_H
+#define _ZMOD4XXX_BATCH_H
+
+#include "zmod4xxx_types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Batch frame, version 1, all multi-byte fields little endian:
+ *
+ *   0  u8      ZMOD4XXX_BATCH_MAGIC
+ *   1  u8      ZMOD4XXX_BATCH_VERSION
+ *   2  u8      channels per sample
+ *   3  u8      samples in the frame
+ *   4  u16     frame length in bytes, CRC included
+ *   6  varint  sequence number of the first sample
+ *      varint  timestamp of the first sample
+ *      samples, each:
+ *        u8      ZMOD4XXX_BATCH_F_* flags
+ *        varint  sequence gap - 1, only with ZMOD4XXX_BATCH_F_GAP
+ *        svarint timestamp delta of delta
+ *        svarint per channel, value minus the value of the previous sample
+ *   n  u16     CRC-16/CCITT-FALSE of bytes 0..n-1
+ *
+ * varint is LEB128, svarint the zigzag of a signed value as varint. The
+ * first sample is encoded against a sequence gap of 1, a timestamp delta
+ * of 0 and values of 0. Values are the fixed-point integers of
+ * struct rt_sensor_data: IAQ in 0.1, TVOC in ug/m^3, EtOH in ppb, eCO2 in
+ * ppm. A decoder accepts any frame of its version and skips channels it
+ * does not know.
+ */
+#define ZMOD4XXX_BATCH_MAGIC    (0x5A)
+#define ZMOD4XXX_BATCH_VERSION  (1)
+#define ZMOD4XXX_BATCH_CH_MAX   (4) /**< IAQ, TVOC, EtOH, eCO2 */
+#define ZMOD4XXX_BATCH_HDR_LEN  (6)
+#define ZMOD4XXX_BATCH_SAMPLE_MAX_LEN (1 + 5 + 5 + 5 * ZMOD4XXX_BATCH_CH_MAX)
+
+#define ZMOD4XXX_BATCH_F_VALID       (1 << 0) /**< algorithm output is valid */
+#define ZMOD4XXX_BATCH_F_STABILIZING (1 << 1) /**< algorithm is stabilizing */
+#define ZMOD4XXX_BATCH_F_HEALTH      (1 << 2) /**< a health flag is raised, see zmod4xxx_health.h */
+#define ZMOD4XXX_BATCH_F_GAP         (1 << 7) /**< sequence numbers were skipped */
+/* flags a sample carries, the others belong to the encoding */
+#define ZMOD4XXX_BATCH_F_SAMPLE      (ZMOD4XXX_BATCH_F_VALID | ZMOD4XXX_BATCH_F_STABILIZING | \
+                                      ZMOD4XXX_BATCH_F_HEALTH)
+
+#define ERROR_BATCH_SPACE  ((zmod4xxx_err)-17) /**< the sample does not fit */
+#define ERROR_BATCH_FORMAT ((zmod4xxx_err)-18) /**< not a valid frame */
+
+/**
+ * @brief One sample of a batch
+ */
+typedef struct {
+    uint32_t seq; /**< sequence number, increasing */
+    uint32_t ts; /**< timestamp, e.g. rt_sensor_get_ts() */
+    uint8_t flags; /**< ZMOD4XXX_BATCH_F_SAMPLE bits */
+    int32_t v[ZMOD4XXX_BATCH_CH_MAX]; /**< fixed-point values */
+} zmod4xxx_batch_sample_t;
+
+/**
+ * @brief Encoder writing one frame into a caller buffer
+ */
+typedef struct {
+    uint8_t *buf;
+    uint32_t cap;
+    uint32_t len;
+    uint8_t count;
+    uint32_t prev_seq;
+    uint32_t prev_ts;
+    int32_t prev_delta;
+    int32_t prev_v[ZMOD4XXX_BATCH_CH_MAX];
+} zmod4xxx_batch_enc_t;
+
+/**
+ * @brief Decoder reading one frame in place
+ */
+typedef struct {
+    const uint8_t *buf;
+    uint32_t len; /**< frame length without the CRC */
+    uint32_t pos;
+    uint8_t channels;
+    uint8_t count;
+    uint8_t index;
+    zmod4xxx_batch_sample_t prev;
+    int32_t prev_delta;
+} zmod4xxx_batch_dec_t;
+
+/**
+ * @brief   Start a frame
+ * @param   [out] enc encoder
+ * @param   [in] buf buffer the frame is built in
+ * @param   [in] cap size of buf, at most 65535 is used
+ * @return  error code
+ */
+zmod4xxx_err zmod4xxx_batch_begin(zmod4xxx_batch_enc_t *enc, uint8_t *buf, uint32_t cap);
+
+/**
+ * @brief   Append a sample
+ * @param   [in,out] enc encoder
+ * @param   [in] s sample
+ * @return  error code
+ * @retval  0 success
+ * @retval  ERROR_BATCH_SPACE frame is full, the sample was not added
+ */
+zmod4xxx_err zmod4xxx_batch_add(zmod4xxx_batch_enc_t *enc, const zmod4xxx_batch_sample_t *s);
+
+/**
+ * @brief   Close the frame
+ * @param   [in,out] enc encoder
+ * @return  length of the frame in buf, 0 if it has no samples
+ */
+uint32_t zmod4xxx_batch_end(zmod4xxx_batch_enc_t *enc);
+
+/**
+ * @brief   Check a frame and prepare to decode it
+ * @param   [out] dec decoder
+ * @param   [in] buf frame
+ * @param   [in] len bytes available in buf, may be more than the frame
+ * @param   [out] frame_len length of the frame, may be NULL
+ * @return  error code
+ * @retval  0 success
+ * @retval  ERROR_BATCH_FORMAT bad magic, version, length or CRC
+ */
+zmod4xxx_err zmod4xxx_batch_open(zmod4xxx_batch_dec_t *dec, const uint8_t *buf,
+                                 uint32_t len, uint32_t *frame_len);
+
+/**
+ * @brief   Decode the next sample
+ * @param   [in,out] dec decoder
+ * @param   [out] s sample; channels the frame lacks are 0
+ * @return  1 for a sample, 0 at the end of the frame, ERROR_BATCH_FORMAT
+ */
+int8_t zmod4xxx_batch_next(zmod4xxx_batch_dec_t *dec, zmod4xxx_batch_sample_t *s);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _ZMOD4XXX_BATCH_H */
@@ -0,0 +1,322 @@
+/*
+ * Copyright (c) 2006-2021, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-19     Sherman      first version
+ * 2026-10-19     Sherman      a sleep inside a section is a violation
+ * 2026-10-19     Sherman      add zmod4xxx_bus_held()
+ */
+
+/*
+ * Bus arbitration. Every transaction takes the lock of its bus for itself
+ * alone, and a section keeps it over a few transactions that belong
+ * together. The wait of a sensor, seconds of delay_ms, belongs outside of
+ * any section; the delay wrapper asserts that the calling thread holds no
+ * lock and counts it when it does. Nesting is counted here, so the lock of
+ * the HAL need not be recursive. Define ZMOD4XXX_BUS_ASSERT, e.g. to
+ * RT_ASSERT, to route the check to the assert of the system.
+ */
+
+#ifndef ZMOD4XXX_USING_BUS
+#define ZMOD4XXX_USING_BUS
+#endif
+
+#include <stddef.h>
+#include <string.h>
+
+#include "zmod4xxx_bus.h"
+
+#ifndef ZMOD4XXX_BUS_ASSERT
+#include <assert.h>
+#define ZMOD4XXX_BUS_ASSERT(x) assert(x)
+#endif
+
+struct bus_slot
+{
+    uint8_t used;
+    uint8_t i2c_addr;
+    zmod4xxx_bus_t *bus;
+    zmod4xxx_i2c_ptr_t read;
+    zmod4xxx_i2c_ptr_t write;
+};
+
+static struct bus_slot bus_slots[ZMOD4XXX_BUS_DEV_MAX];
+static zmod4xxx_bus_t *bus_list[ZMOD4XXX_BUS_MAX];
+static zmod4xxx_delay_ptr_p bus_sleep;
+
+static struct bus_slot *bus_find(uint8_t i2c_addr)
+{
+    uint8_t i;
+
+    for (i = 0; i < ZMOD4XXX_BUS_DEV_MAX; i++)
+    {
+        if (bus_slots[i].used && bus_slots[i].i2c_addr == i2c_addr)
+        {
+            return &bus_slots[i];
+        }
+    }
+    return NULL;
+}
+
+static uint32_t bus_now(const zmod4xxx_bus_t *bus)
+{
+    return bus->ops.clock_us ? bus->ops.clock_us() : 0;
+}
+
+static uint8_t bus_bucket(uint32_t us)
+{
+    uint8_t b = 0;
+
+    while (us && b < ZMOD4XXX_BUS_BUCKETS - 1)
+    {
+        us >>= 1;
+        b++;
+    }
+    return b;
+}
+
+/* statistics are only written with the lock held */
+static zmod4xxx_err bus_lock(zmod4xxx_bus_t *bus)
+{
+    void *self = bus->ops.self();
+    uint32_t t0, t1, us;
+    uint8_t contended = 0;
+
+    if (bus->owner == self)
+    {
+        bus->depth++;
+        return ZMOD4XXX_OK;
+    }
+    t0 = bus_now(bus);
+    if (bus->ops.take(bus->ops.ctx, 0))
+    {
+        contended = 1;
+        if (bus->ops.take(bus->ops.ctx, ZMOD4XXX_BUS_TIMEOUT_MS))
+        {
+            /* not ours to count under the lock; a lost count is harmless */
+            bus->stats.timeouts++;
+            return ERROR_BUS_TIMEOUT;
+        }
+    }
+    t1 = bus_now(bus);
+    bus->owner = self;
+    bus->depth = 1;
+    bus->taken_us = t1;
+
+    us = t1 - t0;
+    bus->stats.locks++;
+    bus->stats.contended += contended;
+    bus->stats.wait_us += us;
+    bus->stats.wait_max_us = us > bus->stats.wait_max_us ? us : bus->stats.wait_max_us;
+    bus->stats.wait_hist[bus_bucket(us)]++;
+    return ZMOD4XXX_OK;
+}
+
+static void bus_unlock(zmod4xxx_bus_t *bus)
+{
+    uint32_t us;
+
+    if (bus->owner != bus->ops.self() || --bus->depth)
+    {
+        return;
+    }
+    us = bus_now(bus) - bus->taken_us;
+    bus->stats.hold_us += us;
+    bus->stats.hold_max_us = us > bus->stats.hold_max_us ? us : bus->stats.hold_max_us;
+    bus->stats.hold_hist[bus_bucket(us)]++;
+    bus->owner = NULL;
+    bus->ops.release(bus->ops.ctx);
+}
+
+static int8_t bus_transfer(uint8_t i2c_addr, uint8_t reg_addr,
+                           uint8_t *data_buf, uint8_t len, uint8_t write)
+{
+    struct bus_slot *slot = bus_find(i2c_addr);
+    int8_t ret;
+
+    if (slot == NULL)
+    {
+        return ERROR_I2C;
+    }
+    ret = bus_lock(slot->bus);
+    if (ret)
+    {
+        return ret;
+    }
+    ret = write ? slot->write(i2c_addr, reg_addr, data_buf, len)
+                : slot->read(i2c_addr, reg_addr, data_buf, len);
+    bus_unlock(slot->bus);
+    return ret;
+}
+
+static int8_t bus_read(uint8_t i2c_addr, uint8_t reg_addr,
+                       uint8_t *data_buf, uint8_t len)
+{
+    return bus_transfer(i2c_addr, reg_addr, data_buf, len, 0);
+}
+
+static int8_t bus_write(uint8_t i2c_addr, uint8_t reg_addr,
+                        uint8_t *data_buf, uint8_t len)
+{
+    return bus_transfer(i2c_addr, reg_addr, data_buf, len, 1);
+}
+
+static void bus_delay_ms(uint32_t ms)
+{
+    zmod4xxx_bus_t *bus;
+    uint8_t i;
+
+    for (i = 0; i < ZMOD4XXX_BUS_MAX; i++)
+    {
+        bus = bus_list[i];
+        if (bus != NULL && bus->owner == bus->ops.self())
+        {
+            /* counted under the lock, which stays held for the section */
+            bus->stats.sleep_violations++;
+            ZMOD4XXX_BUS_ASSERT(bus->owner != bus->ops.self());
+        }
+    }
+    bus_sleep(ms);
+}
+
+void zmod4xxx_bus_init(zmod4xxx_bus_t *bus, const char *name, const zmod4xxx_bus_ops_t *ops)
+{
+    memset(bus, 0, sizeof(*bus));
+    bus->name = name;
+    bus->ops = *ops;
+}
+
+zmod4xxx_err zmod4xxx_bus_attach(zmod4xxx_dev_t *dev, zmod4xxx_bus_t *bus)
+{
+    struct bus_slot *slot;
+    uint8_t i, b = ZMOD4XXX_BUS_MAX;
+
+    if (dev == NULL || bus == NULL || dev->read == NULL || dev->write == NULL ||
+        dev->delay_ms == NULL || bus->ops.take == NULL || bus->ops.release == NULL ||
+        bus->ops.self == NULL)
+    {
+        return ERROR_NULL_PTR;
+    }
+    if (dev->read == bus_read)
+    {
+        return ZMOD4XXX_OK;
+    }
+    if (bus_sleep != NULL && dev->delay_ms != bus_sleep && dev->delay_ms != bus_delay_ms)
+    {
+        return ERROR_INIT_OUT_OF_RANGE;
+    }
+
+    for (i = 0; i < ZMOD4XXX_BUS_MAX; i++)
+    {
+        if (bus_list[i] == bus || (bus_list[i] == NULL && b == ZMOD4XXX_BUS_MAX))
+        {
+            b = i;
+        }
+    }
+    slot = bus_find(dev->i2c_addr);
+    for (i = 0; slot == NULL && i < ZMOD4XXX_BUS_DEV_MAX; i++)
+    {
+        if (!bus_slots[i].used)
+        {
+            slot = &bus_slots[i];
+        }
+    }
+    if (slot == NULL || b == ZMOD4XXX_BUS_MAX)
+    {
+        return ERROR_INIT_OUT_OF_RANGE;
+    }
+
+    bus_list[b] = bus;
+    slot->read = dev->read;
+    slot->write = dev->write;
+    slot->bus = bus;
+    slot->i2c_addr = dev->i2c_addr;
+    slot->used = 1;
+    if (dev->delay_ms != bus_delay_ms)
+    {
+        bus_sleep = dev->delay_ms;
+    }
+
+    dev->read = bus_read;
+    dev->write = bus_write;
+    dev->delay_ms = bus_delay_ms;
+    return ZMOD4XXX_OK;
+}
+
+void zmod4xxx_bus_detach(zmod4xxx_dev_t *dev)
+{
+    struct bus_slot *slot = bus_find(dev->i2c_addr);
+
+    if (slot == NULL)
+    {
+        return;
+    }
+    if (dev->read == bus_read)
+    {
+        dev->read = slot->read;
+        dev->write = slot->write;
+        dev->delay_ms = bus_sleep;
+    }
+    slot->used = 0;
+}
+
+zmod4xxx_err zmod4xxx_bus_begin(zmod4xxx_dev_t *dev)
+{
+    struct bus_slot *slot = bus_find(dev->i2c_addr);
+    zmod4xxx_err ret;
+
+    if (slot == NULL)
+    {
+        return ZMOD4XXX_OK;
+    }
+    ret = bus_lock(slot->bus);
+    if (!ret)
+    {
+        slot->bus->stats.sections++;
+    }
+    return ret;
+}
+
+void zmod4xxx_bus_end(zmod4xxx_dev_t *dev)
+{
+    struct bus_slot *slot = bus_find(dev->i2c_addr);
+
+    if (slot != NULL)
+    {
+        bus_unlock(slot->bus);
+    }
+}
+
+uint8_t zmod4xxx_bus_held(uint8_t i2c_addr)
+{
+    struct bus_slot *slot = bus_find(i2c_addr);
+
+    return slot != NULL && slot->bus->owner == slot->bus->ops.self();
+}
+
+void zmod4xxx_bus_get(zmod4xxx_bus_t *bus, zmod4xxx_bus_stats_t *st)
+{
+    uint8_t locked = bus->owner != bus->ops.self() &&
+                     bus->ops.take(bus->ops.ctx, ZMOD4XXX_BUS_TIMEOUT_MS) == 0;
+
+    *st = bus->stats;
+    if (locked)
+    {
+        bus->ops.release(bus->ops.ctx);
+    }
+}
+
+void zmod4xxx_bus_reset(zmod4xxx_bus_t *bus)
+{
+    uint8_t locked = bus->owner != bus->ops.self() &&
+                     bus->ops.take(bus->ops.ctx, ZMOD4XXX_BUS_TIMEOUT_MS) == 0;
+
+    memset(&bus->stats, 0, sizeof(bus->stats));
+    if (locked)
+    {
+        bus->ops.release(bus->ops.ctx);
+    }
+}
@@ -0,0 +1,173 @@
+/*
+ * Copyright (c) 2006-2021, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-19     Sherman      first version
+ * 2026-10-19     Sherman      a sleep inside a section is a violation
+ * 2026-10-19     Sherman      ERROR_BUS_TIMEOUT moves to zmod4xxx_err
+ * 2026-10-19     Sherman      add zmod4xxx_bus_held()
+ */
+
+#ifndef _ZMOD4XXX_BUS_H
+#define _ZMOD4XXX_BUS_H
+
+#include "zmod4xxx_types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define ZMOD4XXX_BUS_DEV_MAX    (4)  /**< devices that can be attached */
+#define ZMOD4XXX_BUS_MAX        (2)  /**< buses the devices can be on */
+#define ZMOD4XXX_BUS_BUCKETS    (20) /**< wait and hold time buckets */
+#ifndef ZMOD4XXX_BUS_TIMEOUT_MS
+#define ZMOD4XXX_BUS_TIMEOUT_MS (1000) /**< longest wait for the lock */
+#endif
+
+/**
+ * @brief Lock of a bus, from the HAL
+ *
+ * The lock should be the one every driver of the bus takes, e.g. the mutex
+ * of the bus device, so that other devices are arbitrated too. It need not
+ * be recursive; a lock with priority inheritance keeps a low priority
+ * sensor thread from delaying a high priority user of the bus.
+ */
+typedef struct {
+    /** take the lock, 0 on success; timeout_ms 0 tries without waiting */
+    int8_t (*take)(void *ctx, uint32_t timeout_ms);
+    void (*release)(void *ctx); /**< release the lock */
+    void *(*self)(void); /**< the calling thread */
+    uint32_t (*clock_us)(void); /**< microsecond clock, may be NULL */
+    void *ctx; /**< passed to take and release */
+} zmod4xxx_bus_ops_t;
+
+/**
+ * @brief Lock statistics of one bus
+ *
+ * hist[0] counts times below 1 us, hist[k] those in [2^(k-1), 2^k) us, and
+ * the last bucket everything above. Only the outermost lock of a thread is
+ * counted; a section and the transactions in it are one hold.
+ */
+typedef struct {
+    uint32_t locks; /**< times the lock was taken */
+    uint32_t contended; /**< of them, times it was not free at once */
+    uint32_t timeouts; /**< times it was not free within ZMOD4XXX_BUS_TIMEOUT_MS */
+    uint32_t sections; /**< atomic sections begun */
+    uint32_t sleep_violations; /**< delay_ms inside a section, slept with the lock held */
+    uint32_t wait_max_us; /**< longest wait */
+    uint32_t hold_max_us; /**< longest hold */
+    uint64_t wait_us; /**< total wait */
+    uint64_t hold_us; /**< total hold */
+    uint32_t wait_hist[ZMOD4XXX_BUS_BUCKETS];
+    uint32_t hold_hist[ZMOD4XXX_BUS_BUCKETS];
+} zmod4xxx_bus_stats_t;
+
+/**
+ * @brief One bus shared by the attached devices and other drivers
+ */
+typedef struct {
+    const char *name; /**< for reports */
+    zmod4xxx_bus_ops_t ops;
+    void *volatile owner; /**< thread holding the lock, NULL if none of ours */
+    uint16_t depth; /**< nesting of the owner */
+    uint32_t taken_us; /**< clock when the owner took the lock */
+    zmod4xxx_bus_stats_t stats;
+} zmod4xxx_bus_t;
+
+#ifdef ZMOD4XXX_USING_BUS
+
+/**
+ * @brief   Set up a bus
+ * @param   [out] bus bus
+ * @param   [in] name name for reports
+ * @param   [in] ops lock of the bus, copied
+ */
+void zmod4xxx_bus_init(zmod4xxx_bus_t *bus, const char *name, const zmod4xxx_bus_ops_t *ops);
+
+/**
+ * @brief   Lock the bus around every transaction of a device
+ * @param   [in,out] dev device with read, write and delay_ms set up; they
+ *          are replaced by locking wrappers
+ * @param   [in] bus bus the device is on
+ * @return  error code
+ * @retval  0 success
+ * @retval  "!= 0" error
+ * @note    Devices are told apart by I2C address and have to share one
+ *          delay_ms. Attach before zmod4xxx_stats_attach() and
+ *          zmod4xxx_retry_attach(), so the lock covers single attempts and
+ *          is free during a retry backoff. Inside a section the lock stays
+ *          held, so the retry layer retries there without a backoff.
+ */
+zmod4xxx_err zmod4xxx_bus_attach(zmod4xxx_dev_t *dev, zmod4xxx_bus_t *bus);
+
+/**
+ * @brief   Restore the original bus functions of a device
+ * @param   [in,out] dev pointer to the device
+ */
+void zmod4xxx_bus_detach(zmod4xxx_dev_t *dev);
+
+/**
+ * @brief   Begin a section of transactions no other user of the bus may
+ *          come between, e.g. the tables and the command of a run
+ * @param   [in] dev pointer to the device
+ * @return  error code
+ * @retval  0 success, also for a device that is not attached
+ * @retval  ERROR_BUS_TIMEOUT the lock was not free in time
+ * @note    Sections nest. A section must not contain a delay_ms, as
+ *          the other users of the bus would wait through it. A delay_ms
+ *          inside one fails ZMOD4XXX_BUS_ASSERT() and is counted in
+ *          sleep_violations; the lock is kept, since dropping it would
+ *          let another user between the transactions of the section.
+ */
+zmod4xxx_err zmod4xxx_bus_begin(zmod4xxx_dev_t *dev);
+
+/**
+ * @brief   End a section begun with zmod4xxx_bus_begin()
+ * @param   [in] dev pointer to the device
+ */
+void zmod4xxx_bus_end(zmod4xxx_dev_t *dev);
+
+/**
+ * @brief   Whether the calling thread holds the bus of a device
+ * @param   [in] i2c_addr address of the device
+ * @return  1 inside a section of the device or of another one on its bus,
+ *          0 otherwise and for a device that is not attached
+ */
+uint8_t zmod4xxx_bus_held(uint8_t i2c_addr);
+
+/**
+ * @brief   Get a copy of the statistics of a bus
+ * @param   [in] bus bus
+ * @param   [out] st statistics
+ */
+void zmod4xxx_bus_get(zmod4xxx_bus_t *bus, zmod4xxx_bus_stats_t *st);
+
+/**
+ * @brief   Clear the statistics of a bus
+ * @param   [in] bus bus
+ */
+void zmod4xxx_bus_reset(zmod4xxx_bus_t *bus);
+
+#define ZMOD4XXX_BUS_BEGIN(dev) zmod4xxx_bus_begin(dev)
+#define ZMOD4XXX_BUS_END(dev)   zmod4xxx_bus_end(dev)
+
+#else
+
+#define zmod4xxx_bus_attach(dev, bus)   (ZMOD4XXX_OK)
+#define zmod4xxx_bus_detach(dev)        ((void)0)
+
+#define zmod4xxx_bus_held(i2c_addr)     (0U)
+
+#define ZMOD4XXX_BUS_BEGIN(dev)         (ZMOD4XXX_OK)
+#define ZMOD4XXX_BUS_END(dev)           ((void)0)
+
+#endif /* ZMOD4XXX_USING_BUS */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _ZMOD4XXX_BUS_H */
@@ -0,0 +1,179 @@
+/*
+ * Copyright (c) 2006-2021, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-19     Sherman      first version
+ */
+
+/*
+ * Cleaning job around zmod4xxx_cleaning_run(). The library call runs the
+ * whole procedure in one go and reports nothing while it does, so the job
+ * only adds what the caller cannot: a record in non-volatile storage that
+ * is written before and after a run, and progress from the clock against
+ * the nominal run time. A run cannot be continued from where a reset cut
+ * it; it is found in the record and started again.
+ */
+
+#ifndef ZMOD4XXX_USING_CLEAN
+#define ZMOD4XXX_USING_CLEAN
+#endif
+
+#include <stddef.h>
+#include <string.h>
+
+#include "zmod4xxx_clean.h"
+#include "zmod4xxx_cleaning.h"
+
+static uint32_t clean_crc32(const uint8_t *buf, uint32_t len)
+{
+    uint32_t crc = 0xFFFFFFFFUL;
+    uint8_t k;
+
+    while (len--)
+    {
+        crc ^= *buf++;
+        for (k = 0; k < 8; k++)
+        {
+            crc = (crc >> 1) ^ (0xEDB88320UL & (0U - (crc & 1)));
+        }
+    }
+    return ~crc;
+}
+
+static uint32_t clean_rec_crc(const zmod4xxx_clean_rec_t *rec)
+{
+    return clean_crc32((const uint8_t *)rec, offsetof(zmod4xxx_clean_rec_t, crc));
+}
+
+static zmod4xxx_err clean_store(zmod4xxx_clean_t *c)
+{
+    c->rec.crc = clean_rec_crc(&c->rec);
+    if (c->nv.store(c->nv.ctx, &c->rec, sizeof(c->rec)))
+    {
+        return ERROR_CLEAN_NV;
+    }
+    return ZMOD4XXX_OK;
+}
+
+zmod4xxx_err zmod4xxx_clean_init(zmod4xxx_clean_t *c, zmod4xxx_dev_t *dev,
+                                 const zmod4xxx_clean_nv_t *nv,
+                                 uint32_t (*clock_ms)(void))
+{
+    uint8_t track[ZMOD4XXX_LEN_TRACKING];
+    zmod4xxx_err ret;
+
+    memset(c, 0, sizeof(*c));
+    c->dev = dev;
+    c->nv = *nv;
+    c->clock_ms = clock_ms;
+
+    ret = zmod4xxx_read_tracking_number(dev, track);
+    if (ret)
+    {
+        return ret;
+    }
+    if (c->nv.load(c->nv.ctx, &c->rec, sizeof(c->rec)) ||
+        c->rec.magic != ZMOD4XXX_CLEAN_MAGIC || c->rec.version != ZMOD4XXX_CLEAN_VERSION ||
+        c->rec.crc != clean_rec_crc(&c->rec) ||
+        memcmp(c->rec.track, track, sizeof(track)))
+    {
+        memset(&c->rec, 0, sizeof(c->rec));
+        c->rec.magic = ZMOD4XXX_CLEAN_MAGIC;
+        c->rec.version = ZMOD4XXX_CLEAN_VERSION;
+        c->rec.state = ZMOD4XXX_CLEAN_NONE;
+        memcpy(c->rec.track, track, sizeof(track));
+    }
+    return ZMOD4XXX_OK;
+}
+
+zmod4xxx_err zmod4xxx_clean_run(zmod4xxx_clean_t *c)
+{
+    zmod4xxx_err ret;
+
+    if (c->rec.state == ZMOD4XXX_CLEAN_DONE)
+    {
+        return ZMOD4XXX_OK;
+    }
+    if (c->rec.attempts >= ZMOD4XXX_CLEAN_ATTEMPTS_MAX)
+    {
+        if (c->rec.state != ZMOD4XXX_CLEAN_FAILED)
+        {
+            /* the last attempt was interrupted */
+            c->rec.state = ZMOD4XXX_CLEAN_FAILED;
+            clean_store(c);
+        }
+        return ERROR_CLEANING;
+    }
+
+    c->rec.state = ZMOD4XXX_CLEAN_RUNNING;
+    c->rec.attempts++;
+    ret = clean_store(c);
+    if (ret)
+    {
+        /* without the record a reset could run it once more unnoticed */
+        c->rec.attempts--;
+        c->rec.state = ZMOD4XXX_CLEAN_NONE;
+        return ret;
+    }
+
+    c->start_ms = c->clock_ms();
+    c->busy = 1;
+    ret = (zmod4xxx_err)zmod4xxx_cleaning_run(c->dev);
+    c->rec.elapsed_ms = c->clock_ms() - c->start_ms;
+    c->rec.result = ret;
+    if (ret == ZMOD4XXX_OK)
+    {
+        c->rec.state = ZMOD4XXX_CLEAN_DONE;
+    }
+    else
+    {
+        c->rec.state = c->rec.attempts >= ZMOD4XXX_CLEAN_ATTEMPTS_MAX ?
+                       ZMOD4XXX_CLEAN_FAILED : ZMOD4XXX_CLEAN_NONE;
+    }
+    /* a DONE that is not stored is done for this boot; the next boot finds
+     * RUNNING and runs again, like after a reset */
+    if (clean_store(c) && ret == ZMOD4XXX_OK)
+    {
+        ret = ERROR_CLEAN_NV;
+    }
+    c->busy = 0;
+    return ret;
+}
+
+zmod4xxx_err zmod4xxx_clean_ready(const zmod4xxx_clean_t *c)
+{
+    return c->rec.state == ZMOD4XXX_CLEAN_DONE && !c->busy ? ZMOD4XXX_OK
+                                                           : ERROR_CLEAN_PENDING;
+}
+
+void zmod4xxx_clean_progress(const zmod4xxx_clean_t *c, zmod4xxx_clean_progress_t *p)
+{
+    uint32_t elapsed;
+
+    memset(p, 0, sizeof(*p));
+    p->busy = c->busy;
+    p->state = c->rec.state;
+    p->attempts = c->rec.attempts;
+    p->result = c->rec.result;
+    if (!p->busy)
+    {
+        p->elapsed_ms = c->rec.elapsed_ms;
+        p->percent = p->state == ZMOD4XXX_CLEAN_DONE ? 100 : 0;
+        return;
+    }
+
+    elapsed = c->clock_ms() - c->start_ms;
+    p->elapsed_ms = elapsed;
+    if (elapsed < ZMOD4XXX_CLEAN_DURATION_MS)
+    {
+        p->eta_ms = ZMOD4XXX_CLEAN_DURATION_MS - elapsed;
+        p->percent = (uint8_t)((uint64_t)elapsed * 100 / ZMOD4XXX_CLEAN_DURATION_MS);
+    }
+    if (p->percent > 99 || elapsed >= ZMOD4XXX_CLEAN_DURATION_MS)
+    {
+        p->percent = 99;
+    }
+}
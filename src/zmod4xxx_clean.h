@@ -0,0 +1,155 @@
+/*
+ * Copyright (c) 2006-2021, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-19     Sherman      first version
+ */
+
+#ifndef _ZMOD4XXX_CLEAN_H
+#define _ZMOD4XXX_CLEAN_H
+
+#include "zmod4xxx.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define ZMOD4XXX_CLEAN_MAGIC   (0x435A) /**< "ZC" */
+#define ZMOD4XXX_CLEAN_VERSION (1)
+
+#ifndef ZMOD4XXX_CLEAN_DURATION_MS
+#define ZMOD4XXX_CLEAN_DURATION_MS  (600000) /**< run time of the procedure, for the ETA */
+#endif
+#ifndef ZMOD4XXX_CLEAN_ATTEMPTS_MAX
+#define ZMOD4XXX_CLEAN_ATTEMPTS_MAX (3) /**< runs started before giving up */
+#endif
+
+#define ERROR_CLEAN_PENDING ((zmod4xxx_err)-19) /**< the sensor is not cleaned yet */
+#define ERROR_CLEAN_NV      ((zmod4xxx_err)-20) /**< the record could not be stored */
+
+/**
+ * @brief State of the cleaning of one sensor
+ */
+typedef enum {
+    ZMOD4XXX_CLEAN_NONE = 0, /**< not run, or a run failed and may be retried */
+    ZMOD4XXX_CLEAN_RUNNING = 1, /**< started; found after a reset: interrupted */
+    ZMOD4XXX_CLEAN_DONE = 2, /**< cleaned, measurements may start */
+    ZMOD4XXX_CLEAN_FAILED = 3, /**< ZMOD4XXX_CLEAN_ATTEMPTS_MAX runs failed */
+} zmod4xxx_clean_state;
+
+/**
+ * @brief Non-volatile storage of the record, functions return 0 on success
+ *
+ * store() replaces the whole record, e.g. erase and program of a small
+ * flash partition or an EEPROM write.
+ */
+typedef struct {
+    int (*load)(void *ctx, void *buf, uint32_t len);
+    int (*store)(void *ctx, const void *buf, uint32_t len);
+    void *ctx; /**< passed to the functions */
+} zmod4xxx_clean_nv_t;
+
+/**
+ * @brief Record as stored, tied to the sensor by its tracking number
+ */
+typedef struct {
+    uint16_t magic; /**< ZMOD4XXX_CLEAN_MAGIC */
+    uint8_t version; /**< ZMOD4XXX_CLEAN_VERSION */
+    uint8_t state; /**< zmod4xxx_clean_state */
+    uint8_t track[ZMOD4XXX_LEN_TRACKING]; /**< tracking number of the sensor */
+    uint8_t attempts; /**< runs started */
+    int8_t result; /**< error of the last run, 0 if none */
+    uint32_t elapsed_ms; /**< run time of the last finished run */
+    uint32_t crc; /**< CRC-32 of the record with this field 0 */
+} zmod4xxx_clean_rec_t;
+
+/**
+ * @brief Progress of a cleaning job
+ */
+typedef struct {
+    uint8_t state; /**< zmod4xxx_clean_state */
+    uint8_t busy; /**< a run is in progress */
+    uint8_t attempts; /**< runs started */
+    uint8_t percent; /**< 0..100, held at 99 until the run returns */
+    int8_t result; /**< error of the last run */
+    uint32_t elapsed_ms; /**< time in the current or the last run */
+    uint32_t eta_ms; /**< time left, 0 if not running */
+} zmod4xxx_clean_progress_t;
+
+/**
+ * @brief Cleaning job of one sensor
+ */
+typedef struct {
+    zmod4xxx_dev_t *dev;
+    zmod4xxx_clean_nv_t nv;
+    uint32_t (*clock_ms)(void);
+    zmod4xxx_clean_rec_t rec; /**< record as last stored */
+    uint32_t start_ms; /**< clock at the start of the current run */
+    volatile uint8_t busy; /**< a run is in progress */
+} zmod4xxx_clean_t;
+
+#ifdef ZMOD4XXX_USING_CLEAN
+
+/**
+ * @brief   Load the record of a sensor
+ * @param   [out] c job
+ * @param   [in] dev device after zmod4xxx_read_sensor_info()
+ * @param   [in] nv storage of the record, copied
+ * @param   [in] clock_ms millisecond clock for progress
+ * @return  error code
+ * @retval  0 success; a missing or damaged record, or one of another
+ *          sensor, starts over with ZMOD4XXX_CLEAN_NONE
+ * @retval  "!= 0" the tracking number could not be read
+ */
+zmod4xxx_err zmod4xxx_clean_init(zmod4xxx_clean_t *c, zmod4xxx_dev_t *dev,
+                                 const zmod4xxx_clean_nv_t *nv,
+                                 uint32_t (*clock_ms)(void));
+
+/**
+ * @brief   Run the cleaning procedure unless the record says it is done
+ * @param   [in,out] c job
+ * @return  error code
+ * @retval  0 the sensor is cleaned
+ * @retval  ERROR_CLEAN_NV the start could not be recorded, nothing was run
+ * @retval  ERROR_CLEANING ZMOD4XXX_CLEAN_ATTEMPTS_MAX runs failed
+ * @retval  "!= 0" error of zmod4xxx_cleaning_run()
+ * @note    Blocks for about ten minutes in the delays of the device, so
+ *          call it from a thread of its own; jobs of different sensors can
+ *          run side by side. The start is stored before the procedure runs,
+ *          so a run cut short by a reset is found and run again, counted
+ *          against the attempts. The sensor has to be prepared again
+ *          afterwards, zmod4xxx_prepare_sensor().
+ */
+zmod4xxx_err zmod4xxx_clean_run(zmod4xxx_clean_t *c);
+
+/**
+ * @brief   Check whether measurements may start
+ * @param   [in] c job
+ * @return  0 if the sensor is cleaned, else ERROR_CLEAN_PENDING
+ */
+zmod4xxx_err zmod4xxx_clean_ready(const zmod4xxx_clean_t *c);
+
+/**
+ * @brief   Get the progress of a job, from any thread
+ * @param   [in] c job
+ * @param   [out] p progress
+ */
+void zmod4xxx_clean_progress(const zmod4xxx_clean_t *c, zmod4xxx_clean_progress_t *p);
+
+#else
+
+#define zmod4xxx_clean_init(c, dev, nv, clock_ms)   (ZMOD4XXX_OK)
+#define zmod4xxx_clean_run(c)                       (ZMOD4XXX_OK)
+#define zmod4xxx_clean_ready(c)                     (ZMOD4XXX_OK)
+#define zmod4xxx_clean_progress(c, p)               ((void)0)
+
+#endif /* ZMOD4XXX_USING_CLEAN */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _ZMOD4XXX_CLEAN_H */
@@ -0,0 +1,503 @@
+/*
+ * Copyright (c) 2006-2021, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-19     Sherman      first version
+ */
+
+/*
+ * C++20 coroutine API for hosts that drive many sensors, e.g. a gateway or
+ * a simulation. The measurement cycle is written as straight-line code
+ *
+ *   for (;;)
+ *   {
+ *       co_await dev.start();
+ *       co_await dev.sequencer_done();
+ *       co_await dev.read_frame(frame);
+ *       co_await dev.sleep(ZMOD4410_IAQ2_WAIT_MS);
+ *   }
+ *
+ * and every wait that blocks in delay_ms in C is a timer on an executor
+ * instead. Bus transfers stay synchronous: at 400 kHz they take tens of
+ * microseconds, the waits seconds. An executor is single-threaded; to use
+ * more cores run one per thread and split the sensors between them.
+ *
+ * Waiting costs no allocation: awaiters live in the coroutine frame and the
+ * status polling reschedules itself from the timer queue. The only
+ * allocation is the frame of each top-level task, counted in frame_stats.
+ *
+ * Keep to one co_await per statement; GCC 12 jumps to a bad resume point
+ * for co_await in the operands of || and &&.
+ */
+
+#ifndef _ZMOD4XXX_CO_HPP
+#define _ZMOD4XXX_CO_HPP
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <new>
+#include <thread>
+#include <vector>
+
+#include "zmod4xxx.h"
+#include "zmod4410_config_iaq2.h"
+
+namespace zmod4xxx::co
+{
+
+/**
+ * @brief Coroutine frames allocated by all tasks, in all threads
+ */
+struct frame_stats
+{
+    static inline std::atomic<uint64_t> live_bytes{0};
+    static inline std::atomic<uint64_t> live_frames{0};
+    static inline std::atomic<uint64_t> total_frames{0};
+};
+
+class executor;
+
+/**
+ * @brief A top-level coroutine, started and owned by an executor
+ */
+class task
+{
+public:
+    struct promise_type
+    {
+        executor *ex = nullptr;
+
+        task get_return_object()
+        {
+            return task(std::coroutine_handle<promise_type>::from_promise(*this));
+        }
+        std::suspend_always initial_suspend() noexcept
+        {
+            return {};
+        }
+        std::suspend_always final_suspend() noexcept;
+        void return_void()
+        {
+        }
+        void unhandled_exception()
+        {
+            std::terminate();
+        }
+
+        static void *operator new(std::size_t n)
+        {
+            frame_stats::live_bytes += n;
+            frame_stats::live_frames++;
+            frame_stats::total_frames++;
+            return ::operator new(n);
+        }
+        static void operator delete(void *p, std::size_t n)
+        {
+            frame_stats::live_bytes -= n;
+            frame_stats::live_frames--;
+            ::operator delete(p);
+        }
+    };
+
+    task(task &&other) noexcept : h_(other.h_)
+    {
+        other.h_ = nullptr;
+    }
+    task(const task &) = delete;
+    task &operator=(const task &) = delete;
+    ~task()
+    {
+        if (h_)
+        {
+            h_.destroy();
+        }
+    }
+
+private:
+    friend class executor;
+
+    explicit task(std::coroutine_handle<promise_type> h) : h_(h)
+    {
+    }
+
+    std::coroutine_handle<promise_type> h_;
+};
+
+/**
+ * @brief Single-threaded timer queue that resumes coroutines
+ *
+ * With a virtual clock the executor jumps from one timer to the next, so a
+ * simulated day runs as fast as the host can do the work; with the steady
+ * clock it sleeps until the next timer is due.
+ */
+class executor
+{
+public:
+    using callback_t = void (*)(void *ctx);
+
+    explicit executor(bool virtual_time = true)
+        : virtual_(virtual_time), t0_(std::chrono::steady_clock::now())
+    {
+    }
+    executor(const executor &) = delete;
+    executor &operator=(const executor &) = delete;
+    ~executor()
+    {
+        for (auto h : tasks_)
+        {
+            h.destroy();
+        }
+    }
+
+    /**
+     * @brief   Current time on the executor's clock
+     */
+    uint64_t now_us() const
+    {
+        if (virtual_)
+        {
+            return now_;
+        }
+        return (uint64_t)std::chrono::duration_cast<std::chrono::microseconds>(
+                   std::chrono::steady_clock::now() - t0_).count();
+    }
+
+    /**
+     * @brief   Call fn(ctx) from run() once ms milliseconds have passed
+     */
+    void after(uint32_t ms, callback_t fn, void *ctx)
+    {
+        timers_.push_back({now_us() + ms * 1000ULL, seq_++, fn, ctx});
+        std::push_heap(timers_.begin(), timers_.end(), later);
+    }
+
+    /**
+     * @brief   Take over a task and start it on the next run()
+     */
+    void spawn(task &&t)
+    {
+        auto h = t.h_;
+
+        t.h_ = nullptr;
+        h.promise().ex = this;
+        tasks_.push_back(h);
+        live_++;
+        after(0, resume, h.address());
+    }
+
+    /**
+     * @brief   Awaitable that resumes the caller after ms milliseconds
+     */
+    auto sleep(uint32_t ms)
+    {
+        struct awaiter
+        {
+            executor &ex;
+            uint32_t ms;
+
+            bool await_ready() const noexcept
+            {
+                return false;
+            }
+            void await_suspend(std::coroutine_handle<> h)
+            {
+                ex.after(ms, resume, h.address());
+            }
+            void await_resume() const noexcept
+            {
+            }
+        };
+        return awaiter{*this, ms};
+    }
+
+    /**
+     * @brief   Run timers until every task has finished
+     * @return  number of timers run
+     */
+    uint64_t run()
+    {
+        uint64_t n = 0;
+
+        while (live_ && !timers_.empty())
+        {
+            std::pop_heap(timers_.begin(), timers_.end(), later);
+            timer t = timers_.back();
+            timers_.pop_back();
+            if (virtual_)
+            {
+                now_ = std::max(now_, t.when_us);
+            }
+            else
+            {
+                std::this_thread::sleep_until(t0_ + std::chrono::microseconds(t.when_us));
+            }
+            t.fn(t.ctx);
+            n++;
+        }
+        return n;
+    }
+
+    /**
+     * @brief   Tasks that have not finished
+     */
+    std::size_t live() const
+    {
+        return live_;
+    }
+
+private:
+    friend struct task::promise_type;
+
+    struct timer
+    {
+        uint64_t when_us;
+        uint64_t seq; /* keeps timers due at the same time in order */
+        callback_t fn;
+        void *ctx;
+    };
+
+    static bool later(const timer &a, const timer &b)
+    {
+        return a.when_us != b.when_us ? a.when_us > b.when_us : a.seq > b.seq;
+    }
+
+    static void resume(void *addr)
+    {
+        std::coroutine_handle<>::from_address(addr).resume();
+    }
+
+    void finished()
+    {
+        live_--;
+    }
+
+    bool virtual_;
+    std::chrono::steady_clock::time_point t0_;
+    uint64_t now_ = 0;
+    uint64_t seq_ = 0;
+    std::size_t live_ = 0;
+    std::vector<timer> timers_;
+    std::vector<std::coroutine_handle<task::promise_type>> tasks_;
+};
+
+inline std::suspend_always task::promise_type::final_suspend() noexcept
+{
+    if (ex != nullptr)
+    {
+        ex->finished();
+    }
+    return {};
+}
+
+/**
+ * @brief Awaitable of a step that completes without waiting
+ */
+template <class T>
+struct ready
+{
+    T value;
+
+    bool await_ready() const noexcept
+    {
+        return true;
+    }
+    void await_suspend(std::coroutine_handle<>) const noexcept
+    {
+    }
+    T await_resume() const noexcept
+    {
+        return value;
+    }
+};
+
+/**
+ * @brief Driver over a zmod4xxx_dev_t and the C API
+ *
+ * zmod4xxx::sensor<> of zmod4xxx.hpp is a driver as well; its HAL can carry
+ * a context, which a C HAL cannot.
+ */
+class c_driver
+{
+public:
+    using adc_t = std::array<uint8_t, RSLT_MAX>;
+    using rmox_t = std::array<float, RSLT_MAX / 2>;
+
+    explicit c_driver(zmod4xxx_dev_t *dev) : dev_(dev)
+    {
+    }
+
+    zmod4xxx_dev_t *c_dev()
+    {
+        return dev_;
+    }
+    zmod4xxx_err start()
+    {
+        return zmod4xxx_start_measurement(dev_);
+    }
+    zmod4xxx_err status(uint8_t &st)
+    {
+        return zmod4xxx_read_status(dev_, &st);
+    }
+    zmod4xxx_err read_adc(adc_t &adc)
+    {
+        return zmod4xxx_read_adc_result(dev_, adc.data());
+    }
+    void calc_rmox(const adc_t &adc, rmox_t &rmox) const
+    {
+        zmod4xxx_calc_rmox(dev_, const_cast<uint8_t *>(adc.data()), rmox.data());
+    }
+
+private:
+    zmod4xxx_dev_t *dev_;
+};
+
+/**
+ * @brief The measurement cycle of one sensor as awaitable steps
+ * @tparam Driver c_driver or zmod4xxx::sensor<>
+ */
+template <class Driver>
+class device
+{
+public:
+    using adc_t = typename Driver::adc_t;
+    using rmox_t = typename Driver::rmox_t;
+
+    /**
+     * @brief One measurement
+     */
+    struct frame
+    {
+        uint64_t ts_us; /**< executor time the results were read */
+        adc_t adc; /**< raw ADC results */
+        rmox_t rmox; /**< MOx resistances */
+    };
+
+    /**
+     * @param   [in] ex executor the waits run on
+     * @param   [in] drv driver, not copied
+     * @param   [in] poll_ms wait between status reads
+     * @param   [in] poll_max status reads before ERROR_GAS_TIMEOUT
+     */
+    device(executor &ex, Driver &drv, uint32_t poll_ms = 200,
+           uint32_t poll_max = ZMOD4410_IAQ2_COUNTER_LIMIT)
+        : ex_(ex), drv_(drv), poll_ms_(poll_ms), poll_max_(poll_max)
+    {
+    }
+
+    Driver &driver()
+    {
+        return drv_;
+    }
+
+    /**
+     * @brief   Start a measurement, zmod4xxx_start_measurement()
+     */
+    ready<zmod4xxx_err> start()
+    {
+        return {drv_.start()};
+    }
+
+    /**
+     * @brief   Wait for the sequencer to finish
+     * @param   [in] first_ms wait before the first status read, e.g. the
+     *          known run time of the sequence, to save polls
+     * @return  awaitable giving 0 or the error of a status read, or
+     *          ERROR_GAS_TIMEOUT after poll_max reads
+     */
+    auto sequencer_done(uint32_t first_ms = 0)
+    {
+        struct awaiter
+        {
+            device &d;
+            uint32_t first_ms;
+            std::coroutine_handle<> h;
+            zmod4xxx_err ret = ZMOD4XXX_OK;
+            uint32_t polls = 0;
+
+            bool poll()
+            {
+                uint8_t st;
+
+                ret = d.drv_.status(st);
+                if (ret || !(st & STATUS_SEQUENCER_RUNNING_MASK))
+                {
+                    return true;
+                }
+                if (++polls >= d.poll_max_)
+                {
+                    ret = ERROR_GAS_TIMEOUT;
+                    return true;
+                }
+                return false;
+            }
+            static void step(void *ctx)
+            {
+                awaiter *a = static_cast<awaiter *>(ctx);
+
+                if (a->poll())
+                {
+                    a->h.resume();
+                    return;
+                }
+                a->d.ex_.after(a->d.poll_ms_, step, a);
+            }
+            bool await_ready()
+            {
+                return first_ms == 0 && poll();
+            }
+            void await_suspend(std::coroutine_handle<> handle)
+            {
+                h = handle;
+                d.ex_.after(first_ms ? first_ms : d.poll_ms_, step, this);
+            }
+            zmod4xxx_err await_resume() const noexcept
+            {
+                return ret;
+            }
+        };
+        return awaiter{*this, first_ms, {}};
+    }
+
+    /**
+     * @brief   Read the results and convert them, zmod4xxx_read_rmox()
+     *          without its 50 ms wait
+     */
+    ready<zmod4xxx_err> read_frame(frame &f)
+    {
+        zmod4xxx_err ret = drv_.read_adc(f.adc);
+
+        if (ret == ZMOD4XXX_OK)
+        {
+            drv_.calc_rmox(f.adc, f.rmox);
+            f.ts_us = ex_.now_us();
+        }
+        return {ret};
+    }
+
+    /**
+     * @brief   Wait on the executor instead of delay_ms()
+     */
+    auto sleep(uint32_t ms)
+    {
+        return ex_.sleep(ms);
+    }
+
+private:
+    executor &ex_;
+    Driver &drv_;
+    uint32_t poll_ms_;
+    uint32_t poll_max_;
+};
+
+} /* namespace zmod4xxx::co */
+
+#endif /* _ZMOD4XXX_CO_HPP */
@@ -0,0 +1,301 @@
+/*
+ * Copyright (c) 2006-2021, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-19     Sherman      first version
+ */
+
+/*
+ * Deferred log. Writers store a format index and raw argument words in a
+ * ring laid out like the span trace: a slot is claimed with an atomic
+ * increment of the head and published by storing its sequence number last.
+ * The text is only put together by the one reader, a low priority thread
+ * or a host tool after upload, so a record costs the writer a few dozen
+ * stores instead of a formatted UART write.
+ */
+
+#ifndef ZMOD4XXX_USING_DLOG
+#define ZMOD4XXX_USING_DLOG
+#endif
+
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "zmod4xxx_dlog.h"
+
+#if (ZMOD4XXX_DLOG_SIZE & (ZMOD4XXX_DLOG_SIZE - 1)) != 0
+#error "ZMOD4XXX_DLOG_SIZE must be a power of two"
+#endif
+
+#define DLOG_SPEC_MAX (16)
+
+static zmod4xxx_dlog_rec_t dlog_ring[ZMOD4XXX_DLOG_SIZE];
+static uint32_t dlog_head;
+static uint32_t dlog_tail;
+static uint32_t dlog_lost;
+static uint32_t (*dlog_clock)(void);
+
+#define ZMOD4XXX_DLOG_TEXT(name, fmt) fmt,
+static const char *const dlog_formats[ZMOD4XXX_DLOG_FMT_MAX] = {
+    ZMOD4XXX_DLOG_FORMATS(ZMOD4XXX_DLOG_TEXT)
+};
+#undef ZMOD4XXX_DLOG_TEXT
+
+uint32_t zmod4xxx_dlog_float(float f)
+{
+    uint32_t u;
+
+    memcpy(&u, &f, sizeof(u));
+    return u;
+}
+
+void zmod4xxx_dlog_init(uint32_t (*clock)(void))
+{
+    dlog_clock = clock;
+    dlog_lost = 0;
+    dlog_tail = __atomic_load_n(&dlog_head, __ATOMIC_ACQUIRE);
+}
+
+void zmod4xxx_dlog_args(uint16_t id, const uint32_t *args, uint8_t nargs)
+{
+    uint32_t idx = __atomic_fetch_add(&dlog_head, 1, __ATOMIC_RELAXED);
+    zmod4xxx_dlog_rec_t *rec = &dlog_ring[idx & (ZMOD4XXX_DLOG_SIZE - 1)];
+    uint8_t i;
+
+    if (nargs > ZMOD4XXX_DLOG_ARGS_MAX)
+    {
+        nargs = ZMOD4XXX_DLOG_ARGS_MAX;
+    }
+    __atomic_store_n(&rec->seq, 0, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+    rec->ts = dlog_clock ? dlog_clock() : 0;
+    rec->id = id;
+    rec->nargs = nargs;
+    for (i = 0; i < nargs; i++)
+    {
+        rec->args[i] = args[i];
+    }
+    __atomic_store_n(&rec->seq, idx + 1, __ATOMIC_RELEASE);
+}
+
+void zmod4xxx_dlog(uint16_t id, uint8_t nargs, ...)
+{
+    uint32_t args[ZMOD4XXX_DLOG_ARGS_MAX];
+    va_list ap;
+    uint8_t i;
+
+    if (nargs > ZMOD4XXX_DLOG_ARGS_MAX)
+    {
+        nargs = ZMOD4XXX_DLOG_ARGS_MAX;
+    }
+    va_start(ap, nargs);
+    for (i = 0; i < nargs; i++)
+    {
+        args[i] = va_arg(ap, uint32_t);
+    }
+    va_end(ap);
+    zmod4xxx_dlog_args(id, args, nargs);
+}
+
+int zmod4xxx_dlog_read(zmod4xxx_dlog_rec_t *rec)
+{
+    zmod4xxx_dlog_rec_t *slot;
+    uint32_t head, seq;
+
+    for (;;)
+    {
+        head = __atomic_load_n(&dlog_head, __ATOMIC_ACQUIRE);
+        if (head - dlog_tail > ZMOD4XXX_DLOG_SIZE)
+        {
+            dlog_lost += head - ZMOD4XXX_DLOG_SIZE - dlog_tail;
+            dlog_tail = head - ZMOD4XXX_DLOG_SIZE;
+        }
+        if (head == dlog_tail)
+        {
+            return 0;
+        }
+
+        slot = &dlog_ring[dlog_tail & (ZMOD4XXX_DLOG_SIZE - 1)];
+        seq = __atomic_load_n(&slot->seq, __ATOMIC_ACQUIRE);
+        if (seq != dlog_tail + 1)
+        {
+            /* 0 or older: claimed but not published yet, try again later */
+            if (seq == 0 || (int32_t)(seq - (dlog_tail + 1)) < 0)
+            {
+                return 0;
+            }
+            dlog_lost++;
+            dlog_tail++;
+            continue;
+        }
+        memcpy(rec, slot, sizeof(*rec));
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+        dlog_tail++;
+        if (__atomic_load_n(&slot->seq, __ATOMIC_RELAXED) != seq)
+        {
+            dlog_lost++;
+            continue;
+        }
+        if (rec->nargs > ZMOD4XXX_DLOG_ARGS_MAX)
+        {
+            rec->nargs = ZMOD4XXX_DLOG_ARGS_MAX;
+        }
+        return 1;
+    }
+}
+
+uint32_t zmod4xxx_dlog_lost(void)
+{
+    return dlog_lost;
+}
+
+static uint32_t dlog_append(uint32_t size, uint32_t len, int n)
+{
+    if (n < 0)
+    {
+        return len;
+    }
+    len += (uint32_t)n;
+    return len < size ? len : size - 1;
+}
+
+uint32_t zmod4xxx_dlog_format(const zmod4xxx_dlog_rec_t *rec, char *buf, uint32_t size)
+{
+    const char *p;
+    char spec[DLOG_SPEC_MAX];
+    uint32_t len = 0, n, word, used = 0;
+    float f;
+    uint8_t i;
+
+    if (size == 0)
+    {
+        return 0;
+    }
+    buf[0] = '\0';
+    if (rec->id >= ZMOD4XXX_DLOG_FMT_MAX)
+    {
+        len = dlog_append(size, len, snprintf(buf, size, "fmt#%u", rec->id));
+        for (i = 0; i < rec->nargs && i < ZMOD4XXX_DLOG_ARGS_MAX; i++)
+        {
+            len = dlog_append(size, len,
+                              snprintf(buf + len, size - len, " 0x%08X", rec->args[i]));
+        }
+        return len;
+    }
+
+    for (p = dlog_formats[rec->id]; *p && len < size - 1; p++)
+    {
+        if (*p != '%' || p[1] == '%')
+        {
+            buf[len++] = *p;
+            p += *p == '%';
+            continue;
+        }
+
+        /* copy the conversion as it is, without length modifiers */
+        spec[0] = '%';
+        for (n = 1, p++; *p && strchr("-+ #0123456789.", *p) && n < DLOG_SPEC_MAX - 2; p++)
+        {
+            spec[n++] = *p;
+        }
+        while (*p == 'l' || *p == 'h')
+        {
+            p++;
+        }
+        if (*p == '\0')
+        {
+            break;
+        }
+        spec[n++] = *p;
+        spec[n] = '\0';
+
+        if (used >= rec->nargs)
+        {
+            len = dlog_append(size, len, snprintf(buf + len, size - len, "?"));
+            continue;
+        }
+        word = rec->args[used++];
+        switch (*p)
+        {
+        case 'f': case 'F': case 'e': case 'E': case 'g': case 'G':
+            memcpy(&f, &word, sizeof(f));
+            len = dlog_append(size, len, snprintf(buf + len, size - len, spec, (double)f));
+            break;
+        case 'd': case 'i':
+            len = dlog_append(size, len, snprintf(buf + len, size - len, spec, (int)(int32_t)word));
+            break;
+        case 'u': case 'x': case 'X': case 'o': case 'c':
+            len = dlog_append(size, len, snprintf(buf + len, size - len, spec, (unsigned int)word));
+            break;
+        default:
+            len = dlog_append(size, len, snprintf(buf + len, size - len, "0x%08X", word));
+            break;
+        }
+    }
+    buf[len] = '\0';
+    return len;
+}
+
+static void dlog_put32(uint8_t *p, uint32_t v)
+{
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+    p[2] = (uint8_t)(v >> 16);
+    p[3] = (uint8_t)(v >> 24);
+}
+
+static uint32_t dlog_get32(const uint8_t *p)
+{
+    return p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+uint32_t zmod4xxx_dlog_pack(const zmod4xxx_dlog_rec_t *rec, uint8_t *buf)
+{
+    uint8_t i, nargs = rec->nargs;
+
+    if (nargs > ZMOD4XXX_DLOG_ARGS_MAX)
+    {
+        nargs = ZMOD4XXX_DLOG_ARGS_MAX;
+    }
+    dlog_put32(buf, rec->seq);
+    dlog_put32(buf + 4, rec->ts);
+    buf[8] = (uint8_t)rec->id;
+    buf[9] = (uint8_t)(rec->id >> 8);
+    buf[10] = nargs;
+    buf[11] = 0;
+    for (i = 0; i < nargs; i++)
+    {
+        dlog_put32(buf + ZMOD4XXX_DLOG_WIRE_HDR + 4 * i, rec->args[i]);
+    }
+    return ZMOD4XXX_DLOG_WIRE_HDR + 4 * nargs;
+}
+
+uint32_t zmod4xxx_dlog_unpack(const uint8_t *buf, uint32_t len, zmod4xxx_dlog_rec_t *rec)
+{
+    uint32_t need;
+    uint8_t i;
+
+    if (len < ZMOD4XXX_DLOG_WIRE_HDR || buf[10] > ZMOD4XXX_DLOG_ARGS_MAX || buf[11] != 0)
+    {
+        return 0;
+    }
+    need = ZMOD4XXX_DLOG_WIRE_HDR + 4 * buf[10];
+    if (len < need)
+    {
+        return 0;
+    }
+    memset(rec, 0, sizeof(*rec));
+    rec->seq = dlog_get32(buf);
+    rec->ts = dlog_get32(buf + 4);
+    rec->id = (uint16_t)(buf[8] | (buf[9] << 8));
+    rec->nargs = buf[10];
+    for (i = 0; i < rec->nargs; i++)
+    {
+        rec->args[i] = dlog_get32(buf + ZMOD4XXX_DLOG_WIRE_HDR + 4 * i);
+    }
+    return need;
+}
@@ -0,0 +1,157 @@
+/*
+ * Copyright (c) 2006-2021, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-19     Sherman      first version
+ */
+
+#ifndef _ZMOD4XXX_DLOG_H
+#define _ZMOD4XXX_DLOG_H
+
+#include "zmod4xxx_types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifndef ZMOD4XXX_DLOG_SIZE
+#define ZMOD4XXX_DLOG_SIZE (64) /**< records in the ring, power of two */
+#endif
+
+#define ZMOD4XXX_DLOG_ARGS_MAX (7) /**< argument words per record */
+
+/* wire form: seq, ts (u32), id (u16), nargs (u8), 0 (u8), args (u32), little endian */
+#define ZMOD4XXX_DLOG_WIRE_HDR (12)
+#define ZMOD4XXX_DLOG_WIRE_MAX (ZMOD4XXX_DLOG_WIRE_HDR + 4 * ZMOD4XXX_DLOG_ARGS_MAX)
+
+/*
+ * Format table, the only place the text lives. A record carries the index
+ * and the raw argument words; the firmware and the host format them with
+ * the same table, so new entries go at the end. Conversions are the ones
+ * of printf without strings: d, i, u, x, X, c take an integer word, f, e,
+ * g a word from ZMOD4XXX_DLOG_F().
+ */
+#define ZMOD4XXX_DLOG_FORMATS(X) \
+    X(WARMUP,  "Warmup!") \
+    X(VALID,   "Valid!") \
+    X(RESULT,  "EtOH %.3f ppm, TVOC %.3f mg/m^3, eCO2 %.0f ppm, IAQ %.1f, log_Rcda %.3f logOhm") \
+    X(RMOX_LO, "Rmox[0..6] %.3f %.3f %.3f %.3f %.3f %.3f %.3f kOhm") \
+    X(RMOX_HI, "Rmox[7..12] %.3f %.3f %.3f %.3f %.3f %.3f kOhm") \
+    X(MODE,    "mode %u, sample %u") \
+    X(HEALTH,  "health flags 0x%02x, latched 0x%02x, drift %.3f") \
+    X(LOW,     "Low power, outputs held")
+
+#define ZMOD4XXX_DLOG_ENUM(name, fmt) ZMOD4XXX_DLOG_##name,
+typedef enum {
+    ZMOD4XXX_DLOG_FORMATS(ZMOD4XXX_DLOG_ENUM)
+    ZMOD4XXX_DLOG_FMT_MAX
+} zmod4xxx_dlog_fmt;
+#undef ZMOD4XXX_DLOG_ENUM
+
+/**
+ * @brief One log record, formatted when it is read
+ */
+typedef struct {
+    uint32_t seq; /**< write index + 1, 0 while the record is written */
+    uint32_t ts; /**< time of the write on the log clock */
+    uint16_t id; /**< zmod4xxx_dlog_fmt */
+    uint8_t nargs; /**< words used in args */
+    uint8_t reserved;
+    uint32_t args[ZMOD4XXX_DLOG_ARGS_MAX]; /**< raw argument words */
+} zmod4xxx_dlog_rec_t;
+
+/**
+ * @brief   Argument word of a float
+ * @param   [in] f value
+ * @return  bit pattern of f
+ */
+uint32_t zmod4xxx_dlog_float(float f);
+
+#define ZMOD4XXX_DLOG_F(f) zmod4xxx_dlog_float((float)(f))
+
+/**
+ * @brief   Format a record with the format table
+ * @param   [in] rec record
+ * @param   [out] buf text, always NUL-terminated
+ * @param   [in] size size of buf
+ * @return  length of the text, without the NUL
+ * @note    Unknown ids and missing arguments are printed as such, so a
+ *          host with an older table still shows the raw words.
+ */
+uint32_t zmod4xxx_dlog_format(const zmod4xxx_dlog_rec_t *rec, char *buf, uint32_t size);
+
+/**
+ * @brief   Serialize a record for upload
+ * @param   [in] rec record
+ * @param   [out] buf at least ZMOD4XXX_DLOG_WIRE_MAX bytes
+ * @return  bytes written
+ */
+uint32_t zmod4xxx_dlog_pack(const zmod4xxx_dlog_rec_t *rec, uint8_t *buf);
+
+/**
+ * @brief   Parse an uploaded record
+ * @param   [in] buf bytes
+ * @param   [in] len bytes available
+ * @param   [out] rec record
+ * @return  bytes used, 0 if buf does not hold a whole valid record
+ */
+uint32_t zmod4xxx_dlog_unpack(const uint8_t *buf, uint32_t len, zmod4xxx_dlog_rec_t *rec);
+
+#ifdef ZMOD4XXX_USING_DLOG
+
+/**
+ * @brief   Set the clock records are stamped with
+ * @param   [in] clock free-running clock, e.g. milliseconds
+ */
+void zmod4xxx_dlog_init(uint32_t (*clock)(void));
+
+/**
+ * @brief   Append a record; safe from any thread or interrupt
+ * @param   [in] id zmod4xxx_dlog_fmt
+ * @param   [in] nargs number of uint32_t arguments that follow, at most
+ *          ZMOD4XXX_DLOG_ARGS_MAX; floats go through ZMOD4XXX_DLOG_F()
+ */
+void zmod4xxx_dlog(uint16_t id, uint8_t nargs, ...);
+
+/**
+ * @brief   Append a record with the arguments in an array
+ * @param   [in] id zmod4xxx_dlog_fmt
+ * @param   [in] args argument words
+ * @param   [in] nargs number of words, at most ZMOD4XXX_DLOG_ARGS_MAX
+ */
+void zmod4xxx_dlog_args(uint16_t id, const uint32_t *args, uint8_t nargs);
+
+/**
+ * @brief   Take the oldest record not read yet; one reader at a time
+ * @param   [out] rec record
+ * @return  1 if a record was taken, 0 if the ring is empty
+ * @note    When writers lapped the reader the overwritten records are
+ *          counted by zmod4xxx_dlog_lost() and reading goes on with the
+ *          oldest one left.
+ */
+int zmod4xxx_dlog_read(zmod4xxx_dlog_rec_t *rec);
+
+/**
+ * @brief   Records overwritten before they were read
+ * @return  count since zmod4xxx_dlog_init()
+ */
+uint32_t zmod4xxx_dlog_lost(void);
+
+#else
+
+#define zmod4xxx_dlog_init(clock)           ((void)0)
+#define zmod4xxx_dlog(...)                  ((void)0)
+#define zmod4xxx_dlog_args(id, args, n)     ((void)(args))
+#define zmod4xxx_dlog_read(rec)             ((void)(rec), 0)
+#define zmod4xxx_dlog_lost()                (0U)
+
+#endif /* ZMOD4XXX_USING_DLOG */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _ZMOD4XXX_DLOG_H */
@@ -0,0 +1,202 @@
+/*
+ * Copyright (c) 2006-2021, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-19     Sherman      first version
+ * 2026-10-19     Sherman      time constants in ms, keep adapting while flagged
+ */
+
+/*
+ * Sensor health from the values every cycle already has. Each estimator is
+ * an exponentially weighted mean whose weight starts at 1/1, 1/2, ... until
+ * it drops to the time since the last sample over the time constant, so it
+ * is a plain average while it fills up, needs no seed value and keeps its
+ * time constant at any sample rate. The variance of the profile span is the
+ * exponentially weighted one of West, "Updating mean and variance
+ * estimates", 1979; a floor relative to the mean span keeps a very steady
+ * profile from flagging noise. Samples that raise HEATER update the profile
+ * at heater_rate of the usual weight, so a lasting change is taken in after
+ * a few time constants instead of staying flagged forever.
+ */
+
+#ifndef ZMOD4XXX_USING_HEALTH
+#define ZMOD4XXX_USING_HEALTH
+#endif
+
+#include <math.h>
+#include <string.h>
+
+#include "zmod4xxx_health.h"
+
+static const zmod4xxx_health_config_t health_default =
+{
+    60000UL,    /* fast_ms: 1 min */
+    86400000UL, /* slow_ms: 1 day */
+    3600000UL,  /* profile_ms: 1 h */
+    3600000UL,  /* warmup_ms: 1 h */
+    0.5f,       /* drift_limit */
+    0.3f,       /* shift_limit */
+    0.1f,       /* sat_rate */
+    6.0f,       /* heater_z */
+    0.02f,      /* span_rel */
+    0.1f,       /* span_min */
+    0.1f,       /* heater_rate */
+    30,         /* stuck_max */
+};
+
+static float health_weight(uint32_t k, uint32_t dt_ms, uint32_t tau_ms)
+{
+    float fill = 1.0f / (float)(k + 1);
+    float share = tau_ms ? (float)dt_ms / (float)tau_ms : 1.0f;
+
+    if (share > 1.0f)
+    {
+        share = 1.0f;
+    }
+    return fill > share ? fill : share;
+}
+
+void zmod4xxx_health_init(zmod4xxx_health_t *h, const zmod4xxx_health_config_t *cfg)
+{
+    memset(h, 0, sizeof(*h));
+    h->cfg = cfg ? *cfg : health_default;
+}
+
+uint8_t zmod4xxx_health_update(zmod4xxx_health_t *h, const float *rmox, uint8_t n,
+                               float log_rcda, uint32_t now_ms)
+{
+    uint8_t flags = 0, i, clamped = 0, used = 0;
+    float sum = 0, lo = 0, hi = 0, r, a, d, x, var;
+    uint32_t dt;
+    uint8_t warm;
+
+    if (h->samples == 0)
+    {
+        h->start_ms = h->last_ms = now_ms;
+    }
+    dt = now_ms - h->last_ms;
+    h->last_ms = now_ms;
+    warm = now_ms - h->start_ms >= h->cfg.warmup_ms;
+
+    for (i = 0; i < n; i++)
+    {
+        r = rmox[i];
+        if (!isfinite(r))
+        {
+            flags |= ZMOD4XXX_HEALTH_F_INVALID;
+            continue;
+        }
+        sum += r;
+        if (r == ZMOD4XXX_HEALTH_RMOX_LO)
+        {
+            h->clamp_lo++;
+            clamped++;
+        }
+        else if (r == ZMOD4XXX_HEALTH_RMOX_HI)
+        {
+            h->clamp_hi++;
+            clamped++;
+        }
+        else if (r > 0)
+        {
+            lo = used && lo < r ? lo : r;
+            hi = used && hi > r ? hi : r;
+            used++;
+        }
+    }
+
+    /* saturation over the short term, so one clamped sample is no alarm */
+    if (n)
+    {
+        h->sat += ((float)clamped / n - h->sat) * health_weight(h->samples, dt, h->cfg.fast_ms);
+    }
+    if (h->sat > h->cfg.sat_rate)
+    {
+        flags |= ZMOD4XXX_HEALTH_F_SATURATED;
+    }
+
+    /* a live sensor never repeats all its resistances exactly */
+    h->stuck = h->samples && sum == h->prev_sum ? (uint16_t)(h->stuck + (h->stuck < 0xFFFF)) : 0;
+    h->prev_sum = sum;
+    if (h->cfg.stuck_max && h->stuck >= h->cfg.stuck_max)
+    {
+        flags |= ZMOD4XXX_HEALTH_F_STUCK;
+    }
+
+    /* the heater steps spread the resistances over decades; a broken or
+     * weak heater narrows or shifts that spread; clamped steps would cut
+     * it short, they are SATURATED's to report */
+    if (used >= 2 && clamped == 0)
+    {
+        x = log10f(hi / lo);
+        d = x - h->span_mean;
+        var = h->cfg.span_rel * h->span_mean;
+        var = var * var > h->span_var ? var * var : h->span_var;
+        a = health_weight(h->samples, dt, h->cfg.profile_ms);
+        if (warm &&
+            (x < h->cfg.span_min || d * d > h->cfg.heater_z * h->cfg.heater_z * var))
+        {
+            flags |= ZMOD4XXX_HEALTH_F_HEATER;
+            a *= h->cfg.heater_rate;
+        }
+        h->span_mean += a * d;
+        h->span_var = (1.0f - a) * (h->span_var + a * d * d);
+    }
+
+    if (isinf(log_rcda))
+    {
+        flags |= ZMOD4XXX_HEALTH_F_INVALID;
+    }
+    else if (!isnan(log_rcda))
+    {
+        if (h->rcda_samples == 0)
+        {
+            h->rcda_ref = log_rcda;
+            h->rcda_start_ms = h->rcda_last_ms = now_ms;
+        }
+        dt = now_ms - h->rcda_last_ms;
+        h->rcda_last_ms = now_ms;
+        x = log_rcda - h->rcda_ref;
+        h->rcda_fast += (x - h->rcda_fast) * health_weight(h->rcda_samples, dt, h->cfg.fast_ms);
+        h->rcda_slow += (x - h->rcda_slow) * health_weight(h->rcda_samples, dt, h->cfg.slow_ms);
+        h->rcda_samples++;
+        if (!h->rcda_warm && now_ms - h->rcda_start_ms >= h->cfg.warmup_ms)
+        {
+            h->rcda_base = h->rcda_slow;
+            h->rcda_warm = 1;
+        }
+        else if (h->rcda_warm)
+        {
+            if (fabsf(h->rcda_slow - h->rcda_base) > h->cfg.drift_limit)
+            {
+                flags |= ZMOD4XXX_HEALTH_F_DRIFT;
+            }
+            if (fabsf(h->rcda_fast - h->rcda_slow) > h->cfg.shift_limit)
+            {
+                flags |= ZMOD4XXX_HEALTH_F_SHIFT;
+            }
+        }
+    }
+
+    h->samples++;
+    h->flags = flags;
+    h->latched |= flags;
+    return flags;
+}
+
+void zmod4xxx_health_clear(zmod4xxx_health_t *h)
+{
+    h->latched = h->flags;
+}
+
+float zmod4xxx_health_drift(const zmod4xxx_health_t *h)
+{
+    if (!h->rcda_warm)
+    {
+        return 0;
+    }
+    return h->rcda_slow - h->rcda_base;
+}
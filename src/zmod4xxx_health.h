@@ -0,0 +1,125 @@
+/*
+ * Copyright (c) 2006-2021, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-19     Sherman      first version
+ * 2026-10-19     Sherman      time constants in ms, keep adapting while flagged
+ */
+
+#ifndef _ZMOD4XXX_HEALTH_H
+#define _ZMOD4XXX_HEALTH_H
+
+#include "zmod4xxx_types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* the values zmod4xxx_calc_rmox() clamps out-of-range ADC results to */
+#define ZMOD4XXX_HEALTH_RMOX_LO ((float)1e-3)
+#define ZMOD4XXX_HEALTH_RMOX_HI ((float)10e9)
+
+#define ZMOD4XXX_HEALTH_F_DRIFT     (1 << 0) /**< log_rcda baseline left its reference */
+#define ZMOD4XXX_HEALTH_F_SHIFT     (1 << 1) /**< log_rcda jumped away from the baseline */
+#define ZMOD4XXX_HEALTH_F_SATURATED (1 << 2) /**< too many clamped resistances */
+#define ZMOD4XXX_HEALTH_F_HEATER    (1 << 3) /**< heater profile out of its usual shape */
+#define ZMOD4XXX_HEALTH_F_STUCK     (1 << 4) /**< resistances repeat sample after sample */
+#define ZMOD4XXX_HEALTH_F_INVALID   (1 << 5) /**< a value was not a finite number */
+
+/**
+ * @brief Tracker configuration, time constants in milliseconds so they hold
+ *        at any sample rate
+ */
+typedef struct {
+    uint32_t fast_ms; /**< time constant of the short-term log_rcda mean */
+    uint32_t slow_ms; /**< time constant of the log_rcda baseline */
+    uint32_t profile_ms; /**< time constant of the heater profile span */
+    uint32_t warmup_ms; /**< time before anything but saturation is judged */
+    float drift_limit; /**< decades between baseline and reference for DRIFT */
+    float shift_limit; /**< decades between short-term mean and baseline for SHIFT */
+    float sat_rate; /**< clamped fraction of the resistances for SATURATED */
+    float heater_z; /**< deviations of the profile span from its mean for HEATER */
+    float span_rel; /**< smallest deviation counted, relative to the mean span */
+    float span_min; /**< decades; a flatter profile is HEATER at once */
+    float heater_rate; /**< weight of a HEATER sample in the profile, relative */
+    uint16_t stuck_max; /**< repeated samples for STUCK */
+} zmod4xxx_health_config_t;
+
+/**
+ * @brief Health of one sensor, a fixed size whatever the run time
+ *
+ * Baselines are exponentially weighted means. The log_rcda means are kept
+ * relative to the first value seen, so a time constant of days does not
+ * lose the updates in the rounding of a float.
+ */
+typedef struct {
+    zmod4xxx_health_config_t cfg;
+    uint32_t samples; /**< samples seen */
+    uint32_t rcda_samples; /**< samples with a log_rcda */
+    uint32_t start_ms; /**< time of the first sample */
+    uint32_t last_ms; /**< time of the last sample */
+    uint32_t rcda_start_ms; /**< time of the first log_rcda */
+    uint32_t rcda_last_ms; /**< time of the last log_rcda */
+    uint32_t clamp_lo; /**< resistances clamped to ZMOD4XXX_HEALTH_RMOX_LO */
+    uint32_t clamp_hi; /**< resistances clamped to ZMOD4XXX_HEALTH_RMOX_HI */
+    float sat; /**< mean clamped fraction */
+    float rcda_ref; /**< first log_rcda */
+    float rcda_fast; /**< short-term mean, minus rcda_ref */
+    float rcda_slow; /**< baseline, minus rcda_ref */
+    float rcda_base; /**< baseline at the end of the warmup, minus rcda_ref */
+    float span_mean; /**< mean decades between the largest and smallest resistance */
+    float span_var; /**< its variance */
+    float prev_sum; /**< sum of the last resistances */
+    uint16_t stuck; /**< samples in a row with the same sum */
+    uint8_t rcda_warm; /**< rcda_base is set */
+    uint8_t flags; /**< flags of the last sample */
+    uint8_t latched; /**< flags raised since the last zmod4xxx_health_clear() */
+} zmod4xxx_health_t;
+
+#ifdef ZMOD4XXX_USING_HEALTH
+
+/**
+ * @brief   Start tracking a sensor
+ * @param   [out] h tracker
+ * @param   [in] cfg configuration, copied; NULL for the defaults for IAQ
+ *          2nd Gen: one minute short-term, one day baseline, one hour for
+ *          the profile and the warmup
+ */
+void zmod4xxx_health_init(zmod4xxx_health_t *h, const zmod4xxx_health_config_t *cfg);
+
+/**
+ * @brief   Add a sample, O(n)
+ * @param   [in,out] h tracker
+ * @param   [in] rmox resistances from zmod4xxx_calc_rmox()
+ * @param   [in] n number of resistances
+ * @param   [in] log_rcda log10 of the CDA resistance from the algorithm, NAN
+ *          while it has none, e.g. during stabilization
+ * @param   [in] now_ms time of the sample
+ * @return  ZMOD4XXX_HEALTH_F_* flags of the sample
+ */
+uint8_t zmod4xxx_health_update(zmod4xxx_health_t *h, const float *rmox, uint8_t n,
+                               float log_rcda, uint32_t now_ms);
+
+/**
+ * @brief   Reset the latched flags
+ * @param   [in,out] h tracker
+ */
+void zmod4xxx_health_clear(zmod4xxx_health_t *h);
+
+/**
+ * @brief   Drift of the log_rcda baseline
+ * @param   [in] h tracker
+ * @return  decades of log_rcda since the end of the warmup, 0 before
+ */
+float zmod4xxx_health_drift(const zmod4xxx_health_t *h);
+
+#endif /* ZMOD4XXX_USING_HEALTH */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _ZMOD4XXX_HEALTH_H */
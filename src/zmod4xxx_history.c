@@ -0,0 +1,640 @@
+/*
+ * Copyright (c) 2006-2021, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-19     Sherman      first version
+ */
+
+/*
+ * Compressed time series in flash pages, after Pelkonen et al., "Gorilla: A
+ * Fast, Scalable, In-Memory Time Series Database". Each page starts over
+ * with a raw sample, so it decodes on its own. Timestamps are stored as
+ * delta of delta, values as the XOR with the previous value of the channel
+ * (32-bit floats, so 5 bits of leading zeros and 5 bits of length). The
+ * page header doubles as a rollup of the page.
+ */
+
+#ifndef ZMOD4XXX_USING_HISTORY
+#define ZMOD4XXX_USING_HISTORY
+#endif
+
+#include <string.h>
+
+#include "zmod4xxx_history.h"
+
+#define HIST_DATA_BYTES (ZMOD4XXX_HISTORY_PAGE_SIZE - sizeof(zmod4xxx_history_hdr_t))
+#define HIST_DATA_BITS  (HIST_DATA_BYTES * 8)
+/* worst case of a sample: 4 + 32 bits of time, 2 + 5 + 5 + 32 per value */
+#define HIST_SAMPLE_BITS(ch) (36U + 44U * (ch))
+#define HIST_CACHE (32)
+
+/* decoder state, the same as the encoder state in zmod4xxx_history_t */
+struct hist_codec
+{
+    uint32_t prev_ts;
+    int32_t prev_delta;
+    uint32_t prev_v[ZMOD4XXX_HISTORY_CH_MAX];
+    uint8_t lead[ZMOD4XXX_HISTORY_CH_MAX];
+    uint8_t trail[ZMOD4XXX_HISTORY_CH_MAX];
+};
+
+struct hist_reader
+{
+    const zmod4xxx_history_t *h;
+    const uint8_t *mem; /* data of the open page, NULL to read flash */
+    uint32_t page;
+    uint32_t pos; /* bit position in the data */
+    uint8_t cache[HIST_CACHE];
+    uint32_t cache_off;
+    uint32_t cache_len;
+    int err;
+};
+
+static uint32_t hist_crc32(const uint8_t *buf, uint32_t len, uint32_t crc)
+{
+    uint8_t k;
+
+    crc = ~crc;
+    while (len--)
+    {
+        crc ^= *buf++;
+        for (k = 0; k < 8; k++)
+        {
+            crc = (crc >> 1) ^ (0xEDB88320UL & (0U - (crc & 1)));
+        }
+    }
+    return ~crc;
+}
+
+static uint32_t hist_f2u(float f)
+{
+    uint32_t u;
+
+    memcpy(&u, &f, sizeof(u));
+    return u;
+}
+
+static float hist_u2f(uint32_t u)
+{
+    float f;
+
+    memcpy(&f, &u, sizeof(f));
+    return f;
+}
+
+static uint8_t hist_clz(uint32_t x)
+{
+    uint8_t n = 0;
+
+    while (n < 32 && !(x & 0x80000000UL))
+    {
+        x <<= 1;
+        n++;
+    }
+    return n;
+}
+
+static uint8_t hist_ctz(uint32_t x)
+{
+    uint8_t n = 0;
+
+    while (n < 32 && !(x & 1))
+    {
+        x >>= 1;
+        n++;
+    }
+    return n;
+}
+
+/* append the low n bits of val, most significant first */
+static void hist_put(zmod4xxx_history_t *h, uint32_t val, uint8_t n)
+{
+    uint8_t *data = h->page + sizeof(zmod4xxx_history_hdr_t);
+    uint32_t pos = h->hdr.bits;
+
+    while (n--)
+    {
+        if ((val >> n) & 1)
+        {
+            data[pos >> 3] |= (uint8_t)(0x80 >> (pos & 7));
+        }
+        pos++;
+    }
+    h->hdr.bits = (uint16_t)pos;
+}
+
+static uint8_t hist_byte(struct hist_reader *r, uint32_t idx)
+{
+    uint32_t off = sizeof(zmod4xxx_history_hdr_t) + idx;
+
+    if (r->mem != NULL)
+    {
+        return r->mem[idx];
+    }
+    if (off < r->cache_off || off >= r->cache_off + r->cache_len)
+    {
+        r->cache_off = off;
+        r->cache_len = ZMOD4XXX_HISTORY_PAGE_SIZE - off;
+        if (r->cache_len > HIST_CACHE)
+        {
+            r->cache_len = HIST_CACHE;
+        }
+        if (r->h->flash.read(r->h->flash.ctx, r->page, off, r->cache, r->cache_len))
+        {
+            r->err = 1;
+            r->cache_len = 0;
+            return 0;
+        }
+    }
+    return r->cache[off - r->cache_off];
+}
+
+static uint32_t hist_get(struct hist_reader *r, uint8_t n)
+{
+    uint32_t val = 0;
+
+    while (n--)
+    {
+        val = (val << 1) | ((hist_byte(r, r->pos >> 3) >> (7 - (r->pos & 7))) & 1);
+        r->pos++;
+    }
+    return val;
+}
+
+static void hist_encode(zmod4xxx_history_t *h, const zmod4xxx_history_sample_t *s)
+{
+    int32_t delta, dod;
+    uint32_t v, x;
+    uint8_t c, l, t, len;
+
+    if (h->hdr.count == 0)
+    {
+        hist_put(h, s->ts, 32);
+        for (c = 0; c < h->channels; c++)
+        {
+            h->prev_v[c] = hist_f2u(s->v[c]);
+            hist_put(h, h->prev_v[c], 32);
+            h->lead[c] = 0;
+            h->trail[c] = 0;
+        }
+        h->prev_ts = s->ts;
+        h->prev_delta = 0;
+        return;
+    }
+
+    delta = (int32_t)(s->ts - h->prev_ts);
+    dod = delta - h->prev_delta;
+    if (dod == 0)
+    {
+        hist_put(h, 0, 1);
+    }
+    else if (dod >= -63 && dod <= 64)
+    {
+        hist_put(h, 2, 2);
+        hist_put(h, (uint32_t)dod & 0x7F, 7);
+    }
+    else if (dod >= -255 && dod <= 256)
+    {
+        hist_put(h, 6, 3);
+        hist_put(h, (uint32_t)dod & 0x1FF, 9);
+    }
+    else if (dod >= -2047 && dod <= 2048)
+    {
+        hist_put(h, 14, 4);
+        hist_put(h, (uint32_t)dod & 0xFFF, 12);
+    }
+    else
+    {
+        hist_put(h, 15, 4);
+        hist_put(h, (uint32_t)dod, 32);
+    }
+    h->prev_ts = s->ts;
+    h->prev_delta = delta;
+
+    for (c = 0; c < h->channels; c++)
+    {
+        v = hist_f2u(s->v[c]);
+        x = v ^ h->prev_v[c];
+        h->prev_v[c] = v;
+        if (x == 0)
+        {
+            hist_put(h, 0, 1);
+            continue;
+        }
+        l = hist_clz(x);
+        t = hist_ctz(x);
+        if (l > 31)
+        {
+            l = 31;
+        }
+        len = (uint8_t)(32 - h->lead[c] - h->trail[c]);
+        /* reuse the window unless a new one saves more than its 10 bits */
+        if (l >= h->lead[c] && t >= h->trail[c] && len <= 32 - l - t + 10)
+        {
+            hist_put(h, 2, 2);
+            hist_put(h, x >> h->trail[c], len);
+            continue;
+        }
+        len = (uint8_t)(32 - l - t);
+        hist_put(h, 3, 2);
+        hist_put(h, l, 5);
+        hist_put(h, len - 1U, 5);
+        hist_put(h, x >> t, len);
+        h->lead[c] = l;
+        h->trail[c] = t;
+    }
+}
+
+static void hist_decode(struct hist_reader *r, struct hist_codec *st, uint8_t first,
+                        uint8_t channels, zmod4xxx_history_sample_t *s)
+{
+    int32_t dod;
+    uint32_t x;
+    uint8_t c, len;
+
+    if (first)
+    {
+        st->prev_ts = hist_get(r, 32);
+        st->prev_delta = 0;
+        for (c = 0; c < channels; c++)
+        {
+            st->prev_v[c] = hist_get(r, 32);
+            st->lead[c] = 0;
+            st->trail[c] = 0;
+        }
+    }
+    else
+    {
+        if (!hist_get(r, 1))
+        {
+            dod = 0;
+        }
+        else if (!hist_get(r, 1))
+        {
+            dod = (int32_t)hist_get(r, 7);
+            dod -= dod > 64 ? 128 : 0;
+        }
+        else if (!hist_get(r, 1))
+        {
+            dod = (int32_t)hist_get(r, 9);
+            dod -= dod > 256 ? 512 : 0;
+        }
+        else if (!hist_get(r, 1))
+        {
+            dod = (int32_t)hist_get(r, 12);
+            dod -= dod > 2048 ? 4096 : 0;
+        }
+        else
+        {
+            dod = (int32_t)hist_get(r, 32);
+        }
+        st->prev_delta += dod;
+        st->prev_ts += (uint32_t)st->prev_delta;
+
+        for (c = 0; c < channels; c++)
+        {
+            if (!hist_get(r, 1))
+            {
+                continue;
+            }
+            if (hist_get(r, 1))
+            {
+                st->lead[c] = (uint8_t)hist_get(r, 5);
+                len = (uint8_t)(hist_get(r, 5) + 1);
+                st->trail[c] = (uint8_t)(32 - st->lead[c] - len);
+            }
+            len = (uint8_t)(32 - st->lead[c] - st->trail[c]);
+            x = hist_get(r, len) << st->trail[c];
+            st->prev_v[c] ^= x;
+        }
+    }
+    s->ts = st->prev_ts;
+    for (c = 0; c < channels; c++)
+    {
+        s->v[c] = hist_u2f(st->prev_v[c]);
+    }
+}
+
+static void hist_open(zmod4xxx_history_t *h, uint32_t seq)
+{
+    memset(h->page, 0, sizeof(h->page));
+    memset(&h->hdr, 0, sizeof(h->hdr));
+    h->hdr.magic = ZMOD4XXX_HISTORY_MAGIC;
+    h->hdr.version = ZMOD4XXX_HISTORY_VERSION;
+    h->hdr.channels = h->channels;
+    h->hdr.seq = seq;
+}
+
+/* program the open page to the head of the ring and open the next one */
+static zmod4xxx_err hist_program(zmod4xxx_history_t *h)
+{
+    const zmod4xxx_history_flash_t *f = &h->flash;
+    uint32_t seq = h->hdr.seq;
+    zmod4xxx_err ret = ZMOD4XXX_OK;
+
+    h->hdr.crc = 0;
+    memcpy(h->page, &h->hdr, sizeof(h->hdr));
+    h->hdr.crc = hist_crc32(h->page, ZMOD4XXX_HISTORY_PAGE_SIZE, 0);
+    memcpy(h->page, &h->hdr, sizeof(h->hdr));
+
+    if (f->erase(f->ctx, h->head) || f->prog(f->ctx, h->head, h->page,
+                                              ZMOD4XXX_HISTORY_PAGE_SIZE))
+    {
+        h->errors++;
+        ret = ERROR_HISTORY_FLASH;
+    }
+    else
+    {
+        h->pages_written++;
+    }
+    h->head = (h->head + 1) % f->pages;
+    hist_open(h, seq + 1);
+    return ret;
+}
+
+/* header of a programmed page, 0 if it holds a page of this store */
+static int hist_read_hdr(const zmod4xxx_history_t *h, uint32_t page,
+                         zmod4xxx_history_hdr_t *hdr)
+{
+    if (h->flash.read(h->flash.ctx, page, 0, hdr, sizeof(*hdr)))
+    {
+        return -1;
+    }
+    if (hdr->magic != ZMOD4XXX_HISTORY_MAGIC ||
+        hdr->version != ZMOD4XXX_HISTORY_VERSION ||
+        hdr->channels != h->channels || hdr->count == 0 ||
+        hdr->bits > HIST_DATA_BITS)
+    {
+        return -1;
+    }
+    return 0;
+}
+
+/* whether the whole page matches its CRC */
+static int hist_page_ok(const zmod4xxx_history_t *h, uint32_t page,
+                        const zmod4xxx_history_hdr_t *hdr)
+{
+    zmod4xxx_history_hdr_t zero = *hdr;
+    uint8_t buf[HIST_CACHE];
+    uint32_t off, len, crc;
+
+    zero.crc = 0;
+    crc = hist_crc32((const uint8_t *)&zero, sizeof(zero), 0);
+    for (off = sizeof(zero); off < ZMOD4XXX_HISTORY_PAGE_SIZE; off += len)
+    {
+        len = ZMOD4XXX_HISTORY_PAGE_SIZE - off;
+        if (len > sizeof(buf))
+        {
+            len = sizeof(buf);
+        }
+        if (h->flash.read(h->flash.ctx, page, off, buf, len))
+        {
+            return 0;
+        }
+        crc = hist_crc32(buf, len, crc);
+    }
+    return crc == hdr->crc;
+}
+
+zmod4xxx_err zmod4xxx_history_init(zmod4xxx_history_t *h,
+                                   const zmod4xxx_history_flash_t *flash,
+                                   uint8_t channels)
+{
+    zmod4xxx_history_hdr_t hdr;
+    uint32_t page, best_seq = 0;
+
+    if (h == NULL || flash == NULL || flash->read == NULL ||
+        flash->prog == NULL || flash->erase == NULL)
+    {
+        return ERROR_NULL_PTR;
+    }
+    if (flash->pages == 0 || channels == 0 || channels > ZMOD4XXX_HISTORY_CH_MAX)
+    {
+        return ERROR_INIT_OUT_OF_RANGE;
+    }
+    memset(h, 0, sizeof(*h));
+    h->flash = *flash;
+    h->channels = channels;
+
+    for (page = 0; page < flash->pages; page++)
+    {
+        if (hist_read_hdr(h, page, &hdr) == 0 && hdr.seq > best_seq &&
+            hist_page_ok(h, page, &hdr))
+        {
+            best_seq = hdr.seq;
+            h->head = (page + 1) % flash->pages;
+        }
+    }
+    hist_open(h, best_seq + 1);
+    return ZMOD4XXX_OK;
+}
+
+zmod4xxx_err zmod4xxx_history_append(zmod4xxx_history_t *h,
+                                     const zmod4xxx_history_sample_t *s)
+{
+    zmod4xxx_err ret = ZMOD4XXX_OK;
+    uint8_t c;
+
+    if (h->hdr.count && s->ts < h->hdr.t_last)
+    {
+        return ERROR_INIT_OUT_OF_RANGE;
+    }
+    if (h->hdr.bits + HIST_SAMPLE_BITS(h->channels) > HIST_DATA_BITS ||
+        h->hdr.count == UINT16_MAX)
+    {
+        ret = hist_program(h);
+    }
+
+    hist_encode(h, s);
+    for (c = 0; c < h->channels; c++)
+    {
+        if (h->hdr.count == 0 || s->v[c] < h->hdr.min[c])
+        {
+            h->hdr.min[c] = s->v[c];
+        }
+        if (h->hdr.count == 0 || s->v[c] > h->hdr.max[c])
+        {
+            h->hdr.max[c] = s->v[c];
+        }
+        h->hdr.sum[c] += s->v[c];
+    }
+    if (h->hdr.count == 0)
+    {
+        h->hdr.t_first = s->ts;
+    }
+    h->hdr.t_last = s->ts;
+    h->hdr.count++;
+    h->samples++;
+    return ret;
+}
+
+zmod4xxx_err zmod4xxx_history_flush(zmod4xxx_history_t *h)
+{
+    if (h->hdr.count == 0)
+    {
+        return ZMOD4XXX_OK;
+    }
+    return hist_program(h);
+}
+
+/* walk the pages oldest first, the open page last */
+typedef int (*hist_page_fn)(const zmod4xxx_history_t *h, struct hist_reader *r,
+                            const zmod4xxx_history_hdr_t *hdr, void *arg);
+
+static zmod4xxx_err hist_walk(const zmod4xxx_history_t *h, uint32_t t0, uint32_t t1,
+                              hist_page_fn fn, void *arg)
+{
+    struct hist_reader r;
+    zmod4xxx_history_hdr_t hdr;
+    uint32_t i, page;
+
+    for (i = 0; i <= h->flash.pages; i++)
+    {
+        memset(&r, 0, sizeof(r));
+        r.h = h;
+        if (i < h->flash.pages)
+        {
+            page = (h->head + i) % h->flash.pages;
+            if (hist_read_hdr(h, page, &hdr) || hdr.seq >= h->hdr.seq)
+            {
+                continue;
+            }
+            r.page = page;
+        }
+        else
+        {
+            hdr = h->hdr;
+            r.mem = h->page + sizeof(zmod4xxx_history_hdr_t);
+            if (hdr.count == 0)
+            {
+                break;
+            }
+        }
+        if (hdr.t_last < t0 || hdr.t_first > t1)
+        {
+            continue;
+        }
+        if (fn(h, &r, &hdr, arg))
+        {
+            break;
+        }
+        if (r.err)
+        {
+            return ERROR_HISTORY_FLASH;
+        }
+    }
+    return ZMOD4XXX_OK;
+}
+
+struct hist_query
+{
+    uint32_t t0, t1;
+    zmod4xxx_history_cb_t cb;
+    void *ctx;
+    zmod4xxx_history_agg_t *agg;
+    float sum[ZMOD4XXX_HISTORY_CH_MAX];
+};
+
+static void hist_agg_add(struct hist_query *q, uint8_t channels, uint32_t count,
+                         const float *min, const float *max, const float *sum)
+{
+    uint8_t c;
+
+    for (c = 0; c < channels; c++)
+    {
+        if (q->agg->count == 0 || min[c] < q->agg->min[c])
+        {
+            q->agg->min[c] = min[c];
+        }
+        if (q->agg->count == 0 || max[c] > q->agg->max[c])
+        {
+            q->agg->max[c] = max[c];
+        }
+        q->sum[c] += sum[c];
+    }
+    q->agg->count += count;
+}
+
+static int hist_page_samples(const zmod4xxx_history_t *h, struct hist_reader *r,
+                             const zmod4xxx_history_hdr_t *hdr, void *arg)
+{
+    struct hist_query *q = arg;
+    struct hist_codec st;
+    zmod4xxx_history_sample_t s;
+    uint16_t n;
+
+    /* pages fully inside the range only need their rollup */
+    if (q->agg != NULL && hdr->t_first >= q->t0 && hdr->t_last <= q->t1)
+    {
+        hist_agg_add(q, h->channels, hdr->count, hdr->min, hdr->max, hdr->sum);
+        return 0;
+    }
+
+    memset(&s, 0, sizeof(s));
+    for (n = 0; n < hdr->count && !r->err; n++)
+    {
+        hist_decode(r, &st, n == 0, h->channels, &s);
+        if (s.ts < q->t0)
+        {
+            continue;
+        }
+        if (s.ts > q->t1)
+        {
+            break;
+        }
+        if (q->agg != NULL)
+        {
+            hist_agg_add(q, h->channels, 1, s.v, s.v, s.v);
+        }
+        else if (q->cb(q->ctx, &s))
+        {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+zmod4xxx_err zmod4xxx_history_query(const zmod4xxx_history_t *h, uint32_t t0,
+                                    uint32_t t1, zmod4xxx_history_cb_t cb,
+                                    void *ctx)
+{
+    struct hist_query q;
+
+    if (h == NULL || cb == NULL)
+    {
+        return ERROR_NULL_PTR;
+    }
+    memset(&q, 0, sizeof(q));
+    q.t0 = t0;
+    q.t1 = t1;
+    q.cb = cb;
+    q.ctx = ctx;
+    return hist_walk(h, t0, t1, hist_page_samples, &q);
+}
+
+zmod4xxx_err zmod4xxx_history_aggregate(const zmod4xxx_history_t *h, uint32_t t0,
+                                        uint32_t t1, zmod4xxx_history_agg_t *agg)
+{
+    struct hist_query q;
+    zmod4xxx_err ret;
+    uint8_t c;
+
+    if (h == NULL || agg == NULL)
+    {
+        return ERROR_NULL_PTR;
+    }
+    memset(&q, 0, sizeof(q));
+    memset(agg, 0, sizeof(*agg));
+    q.t0 = t0;
+    q.t1 = t1;
+    q.agg = agg;
+    ret = hist_walk(h, t0, t1, hist_page_samples, &q);
+    for (c = 0; c < h->channels && agg->count; c++)
+    {
+        agg->mean[c] = q.sum[c] / agg->count;
+    }
+    return ret;
+}
@@ -0,0 +1,170 @@
+/*
+ * Copyright (c) 2006-2021, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-19     Sherman      first version
+ */
+
+#ifndef _ZMOD4XXX_HISTORY_H
+#define _ZMOD4XXX_HISTORY_H
+
+#include "zmod4xxx_types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifndef ZMOD4XXX_HISTORY_PAGE_SIZE
+#define ZMOD4XXX_HISTORY_PAGE_SIZE (1024) /**< bytes per page, header included */
+#endif
+
+#define ZMOD4XXX_HISTORY_MAGIC   (0x485A) /**< "ZH" */
+#define ZMOD4XXX_HISTORY_VERSION (1)
+#define ZMOD4XXX_HISTORY_CH_MAX  (5) /**< IAQ, TVOC, EtOH, eCO2, log_rcda */
+
+#define ERROR_HISTORY_FLASH ((zmod4xxx_err)-16) /**< a flash operation failed */
+
+/**
+ * @brief Flash the history is kept in, as a ring of equal pages
+ *
+ * A page is erased right before it is programmed, and programmed once,
+ * whole. Pages are used in order, so an erase unit larger than a page can
+ * be erased when its first page comes up, at the cost of the oldest pages
+ * it also holds. Functions return 0 on success.
+ */
+typedef struct {
+    int (*read)(void *ctx, uint32_t page, uint32_t off, void *buf, uint32_t len);
+    int (*prog)(void *ctx, uint32_t page, const void *buf, uint32_t len);
+    int (*erase)(void *ctx, uint32_t page);
+    void *ctx; /**< passed to the functions */
+    uint32_t pages; /**< pages in the ring, at least 1 */
+} zmod4xxx_history_flash_t;
+
+/**
+ * @brief Page header, also the rollup of the samples in the page
+ */
+typedef struct {
+    uint16_t magic; /**< ZMOD4XXX_HISTORY_MAGIC */
+    uint8_t version; /**< ZMOD4XXX_HISTORY_VERSION */
+    uint8_t channels; /**< values per sample */
+    uint32_t seq; /**< page sequence number, counts up from 1 */
+    uint32_t t_first; /**< timestamp of the first sample */
+    uint32_t t_last; /**< timestamp of the last sample */
+    uint16_t count; /**< samples in the page */
+    uint16_t bits; /**< bits of sample data after the header */
+    float min[ZMOD4XXX_HISTORY_CH_MAX];
+    float max[ZMOD4XXX_HISTORY_CH_MAX];
+    float sum[ZMOD4XXX_HISTORY_CH_MAX];
+    uint32_t crc; /**< CRC-32 of the page with this field 0 */
+} zmod4xxx_history_hdr_t;
+
+/**
+ * @brief One stored sample
+ */
+typedef struct {
+    uint32_t ts; /**< timestamp, increasing; seconds are a good unit */
+    float v[ZMOD4XXX_HISTORY_CH_MAX]; /**< values, the first channels used */
+} zmod4xxx_history_sample_t;
+
+/**
+ * @brief Aggregates over a time range
+ */
+typedef struct {
+    uint32_t count; /**< samples in the range */
+    float min[ZMOD4XXX_HISTORY_CH_MAX];
+    float max[ZMOD4XXX_HISTORY_CH_MAX];
+    float mean[ZMOD4XXX_HISTORY_CH_MAX];
+} zmod4xxx_history_agg_t;
+
+/**
+ * @brief Called for each sample of a query, return non-zero to stop
+ */
+typedef int (*zmod4xxx_history_cb_t)(void *ctx, const zmod4xxx_history_sample_t *s);
+
+/**
+ * @brief History store with its open page
+ */
+typedef struct {
+    zmod4xxx_history_flash_t flash;
+    uint8_t channels; /**< values per sample, 1..ZMOD4XXX_HISTORY_CH_MAX */
+    uint32_t head; /**< page the open page will be programmed to */
+    zmod4xxx_history_hdr_t hdr; /**< header of the open page */
+    uint8_t page[ZMOD4XXX_HISTORY_PAGE_SIZE]; /**< open page */
+    uint32_t prev_ts; /**< encoder state */
+    int32_t prev_delta;
+    uint32_t prev_v[ZMOD4XXX_HISTORY_CH_MAX];
+    uint8_t lead[ZMOD4XXX_HISTORY_CH_MAX];
+    uint8_t trail[ZMOD4XXX_HISTORY_CH_MAX];
+    uint32_t samples; /**< samples appended since init */
+    uint32_t pages_written; /**< pages programmed since init */
+    uint32_t errors; /**< failed flash operations */
+} zmod4xxx_history_t;
+
+#ifdef ZMOD4XXX_USING_HISTORY
+
+/**
+ * @brief   Mount a history store
+ * @param   [out] h store
+ * @param   [in] flash flash functions, copied
+ * @param   [in] channels values per sample
+ * @return  error code
+ * @retval  0 success, appending continues after the newest valid page
+ * @retval  "!= 0" error
+ */
+zmod4xxx_err zmod4xxx_history_init(zmod4xxx_history_t *h,
+                                   const zmod4xxx_history_flash_t *flash,
+                                   uint8_t channels);
+
+/**
+ * @brief   Append a sample to the open page
+ * @param   [in,out] h store
+ * @param   [in] s sample, its timestamp not older than the last one
+ * @return  error code
+ * @note    A full page is programmed to flash before the sample is added.
+ */
+zmod4xxx_err zmod4xxx_history_append(zmod4xxx_history_t *h,
+                                     const zmod4xxx_history_sample_t *s);
+
+/**
+ * @brief   Program the open page now, e.g. before power down
+ * @param   [in,out] h store
+ * @return  error code
+ */
+zmod4xxx_err zmod4xxx_history_flush(zmod4xxx_history_t *h);
+
+/**
+ * @brief   Walk the samples of a time range, oldest first
+ * @param   [in] h store
+ * @param   [in] t0 first timestamp of the range
+ * @param   [in] t1 last timestamp of the range
+ * @param   [in] cb called for each sample
+ * @param   [in] ctx passed to cb
+ * @return  error code
+ */
+zmod4xxx_err zmod4xxx_history_query(const zmod4xxx_history_t *h, uint32_t t0,
+                                    uint32_t t1, zmod4xxx_history_cb_t cb,
+                                    void *ctx);
+
+/**
+ * @brief   Aggregate a time range
+ * @param   [in] h store
+ * @param   [in] t0 first timestamp of the range
+ * @param   [in] t1 last timestamp of the range
+ * @param   [out] agg aggregates
+ * @return  error code
+ * @note    Pages inside the range are taken from their header; only the
+ *          pages at the ends of the range are decoded.
+ */
+zmod4xxx_err zmod4xxx_history_aggregate(const zmod4xxx_history_t *h, uint32_t t0,
+                                        uint32_t t1, zmod4xxx_history_agg_t *agg);
+
+#endif /* ZMOD4XXX_USING_HISTORY */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _ZMOD4XXX_HISTORY_H */
@@ -0,0 +1,82 @@
+/*
+ * Copyright (c) 2006-2021, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-19     Sherman      first version
+ */
+
+/*
+ * Period and latency statistics of the sample time stamps. Adding a value
+ * is integer arithmetic only, so it costs nothing on a core without an FPU;
+ * the square root is taken when the statistics are read.
+ */
+
+#ifndef ZMOD4XXX_USING_JITTER
+#define ZMOD4XXX_USING_JITTER
+#endif
+
+#include <math.h>
+#include <string.h>
+
+#include "zmod4xxx_jitter.h"
+
+static void jitter_acc_add(zmod4xxx_jitter_acc_t *acc, uint32_t v)
+{
+    int64_t d;
+
+    if (acc->count == 0)
+    {
+        acc->ref = v;
+        acc->min = v;
+        acc->max = v;
+    }
+    d = (int64_t)v - acc->ref;
+    acc->sum += d;
+    acc->sum2 += (uint64_t)(d * d);
+    acc->min = v < acc->min ? v : acc->min;
+    acc->max = v > acc->max ? v : acc->max;
+    acc->count++;
+}
+
+void zmod4xxx_jitter_init(zmod4xxx_jitter_t *j)
+{
+    memset(j, 0, sizeof(*j));
+}
+
+void zmod4xxx_jitter_add(zmod4xxx_jitter_t *j, const zmod4xxx_stamp_t *s)
+{
+    if (j->has_prev)
+    {
+        jitter_acc_add(&j->period, s->done_us - j->prev_done_us);
+    }
+    jitter_acc_add(&j->latency, s->publish_us - s->done_us);
+    jitter_acc_add(&j->error, s->err_us);
+    j->prev_done_us = s->done_us;
+    j->has_prev = 1;
+}
+
+void zmod4xxx_jitter_gap(zmod4xxx_jitter_t *j)
+{
+    j->has_prev = 0;
+}
+
+void zmod4xxx_jitter_get(const zmod4xxx_jitter_acc_t *acc, zmod4xxx_jitter_stat_t *st)
+{
+    double mean, var;
+
+    memset(st, 0, sizeof(*st));
+    if (acc->count == 0)
+    {
+        return;
+    }
+    mean = (double)acc->sum / acc->count;
+    var = (double)acc->sum2 / acc->count - mean * mean;
+    st->count = acc->count;
+    st->mean = (uint32_t)(acc->ref + mean + 0.5);
+    st->std = var > 0 ? (uint32_t)(sqrt(var) + 0.5) : 0;
+    st->min = acc->min;
+    st->max = acc->max;
+}
@@ -0,0 +1,113 @@
+/*
+ * Copyright (c) 2006-2021, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-19     Sherman      first version
+ */
+
+#ifndef _ZMOD4XXX_JITTER_H
+#define _ZMOD4XXX_JITTER_H
+
+#include "zmod4xxx_types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Time stamps of one sample on the host clock, in microseconds
+ *
+ * The sample belongs to done_us, the end of the measurement sequence, not
+ * to the time the result is published after the ADC read and the
+ * algorithm. All times wrap at 2^32.
+ */
+typedef struct {
+    uint32_t start_us; /**< measurement started by the host */
+    uint32_t done_us; /**< sequencer completion */
+    uint32_t err_us; /**< done_us is off by at most this; 0 if taken on the INT pin */
+    uint32_t publish_us; /**< result handed to the application */
+} zmod4xxx_stamp_t;
+
+/**
+ * @brief Moments of one time, kept exactly in integers
+ *
+ * The sums are of the differences to the first value, so a period of
+ * seconds and a jitter of microseconds do not meet in one sum. They hold
+ * for more than 10^7 samples with deviations up to one second.
+ */
+typedef struct {
+    uint32_t count; /**< values added */
+    uint32_t ref; /**< first value */
+    int64_t sum; /**< sum of value - ref */
+    uint64_t sum2; /**< sum of (value - ref)^2 */
+    uint32_t min;
+    uint32_t max;
+} zmod4xxx_jitter_acc_t;
+
+/**
+ * @brief Timing of one sensor
+ */
+typedef struct {
+    zmod4xxx_jitter_acc_t period; /**< done_us to done_us of the next sample */
+    zmod4xxx_jitter_acc_t latency; /**< done_us to publish_us */
+    zmod4xxx_jitter_acc_t error; /**< err_us */
+    uint32_t prev_done_us; /**< done_us of the last sample */
+    uint8_t has_prev; /**< prev_done_us starts a period */
+} zmod4xxx_jitter_t;
+
+/**
+ * @brief Statistics of one time, in microseconds
+ */
+typedef struct {
+    uint32_t count;
+    uint32_t mean;
+    uint32_t std; /**< standard deviation, the jitter */
+    uint32_t min;
+    uint32_t max;
+} zmod4xxx_jitter_stat_t;
+
+#ifdef ZMOD4XXX_USING_JITTER
+
+/**
+ * @brief   Start or restart the statistics
+ * @param   [out] j tracker
+ */
+void zmod4xxx_jitter_init(zmod4xxx_jitter_t *j);
+
+/**
+ * @brief   Add a published sample, O(1)
+ * @param   [in,out] j tracker
+ * @param   [in] s time stamps of the sample
+ */
+void zmod4xxx_jitter_add(zmod4xxx_jitter_t *j, const zmod4xxx_stamp_t *s);
+
+/**
+ * @brief   Break the period, e.g. after a dropped sample or a mode switch,
+ *          so the next sample does not count a period of two cycles
+ * @param   [in,out] j tracker
+ */
+void zmod4xxx_jitter_gap(zmod4xxx_jitter_t *j);
+
+/**
+ * @brief   Get the statistics of one time
+ * @param   [in] acc j->period, j->latency or j->error
+ * @param   [out] st statistics, all 0 without values
+ */
+void zmod4xxx_jitter_get(const zmod4xxx_jitter_acc_t *acc, zmod4xxx_jitter_stat_t *st);
+
+#else
+
+#define zmod4xxx_jitter_init(j)     ((void)0)
+#define zmod4xxx_jitter_add(j, s)   ((void)0)
+#define zmod4xxx_jitter_gap(j)      ((void)0)
+
+#endif /* ZMOD4XXX_USING_JITTER */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _ZMOD4XXX_JITTER_H */
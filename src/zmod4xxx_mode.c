@@ -0,0 +1,138 @@
+/*
+ * Copyright (c) 2006-2021, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-19     Sherman      first version
+ * 2026-10-19     Sherman      add sleep timer duty cycling
+ * 2026-10-19     Sherman      write the tables as one bus section
+ * 2026-10-19     Sherman      remove the sleep timer duty cycling
+ * 2026-10-19     Sherman      write the tables with zmod4xxx_write_conf()
+ */
+
+#include <string.h>
+
+#include "zmod4xxx.h"
+#include "zmod4xxx_mode.h"
+
+#define MODE_STOP_POLL_MAX (20)
+
+static int mode_same(const zmod4xxx_conf_str *a, const zmod4xxx_conf_str *b)
+{
+    return a->addr == b->addr && a->len == b->len &&
+           (a->data_buf == b->data_buf ||
+            memcmp(a->data_buf, b->data_buf, a->len) == 0);
+}
+
+static zmod4xxx_err mode_stop(zmod4xxx_dev_t *dev)
+{
+    zmod4xxx_err ret;
+    uint8_t cmd = 0;
+    uint8_t status;
+    uint8_t polls = 0;
+
+    if (dev->write(dev->i2c_addr, ZMOD4XXX_ADDR_CMD, &cmd, 1))
+    {
+        return ERROR_I2C;
+    }
+    for (;;)
+    {
+        ret = zmod4xxx_read_status(dev, &status);
+        if (ret)
+        {
+            return ret;
+        }
+        if (!(status & STATUS_SEQUENCER_RUNNING_MASK))
+        {
+            return ZMOD4XXX_OK;
+        }
+        if (++polls == MODE_STOP_POLL_MAX)
+        {
+            return ERROR_GAS_TIMEOUT;
+        }
+        dev->delay_ms(50);
+    }
+}
+
+/* the tables that differ, through zmod4xxx_write_conf() */
+static zmod4xxx_err mode_write_tables(zmod4xxx_dev_t *dev, const zmod4xxx_conf *cur,
+                                      const zmod4xxx_conf *next, uint8_t *mask)
+{
+    uint8_t hsp[HSP_MAX * 2];
+    uint8_t tables = 0;
+    zmod4xxx_err ret;
+
+    /* the set points follow from the heater table and dev->config */
+    if (!mode_same(&cur->h, &next->h))
+    {
+        ret = zmod4xxx_calc_factor(next, hsp, dev->config);
+        if (ret)
+        {
+            return ret;
+        }
+        tables |= ZMOD4XXX_CONF_H;
+    }
+    if (!mode_same(&cur->d, &next->d))
+    {
+        tables |= ZMOD4XXX_CONF_D;
+    }
+    if (!mode_same(&cur->m, &next->m))
+    {
+        tables |= ZMOD4XXX_CONF_M;
+    }
+    if (!mode_same(&cur->s, &next->s))
+    {
+        tables |= ZMOD4XXX_CONF_S;
+    }
+    if (tables)
+    {
+        ret = zmod4xxx_write_conf(dev, next, tables, hsp, NULL);
+        if (ret)
+        {
+            return ret;
+        }
+    }
+    *mask = tables;
+    return ZMOD4XXX_OK;
+}
+
+zmod4xxx_err zmod4xxx_mode_apply(zmod4xxx_dev_t *dev, const zmod4xxx_mode_t *mode,
+                                 uint8_t *written)
+{
+    const zmod4xxx_conf *cur = dev->meas_conf;
+    const zmod4xxx_conf *next = mode->meas_conf;
+    uint8_t mask = 0;
+    zmod4xxx_err ret;
+
+    if (written != NULL)
+    {
+        *written = 0;
+    }
+    if (cur == NULL || next == NULL || mode->init_conf == NULL)
+    {
+        return ERROR_CONFIG_MISSING;
+    }
+    if (cur != next)
+    {
+        ret = mode_stop(dev);
+        if (ret)
+        {
+            return ret;
+        }
+        ret = mode_write_tables(dev, cur, next, &mask);
+        if (ret)
+        {
+            return ret;
+        }
+    }
+
+    dev->init_conf = mode->init_conf;
+    dev->meas_conf = next;
+    if (written != NULL)
+    {
+        *written = mask;
+    }
+    return ZMOD4XXX_OK;
+}
@@ -0,0 +1,61 @@
+/*
+ * Copyright (c) 2006-2021, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-19     Sherman      first version
+ * 2026-10-19     Sherman      add sleep timer duty cycling
+ * 2026-10-19     Sherman      remove the sleep timer duty cycling
+ * 2026-10-19     Sherman      table bits are the ones of zmod4xxx_write_conf()
+ */
+
+#ifndef _ZMOD4XXX_MODE_H
+#define _ZMOD4XXX_MODE_H
+
+#include "zmod4xxx.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define ZMOD4XXX_MODE_TABLE_H ZMOD4XXX_CONF_H /**< heater set points were written */
+#define ZMOD4XXX_MODE_TABLE_D ZMOD4XXX_CONF_D /**< delay table was written */
+#define ZMOD4XXX_MODE_TABLE_M ZMOD4XXX_CONF_M /**< measurement table was written */
+#define ZMOD4XXX_MODE_TABLE_S ZMOD4XXX_CONF_S /**< sequencer table was written */
+
+/**
+ * @brief One measurement mode, kept in ROM
+ */
+typedef struct {
+    uint8_t id; /**< index in the registry of the sensor */
+    const char *name; /**< short name for logs and shells */
+    const zmod4xxx_conf *init_conf; /**< configuration of the init run */
+    const zmod4xxx_conf *meas_conf; /**< configuration of a measurement */
+    uint32_t wait_ms; /**< host wait after the results before the next start */
+} zmod4xxx_mode_t;
+
+/**
+ * @brief   Switch a running device to another measurement mode
+ * @param   [in,out] dev prepared device; init_conf and meas_conf are set
+ *          to the ones of the mode
+ * @param   [in] mode mode to switch to
+ * @param   [out] written ZMOD4XXX_MODE_TABLE_* bits of the tables written,
+ *          may be NULL
+ * @return  error code
+ * @retval  0 success
+ * @retval  "!= 0" error
+ * @note    The sequencer is stopped and only the measurement tables that
+ *          differ from the current ones are written. The init run is not
+ *          repeated. Heater set points cached elsewhere, e.g. by
+ *          zmod4xxx_recover_init(), have to be refreshed afterwards.
+ */
+zmod4xxx_err zmod4xxx_mode_apply(zmod4xxx_dev_t *dev, const zmod4xxx_mode_t *mode,
+                                 uint8_t *written);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _ZMOD4XXX_MODE_H */
@@ -0,0 +1,109 @@
+/*
+ * Copyright (c) 2006-2021, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-19     Sherman      first version
+ * 2026-10-19     Sherman      write the tables as one bus section
+ * 2026-10-19     Sherman      reuse zmod4xxx_write_conf() and zmod4xxx_run_init()
+ */
+
+#include <string.h>
+
+#include "zmod4xxx_recover.h"
+
+static uint32_t recover_now(const zmod4xxx_recover_t *rec)
+{
+    return rec->clock_ms ? rec->clock_ms() : 0;
+}
+
+zmod4xxx_err zmod4xxx_recover_init(zmod4xxx_dev_t *dev, zmod4xxx_recover_t *rec,
+                                   uint32_t (*clock_ms)(void))
+{
+    zmod4xxx_err ret;
+
+    if (dev == NULL || rec == NULL || dev->init_conf == NULL ||
+        dev->meas_conf == NULL)
+    {
+        return ERROR_NULL_PTR;
+    }
+    memset(rec, 0, sizeof(*rec));
+    rec->clock_ms = clock_ms;
+
+    ret = zmod4xxx_calc_factor(dev->init_conf, rec->init_hsp, dev->config);
+    if (ret)
+    {
+        return ret;
+    }
+    return zmod4xxx_calc_factor(dev->meas_conf, rec->meas_hsp, dev->config);
+}
+
+zmod4xxx_err zmod4xxx_recover_check(zmod4xxx_dev_t *dev, zmod4xxx_recover_t *rec)
+{
+    zmod4xxx_err event, ret;
+
+    event = zmod4xxx_check_error_event(dev);
+    if (event == ERROR_POR_EVENT)
+    {
+        rec->por_events++;
+    }
+    else if (event == ERROR_ACCESS_CONFLICT)
+    {
+        rec->conflicts++;
+    }
+    else if (event != ZMOD4XXX_OK || rec->pending == ZMOD4XXX_OK)
+    {
+        return event;
+    }
+    /* a failed reconfiguration is retried on the next check */
+    if (rec->pending == ERROR_POR_EVENT || event == ZMOD4XXX_OK)
+    {
+        event = rec->pending;
+    }
+
+    if (!rec->down)
+    {
+        rec->down = 1;
+        rec->down_since_ms = recover_now(rec);
+    }
+
+    if (event == ERROR_POR_EVENT)
+    {
+        ret = zmod4xxx_run_init(dev, rec->init_hsp, ZMOD4XXX_RECOVER_POLL_MAX);
+        if (!ret)
+        {
+            dev->delay_ms(50);
+        }
+    }
+    else
+    {
+        ret = ZMOD4XXX_OK;
+    }
+    if (!ret)
+    {
+        ret = zmod4xxx_write_conf(dev, dev->meas_conf, ZMOD4XXX_CONF_ALL,
+                                  rec->meas_hsp, NULL);
+    }
+    if (ret)
+    {
+        rec->failures++;
+        rec->pending = event;
+        return ret;
+    }
+    rec->pending = ZMOD4XXX_OK;
+    rec->recoveries++;
+    return event;
+}
+
+void zmod4xxx_recover_sample(zmod4xxx_recover_t *rec)
+{
+    if (!rec->down)
+    {
+        return;
+    }
+    rec->last_downtime_ms = recover_now(rec) - rec->down_since_ms;
+    rec->downtime_ms += rec->last_downtime_ms;
+    rec->down = 0;
+}
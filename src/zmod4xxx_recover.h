@@ -0,0 +1,83 @@
+/*
+ * Copyright (c) 2006-2021, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-19     Sherman      first version
+ */
+
+#ifndef _ZMOD4XXX_RECOVER_H
+#define _ZMOD4XXX_RECOVER_H
+
+#include "zmod4xxx.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define ZMOD4XXX_RECOVER_POLL_MAX (20) /**< status polls of 50 ms for the init run */
+
+/**
+ * @brief Recovery state and metrics of one device
+ *
+ * Downtime runs from the error event being seen to the next good sample,
+ * as reported by zmod4xxx_recover_sample().
+ */
+typedef struct {
+    uint8_t init_hsp[HSP_MAX * 2]; /**< heater set points of init_conf */
+    uint8_t meas_hsp[HSP_MAX * 2]; /**< heater set points of meas_conf */
+    uint32_t (*clock_ms)(void); /**< millisecond clock for downtime */
+    uint32_t por_events; /**< power-on resets seen */
+    uint32_t conflicts; /**< access conflicts seen */
+    uint32_t recoveries; /**< reconfigurations that succeeded */
+    uint32_t failures; /**< reconfigurations that failed */
+    uint32_t downtime_ms; /**< total downtime */
+    uint32_t last_downtime_ms; /**< downtime of the last completed episode */
+    uint32_t down_since_ms; /**< start of the open episode */
+    int8_t pending; /**< event whose reconfiguration failed, 0 if none */
+    uint8_t down; /**< an episode is open */
+} zmod4xxx_recover_t;
+
+/**
+ * @brief   Cache what a reconfiguration needs
+ * @param   [in] dev device after zmod4xxx_prepare_sensor()
+ * @param   [out] rec recovery state, cleared
+ * @param   [in] clock_ms millisecond clock, may be NULL
+ * @return  error code
+ * @retval  0 success
+ * @retval  "!= 0" error
+ */
+zmod4xxx_err zmod4xxx_recover_init(zmod4xxx_dev_t *dev, zmod4xxx_recover_t *rec,
+                                   uint32_t (*clock_ms)(void));
+
+/**
+ * @brief   Check the error event register and reconfigure the sensor
+ * @param   [in] dev pointer to the device
+ * @param   [in,out] rec recovery state
+ * @return  error code
+ * @retval  0 no event, the last measurement is valid
+ * @retval  ERROR_POR_EVENT, ERROR_ACCESS_CONFLICT the sensor was
+ *          reconfigured; drop the last measurement and carry on
+ * @retval  "!= 0" other error; a failed reconfiguration is retried by
+ *          the next call
+ * @note    After a power-on reset the init and measurement tables are
+ *          written again with the cached heater set points and the init
+ *          sequence is rerun; after an access conflict only the measurement
+ *          tables are. Sensor information is not read again and algorithm
+ *          state is not touched, so the caller keeps its algorithm handle.
+ */
+zmod4xxx_err zmod4xxx_recover_check(zmod4xxx_dev_t *dev, zmod4xxx_recover_t *rec);
+
+/**
+ * @brief   Report a good sample, closing an open downtime episode
+ * @param   [in,out] rec recovery state
+ */
+void zmod4xxx_recover_sample(zmod4xxx_recover_t *rec);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _ZMOD4XXX_RECOVER_H */
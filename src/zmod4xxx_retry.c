@@ -0,0 +1,259 @@
+/*
+ * Copyright (c) 2006-2021, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-19     Sherman      first version
+ * 2026-10-19     Sherman      a bus lock timeout is not retried
+ * 2026-10-19     Sherman      no backoff inside a bus section
+ */
+
+/*
+ * Bounded retries of failed bus transactions. Like the statistics layer the
+ * bus function pointers of a device are swapped for wrappers found by I2C
+ * address; what a failure may be answered with depends on the register.
+ */
+
+#ifndef ZMOD4XXX_USING_RETRY
+#define ZMOD4XXX_USING_RETRY
+#endif
+
+#include <string.h>
+
+#include "zmod4xxx.h"
+#include "zmod4xxx_bus.h"
+#include "zmod4xxx_retry.h"
+
+#define RETRY_ADDR_EVENT (0xB7)
+
+struct retry_slot
+{
+    uint8_t used;
+    zmod4xxx_i2c_ptr_t read;
+    zmod4xxx_i2c_ptr_t write;
+    zmod4xxx_retry_policy_t policy;
+    zmod4xxx_retry_stats_t stats;
+};
+
+static struct retry_slot retry_slots[ZMOD4XXX_RETRY_DEV_MAX];
+
+static struct retry_slot *retry_find(uint8_t i2c_addr)
+{
+    uint8_t i;
+
+    for (i = 0; i < ZMOD4XXX_RETRY_DEV_MAX; i++)
+    {
+        if (retry_slots[i].used && retry_slots[i].stats.i2c_addr == i2c_addr)
+        {
+            return &retry_slots[i];
+        }
+    }
+    return NULL;
+}
+
+static uint8_t retry_classify(uint8_t reg_addr, uint8_t write)
+{
+    if (write)
+    {
+        return reg_addr == ZMOD4XXX_ADDR_CMD ? ZMOD4XXX_RETRY_OP_CMD
+                                             : ZMOD4XXX_RETRY_OP_WRITE;
+    }
+    if (reg_addr == ZMOD4XXX_ADDR_STATUS)
+    {
+        return ZMOD4XXX_RETRY_OP_STATUS;
+    }
+    return reg_addr == RETRY_ADDR_EVENT ? ZMOD4XXX_RETRY_OP_EVENT
+                                        : ZMOD4XXX_RETRY_OP_READ;
+}
+
+static void retry_backoff(struct retry_slot *slot, uint8_t attempt)
+{
+    uint32_t us = slot->policy.backoff_us;
+
+    if (slot->policy.delay_us == NULL || us == 0)
+    {
+        return;
+    }
+    while (--attempt && us < slot->policy.backoff_max_us)
+    {
+        us <<= 1;
+    }
+    if (us > slot->policy.backoff_max_us)
+    {
+        us = slot->policy.backoff_max_us;
+    }
+    slot->policy.delay_us(us);
+}
+
+/* whether a command write that reported failure took effect anyway */
+static int retry_cmd_applied(struct retry_slot *slot, uint8_t i2c_addr,
+                             uint8_t cmd)
+{
+    uint8_t status;
+
+    if (slot->read(i2c_addr, ZMOD4XXX_ADDR_STATUS, &status, 1))
+    {
+        return 0;
+    }
+    if (cmd & STATUS_SEQUENCER_RUNNING_MASK)
+    {
+        return (status & STATUS_SEQUENCER_RUNNING_MASK) != 0;
+    }
+    return (status & STATUS_SEQUENCER_RUNNING_MASK) == 0;
+}
+
+static int8_t retry_transfer(uint8_t i2c_addr, uint8_t reg_addr,
+                             uint8_t *data_buf, uint8_t len, uint8_t write)
+{
+    struct retry_slot *slot = retry_find(i2c_addr);
+    zmod4xxx_retry_op_stats_t *op;
+    uint8_t kind, attempt;
+    int8_t ret;
+
+    if (slot == NULL)
+    {
+        return ERROR_I2C;
+    }
+    kind = retry_classify(reg_addr, write);
+    op = &slot->stats.ops[kind];
+    op->calls++;
+
+    for (attempt = 1; ; attempt++)
+    {
+        ret = write ? slot->write(i2c_addr, reg_addr, data_buf, len)
+                    : slot->read(i2c_addr, reg_addr, data_buf, len);
+        if (ret == 0)
+        {
+            if (attempt > 1)
+            {
+                op->recovered++;
+            }
+            return ret;
+        }
+        if (ret == ERROR_BUS_TIMEOUT)
+        {
+            /* another user holds the bus; a retry would wait for it again */
+            op->lock_timeouts++;
+            return ret;
+        }
+        if (attempt >= slot->policy.attempts)
+        {
+            break;
+        }
+        if (kind == ZMOD4XXX_RETRY_OP_EVENT)
+        {
+            op->unsafe++;
+            break;
+        }
+
+        /* the section keeps the bus; waiting in it would stall the others */
+        if (!zmod4xxx_bus_held(i2c_addr))
+        {
+            retry_backoff(slot, attempt);
+        }
+        if (kind == ZMOD4XXX_RETRY_OP_CMD && len == 1 &&
+            retry_cmd_applied(slot, i2c_addr, data_buf[0]))
+        {
+            op->confirmed++;
+            op->recovered++;
+            return ZMOD4XXX_OK;
+        }
+        op->retries++;
+    }
+    op->failed++;
+    return ret;
+}
+
+static int8_t retry_read(uint8_t i2c_addr, uint8_t reg_addr,
+                         uint8_t *data_buf, uint8_t len)
+{
+    return retry_transfer(i2c_addr, reg_addr, data_buf, len, 0);
+}
+
+static int8_t retry_write(uint8_t i2c_addr, uint8_t reg_addr,
+                          uint8_t *data_buf, uint8_t len)
+{
+    return retry_transfer(i2c_addr, reg_addr, data_buf, len, 1);
+}
+
+zmod4xxx_err zmod4xxx_retry_attach(zmod4xxx_dev_t *dev,
+                                   const zmod4xxx_retry_policy_t *policy)
+{
+    struct retry_slot *slot;
+    uint8_t i;
+
+    if (dev == NULL || policy == NULL || dev->read == NULL || dev->write == NULL)
+    {
+        return ERROR_NULL_PTR;
+    }
+    if (policy->attempts == 0)
+    {
+        return ERROR_INIT_OUT_OF_RANGE;
+    }
+
+    slot = retry_find(dev->i2c_addr);
+    if (slot != NULL && dev->read == retry_read)
+    {
+        slot->policy = *policy;
+        return ZMOD4XXX_OK;
+    }
+    for (i = 0; slot == NULL && i < ZMOD4XXX_RETRY_DEV_MAX; i++)
+    {
+        if (!retry_slots[i].used)
+        {
+            slot = &retry_slots[i];
+        }
+    }
+    if (slot == NULL)
+    {
+        return ERROR_INIT_OUT_OF_RANGE;
+    }
+
+    memset(slot, 0, sizeof(*slot));
+    slot->read = dev->read;
+    slot->write = dev->write;
+    slot->policy = *policy;
+    slot->stats.i2c_addr = dev->i2c_addr;
+    slot->used = 1;
+
+    dev->read = retry_read;
+    dev->write = retry_write;
+    return ZMOD4XXX_OK;
+}
+
+void zmod4xxx_retry_detach(zmod4xxx_dev_t *dev)
+{
+    struct retry_slot *slot = retry_find(dev->i2c_addr);
+
+    if (slot == NULL)
+    {
+        return;
+    }
+    if (dev->read == retry_read)
+    {
+        dev->read = slot->read;
+        dev->write = slot->write;
+    }
+    slot->used = 0;
+}
+
+const zmod4xxx_retry_stats_t *zmod4xxx_retry_get(uint8_t i2c_addr)
+{
+    struct retry_slot *slot = retry_find(i2c_addr);
+
+    return slot ? &slot->stats : NULL;
+}
+
+void zmod4xxx_retry_reset(uint8_t i2c_addr)
+{
+    struct retry_slot *slot = retry_find(i2c_addr);
+
+    if (slot == NULL)
+    {
+        return;
+    }
+    memset(&slot->stats, 0, sizeof(slot->stats));
+    slot->stats.i2c_addr = i2c_addr;
+}
@@ -0,0 +1,139 @@
+/*
+ * Copyright (c) 2006-2021, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-19     Sherman      first version
+ * 2026-10-19     Sherman      a bus lock timeout is not retried
+ * 2026-10-19     Sherman      no backoff inside a bus section
+ */
+
+#ifndef _ZMOD4XXX_RETRY_H
+#define _ZMOD4XXX_RETRY_H
+
+#include "zmod4xxx_types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define ZMOD4XXX_RETRY_DEV_MAX  (4) /**< devices that can have a policy */
+
+#ifndef ZMOD4XXX_RETRY_ATTEMPTS
+#define ZMOD4XXX_RETRY_ATTEMPTS (3) /**< default tries per transaction */
+#endif
+#ifndef ZMOD4XXX_RETRY_BACKOFF_US
+#define ZMOD4XXX_RETRY_BACKOFF_US (100) /**< default first backoff */
+#endif
+#ifndef ZMOD4XXX_RETRY_BACKOFF_MAX_US
+#define ZMOD4XXX_RETRY_BACKOFF_MAX_US (2000) /**< default backoff limit */
+#endif
+
+/**
+ * @brief Kinds of transaction, each with its own rule and counters
+ *
+ * Reads of status, results and sensor information, and writes of the
+ * sequencer tables are repeated as they are. The error event register is
+ * cleared on read, so a failed read of it is not repeated: it may already
+ * have cleared the event. A failed command write is only repeated after the
+ * status register shows it did not take effect. ERROR_BUS_TIMEOUT from the
+ * bus layer is never repeated: the transaction did not reach the bus, and
+ * each try waits up to ZMOD4XXX_BUS_TIMEOUT_MS for another user. Inside a
+ * section of zmod4xxx_bus_begin() the retries follow at once: a backoff
+ * there would wait with the bus held, and delay_us may sleep.
+ */
+typedef enum {
+    ZMOD4XXX_RETRY_OP_STATUS = 0, /**< read of ZMOD4XXX_ADDR_STATUS */
+    ZMOD4XXX_RETRY_OP_READ, /**< results, sensor information, other reads */
+    ZMOD4XXX_RETRY_OP_EVENT, /**< read of the error event register 0xB7 */
+    ZMOD4XXX_RETRY_OP_CMD, /**< write of ZMOD4XXX_ADDR_CMD */
+    ZMOD4XXX_RETRY_OP_WRITE, /**< sequencer tables, other writes */
+    ZMOD4XXX_RETRY_OP_MAX
+} zmod4xxx_retry_op;
+
+/**
+ * @brief Retry policy of one device
+ */
+typedef struct {
+    uint8_t attempts; /**< tries per transaction, 1 disables retrying */
+    uint32_t backoff_us; /**< wait before the first retry, doubled after each */
+    uint32_t backoff_max_us; /**< longest wait */
+    void (*delay_us)(uint32_t us); /**< short wait, NULL to retry at once */
+} zmod4xxx_retry_policy_t;
+
+/**
+ * @brief Counters of one kind of transaction
+ *
+ * A marginal bus shows up as retries that end in recovered, a dead one as
+ * failed growing with calls.
+ */
+typedef struct {
+    uint32_t calls; /**< transactions */
+    uint32_t retries; /**< attempts after the first */
+    uint32_t recovered; /**< transactions that succeeded after a retry */
+    uint32_t failed; /**< transactions that failed on every attempt */
+    uint32_t unsafe; /**< failures not retried because repeating is unsafe */
+    uint32_t confirmed; /**< command writes found applied by the status check */
+    uint32_t lock_timeouts; /**< transactions that did not get the bus lock */
+} zmod4xxx_retry_op_stats_t;
+
+/**
+ * @brief Retry counters of one device
+ */
+typedef struct {
+    uint8_t i2c_addr; /**< address of the device */
+    zmod4xxx_retry_op_stats_t ops[ZMOD4XXX_RETRY_OP_MAX];
+} zmod4xxx_retry_stats_t;
+
+#ifdef ZMOD4XXX_USING_RETRY
+
+/**
+ * @brief   Route the bus accesses of a device through a retry policy
+ * @param   [in,out] dev device with read/write already set up; they are
+ *          replaced by retrying wrappers
+ * @param   [in] policy policy, copied
+ * @return  error code
+ * @retval  0 success
+ * @retval  "!= 0" error
+ * @note    Devices are told apart by I2C address. Attach after
+ *          zmod4xxx_stats_attach() to have the statistics count every
+ *          attempt.
+ */
+zmod4xxx_err zmod4xxx_retry_attach(zmod4xxx_dev_t *dev,
+                                   const zmod4xxx_retry_policy_t *policy);
+
+/**
+ * @brief   Restore the original bus functions of a device
+ * @param   [in,out] dev pointer to the device
+ */
+void zmod4xxx_retry_detach(zmod4xxx_dev_t *dev);
+
+/**
+ * @brief   Get the retry counters of a device
+ * @param   [in] i2c_addr address of the device
+ * @return  counters or NULL if the address has no policy
+ */
+const zmod4xxx_retry_stats_t *zmod4xxx_retry_get(uint8_t i2c_addr);
+
+/**
+ * @brief   Clear the retry counters of a device
+ * @param   [in] i2c_addr address of the device
+ */
+void zmod4xxx_retry_reset(uint8_t i2c_addr);
+
+#else
+
+#define zmod4xxx_retry_attach(dev, policy)  (ZMOD4XXX_OK)
+#define zmod4xxx_retry_detach(dev)          ((void)0)
+#define zmod4xxx_retry_get(i2c_addr)        ((const zmod4xxx_retry_stats_t *)0)
+#define zmod4xxx_retry_reset(i2c_addr)      ((void)0)
+
+#endif /* ZMOD4XXX_USING_RETRY */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _ZMOD4XXX_RETRY_H */
@@ -0,0 +1,132 @@
+/*
+ * Copyright (c) 2006-2021, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-19     Sherman      first version
+ */
+
+/*
+ * Threshold and rate rules over the algorithm outputs. Evaluation only
+ * reports edges; who is told about them and how is up to the caller.
+ */
+
+#ifndef ZMOD4XXX_USING_RULES
+#define ZMOD4XXX_USING_RULES
+#endif
+
+#include <string.h>
+
+#include "zmod4xxx_rule.h"
+
+int8_t zmod4xxx_rule_add(zmod4xxx_rule_set_t *set, const zmod4xxx_rule_t *rule)
+{
+    int8_t id;
+
+    if (rule->channel >= ZMOD4XXX_CH_MAX || rule->kind > ZMOD4XXX_RULE_FALL ||
+        rule->hysteresis < 0)
+    {
+        return -1;
+    }
+    for (id = 0; id < ZMOD4XXX_RULE_MAX; id++)
+    {
+        if (!set->rules[id].used)
+        {
+            memset(&set->rules[id], 0, sizeof(set->rules[id]));
+            set->rules[id].rule = *rule;
+            if (set->rules[id].rule.debounce == 0)
+            {
+                set->rules[id].rule.debounce = 1;
+            }
+            set->rules[id].used = 1;
+            return id;
+        }
+    }
+    return -1;
+}
+
+void zmod4xxx_rule_remove(zmod4xxx_rule_set_t *set, int8_t id)
+{
+    if (id < 0 || id >= ZMOD4XXX_RULE_MAX)
+    {
+        return;
+    }
+    set->rules[id].used = 0;
+    set->active &= ~(1UL << id);
+}
+
+/* the condition with the threshold moved by the hysteresis while active */
+static int rule_holds(const zmod4xxx_rule_state_t *st, float x)
+{
+    float thr = st->rule.threshold;
+
+    if (st->rule.kind == ZMOD4XXX_RULE_BELOW)
+    {
+        return st->active ? x < thr + st->rule.hysteresis : x < thr;
+    }
+    return st->active ? x > thr - st->rule.hysteresis : x > thr;
+}
+
+uint32_t zmod4xxx_rule_eval(zmod4xxx_rule_set_t *set,
+                            const float values[ZMOD4XXX_CH_MAX], uint32_t now_ms)
+{
+    zmod4xxx_rule_state_t *st;
+    uint32_t changed = 0;
+    uint32_t dt;
+    float v, x;
+    int8_t id;
+
+    for (id = 0; id < ZMOD4XXX_RULE_MAX; id++)
+    {
+        st = &set->rules[id];
+        if (!st->used)
+        {
+            continue;
+        }
+        v = values[st->rule.channel];
+        x = v;
+        if (st->rule.kind == ZMOD4XXX_RULE_RISE || st->rule.kind == ZMOD4XXX_RULE_FALL)
+        {
+            dt = now_ms - st->last_ms;
+            if (!st->primed || dt == 0)
+            {
+                st->last = v;
+                st->last_ms = now_ms;
+                st->primed = 1;
+                continue;
+            }
+            x = (v - st->last) * 60000.0f / (float)dt;
+            if (st->rule.kind == ZMOD4XXX_RULE_FALL)
+            {
+                x = -x;
+            }
+            st->last = v;
+            st->last_ms = now_ms;
+        }
+
+        if (rule_holds(st, x) == st->active)
+        {
+            st->count = 0;
+            continue;
+        }
+        if (++st->count < st->rule.debounce)
+        {
+            continue;
+        }
+        st->count = 0;
+        st->active = !st->active;
+        if (st->active)
+        {
+            st->fired++;
+            set->active |= 1UL << id;
+        }
+        else
+        {
+            set->active &= ~(1UL << id);
+        }
+        changed |= 1UL << id;
+    }
+    return changed;
+}
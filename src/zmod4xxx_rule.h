@@ -0,0 +1,115 @@
+/*
+ * Copyright (c) 2006-2021, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-19     Sherman      first version
+ */
+
+#ifndef _ZMOD4XXX_RULE_H
+#define _ZMOD4XXX_RULE_H
+
+#include "zmod4xxx_types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define ZMOD4XXX_RULE_MAX (16) /**< rules per set, ids are 0..ZMOD4XXX_RULE_MAX-1 */
+
+/**
+ * @brief Algorithm outputs a rule can watch
+ */
+typedef enum {
+    ZMOD4XXX_CH_IAQ = 0, /**< IAQ index */
+    ZMOD4XXX_CH_TVOC, /**< TVOC, mg/m^3 */
+    ZMOD4XXX_CH_ETOH, /**< EtOH, ppm */
+    ZMOD4XXX_CH_ECO2, /**< eCO2, ppm */
+    ZMOD4XXX_CH_MAX
+} zmod4xxx_channel;
+
+/**
+ * @brief Conditions of a rule
+ */
+typedef enum {
+    ZMOD4XXX_RULE_ABOVE = 0, /**< value above threshold */
+    ZMOD4XXX_RULE_BELOW, /**< value below threshold */
+    ZMOD4XXX_RULE_RISE, /**< value rising faster than threshold per minute */
+    ZMOD4XXX_RULE_FALL, /**< value falling faster than threshold per minute,
+                             threshold given as a positive rate */
+} zmod4xxx_rule_kind;
+
+/**
+ * @brief One rule
+ *
+ * A rule becomes active when its condition holds for debounce samples in a
+ * row, and inactive when the value is back by more than hysteresis on the
+ * other side of the threshold for as many samples.
+ */
+typedef struct {
+    uint8_t channel; /**< zmod4xxx_channel */
+    uint8_t kind; /**< zmod4xxx_rule_kind */
+    uint8_t debounce; /**< samples in a row for a change, 0 is taken as 1 */
+    float threshold; /**< level, or rate per minute for RISE and FALL */
+    float hysteresis; /**< distance from the threshold to clear again */
+} zmod4xxx_rule_t;
+
+/**
+ * @brief State of one rule
+ */
+typedef struct {
+    zmod4xxx_rule_t rule;
+    uint8_t used; /**< slot holds a rule */
+    uint8_t active; /**< condition currently reported as met */
+    uint8_t count; /**< samples in a row that disagree with active */
+    uint8_t primed; /**< last and last_ms are set, needed for rates */
+    float last; /**< previous value of the channel */
+    uint32_t last_ms; /**< time of the previous value */
+    uint32_t fired; /**< times the rule became active */
+} zmod4xxx_rule_state_t;
+
+/**
+ * @brief A set of rules evaluated together
+ */
+typedef struct {
+    zmod4xxx_rule_state_t rules[ZMOD4XXX_RULE_MAX];
+    uint32_t active; /**< bit per rule id, set while the rule is active */
+} zmod4xxx_rule_set_t;
+
+#ifdef ZMOD4XXX_USING_RULES
+
+/**
+ * @brief   Add a rule to a set
+ * @param   [in,out] set zero-initialized rule set
+ * @param   [in] rule rule, copied
+ * @return  id of the rule, or -1 if the set is full or the rule is invalid
+ */
+int8_t zmod4xxx_rule_add(zmod4xxx_rule_set_t *set, const zmod4xxx_rule_t *rule);
+
+/**
+ * @brief   Remove a rule from a set
+ * @param   [in,out] set rule set
+ * @param   [in] id id returned by zmod4xxx_rule_add()
+ */
+void zmod4xxx_rule_remove(zmod4xxx_rule_set_t *set, int8_t id);
+
+/**
+ * @brief   Evaluate all rules on one sample
+ * @param   [in,out] set rule set
+ * @param   [in] values outputs indexed by zmod4xxx_channel
+ * @param   [in] now_ms time of the sample
+ * @return  bit per rule id that became active or inactive; set->active
+ *          tells which
+ */
+uint32_t zmod4xxx_rule_eval(zmod4xxx_rule_set_t *set,
+                            const float values[ZMOD4XXX_CH_MAX], uint32_t now_ms);
+
+#endif /* ZMOD4XXX_USING_RULES */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _ZMOD4XXX_RULE_H */
@@ -0,0 +1,246 @@
+/*
+ * Copyright (c) 2006-2021, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-19     Sherman      first version
+ * 2026-10-19     Sherman      count bus lock timeouts
+ */
+
+/*
+ * I2C transaction statistics. The bus function pointers of a device are
+ * swapped for wrappers that count calls, bytes, failures and latency per
+ * register. zmod4xxx_i2c_ptr_t carries no context, so the wrappers find
+ * their device by I2C address.
+ */
+
+#ifndef ZMOD4XXX_USING_STATS
+#define ZMOD4XXX_USING_STATS
+#endif
+
+#include <string.h>
+
+#include "zmod4xxx_stats.h"
+
+struct stats_slot
+{
+    uint8_t used;
+    zmod4xxx_i2c_ptr_t read;
+    zmod4xxx_i2c_ptr_t write;
+    zmod4xxx_clock_us_ptr_t clock;
+    zmod4xxx_stats_t stats;
+};
+
+static struct stats_slot stats_slots[ZMOD4XXX_STATS_DEV_MAX];
+
+static struct stats_slot *stats_find(uint8_t i2c_addr)
+{
+    uint8_t i;
+
+    for (i = 0; i < ZMOD4XXX_STATS_DEV_MAX; i++)
+    {
+        if (stats_slots[i].used && stats_slots[i].stats.i2c_addr == i2c_addr)
+        {
+            return &stats_slots[i];
+        }
+    }
+    return NULL;
+}
+
+static zmod4xxx_reg_stats_t *stats_reg(zmod4xxx_stats_t *st, uint8_t reg,
+                                       uint8_t write)
+{
+    uint8_t i;
+
+    for (i = 0; i < st->reg_count; i++)
+    {
+        if (st->regs[i].reg == reg && st->regs[i].write == write)
+        {
+            return &st->regs[i];
+        }
+    }
+    if (st->reg_count == ZMOD4XXX_STATS_REG_MAX)
+    {
+        st->overflow++;
+        return NULL;
+    }
+    st->regs[st->reg_count].reg = reg;
+    st->regs[st->reg_count].write = write;
+    return &st->regs[st->reg_count++];
+}
+
+static uint8_t stats_bucket(uint32_t us)
+{
+    uint8_t b = 0;
+
+    while (us && b < ZMOD4XXX_STATS_BUCKETS - 1)
+    {
+        us >>= 1;
+        b++;
+    }
+    return b;
+}
+
+static void stats_account(struct stats_slot *slot, uint8_t reg, uint8_t write,
+                          uint8_t len, int8_t ret, uint32_t us)
+{
+    zmod4xxx_reg_stats_t *rs = stats_reg(&slot->stats, reg, write);
+
+    if (ret)
+    {
+        /* the bus layer below may not get the lock; that is no bus error */
+        slot->stats.err[ret == ERROR_BUS_TIMEOUT ? -ERROR_BUS_TIMEOUT : -ERROR_I2C]++;
+    }
+    if (rs == NULL)
+    {
+        return;
+    }
+    rs->calls++;
+    if (ret)
+    {
+        rs->errors++;
+    }
+    else
+    {
+        rs->bytes += len;
+    }
+    if (us > rs->max_us)
+    {
+        rs->max_us = us;
+    }
+    rs->hist[stats_bucket(us)]++;
+}
+
+static int8_t stats_transfer(uint8_t i2c_addr, uint8_t reg_addr,
+                             uint8_t *data_buf, uint8_t len, uint8_t write)
+{
+    struct stats_slot *slot = stats_find(i2c_addr);
+    uint32_t t0 = 0, t1 = 0;
+    int8_t ret;
+
+    if (slot == NULL)
+    {
+        return ERROR_I2C;
+    }
+    if (slot->clock)
+    {
+        t0 = slot->clock();
+    }
+    ret = write ? slot->write(i2c_addr, reg_addr, data_buf, len)
+                : slot->read(i2c_addr, reg_addr, data_buf, len);
+    if (slot->clock)
+    {
+        t1 = slot->clock();
+    }
+    stats_account(slot, reg_addr, write, len, ret, t1 - t0);
+    return ret;
+}
+
+static int8_t stats_read(uint8_t i2c_addr, uint8_t reg_addr,
+                         uint8_t *data_buf, uint8_t len)
+{
+    return stats_transfer(i2c_addr, reg_addr, data_buf, len, 0);
+}
+
+static int8_t stats_write(uint8_t i2c_addr, uint8_t reg_addr,
+                          uint8_t *data_buf, uint8_t len)
+{
+    return stats_transfer(i2c_addr, reg_addr, data_buf, len, 1);
+}
+
+zmod4xxx_err zmod4xxx_stats_attach(zmod4xxx_dev_t *dev,
+                                   zmod4xxx_clock_us_ptr_t clock)
+{
+    struct stats_slot *slot;
+    uint8_t i;
+
+    if (dev == NULL || dev->read == NULL || dev->write == NULL)
+    {
+        return ERROR_NULL_PTR;
+    }
+    if (dev->read == stats_read)
+    {
+        return ZMOD4XXX_OK;
+    }
+
+    slot = stats_find(dev->i2c_addr);
+    for (i = 0; slot == NULL && i < ZMOD4XXX_STATS_DEV_MAX; i++)
+    {
+        if (!stats_slots[i].used)
+        {
+            slot = &stats_slots[i];
+        }
+    }
+    if (slot == NULL)
+    {
+        return ERROR_INIT_OUT_OF_RANGE;
+    }
+
+    memset(slot, 0, sizeof(*slot));
+    slot->read = dev->read;
+    slot->write = dev->write;
+    slot->clock = clock;
+    slot->stats.i2c_addr = dev->i2c_addr;
+    slot->used = 1;
+
+    dev->read = stats_read;
+    dev->write = stats_write;
+    return ZMOD4XXX_OK;
+}
+
+void zmod4xxx_stats_detach(zmod4xxx_dev_t *dev)
+{
+    struct stats_slot *slot = stats_find(dev->i2c_addr);
+
+    if (slot == NULL)
+    {
+        return;
+    }
+    if (dev->read == stats_read)
+    {
+        dev->read = slot->read;
+        dev->write = slot->write;
+    }
+    slot->used = 0;
+}
+
+void zmod4xxx_stats_error(zmod4xxx_dev_t *dev, int8_t err)
+{
+    struct stats_slot *slot;
+
+    if (err >= 0 || -err >= ZMOD4XXX_STATS_ERR_MAX)
+    {
+        return;
+    }
+    slot = stats_find(dev->i2c_addr);
+    if (slot == NULL)
+    {
+        return;
+    }
+    /* bus failures are already counted by the wrappers */
+    if (err != ERROR_I2C)
+    {
+        slot->stats.err[-err]++;
+    }
+}
+
+const zmod4xxx_stats_t *zmod4xxx_stats_get(uint8_t i2c_addr)
+{
+    struct stats_slot *slot = stats_find(i2c_addr);
+
+    return slot ? &slot->stats : NULL;
+}
+
+void zmod4xxx_stats_reset(uint8_t i2c_addr)
+{
+    struct stats_slot *slot = stats_find(i2c_addr);
+
+    if (slot == NULL)
+    {
+        return;
+    }
+    memset(&slot->stats, 0, sizeof(slot->stats));
+    slot->stats.i2c_addr = i2c_addr;
+}
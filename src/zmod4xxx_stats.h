@@ -0,0 +1,114 @@
+/*
+ * Copyright (c) 2006-2021, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-19     Sherman      first version
+ * 2026-10-19     Sherman      count bus lock timeouts
+ */
+
+#ifndef _ZMOD4XXX_STATS_H
+#define _ZMOD4XXX_STATS_H
+
+#include "zmod4xxx_types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define ZMOD4XXX_STATS_DEV_MAX  (4)  /**< devices that can be instrumented */
+#define ZMOD4XXX_STATS_REG_MAX  (16) /**< register/direction pairs per device */
+#define ZMOD4XXX_STATS_BUCKETS  (16) /**< latency buckets, see below */
+#define ZMOD4XXX_STATS_ERR_MAX  (22) /**< -ERROR_BUS_TIMEOUT + 1 */
+
+/**
+ * @brief function pointer to a free-running microsecond clock
+ * @return microseconds, wrapping at 2^32
+ */
+typedef uint32_t (*zmod4xxx_clock_us_ptr_t)(void);
+
+/**
+ * @brief Counters of one register, one direction
+ *
+ * hist[0] counts transactions below 1 us, hist[k] those in [2^(k-1), 2^k) us,
+ * and the last bucket everything above.
+ */
+typedef struct {
+    uint8_t reg; /**< register address */
+    uint8_t write; /**< 1 for writes, 0 for reads */
+    uint32_t calls; /**< transactions */
+    uint32_t bytes; /**< payload bytes moved */
+    uint32_t errors; /**< transactions the bus reported as failed */
+    uint32_t max_us; /**< slowest transaction */
+    uint32_t hist[ZMOD4XXX_STATS_BUCKETS]; /**< latency histogram */
+} zmod4xxx_reg_stats_t;
+
+/**
+ * @brief Statistics of one instrumented device
+ */
+typedef struct {
+    uint8_t i2c_addr; /**< address of the device */
+    uint8_t reg_count; /**< used entries of regs */
+    uint32_t overflow; /**< transactions on registers that found no entry */
+    uint32_t err[ZMOD4XXX_STATS_ERR_MAX]; /**< err[-e] counts zmod4xxx_err e */
+    zmod4xxx_reg_stats_t regs[ZMOD4XXX_STATS_REG_MAX];
+} zmod4xxx_stats_t;
+
+#ifdef ZMOD4XXX_USING_STATS
+
+/**
+ * @brief   Route the bus accesses of a device through the statistics layer
+ * @param   [in,out] dev device with read/write already set up; they are
+ *          replaced by counting wrappers
+ * @param   [in] clock microsecond clock for latencies, may be NULL
+ * @return  error code
+ * @retval  0 success
+ * @retval  "!= 0" error
+ * @note    Devices are told apart by I2C address.
+ */
+zmod4xxx_err zmod4xxx_stats_attach(zmod4xxx_dev_t *dev,
+                                   zmod4xxx_clock_us_ptr_t clock);
+
+/**
+ * @brief   Restore the original bus functions of a device
+ * @param   [in,out] dev pointer to the device
+ */
+void zmod4xxx_stats_detach(zmod4xxx_dev_t *dev);
+
+/**
+ * @brief   Count an error returned by the driver API
+ * @param   [in] dev pointer to the device
+ * @param   [in] err value returned by a zmod4xxx_* or algorithm function
+ */
+void zmod4xxx_stats_error(zmod4xxx_dev_t *dev, int8_t err);
+
+/**
+ * @brief   Get the statistics of an instrumented device
+ * @param   [in] i2c_addr address of the device
+ * @return  statistics or NULL if the address is not instrumented
+ */
+const zmod4xxx_stats_t *zmod4xxx_stats_get(uint8_t i2c_addr);
+
+/**
+ * @brief   Clear the statistics of an instrumented device
+ * @param   [in] i2c_addr address of the device
+ */
+void zmod4xxx_stats_reset(uint8_t i2c_addr);
+
+#else
+
+#define zmod4xxx_stats_attach(dev, clock)   (ZMOD4XXX_OK)
+#define zmod4xxx_stats_detach(dev)          ((void)0)
+#define zmod4xxx_stats_error(dev, err)      ((void)0)
+#define zmod4xxx_stats_get(i2c_addr)        ((const zmod4xxx_stats_t *)0)
+#define zmod4xxx_stats_reset(i2c_addr)      ((void)0)
+
+#endif /* ZMOD4XXX_USING_STATS */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _ZMOD4XXX_STATS_H */
@@ -0,0 +1,246 @@
+/*
+ * Copyright (c) 2006-2021, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-19     Sherman      first version
+ */
+
+/*
+ * Span trace ring. Writers claim a slot with an atomic increment of the head
+ * and publish it by storing its sequence number last, so any number of
+ * threads and interrupts can record without a lock. When the ring is full
+ * the oldest spans are overwritten; readers drop slots whose sequence
+ * number changes while they copy them.
+ */
+
+#ifndef ZMOD4XXX_USING_TRACE
+#define ZMOD4XXX_USING_TRACE
+#endif
+
+#include <stdio.h>
+#include <string.h>
+
+#include "zmod4xxx_trace.h"
+
+#if (ZMOD4XXX_TRACE_SIZE & (ZMOD4XXX_TRACE_SIZE - 1)) != 0
+#error "ZMOD4XXX_TRACE_SIZE must be a power of two"
+#endif
+
+#define TRACE_DEV_MAX (4)
+
+struct trace_slot
+{
+    uint8_t i2c_addr;
+    zmod4xxx_i2c_ptr_t read;
+    zmod4xxx_i2c_ptr_t write;
+};
+
+static zmod4xxx_trace_rec_t trace_ring[ZMOD4XXX_TRACE_SIZE];
+static uint32_t trace_head;
+static uint32_t (*trace_clock)(void);
+static struct trace_slot trace_slots[TRACE_DEV_MAX];
+
+static const char *const trace_names[ZMOD4XXX_TRACE_EVENT_MAX] = {
+    "i2c_read", "i2c_write", "prepare", "start", "status", "adc_read",
+    "calc_rmox", "poll", "algo", "publish", "cycle",
+};
+
+void zmod4xxx_trace_init(uint32_t (*clock)(void))
+{
+    trace_clock = clock;
+}
+
+uint32_t zmod4xxx_trace_now(void)
+{
+    return trace_clock ? trace_clock() : 0;
+}
+
+void zmod4xxx_trace_record(uint8_t event, uint8_t track, uint32_t begin_us,
+                           uint16_t arg)
+{
+    uint32_t end_us = zmod4xxx_trace_now();
+    uint32_t idx = __atomic_fetch_add(&trace_head, 1, __ATOMIC_RELAXED);
+    zmod4xxx_trace_rec_t *rec = &trace_ring[idx & (ZMOD4XXX_TRACE_SIZE - 1)];
+
+    __atomic_store_n(&rec->seq, 0, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+    rec->ts_us = begin_us;
+    rec->dur_us = end_us - begin_us;
+    rec->event = event;
+    rec->track = track;
+    rec->arg = arg;
+    __atomic_store_n(&rec->seq, idx + 1, __ATOMIC_RELEASE);
+}
+
+static struct trace_slot *trace_find(uint8_t i2c_addr)
+{
+    uint8_t i;
+
+    for (i = 0; i < TRACE_DEV_MAX; i++)
+    {
+        if (trace_slots[i].read && trace_slots[i].i2c_addr == i2c_addr)
+        {
+            return &trace_slots[i];
+        }
+    }
+    return NULL;
+}
+
+static int8_t trace_read(uint8_t i2c_addr, uint8_t reg_addr,
+                         uint8_t *data_buf, uint8_t len)
+{
+    struct trace_slot *slot = trace_find(i2c_addr);
+    uint32_t t0 = zmod4xxx_trace_now();
+    int8_t ret;
+
+    if (slot == NULL)
+    {
+        return ERROR_I2C;
+    }
+    ret = slot->read(i2c_addr, reg_addr, data_buf, len);
+    zmod4xxx_trace_record(ZMOD4XXX_TRACE_I2C_READ, i2c_addr, t0,
+                          (uint16_t)((reg_addr << 8) | len));
+    return ret;
+}
+
+static int8_t trace_write(uint8_t i2c_addr, uint8_t reg_addr,
+                          uint8_t *data_buf, uint8_t len)
+{
+    struct trace_slot *slot = trace_find(i2c_addr);
+    uint32_t t0 = zmod4xxx_trace_now();
+    int8_t ret;
+
+    if (slot == NULL)
+    {
+        return ERROR_I2C;
+    }
+    ret = slot->write(i2c_addr, reg_addr, data_buf, len);
+    zmod4xxx_trace_record(ZMOD4XXX_TRACE_I2C_WRITE, i2c_addr, t0,
+                          (uint16_t)((reg_addr << 8) | len));
+    return ret;
+}
+
+zmod4xxx_err zmod4xxx_trace_attach(zmod4xxx_dev_t *dev)
+{
+    struct trace_slot *slot;
+    uint8_t i;
+
+    if (dev == NULL || dev->read == NULL || dev->write == NULL)
+    {
+        return ERROR_NULL_PTR;
+    }
+    if (dev->read == trace_read)
+    {
+        return ZMOD4XXX_OK;
+    }
+
+    slot = trace_find(dev->i2c_addr);
+    for (i = 0; slot == NULL && i < TRACE_DEV_MAX; i++)
+    {
+        if (trace_slots[i].read == NULL)
+        {
+            slot = &trace_slots[i];
+        }
+    }
+    if (slot == NULL)
+    {
+        return ERROR_INIT_OUT_OF_RANGE;
+    }
+    slot->i2c_addr = dev->i2c_addr;
+    slot->write = dev->write;
+    slot->read = dev->read;
+
+    dev->read = trace_read;
+    dev->write = trace_write;
+    return ZMOD4XXX_OK;
+}
+
+/* copy one slot, failing if it is empty or was rewritten meanwhile */
+static int trace_copy(uint32_t idx, zmod4xxx_trace_rec_t *rec)
+{
+    const zmod4xxx_trace_rec_t *slot =
+        &trace_ring[idx & (ZMOD4XXX_TRACE_SIZE - 1)];
+
+    if (__atomic_load_n(&slot->seq, __ATOMIC_ACQUIRE) != idx + 1)
+    {
+        return 0;
+    }
+    *rec = *slot;
+    __atomic_thread_fence(__ATOMIC_ACQUIRE);
+    return __atomic_load_n(&slot->seq, __ATOMIC_RELAXED) == idx + 1 &&
+           rec->event < ZMOD4XXX_TRACE_EVENT_MAX;
+}
+
+static uint32_t trace_oldest(uint32_t head)
+{
+    return head > ZMOD4XXX_TRACE_SIZE ? head - ZMOD4XXX_TRACE_SIZE : 0;
+}
+
+uint32_t zmod4xxx_trace_snapshot(zmod4xxx_trace_rec_t *recs, uint32_t max)
+{
+    uint32_t head = __atomic_load_n(&trace_head, __ATOMIC_ACQUIRE);
+    uint32_t idx, n = 0;
+
+    for (idx = trace_oldest(head); idx != head && n < max; idx++)
+    {
+        if (trace_copy(idx, &recs[n]))
+        {
+            n++;
+        }
+    }
+    return n;
+}
+
+void zmod4xxx_trace_dump_json(zmod4xxx_trace_out_ptr_t out, void *ctx)
+{
+    zmod4xxx_trace_rec_t rec;
+    uint32_t head = __atomic_load_n(&trace_head, __ATOMIC_ACQUIRE);
+    uint32_t idx;
+    char line[160];
+    const char *sep = "";
+
+    out(ctx, "{\"traceEvents\":[\n");
+    for (idx = trace_oldest(head); idx != head; idx++)
+    {
+        if (!trace_copy(idx, &rec))
+        {
+            continue;
+        }
+        if (rec.event <= ZMOD4XXX_TRACE_I2C_WRITE)
+        {
+            snprintf(line, sizeof(line),
+                     "%s{\"name\":\"%s 0x%02X\",\"cat\":\"i2c\",\"ph\":\"X\","
+                     "\"ts\":%lu,\"dur\":%lu,\"pid\":%u,\"tid\":1,"
+                     "\"args\":{\"len\":%u}}",
+                     sep, trace_names[rec.event], rec.arg >> 8,
+                     (unsigned long)rec.ts_us, (unsigned long)rec.dur_us,
+                     rec.track, rec.arg & 0xFF);
+        }
+        else
+        {
+            snprintf(line, sizeof(line),
+                     "%s{\"name\":\"%s\",\"cat\":\"driver\",\"ph\":\"X\","
+                     "\"ts\":%lu,\"dur\":%lu,\"pid\":%u,\"tid\":0,"
+                     "\"args\":{\"arg\":%d}}",
+                     sep, trace_names[rec.event],
+                     (unsigned long)rec.ts_us, (unsigned long)rec.dur_us,
+                     rec.track, (int16_t)rec.arg);
+        }
+        out(ctx, line);
+        sep = ",\n";
+    }
+    out(ctx, "\n]}\n");
+}
+
+void zmod4xxx_trace_clear(void)
+{
+    uint32_t i;
+
+    for (i = 0; i < ZMOD4XXX_TRACE_SIZE; i++)
+    {
+        __atomic_store_n(&trace_ring[i].seq, 0, __ATOMIC_RELAXED);
+    }
+}
@@ -0,0 +1,137 @@
+/*
+ * Copyright (c) 2006-2021, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-19     Sherman      first version
+ */
+
+#ifndef _ZMOD4XXX_TRACE_H
+#define _ZMOD4XXX_TRACE_H
+
+#include "zmod4xxx_types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifndef ZMOD4XXX_TRACE_SIZE
+#define ZMOD4XXX_TRACE_SIZE (256) /**< records in the ring, power of two */
+#endif
+
+/**
+ * @brief Span types recorded in the trace
+ */
+typedef enum {
+    ZMOD4XXX_TRACE_I2C_READ = 0, /**< one read transaction */
+    ZMOD4XXX_TRACE_I2C_WRITE, /**< one write transaction */
+    ZMOD4XXX_TRACE_PREPARE, /**< zmod4xxx_prepare_sensor() */
+    ZMOD4XXX_TRACE_START, /**< zmod4xxx_start_measurement() */
+    ZMOD4XXX_TRACE_STATUS, /**< zmod4xxx_read_status() */
+    ZMOD4XXX_TRACE_ADC_READ, /**< zmod4xxx_read_adc_result() */
+    ZMOD4XXX_TRACE_CALC_RMOX, /**< zmod4xxx_calc_rmox() */
+    ZMOD4XXX_TRACE_POLL, /**< waiting for the sequencer to finish */
+    ZMOD4XXX_TRACE_ALGO, /**< the gas algorithm, e.g. calc_iaq_2nd_gen() */
+    ZMOD4XXX_TRACE_PUBLISH, /**< handing the results to the consumer */
+    ZMOD4XXX_TRACE_CYCLE, /**< one full acquisition */
+    ZMOD4XXX_TRACE_EVENT_MAX
+} zmod4xxx_trace_event;
+
+/**
+ * @brief One completed span
+ */
+typedef struct {
+    uint32_t seq; /**< write index + 1, 0 while the record is written */
+    uint32_t ts_us; /**< begin time */
+    uint32_t dur_us; /**< duration */
+    uint8_t event; /**< zmod4xxx_trace_event */
+    uint8_t track; /**< I2C address of the sensor */
+    uint16_t arg; /**< register << 8 | length for I2C, result otherwise */
+} zmod4xxx_trace_rec_t;
+
+/**
+ * @brief function pointer receiving dump output
+ * @param [in] ctx caller context
+ * @param [in] str NUL-terminated chunk of text
+ */
+typedef void (*zmod4xxx_trace_out_ptr_t)(void *ctx, const char *str);
+
+#ifdef ZMOD4XXX_USING_TRACE
+
+/**
+ * @brief   Set the microsecond clock spans are stamped with
+ * @param   [in] clock free-running microsecond clock
+ */
+void zmod4xxx_trace_init(uint32_t (*clock)(void));
+
+/**
+ * @brief   Read the trace clock
+ * @return  microseconds, 0 before zmod4xxx_trace_init()
+ */
+uint32_t zmod4xxx_trace_now(void);
+
+/**
+ * @brief   Append a completed span; safe from any thread or interrupt
+ * @param   [in] event zmod4xxx_trace_event
+ * @param   [in] track I2C address of the sensor
+ * @param   [in] begin_us value of zmod4xxx_trace_now() at the start
+ * @param   [in] arg event specific argument
+ */
+void zmod4xxx_trace_record(uint8_t event, uint8_t track, uint32_t begin_us,
+                           uint16_t arg);
+
+/**
+ * @brief   Trace every bus transaction of a device
+ * @param   [in,out] dev device with read/write already set up
+ * @return  error code
+ * @retval  0 success
+ * @retval  "!= 0" error
+ */
+zmod4xxx_err zmod4xxx_trace_attach(zmod4xxx_dev_t *dev);
+
+/**
+ * @brief   Copy out the records still in the ring, oldest first
+ * @param   [out] recs destination
+ * @param   [in] max capacity of recs
+ * @return  number of records copied
+ */
+uint32_t zmod4xxx_trace_snapshot(zmod4xxx_trace_rec_t *recs, uint32_t max);
+
+/**
+ * @brief   Write the ring as Chrome trace JSON (chrome://tracing, Perfetto)
+ * @param   [in] out output function
+ * @param   [in] ctx passed to out
+ */
+void zmod4xxx_trace_dump_json(zmod4xxx_trace_out_ptr_t out, void *ctx);
+
+/**
+ * @brief   Drop all records
+ */
+void zmod4xxx_trace_clear(void);
+
+#define ZMOD4XXX_TRACE_BEGIN()  uint32_t trace_t0 = zmod4xxx_trace_now()
+#define ZMOD4XXX_TRACE_END(event, track, arg) \
+    zmod4xxx_trace_record((event), (track), trace_t0, (uint16_t)(arg))
+
+#else
+
+#define zmod4xxx_trace_init(clock)          ((void)0)
+#define zmod4xxx_trace_now()                (0U)
+#define zmod4xxx_trace_record(e, t, b, a)   ((void)(b))
+#define zmod4xxx_trace_attach(dev)          ((void)(dev), ZMOD4XXX_OK)
+#define zmod4xxx_trace_snapshot(recs, max)  (0U)
+#define zmod4xxx_trace_dump_json(out, ctx)  ((void)(out), (void)(ctx))
+#define zmod4xxx_trace_clear()              ((void)0)
+
+#define ZMOD4XXX_TRACE_BEGIN()
+#define ZMOD4XXX_TRACE_END(event, track, arg)
+
+#endif /* ZMOD4XXX_USING_TRACE */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _ZMOD4XXX_TRACE_H */
@@ -38,7 +38,8 @@ typedef enum {
     ERROR_POR_EVENT =
         -7, /**< Power-on reset event. Check power supply and reset pin. */
     ERROR_CLEANING = -8, /**< Error cleaning. */
-    ERROR_NULL_PTR = -9 /**< Null pointer error. */
+    ERROR_NULL_PTR = -9, /**< Null pointer error. */
+    ERROR_BUS_TIMEOUT = -21 /**< The bus lock was not free in time. */
 } zmod4xxx_err;
 
 /**
@@ -67,7 +68,7 @@ typedef void (*zmod4xxx_delay_ptr_p)(uint32_t ms);
 typedef struct {
     uint8_t addr;
     uint8_t len;
-    uint8_t *data_buf;
+    const uint8_t *data_buf;
 } zmod4xxx_conf_str;
 
 /**
@@ -96,8 +97,8 @@ typedef struct {
     zmod4xxx_i2c_ptr_t read; /**< function pointer to i2c read */
     zmod4xxx_i2c_ptr_t write; /**< function pointer to i2c write */
     zmod4xxx_delay_ptr_p delay_ms; /**< function pointer to delay function */
-    zmod4xxx_conf *init_conf; /**< pointer to the init configuration */
-    zmod4xxx_conf *meas_conf; /**< pointer to the measurement configuration */
+    const zmod4xxx_conf *init_conf; /**< pointer to the init configuration */
+    const zmod4xxx_conf *meas_conf; /**< pointer to the measurement configuration */
 } zmod4xxx_dev_t;
 
 #endif // _ZMOD4XXX_TYPES_H
@@ -0,0 +1,86 @@
+/*
+ * Copyright (c) 2006-2021, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-19     Sherman      first version
+ */
+
+/*
+ * The wait for a host started sequence, shared by the port and the host
+ * tools so that what zmod_bench checks is what the firmware runs.
+ */
+
+#include <stddef.h>
+
+#include "zmod4xxx_wait.h"
+
+void zmod4xxx_wait_init(zmod4xxx_wait_t *w, uint32_t fine_ms, uint32_t timeout_ms,
+                        uint32_t (*clock_us)(void))
+{
+    w->run_us = 0;
+    w->fine_ms = fine_ms ? fine_ms : ZMOD4XXX_WAIT_FINE_MS;
+    w->timeout_ms = timeout_ms;
+    w->clock_us = clock_us;
+}
+
+void zmod4xxx_wait_reset(zmod4xxx_wait_t *w)
+{
+    w->run_us = 0;
+}
+
+zmod4xxx_err zmod4xxx_wait_done(zmod4xxx_dev_t *dev, zmod4xxx_wait_t *w,
+                                zmod4xxx_stamp_t *s, uint8_t *status,
+                                uint32_t *polls)
+{
+    uint32_t now, last = s->start_us;
+    zmod4xxx_err ret;
+    uint8_t st;
+
+    if (w->run_us > w->fine_ms * 2000)
+    {
+        dev->delay_ms(w->run_us / 1000 - w->fine_ms * 2);
+    }
+    for (;;)
+    {
+        ret = zmod4xxx_read_status(dev, &st);
+        now = w->clock_us();
+        if (polls != NULL)
+        {
+            (*polls)++;
+        }
+        if (ret)
+        {
+            return ret;
+        }
+        if (status != NULL)
+        {
+            *status = st;
+        }
+        if (!(st & STATUS_SEQUENCER_RUNNING_MASK))
+        {
+            break;
+        }
+        last = now;
+        if (now - s->start_us > w->timeout_ms * 1000UL)
+        {
+            return ERROR_GAS_TIMEOUT;
+        }
+        dev->delay_ms(w->run_us ? w->fine_ms : ZMOD4XXX_WAIT_POLL_MS);
+    }
+    s->err_us = (now - last) / 2;
+    s->done_us = last + s->err_us;
+
+    if (last != s->start_us)
+    {
+        w->run_us = last - s->start_us;
+    }
+    else
+    {
+        /* done at the first read: the delay overshot, wake earlier */
+        w->run_us = w->run_us > w->fine_ms * 4000 ? w->run_us - w->fine_ms * 4000 : 0;
+    }
+    return ZMOD4XXX_OK;
+}
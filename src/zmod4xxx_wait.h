@@ -0,0 +1,80 @@
+/*
+ * Copyright (c) 2006-2021, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-19     Sherman      first version
+ */
+
+#ifndef _ZMOD4XXX_WAIT_H
+#define _ZMOD4XXX_WAIT_H
+
+#include "zmod4xxx.h"
+#include "zmod4xxx_jitter.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define ZMOD4XXX_WAIT_POLL_MS   (200) /**< status poll period while the run time is unknown */
+#ifndef ZMOD4XXX_WAIT_FINE_MS
+#define ZMOD4XXX_WAIT_FINE_MS   (5) /**< default status poll period around the end */
+#endif
+
+/**
+ * @brief Status wait of one device, with the run time it learned
+ */
+typedef struct {
+    uint32_t run_us; /**< run time of a host started sequence, 0 until known */
+    uint32_t fine_ms; /**< status poll period around the learned end */
+    uint32_t timeout_ms; /**< longest run, from the start */
+    uint32_t (*clock_us)(void); /**< microsecond clock delay_ms sleeps on */
+} zmod4xxx_wait_t;
+
+/**
+ * @brief   Set up a wait
+ * @param   [out] w wait, run time unknown
+ * @param   [in] fine_ms status poll period around the end, 0 for
+ *          ZMOD4XXX_WAIT_FINE_MS
+ * @param   [in] timeout_ms longest run, e.g. the counter limit of the mode
+ *          times ZMOD4XXX_WAIT_POLL_MS
+ * @param   [in] clock_us microsecond clock
+ */
+void zmod4xxx_wait_init(zmod4xxx_wait_t *w, uint32_t fine_ms, uint32_t timeout_ms,
+                        uint32_t (*clock_us)(void));
+
+/**
+ * @brief   Forget the learned run time, e.g. after a mode switch
+ * @param   [in,out] w wait
+ */
+void zmod4xxx_wait_reset(zmod4xxx_wait_t *w);
+
+/**
+ * @brief   Wait for the sequence started at s->start_us and stamp its end
+ * @param   [in] dev pointer to the device
+ * @param   [in,out] w wait
+ * @param   [in,out] s stamp; start_us is set by the caller right after the
+ *          start command, done_us and err_us are set here
+ * @param   [out] status last status read, may be NULL
+ * @param   [in,out] polls incremented for every status read, may be NULL
+ * @return  error code
+ * @retval  0 the sequencer is done
+ * @retval  ERROR_GAS_TIMEOUT it ran longer than timeout_ms
+ * @retval  "!= 0" other error
+ * @note    The end is bracketed between the last status read that saw the
+ *          sequencer running and the first that did not. The run time
+ *          learned from the brackets is slept through in one delay_ms and
+ *          only its end is polled every fine_ms, which keeps the stamp
+ *          within half of that at a few status reads per sample.
+ */
+zmod4xxx_err zmod4xxx_wait_done(zmod4xxx_dev_t *dev, zmod4xxx_wait_t *w,
+                                zmod4xxx_stamp_t *s, uint8_t *status,
+                                uint32_t *polls);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _ZMOD4XXX_WAIT_H */
@@ -0,0 +1,204 @@
+/*
+ * Copyright (c) 2006-2021, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-19     Sherman      first version
+ */
+
+/*
+ * Rolling windows without sample storage. Each bucket keeps count, sum,
+ * min, max and a small histogram; the window histogram is kept as the sum
+ * of the bucket ones, so a bucket leaving the window only subtracts its
+ * bins. Queries merge the buckets, which are few.
+ */
+
+#ifndef ZMOD4XXX_USING_WINDOW
+#define ZMOD4XXX_USING_WINDOW
+#endif
+
+#include <string.h>
+
+#include "zmod4xxx_window.h"
+
+static void window_clear(zmod4xxx_window_t *w, uint8_t i)
+{
+    zmod4xxx_window_bucket_t *b = &w->bucket[i];
+    uint8_t k;
+
+    for (k = 0; k < ZMOD4XXX_WINDOW_BINS; k++)
+    {
+        w->hist[k] -= b->hist[k];
+    }
+    memset(b, 0, sizeof(*b));
+}
+
+/* move the head to the bucket now_ms falls in, emptying the ones passed */
+static void window_rotate(zmod4xxx_window_t *w, uint32_t now_ms)
+{
+    uint32_t steps;
+
+    if (!w->started)
+    {
+        w->head_ms = now_ms;
+        w->started = 1;
+        return;
+    }
+    steps = (uint32_t)(now_ms - w->head_ms) / w->cfg.bucket_ms;
+    if (steps == 0)
+    {
+        return;
+    }
+    w->head_ms += steps * w->cfg.bucket_ms;
+    if (steps >= w->cfg.buckets)
+    {
+        memset(w->bucket, 0, sizeof(w->bucket));
+        memset(w->hist, 0, sizeof(w->hist));
+        return;
+    }
+    while (steps--)
+    {
+        w->head = (uint8_t)((w->head + 1) % w->cfg.buckets);
+        window_clear(w, w->head);
+    }
+}
+
+static uint8_t window_bin(const zmod4xxx_window_t *w, float x)
+{
+    float pos = (x - w->cfg.lo) * ZMOD4XXX_WINDOW_BINS / (w->cfg.hi - w->cfg.lo);
+
+    if (pos <= 0)
+    {
+        return 0;
+    }
+    if (pos >= ZMOD4XXX_WINDOW_BINS - 1)
+    {
+        return ZMOD4XXX_WINDOW_BINS - 1;
+    }
+    return (uint8_t)pos;
+}
+
+zmod4xxx_err zmod4xxx_window_init(zmod4xxx_window_t *w,
+                                  const zmod4xxx_window_config_t *cfg)
+{
+    if (cfg->buckets == 0 || cfg->buckets > ZMOD4XXX_WINDOW_BUCKETS ||
+        cfg->bucket_ms == 0 || !(cfg->hi > cfg->lo))
+    {
+        return ERROR_INIT_OUT_OF_RANGE;
+    }
+    memset(w, 0, sizeof(*w));
+    w->cfg = *cfg;
+    return ZMOD4XXX_OK;
+}
+
+void zmod4xxx_window_add(zmod4xxx_window_t *w, float x, uint32_t now_ms)
+{
+    zmod4xxx_window_bucket_t *b;
+    uint8_t bin;
+
+    window_rotate(w, now_ms);
+    b = &w->bucket[w->head];
+    if (b->count == 0 || x < b->min)
+    {
+        b->min = x;
+    }
+    if (b->count == 0 || x > b->max)
+    {
+        b->max = x;
+    }
+    if (b->count < UINT16_MAX)
+    {
+        b->count++;
+        b->sum += x;
+    }
+    bin = window_bin(w, x);
+    if (b->hist[bin] < UINT8_MAX)
+    {
+        b->hist[bin]++;
+        w->hist[bin]++;
+    }
+
+    w->ewma = w->ewma_set ? w->ewma + w->cfg.alpha * (x - w->ewma) : x;
+    w->ewma_set = 1;
+}
+
+float zmod4xxx_window_quantile(const zmod4xxx_window_t *w, float q)
+{
+    float width = (w->cfg.hi - w->cfg.lo) / ZMOD4XXX_WINDOW_BINS;
+    float rank, seen = 0;
+    uint32_t total = 0;
+    uint8_t k;
+
+    for (k = 0; k < ZMOD4XXX_WINDOW_BINS; k++)
+    {
+        total += w->hist[k];
+    }
+    if (total == 0)
+    {
+        return 0;
+    }
+    rank = q * total;
+    for (k = 0; k < ZMOD4XXX_WINDOW_BINS - 1; k++)
+    {
+        if (seen + w->hist[k] >= rank && w->hist[k])
+        {
+            break;
+        }
+        seen += w->hist[k];
+    }
+    if (w->hist[k] == 0)
+    {
+        return w->cfg.lo + width * k;
+    }
+    return w->cfg.lo + width * (k + (rank - seen) / w->hist[k]);
+}
+
+static float window_clamp(float x, const zmod4xxx_window_result_t *res)
+{
+    if (x < res->min)
+    {
+        return res->min;
+    }
+    return x > res->max ? res->max : x;
+}
+
+void zmod4xxx_window_get(zmod4xxx_window_t *w, uint32_t now_ms,
+                         zmod4xxx_window_result_t *res)
+{
+    const zmod4xxx_window_bucket_t *b;
+    float sum = 0;
+    uint8_t i;
+
+    memset(res, 0, sizeof(*res));
+    window_rotate(w, now_ms);
+    for (i = 0; i < w->cfg.buckets; i++)
+    {
+        b = &w->bucket[i];
+        if (b->count == 0)
+        {
+            continue;
+        }
+        if (res->count == 0 || b->min < res->min)
+        {
+            res->min = b->min;
+        }
+        if (res->count == 0 || b->max > res->max)
+        {
+            res->max = b->max;
+        }
+        res->count += b->count;
+        sum += b->sum;
+    }
+    if (res->count == 0)
+    {
+        return;
+    }
+    res->mean = sum / res->count;
+    res->ewma = w->ewma;
+    /* the sketch only knows bins, the extremes are exact */
+    res->p50 = window_clamp(zmod4xxx_window_quantile(w, 0.50f), res);
+    res->p90 = window_clamp(zmod4xxx_window_quantile(w, 0.90f), res);
+    res->p99 = window_clamp(zmod4xxx_window_quantile(w, 0.99f), res);
+}
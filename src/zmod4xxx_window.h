@@ -0,0 +1,126 @@
+/*
+ * Copyright (c) 2006-2021, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-19     Sherman      first version
+ */
+
+#ifndef _ZMOD4XXX_WINDOW_H
+#define _ZMOD4XXX_WINDOW_H
+
+#include "zmod4xxx_types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#ifndef ZMOD4XXX_WINDOW_BUCKETS
+#define ZMOD4XXX_WINDOW_BUCKETS (15) /**< most buckets per window */
+#endif
+#ifndef ZMOD4XXX_WINDOW_BINS
+#define ZMOD4XXX_WINDOW_BINS    (16) /**< histogram bins of the percentile sketch */
+#endif
+
+/**
+ * @brief Window configuration
+ *
+ * A window is a ring of buckets of bucket_ms each; it covers the current
+ * bucket and the buckets - 1 before it. Percentiles come from a histogram
+ * of ZMOD4XXX_WINDOW_BINS equal bins over [lo, hi]; values outside fall in
+ * the end bins and the error is at most one bin width inside the range.
+ */
+typedef struct {
+    float lo; /**< lower end of the histogram */
+    float hi; /**< upper end of the histogram */
+    uint32_t bucket_ms; /**< time covered by one bucket */
+    uint8_t buckets; /**< buckets in the window, 1..ZMOD4XXX_WINDOW_BUCKETS */
+    float alpha; /**< EWMA weight of a new sample, 0..1 */
+} zmod4xxx_window_config_t;
+
+/**
+ * @brief Aggregates of one bucket
+ */
+typedef struct {
+    uint16_t count; /**< samples */
+    float sum; /**< sum of the samples */
+    float min; /**< smallest sample */
+    float max; /**< largest sample */
+    uint8_t hist[ZMOD4XXX_WINDOW_BINS]; /**< samples per bin, saturating */
+} zmod4xxx_window_bucket_t;
+
+/**
+ * @brief One rolling window over one output
+ */
+typedef struct {
+    zmod4xxx_window_config_t cfg;
+    zmod4xxx_window_bucket_t bucket[ZMOD4XXX_WINDOW_BUCKETS];
+    uint16_t hist[ZMOD4XXX_WINDOW_BINS]; /**< sum of the bucket histograms */
+    uint8_t head; /**< current bucket */
+    uint8_t started; /**< head_ms is set */
+    uint32_t head_ms; /**< start of the current bucket */
+    uint8_t ewma_set; /**< ewma holds a value */
+    float ewma; /**< exponentially weighted mean, not windowed */
+} zmod4xxx_window_t;
+
+/**
+ * @brief Snapshot of a window
+ */
+typedef struct {
+    uint32_t count; /**< samples in the window */
+    float min;
+    float max;
+    float mean;
+    float ewma;
+    float p50; /**< approximate median */
+    float p90; /**< approximate 90th percentile */
+    float p99; /**< approximate 99th percentile */
+} zmod4xxx_window_result_t;
+
+#ifdef ZMOD4XXX_USING_WINDOW
+
+/**
+ * @brief   Set up an empty window
+ * @param   [out] w window
+ * @param   [in] cfg configuration, copied
+ * @return  error code
+ * @retval  0 success
+ * @retval  ERROR_INIT_OUT_OF_RANGE bad bucket count, length or range
+ */
+zmod4xxx_err zmod4xxx_window_init(zmod4xxx_window_t *w,
+                                  const zmod4xxx_window_config_t *cfg);
+
+/**
+ * @brief   Add a sample, O(1) apart from rotating out expired buckets
+ * @param   [in,out] w window
+ * @param   [in] x sample
+ * @param   [in] now_ms time of the sample, not older than the last one
+ */
+void zmod4xxx_window_add(zmod4xxx_window_t *w, float x, uint32_t now_ms);
+
+/**
+ * @brief   Get the aggregates of the window
+ * @param   [in,out] w window, expired buckets are rotated out
+ * @param   [in] now_ms current time
+ * @param   [out] res aggregates, all 0 if the window is empty
+ */
+void zmod4xxx_window_get(zmod4xxx_window_t *w, uint32_t now_ms,
+                         zmod4xxx_window_result_t *res);
+
+/**
+ * @brief   Approximate quantile of the samples in the window
+ * @param   [in] w window
+ * @param   [in] q quantile, 0..1
+ * @return  quantile, interpolated inside its bin
+ */
+float zmod4xxx_window_quantile(const zmod4xxx_window_t *w, float q);
+
+#endif /* ZMOD4XXX_USING_WINDOW */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _ZMOD4XXX_WINDOW_H */
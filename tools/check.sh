@@ -0,0 +1,46 @@
+#!/bin/sh
+#
+# Copyright (c) 2006-2021, RT-Thread Development Team
+#
+# SPDX-License-Identifier: Apache-2.0
+#
+# Change Logs:
+# Date           Author       Notes
+# 2026-10-19     Sherman      first version
+#
+# Host check of the package, to run before a change is merged:
+#   tools/check.sh [build dir]
+#
+# Builds zmod_bench, zmod_soak and zmod_faults on the simulation HAL with
+# the commands in their headers and runs them. zmod_bench -c fails on a
+# golden vector, the CPU budget or a bus budget of zmod_golden.h; the other
+# two fail on a sample error or an unrecovered fault. Exits with the status
+# of the first failure.
+
+set -e
+
+cd "$(dirname "$0")/.."
+out=${1:-build/check}
+mkdir -p "$out"
+CC=${CC:-gcc}
+CFLAGS=${CFLAGS:--O2 -std=c99 -Wall}
+
+$CC $CFLAGS -DZMOD4XXX_USING_HAL_SIM -DZMOD4XXX_USING_WINDOW \
+    -DZMOD4XXX_USING_HISTORY -DZMOD4XXX_USING_DLOG -Isrc -Ihal -Iports -Itools \
+    -I"libraries/iaq_2nd_gen/Arm Cortex-M/M33/arm-none-eabi-gcc" \
+    tools/zmod_bench.c src/zmod4xxx.c src/zmod4xxx_recover.c \
+    src/zmod4xxx_wait.c src/zmod4xxx_mode.c src/zmod4410_config_iaq2.c \
+    src/zmod4xxx_window.c src/zmod4xxx_history.c src/zmod4xxx_batch.c \
+    src/zmod4xxx_dlog.c hal/hal_sim.c -o "$out/zmod_bench"
+$CC $CFLAGS -DZMOD4XXX_USING_HAL_SIM -Isrc -Ihal -Itools \
+    tools/zmod_soak.c src/zmod4xxx.c src/zmod4xxx_recover.c \
+    src/zmod4xxx_wait.c src/zmod4410_config_iaq2.c hal/hal_sim.c -o "$out/zmod_soak"
+$CC $CFLAGS -DZMOD4XXX_USING_HAL_SIM -DZMOD4XXX_USING_RETRY \
+    -Isrc -Ihal -Itools tools/zmod_faults.c src/zmod4xxx.c \
+    src/zmod4xxx_recover.c src/zmod4xxx_retry.c src/zmod4xxx_wait.c \
+    src/zmod4410_config_iaq2.c hal/hal_sim.c -o "$out/zmod_faults"
+
+"$out/zmod_bench" -c
+"$out/zmod_soak" -n 4 -s 10000 > /dev/null
+"$out/zmod_faults" > /dev/null
+echo "check passed"
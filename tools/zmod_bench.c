@@ -0,0 +1,815 @@
+/*
+ * Copyright (c) 2006-2021, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-19     Sherman      first version
+ * 2026-10-19     Sherman      add host wakeups of sleep timer modes
+ * 2026-10-19     Sherman      add windowed statistics
+ * 2026-10-19     Sherman      add compressed history
+ * 2026-10-19     Sherman      add batch frames
+ * 2026-10-19     Sherman      add deferred logging
+ * 2026-10-19     Sherman      add golden vector and budget checks
+ * 2026-10-19     Sherman      budget the cycle with the port's status wait
+ */
+
+/*
+ * Host tool: benchmarks of the driver hot paths and of full measurement
+ * cycles against the simulated bus.
+ *
+ * Build on Linux from the package root:
+ *   gcc -O2 -std=c99 -DZMOD4XXX_USING_HAL_SIM -DZMOD4XXX_USING_WINDOW \
+ *       -DZMOD4XXX_USING_HISTORY -DZMOD4XXX_USING_DLOG -Isrc -Ihal -Iports -Itools \
+ *       -I"libraries/iaq_2nd_gen/Arm Cortex-M/M33/arm-none-eabi-gcc" \
+ *       tools/zmod_bench.c src/zmod4xxx.c src/zmod4xxx_recover.c \
+ *       src/zmod4xxx_wait.c src/zmod4xxx_mode.c src/zmod4410_config_iaq2.c \
+ *       src/zmod4xxx_window.c src/zmod4xxx_history.c src/zmod4xxx_batch.c \
+ *       src/zmod4xxx_dlog.c hal/hal_sim.c -o zmod_bench
+ *
+ * Usage:
+ *   zmod_bench [-c] [-n iterations] [-s samples]
+ *
+ * Prints one JSON object per benchmark on stdout. Bus counts come from the
+ * simulator and are exact; times are host wall-clock and only comparable
+ * on the same machine. Host awake time is the bus time at 400 kHz plus
+ * BENCH_WAKE_US for every wakeup, an estimate of what a duty-cycled MCU pays.
+ *
+ * -c runs the checks of zmod_golden.h instead and exits with 1 if one
+ * fails: zmod4xxx_calc_rmox() and zmod4xxx_calc_factor() against the golden
+ * vectors, their time against the reference copies in the same binary, and
+ * the bus counts of startup and cycle against their budgets. The cycle
+ * waits with zmod4xxx_wait_done() as the port does without the INT pin, so
+ * the budget covers the status reads the firmware makes. tools/check.sh
+ * builds and runs it with zmod_soak and zmod_faults.
+ * Host times differ between machines, so the CPU budget is a ratio to the
+ * code as imported rather than a cycle count.
+ */
+
+#define _POSIX_C_SOURCE 199309L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "iaq_2nd_gen.h"
+#include "zmod4410_config_iaq2.h"
+#include "zmod4410_scale.h"
+#include "zmod4xxx.h"
+#include "zmod4xxx_batch.h"
+#include "zmod4xxx_dlog.h"
+#include "zmod4xxx_hal.h"
+#include "zmod4xxx_history.h"
+#include "zmod4xxx_window.h"
+#include "zmod_cycle.h"
+#include "zmod_golden.h"
+
+/* the integer part of struct rt_sensor_data the port fills in */
+struct bench_sensor_data
+{
+    uint32_t timestamp;
+    int32_t value;
+};
+
+/* assumed cost of one wakeup of the host: interrupt, scheduler, clocks */
+#define BENCH_WAKE_US (50)
+
+/* timed rounds of a CPU check, the fastest counts */
+#define CHECK_ROUNDS (7)
+
+/* cycles the status wait needs to learn the run time, left out of the budget */
+#define CHECK_LEARN_CYCLES (2)
+
+static volatile float sink_f;
+static volatile int32_t sink_i;
+
+static uint64_t now_ns(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+static void report_call(const char *name, uint32_t iterations, uint64_t ns)
+{
+    printf("{\"bench\":\"%s\",\"iterations\":%u,\"ns_per_call\":%.2f}\n",
+           name, iterations, (double)ns / iterations);
+}
+
+static void report_bus(const char *name, uint32_t count,
+                       const zmod4xxx_sim_stats_t *st, uint64_t virtual_us,
+                       uint64_t ns)
+{
+    printf("{\"bench\":\"%s\",\"count\":%u,\"i2c\":%.3f,\"i2c_bytes\":%.3f,"
+           "\"sleeps\":%.3f,\"virtual_ms\":%.3f,\"host_ns\":%.1f}\n",
+           name, count,
+           (double)(st->reads + st->writes) / count,
+           (double)(st->read_bytes + st->write_bytes) / count,
+           (double)st->sleeps / count,
+           virtual_us / 1000.0 / count,
+           (double)ns / count);
+}
+
+static void report_power(const char *name, uint32_t count,
+                         const zmod4xxx_sim_stats_t *st, uint64_t virtual_us)
+{
+    double awake_us = st->bus_ns / 1000.0 + (double)st->sleeps * BENCH_WAKE_US;
+
+    printf("{\"bench\":\"%s_power\",\"count\":%u,\"wakeups\":%.3f,"
+           "\"i2c\":%.3f,\"bus_us\":%.1f,\"awake_us\":%.1f,"
+           "\"period_ms\":%.1f,\"awake_ppm\":%.2f}\n",
+           name, count,
+           (double)st->sleeps / count,
+           (double)(st->reads + st->writes) / count,
+           st->bus_ns / 1000.0 / count,
+           awake_us / count,
+           virtual_us / 1000.0 / count,
+           awake_us * 1e6 / virtual_us);
+}
+
+static void prepare_dev(zmod4xxx_sim_t *sim, zmod4xxx_dev_t *dev,
+                        uint8_t *prod_data, uint8_t addr)
+{
+    zmod4xxx_sim_init(sim, addr, addr);
+    zmod4xxx_sim_attach(sim, dev);
+    dev->pid = ZMOD4410_PID;
+    dev->init_conf = &zmod_sensor_type[INIT];
+    dev->meas_conf = &zmod_sensor_type[MEASUREMENT];
+    dev->prod_data = prod_data;
+}
+
+static void bench_calc_rmox(zmod4xxx_dev_t *dev, uint32_t iterations)
+{
+    uint8_t adc_result[RSLT_MAX];
+    float rmox[RSLT_MAX / 2];
+    uint32_t i;
+    uint64_t t0;
+
+    for (i = 0; i < RSLT_MAX; i++)
+    {
+        adc_result[i] = (uint8_t)(0x40 + i * 5);
+    }
+    t0 = now_ns();
+    for (i = 0; i < iterations; i++)
+    {
+        adc_result[1] = (uint8_t)i;
+        zmod4xxx_calc_rmox(dev, adc_result, rmox);
+        sink_f = rmox[0];
+    }
+    report_call("calc_rmox", iterations, now_ns() - t0);
+}
+
+static void bench_calc_factor(zmod4xxx_dev_t *dev, uint32_t iterations)
+{
+    uint8_t hsp[HSP_MAX * 2];
+    uint32_t i;
+    uint64_t t0;
+
+    t0 = now_ns();
+    for (i = 0; i < iterations; i++)
+    {
+        dev->config[5] = (uint8_t)i;
+        zmod4xxx_calc_factor(dev->meas_conf, hsp, dev->config);
+        sink_i = hsp[0];
+    }
+    report_call("calc_factor", iterations, now_ns() - t0);
+}
+
+static void bench_convert(uint32_t iterations)
+{
+    iaq_2nd_gen_results_t results;
+    struct bench_sensor_data data[4];
+    uint32_t i;
+    uint64_t t0;
+
+    memset(&results, 0, sizeof(results));
+    t0 = now_ns();
+    for (i = 0; i < iterations; i++)
+    {
+        results.etoh = 0.25F + (float)(i & 0xFF) / 1024;
+        results.tvoc = 0.5F + (float)(i & 0xFF) / 512;
+        results.eco2 = 400.0F + (float)(i & 0xFF);
+        results.iaq = 1.0F + (float)(i & 0xFF) / 64;
+
+        data[0].value = ZMOD4410_SCALE_ETOH(results.etoh);
+        data[1].value = ZMOD4410_SCALE_TVOC(results.tvoc);
+        data[2].value = ZMOD4410_SCALE_ECO2(results.eco2);
+        data[3].value = ZMOD4410_SCALE_IAQ(results.iaq);
+        data[0].timestamp = data[1].timestamp = i;
+        data[2].timestamp = data[3].timestamp = i;
+        sink_i = data[0].value + data[1].value + data[2].value + data[3].value;
+    }
+    report_call("convert_results", iterations, now_ns() - t0);
+}
+
+/* the port feeds 2 windows x 4 outputs per sample; time one of them */
+static void bench_window(uint32_t iterations)
+{
+    static const zmod4xxx_window_config_t cfg = { 0.0f, 10.0f, 60000, 15, 0.01f };
+    zmod4xxx_window_t w;
+    zmod4xxx_window_result_t res;
+    uint32_t i, x = 1;
+    uint64_t t0;
+
+    zmod4xxx_window_init(&w, &cfg);
+    t0 = now_ns();
+    for (i = 0; i < iterations; i++)
+    {
+        x = x * 1103515245u + 12345u;
+        /* 3 s per sample, so buckets rotate as in the port */
+        zmod4xxx_window_add(&w, (float)(x >> 16) / 6553.6f, i * 3000u);
+    }
+    report_call("window_add", iterations, now_ns() - t0);
+
+    t0 = now_ns();
+    for (i = 0; i < iterations / 10 + 1; i++)
+    {
+        zmod4xxx_window_get(&w, iterations * 3000u, &res);
+        sink_f = res.p99;
+    }
+    report_call("window_get", iterations / 10 + 1, now_ns() - t0);
+    printf("{\"bench\":\"window_size\",\"bytes\":%u}\n", (unsigned)sizeof(w));
+}
+
+#define BENCH_HIST_PAGES (64)
+
+static uint8_t bench_flash[BENCH_HIST_PAGES][ZMOD4XXX_HISTORY_PAGE_SIZE];
+
+static int bench_flash_read(void *ctx, uint32_t page, uint32_t off, void *buf,
+                            uint32_t len)
+{
+    (void)ctx;
+    memcpy(buf, &bench_flash[page][off], len);
+    return 0;
+}
+
+static int bench_flash_prog(void *ctx, uint32_t page, const void *buf, uint32_t len)
+{
+    (void)ctx;
+    memcpy(bench_flash[page], buf, len);
+    return 0;
+}
+
+static int bench_flash_erase(void *ctx, uint32_t page)
+{
+    (void)ctx;
+    memset(bench_flash[page], 0xFF, ZMOD4XXX_HISTORY_PAGE_SIZE);
+    return 0;
+}
+
+/* one sample a minute of slowly moving outputs, quantized like the
+ * algorithm's; bytes per sample depend on how noisy the data is */
+static void bench_history(uint32_t iterations)
+{
+    static const zmod4xxx_history_flash_t flash =
+    {
+        bench_flash_read, bench_flash_prog, bench_flash_erase, NULL, BENCH_HIST_PAGES,
+    };
+    static zmod4xxx_history_t h;
+    zmod4xxx_history_sample_t s;
+    zmod4xxx_history_agg_t agg;
+    int32_t iaq = 150, tvoc = 300, eco2 = 500;
+    uint32_t i, x = 1, n = iterations / 10 + 1;
+    uint64_t t0;
+
+    memset(bench_flash, 0xFF, sizeof(bench_flash));
+    zmod4xxx_history_init(&h, &flash, 4);
+    memset(&s, 0, sizeof(s));
+    t0 = now_ns();
+    for (i = 0; i < n; i++)
+    {
+        x = x * 1103515245u + 12345u;
+        iaq += (int32_t)((x >> 8) % 5) - 2;
+        tvoc += (int32_t)((x >> 12) % 7) - 3;
+        eco2 += (int32_t)((x >> 16) % 3) - 1;
+        s.ts = 1700000000u + i * 60u;
+        s.v[0] = iaq / 100.0f;
+        s.v[1] = tvoc / 1000.0f;
+        s.v[2] = 0.5f;
+        s.v[3] = (float)eco2;
+        zmod4xxx_history_append(&h, &s);
+    }
+    report_call("history_append", n, now_ns() - t0);
+
+    t0 = now_ns();
+    zmod4xxx_history_aggregate(&h, s.ts - 24 * 3600, s.ts, &agg);
+    printf("{\"bench\":\"history_24h\",\"samples\":%u,\"ns\":%llu,"
+           "\"bytes_per_sample\":%.2f,\"raw_bytes_per_sample\":%u}\n",
+           agg.count, (unsigned long long)(now_ns() - t0),
+           (double)h.pages_written * ZMOD4XXX_HISTORY_PAGE_SIZE /
+           (h.samples - h.hdr.count + (h.pages_written == 0)),
+           (unsigned)(sizeof(s.ts) + 4 * sizeof(float)));
+}
+
+#define BENCH_BATCH_MTU (242) /* e.g. a LoRaWAN payload at DR4 */
+
+/* batch frames against one line of JSON text per sample, as uplinks did */
+static int bench_batch(uint32_t iterations)
+{
+    static zmod4xxx_batch_sample_t in[4096];
+    zmod4xxx_batch_enc_t enc;
+    zmod4xxx_batch_dec_t dec;
+    zmod4xxx_batch_sample_t out;
+    uint8_t frame[BENCH_BATCH_MTU];
+    char text[160];
+    uint32_t n = sizeof(in) / sizeof(in[0]);
+    uint32_t i, k, done, x = 1, rounds = iterations / n + 1;
+    uint64_t t0, ns_enc = 0, ns_dec = 0, bytes = 0, frames = 0, text_bytes = 0;
+    uint32_t flen;
+
+    for (i = 0; i < n; i++)
+    {
+        x = x * 1103515245u + 12345u;
+        in[i].seq = 1000 + i + (i == n / 2);
+        in[i].ts = 500000 + i * 3000 + (x >> 28);
+        in[i].flags = i < 60 ? ZMOD4XXX_BATCH_F_STABILIZING : ZMOD4XXX_BATCH_F_VALID;
+        in[i].v[0] = i ? in[i - 1].v[0] + (int32_t)((x >> 8) % 3) - 1 : 15;
+        in[i].v[1] = i ? in[i - 1].v[1] + (int32_t)((x >> 12) % 21) - 10 : 300;
+        in[i].v[2] = i ? in[i - 1].v[2] + (int32_t)((x >> 16) % 11) - 5 : 500;
+        in[i].v[3] = i ? in[i - 1].v[3] + (int32_t)((x >> 20) % 5) - 2 : 450;
+    }
+
+    for (k = 0; k < rounds; k++)
+    {
+        for (done = 0; done < n; )
+        {
+            t0 = now_ns();
+            zmod4xxx_batch_begin(&enc, frame, sizeof(frame));
+            for (i = done; i < n && zmod4xxx_batch_add(&enc, &in[i]) == ZMOD4XXX_OK; i++)
+            {
+            }
+            flen = zmod4xxx_batch_end(&enc);
+            ns_enc += now_ns() - t0;
+
+            t0 = now_ns();
+            if (zmod4xxx_batch_open(&dec, frame, flen, NULL))
+            {
+                fprintf(stderr, "batch frame rejected\n");
+                return -1;
+            }
+            for (; done < i; done++)
+            {
+                if (zmod4xxx_batch_next(&dec, &out) != 1 ||
+                    memcmp(&out, &in[done], sizeof(out)))
+                {
+                    fprintf(stderr, "batch sample %u differs\n", done);
+                    return -1;
+                }
+            }
+            ns_dec += now_ns() - t0;
+            bytes += flen;
+            frames++;
+        }
+    }
+
+    t0 = now_ns();
+    for (k = 0; k < rounds; k++)
+    {
+        for (i = 0; i < n; i++)
+        {
+            text_bytes += (uint32_t)snprintf(text, sizeof(text),
+                "{\"seq\":%u,\"ts\":%u,\"valid\":%d,\"iaq\":%.1f,\"tvoc\":%.3f,"
+                "\"etoh\":%.3f,\"eco2\":%d}\n", in[i].seq, in[i].ts,
+                in[i].flags & ZMOD4XXX_BATCH_F_VALID, in[i].v[0] / 10.0,
+                in[i].v[1] / 1000.0, in[i].v[2] / 1000.0, (int)in[i].v[3]);
+        }
+    }
+    printf("{\"bench\":\"batch\",\"samples\":%u,\"frames\":%llu,"
+           "\"bytes_per_sample\":%.2f,\"encode_ns\":%.1f,\"decode_ns\":%.1f,"
+           "\"text_bytes_per_sample\":%.2f,\"text_ns\":%.1f}\n",
+           n * rounds, (unsigned long long)frames, (double)bytes / (n * rounds),
+           (double)ns_enc / (n * rounds), (double)ns_dec / (n * rounds),
+           (double)text_bytes / (n * rounds), (double)(now_ns() - t0) / (n * rounds));
+    return 0;
+}
+
+/* the demo's 20 lines per sample against four records formatted later */
+static void bench_dlog(uint32_t iterations)
+{
+    static char out[1024];
+    iaq_2nd_gen_results_t r;
+    zmod4xxx_dlog_rec_t rec;
+    uint32_t w[13];
+    uint64_t t0, ns_text, ns_rec, ns_fmt;
+    uint32_t i, k, n, len = 0, bytes = 0;
+    int j;
+
+    memset(&r, 0, sizeof(r));
+    for (j = 0; j < 13; j++)
+    {
+        r.rmox[j] = 1e5f * (j + 1) + 123.4f;
+    }
+    r.log_rcda = 5.123f;
+    r.etoh = 0.456f;
+    r.tvoc = 0.321f;
+    r.eco2 = 512.0f;
+    r.iaq = 1.7f;
+    n = iterations / 10 + 1;
+
+    t0 = now_ns();
+    for (i = 0; i < n; i++)
+    {
+        r.iaq += 1e-6f;
+        len = 0;
+        len += snprintf(out + len, sizeof(out) - len, "*********** Measurements ***********\n");
+        for (j = 0; j < 13; j++)
+        {
+            len += snprintf(out + len, sizeof(out) - len, " Rmox[%d] = ", j);
+            len += snprintf(out + len, sizeof(out) - len, "%.3f kOhm\n", r.rmox[j] / 1e3);
+        }
+        len += snprintf(out + len, sizeof(out) - len, " log_Rcda = %5.3f logOhm\n", r.log_rcda);
+        len += snprintf(out + len, sizeof(out) - len, " EtOH = %6.3f ppm\n", r.etoh);
+        len += snprintf(out + len, sizeof(out) - len, " TVOC = %6.3f mg/m^3\n", r.tvoc);
+        len += snprintf(out + len, sizeof(out) - len, " eCO2 = %4.0f ppm\n", r.eco2);
+        len += snprintf(out + len, sizeof(out) - len, " IAQ  = %4.1f\n", r.iaq);
+        len += snprintf(out + len, sizeof(out) - len, "Valid!\n");
+        len += snprintf(out + len, sizeof(out) - len, "************************************\n");
+        sink_i = (int32_t)len;
+    }
+    ns_text = now_ns() - t0;
+
+    zmod4xxx_dlog_init(NULL);
+    ns_rec = ns_fmt = 0;
+    for (k = 0; k < n; k += ZMOD4XXX_DLOG_SIZE / 4)
+    {
+        t0 = now_ns();
+        for (i = 0; i < ZMOD4XXX_DLOG_SIZE / 4; i++)
+        {
+            r.iaq += 1e-6f;
+            for (j = 0; j < 13; j++)
+            {
+                w[j] = ZMOD4XXX_DLOG_F(r.rmox[j] / 1e3);
+            }
+            zmod4xxx_dlog_args(ZMOD4XXX_DLOG_RMOX_LO, w, 7);
+            zmod4xxx_dlog_args(ZMOD4XXX_DLOG_RMOX_HI, w + 7, 6);
+            zmod4xxx_dlog(ZMOD4XXX_DLOG_RESULT, 5, ZMOD4XXX_DLOG_F(r.etoh),
+                          ZMOD4XXX_DLOG_F(r.tvoc), ZMOD4XXX_DLOG_F(r.eco2),
+                          ZMOD4XXX_DLOG_F(r.iaq), ZMOD4XXX_DLOG_F(r.log_rcda));
+            zmod4xxx_dlog(ZMOD4XXX_DLOG_VALID, 0);
+        }
+        ns_rec += now_ns() - t0;
+
+        t0 = now_ns();
+        while (zmod4xxx_dlog_read(&rec))
+        {
+            bytes += ZMOD4XXX_DLOG_WIRE_HDR + 4 * rec.nargs;
+            sink_i = (int32_t)zmod4xxx_dlog_format(&rec, out, sizeof(out));
+        }
+        ns_fmt += now_ns() - t0;
+    }
+    k = k / (ZMOD4XXX_DLOG_SIZE / 4) * (ZMOD4XXX_DLOG_SIZE / 4);
+
+    printf("{\"bench\":\"dlog\",\"samples\":%u,\"text_ns\":%.1f,\"text_bytes\":%u,"
+           "\"record_ns\":%.1f,\"record_bytes\":%.1f,\"format_ns\":%.1f,\"lost\":%u}\n",
+           n, (double)ns_text / n, len, (double)ns_rec / k, (double)bytes / k,
+           (double)ns_fmt / k, zmod4xxx_dlog_lost());
+}
+
+static int bench_startup(uint32_t iterations)
+{
+    zmod4xxx_sim_t sim;
+    zmod4xxx_dev_t dev;
+    uint8_t prod_data[ZMOD4410_PROD_DATA_LEN];
+    zmod4xxx_sim_stats_t total;
+    uint64_t virtual_us = 0, ns = 0, t0;
+    uint32_t i;
+
+    memset(&total, 0, sizeof(total));
+    for (i = 0; i < iterations; i++)
+    {
+        prepare_dev(&sim, &dev, prod_data, 0x32);
+        t0 = now_ns();
+        if (zmod4xxx_read_sensor_info(&dev) || zmod4xxx_prepare_sensor(&dev))
+        {
+            fprintf(stderr, "startup failed\n");
+            return -1;
+        }
+        ns += now_ns() - t0;
+        virtual_us += zmod4xxx_sim_time_us(&sim);
+        total.reads += sim.stats.reads;
+        total.writes += sim.stats.writes;
+        total.read_bytes += sim.stats.read_bytes;
+        total.write_bytes += sim.stats.write_bytes;
+        total.sleeps += sim.stats.sleeps;
+        zmod4xxx_sim_detach(&sim);
+    }
+    report_bus("startup", iterations, &total, virtual_us, ns);
+    return 0;
+}
+
+static int bench_cycle(uint32_t samples)
+{
+    zmod4xxx_sim_t sim;
+    zmod4xxx_dev_t dev;
+    zmod4xxx_recover_t rec;
+    zmod4xxx_wait_t wait;
+    uint8_t prod_data[ZMOD4410_PROD_DATA_LEN];
+    uint8_t adc_result[RSLT_MAX];
+    float rmox[RSLT_MAX / 2];
+    uint64_t virtual_start, t0;
+    uint32_t i;
+
+    prepare_dev(&sim, &dev, prod_data, 0x32);
+    if (zmod4xxx_read_sensor_info(&dev) || zmod4xxx_prepare_sensor(&dev) ||
+        zmod4xxx_recover_init(&dev, &rec, hal_get_time_ms))
+    {
+        fprintf(stderr, "startup failed\n");
+        return -1;
+    }
+    zmod4xxx_wait_init(&wait, 0, ZMOD4410_IAQ2_COUNTER_LIMIT * ZMOD4XXX_WAIT_POLL_MS,
+                       hal_get_time_us);
+    memset(&sim.stats, 0, sizeof(sim.stats));
+    virtual_start = zmod4xxx_sim_time_us(&sim);
+
+    t0 = now_ns();
+    for (i = 0; i < samples; i++)
+    {
+        if (zmod_cycle_run(&dev, &wait, &rec, adc_result, rmox))
+        {
+            fprintf(stderr, "cycle %u failed\n", i);
+            return -1;
+        }
+        dev.delay_ms(1990);
+    }
+    report_bus("cycle", samples, &sim.stats,
+               zmod4xxx_sim_time_us(&sim) - virtual_start, now_ns() - t0);
+    report_power("cycle", samples, &sim.stats,
+                 zmod4xxx_sim_time_us(&sim) - virtual_start);
+    zmod4xxx_sim_detach(&sim);
+    return 0;
+}
+
+typedef zmod4xxx_err (*check_rmox_fn)(zmod4xxx_dev_t *dev, uint8_t *adc_result,
+                                      float *rmox);
+typedef zmod4xxx_err (*check_factor_fn)(const zmod4xxx_conf *conf, uint8_t *hsp,
+                                        uint8_t *config);
+
+/* called through these, so neither side is inlined into the loop */
+static check_rmox_fn volatile check_rmox[2] = { zmod4xxx_calc_rmox, zmod_golden_ref_rmox };
+static check_factor_fn volatile check_factor[2] = { zmod4xxx_calc_factor,
+                                                    zmod_golden_ref_factor };
+
+static void check_dev(zmod4xxx_dev_t *dev, uint8_t calib)
+{
+    memset(dev, 0, sizeof(*dev));
+    memcpy(dev->config, zmod_golden_calib[calib].config, sizeof(dev->config));
+    dev->mox_lr = zmod_golden_calib[calib].mox_lr;
+    dev->mox_er = zmod_golden_calib[calib].mox_er;
+    dev->init_conf = &zmod_sensor_type[INIT];
+    dev->meas_conf = &zmod_sensor_type[MEASUREMENT];
+}
+
+/* distance of two floats in units in the last place */
+static uint32_t check_ulp(uint32_t a, uint32_t b)
+{
+    int64_t x = a & 0x80000000UL ? -(int64_t)(a & 0x7FFFFFFFUL) : (int64_t)a;
+    int64_t y = b & 0x80000000UL ? -(int64_t)(b & 0x7FFFFFFFUL) : (int64_t)b;
+    int64_t d = x > y ? x - y : y - x;
+
+    return d > 0xFFFFFFFFLL ? 0xFFFFFFFFUL : (uint32_t)d;
+}
+
+static int check_golden(uint8_t ref)
+{
+    zmod4xxx_dev_t dev;
+    uint8_t adc[RSLT_MAX];
+    float rmox[RSLT_MAX / 2];
+    uint8_t hsp[HSP_MAX * 2];
+    const zmod4xxx_conf *conf[2];
+    uint32_t bits, d, ulp_max = 0, failed = 0, n_rmox = 0, n_hsp = 0;
+    uint8_t c, f, i;
+
+    for (c = 0; c < ZMOD_GOLDEN_CALIBS; c++)
+    {
+        check_dev(&dev, c);
+        for (f = 0; f < ZMOD_GOLDEN_FRAMES; f++)
+        {
+            memcpy(adc, zmod_golden_frame[f], sizeof(adc));
+            check_rmox[ref](&dev, adc, rmox);
+            for (i = 0; i < RSLT_MAX / 2; i++, n_rmox++)
+            {
+                memcpy(&bits, &rmox[i], sizeof(bits));
+                d = check_ulp(bits, zmod_golden_rmox[c][f][i]);
+                ulp_max = d > ulp_max ? d : ulp_max;
+                if (d > ZMOD_GOLDEN_ULP && failed++ < 8)
+                {
+                    fprintf(stderr, "calib %u frame %u rmox[%u]: 0x%08X, golden 0x%08X\n",
+                            c, f, i, (unsigned)bits, (unsigned)zmod_golden_rmox[c][f][i]);
+                }
+            }
+        }
+        conf[0] = dev.init_conf;
+        conf[1] = dev.meas_conf;
+        for (i = 0; i < 2; i++, n_hsp++)
+        {
+            memset(hsp, 0, sizeof(hsp));
+            check_factor[ref](conf[i], hsp, dev.config);
+            if (memcmp(hsp, zmod_golden_hsp[c][i], conf[i]->h.len) && failed++ < 8)
+            {
+                fprintf(stderr, "calib %u conf %u: heater set points differ\n", c, i);
+            }
+        }
+    }
+    printf("{\"check\":\"golden\",\"code\":\"%s\",\"rmox\":%u,\"hsp\":%u,"
+           "\"max_ulp\":%u,\"failed\":%u}\n",
+           ref ? "reference" : "driver", n_rmox, n_hsp, ulp_max, failed);
+    return failed ? -1 : 0;
+}
+
+static uint64_t check_time(uint8_t ref, uint8_t factor, uint32_t iterations)
+{
+    zmod4xxx_dev_t dev;
+    uint8_t adc[ZMOD_GOLDEN_FRAMES][RSLT_MAX];
+    float rmox[RSLT_MAX / 2];
+    uint8_t hsp[HSP_MAX * 2];
+    uint32_t i;
+    uint64_t t0;
+
+    check_dev(&dev, 0);
+    memcpy(adc, zmod_golden_frame, sizeof(adc));
+    t0 = now_ns();
+    for (i = 0; i < iterations; i++)
+    {
+        if (factor)
+        {
+            dev.config[5] = (uint8_t)i;
+            check_factor[ref](dev.meas_conf, hsp, dev.config);
+            sink_i = hsp[0];
+        }
+        else
+        {
+            check_rmox[ref](&dev, adc[i % ZMOD_GOLDEN_FRAMES], rmox);
+            sink_f = rmox[i % (RSLT_MAX / 2)];
+        }
+    }
+    return now_ns() - t0;
+}
+
+static int check_cpu(const char *name, uint8_t factor, uint32_t iterations)
+{
+    uint64_t best[2] = { UINT64_MAX, UINT64_MAX }, ns;
+    uint32_t n = iterations / CHECK_ROUNDS + 1;
+    double ratio;
+    uint8_t r, k;
+
+    for (r = 0; r < CHECK_ROUNDS; r++)
+    {
+        /* alternate who goes first, so warm-up favours neither */
+        for (k = 0; k < 2; k++)
+        {
+            ns = check_time((uint8_t)((r + k) & 1), factor, n);
+            best[(r + k) & 1] = ns < best[(r + k) & 1] ? ns : best[(r + k) & 1];
+        }
+    }
+    ratio = (double)best[0] / (double)best[1];
+    printf("{\"check\":\"cpu\",\"name\":\"%s\",\"ns_per_call\":%.2f,\"ref_ns_per_call\":%.2f,"
+           "\"ratio\":%.3f,\"budget\":%.2f,\"ok\":%d}\n",
+           name, (double)best[0] / n, (double)best[1] / n, ratio, ZMOD_BUDGET_CPU,
+           ratio <= ZMOD_BUDGET_CPU);
+    return ratio <= ZMOD_BUDGET_CPU ? 0 : -1;
+}
+
+static int check_budget(const char *name, uint64_t total, uint32_t count, uint32_t budget)
+{
+    int ok = total <= (uint64_t)budget * count;
+
+    printf("{\"check\":\"budget\",\"name\":\"%s\",\"value\":%.3f,\"budget\":%u,\"ok\":%d}\n",
+           name, (double)total / count, budget, ok);
+    if (total < (uint64_t)budget * count)
+    {
+        fprintf(stderr, "%s is below its budget of %u, lower the budget\n", name, budget);
+    }
+    return ok ? 0 : -1;
+}
+
+static int check_bus(uint32_t samples)
+{
+    zmod4xxx_sim_t sim;
+    zmod4xxx_dev_t dev;
+    zmod4xxx_recover_t rec;
+    zmod4xxx_wait_t wait;
+    uint8_t prod_data[ZMOD4410_PROD_DATA_LEN];
+    uint8_t adc_result[RSLT_MAX];
+    float rmox[RSLT_MAX / 2];
+    zmod4xxx_sim_stats_t *st = &sim.stats;
+    uint32_t i;
+    int ret = 0;
+
+    memset(&dev, 0, sizeof(dev));
+    prepare_dev(&sim, &dev, prod_data, 0x32);
+    if (zmod4xxx_read_sensor_info(&dev) || zmod4xxx_prepare_sensor(&dev))
+    {
+        fprintf(stderr, "startup failed\n");
+        return -1;
+    }
+    ret |= check_budget("startup_i2c", st->reads + st->writes, 1, ZMOD_BUDGET_STARTUP_I2C);
+    ret |= check_budget("startup_bytes", st->read_bytes + st->write_bytes, 1,
+                        ZMOD_BUDGET_STARTUP_BYTES);
+    ret |= check_budget("startup_sleeps", st->sleeps, 1, ZMOD_BUDGET_STARTUP_SLEEPS);
+
+    if (zmod4xxx_recover_init(&dev, &rec, hal_get_time_ms))
+    {
+        fprintf(stderr, "startup failed\n");
+        return -1;
+    }
+    zmod4xxx_wait_init(&wait, 0, ZMOD4410_IAQ2_COUNTER_LIMIT * ZMOD4XXX_WAIT_POLL_MS,
+                       hal_get_time_us);
+    for (i = 0; i < CHECK_LEARN_CYCLES + samples; i++)
+    {
+        if (i == CHECK_LEARN_CYCLES)
+        {
+            memset(st, 0, sizeof(*st));
+        }
+        if (zmod_cycle_run(&dev, &wait, &rec, adc_result, rmox))
+        {
+            fprintf(stderr, "cycle %u failed\n", i);
+            return -1;
+        }
+        dev.delay_ms(ZMOD4410_IAQ2_WAIT_MS);
+    }
+    ret |= check_budget("cycle_i2c", (uint64_t)st->reads + st->writes, samples,
+                        ZMOD_BUDGET_CYCLE_I2C);
+    ret |= check_budget("cycle_bytes", (uint64_t)st->read_bytes + st->write_bytes, samples,
+                        ZMOD_BUDGET_CYCLE_BYTES);
+    ret |= check_budget("cycle_sleeps", st->sleeps, samples, ZMOD_BUDGET_CYCLE_SLEEPS);
+    zmod4xxx_sim_detach(&sim);
+    return ret ? -1 : 0;
+}
+
+static int check_all(uint32_t iterations, uint32_t samples)
+{
+    int ret = 0;
+
+    /* the reference copies first: the CPU budget is only fair if they are exact */
+    ret |= check_golden(1);
+    ret |= check_golden(0);
+    ret |= check_cpu("calc_rmox", 0, iterations);
+    ret |= check_cpu("calc_factor", 1, iterations);
+    ret |= check_bus(samples);
+    return ret ? -1 : 0;
+}
+
+int main(int argc, char **argv)
+{
+    int opt, check = 0;
+    uint32_t iterations = 1000000, samples = 10000;
+    zmod4xxx_sim_t sim;
+    zmod4xxx_dev_t dev;
+    uint8_t prod_data[ZMOD4410_PROD_DATA_LEN];
+
+    while ((opt = getopt(argc, argv, "cn:s:")) != -1)
+    {
+        switch (opt)
+        {
+        case 'c':
+            check = 1;
+            break;
+        case 'n':
+            iterations = (uint32_t)strtoul(optarg, NULL, 0);
+            break;
+        case 's':
+            samples = (uint32_t)strtoul(optarg, NULL, 0);
+            break;
+        default:
+            fprintf(stderr, "usage: %s [-c] [-n iterations] [-s samples]\n", argv[0]);
+            return 1;
+        }
+    }
+    if (iterations == 0 || samples == 0)
+    {
+        fprintf(stderr, "iterations and samples must be > 0\n");
+        return 1;
+    }
+    if (check)
+    {
+        return check_all(iterations, samples) ? 1 : 0;
+    }
+
+    prepare_dev(&sim, &dev, prod_data, 0x32);
+    if (zmod4xxx_read_sensor_info(&dev) || zmod4xxx_prepare_sensor(&dev))
+    {
+        fprintf(stderr, "startup failed\n");
+        return 1;
+    }
+    zmod4xxx_sim_detach(&sim);
+
+    bench_calc_rmox(&dev, iterations);
+    bench_calc_factor(&dev, iterations);
+    bench_convert(iterations);
+    bench_window(iterations);
+    bench_history(iterations);
+    bench_dlog(iterations);
+    if (bench_batch(iterations))
+    {
+        return 1;
+    }
+    if (bench_startup(samples / 100 + 1) || bench_cycle(samples))
+    {
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,285 @@
+/*
+ * Copyright (c) 2006-2021, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-19     Sherman      first version
+ * 2026-10-19     Sherman      link the shared status wait of zmod_cycle_run()
+ */
+
+/*
+ * Host tool: many simulated sensors on the coroutine API of zmod4xxx_co.hpp.
+ *
+ * Build on Linux from the package root:
+ *   gcc -O2 -std=c99 -DZMOD4XXX_USING_HAL_SIM -Isrc -Ihal -c src/zmod4xxx.c \
+ *       src/zmod4xxx_recover.c src/zmod4xxx_mode.c src/zmod4410_config_iaq2.c \
+ *       src/zmod4xxx_wait.c hal/hal_sim.c
+ *   g++ -O2 -std=c++20 -pthread -DZMOD4XXX_USING_HAL_SIM -Isrc -Ihal -Itools \
+ *       tools/zmod_bench_co.cpp zmod4xxx.o zmod4xxx_recover.o zmod4xxx_mode.o \
+ *       zmod4410_config_iaq2.o zmod4xxx_wait.o hal_sim.o -o zmod_bench_co
+ *
+ * Usage:
+ *   zmod_bench_co [-n sensors] [-s samples] [-t threads]
+ *
+ * Every sensor runs the IAQ 2nd Gen cycle as one task on virtual time; the
+ * sensors are split between one executor per thread. Prints one JSON object
+ * on stdout:
+ *   co_sensors   frame_bytes and state_bytes per sensor against the stack of
+ *                a blocking thread, host ns and timers run per sample
+ * The samples of sensor 0 are compared with a blocking C run on the same
+ * seed and a difference fails the run.
+ */
+
+#define _POSIX_C_SOURCE 199309L
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <memory>
+#include <thread>
+#include <vector>
+#include <unistd.h>
+
+#include "zmod4xxx.hpp"
+#include "zmod4xxx_co.hpp"
+#include "zmod4xxx_hal.h"
+#include "zmod_cycle.h"
+
+namespace
+{
+
+/* a typical stack for one blocking sensor thread */
+constexpr uint32_t thread_stack_bytes = 2048;
+
+uint64_t now_ns()
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+/* one simulated sensor, its clock following the executor */
+struct sim_hal
+{
+    zmod4xxx_sim_t *sim = nullptr;
+    zmod4xxx::co::executor *ex = nullptr;
+    uint64_t base_us = 0;
+
+    void sync()
+    {
+        zmod4xxx_sim_set_time_us(sim, base_us + ex->now_us());
+    }
+    int8_t read(uint8_t, uint8_t reg, uint8_t *buf, uint8_t len)
+    {
+        sync();
+        return zmod4xxx_sim_read(sim, reg, buf, len);
+    }
+    int8_t write(uint8_t, uint8_t reg, uint8_t *buf, uint8_t len)
+    {
+        sync();
+        return zmod4xxx_sim_write(sim, reg, buf, len);
+    }
+    /* startup only, before the executor runs */
+    void delay_ms(uint32_t ms)
+    {
+        zmod4xxx_sim_set_time_us(sim, zmod4xxx_sim_time_us(sim) + ms * 1000ULL);
+    }
+};
+
+using sim_sensor = zmod4xxx::sensor<sim_hal, zmod4xxx::zmod4410::init,
+                                    zmod4xxx::zmod4410::iaq2>;
+using sim_device = zmod4xxx::co::device<sim_sensor>;
+
+struct node
+{
+    zmod4xxx_sim_t sim;
+    sim_sensor sensor;
+    sim_device dev;
+    sim_device::frame last;
+    uint32_t samples = 0;
+    zmod4xxx_err ret = ZMOD4XXX_OK;
+
+    node(zmod4xxx::co::executor &ex, uint32_t seed)
+        : sensor(sim_hal{&sim, &ex, 0}), dev(ex, sensor)
+    {
+        zmod4xxx_sim_init(&sim, ZMOD4410_I2C_ADDR, seed);
+    }
+};
+
+/* the cycle of zmod_cycle_run() followed by the wait of the demo */
+zmod4xxx::co::task run_node(node &n, uint32_t samples)
+{
+    while (n.samples < samples)
+    {
+        /* one co_await per statement: GCC 12 miscompiles them inside || */
+        n.ret = co_await n.dev.start();
+        if (n.ret)
+        {
+            co_return;
+        }
+        n.ret = co_await n.dev.sequencer_done();
+        if (n.ret)
+        {
+            co_return;
+        }
+        n.ret = co_await n.dev.read_frame(n.last);
+        if (n.ret)
+        {
+            co_return;
+        }
+        n.samples++;
+        co_await n.dev.sleep(1990);
+    }
+}
+
+struct shard
+{
+    zmod4xxx::co::executor ex;
+    std::vector<std::unique_ptr<node>> nodes;
+    uint64_t timers = 0;
+};
+
+int c_reference(uint32_t seed, uint32_t samples, uint8_t *adc, float *rmox)
+{
+    zmod4xxx_sim_t sim;
+    zmod4xxx_dev_t dev{};
+    uint8_t prod_data[ZMOD4410_PROD_DATA_LEN];
+    uint32_t i;
+
+    zmod4xxx_sim_init(&sim, ZMOD4410_I2C_ADDR, seed);
+    zmod4xxx_sim_attach(&sim, &dev);
+    dev.i2c_addr = ZMOD4410_I2C_ADDR;
+    dev.pid = ZMOD4410_PID;
+    dev.init_conf = &zmod_sensor_type[INIT];
+    dev.meas_conf = &zmod_sensor_type[MEASUREMENT];
+    dev.prod_data = prod_data;
+    if (zmod4xxx_read_sensor_info(&dev) || zmod4xxx_prepare_sensor(&dev))
+    {
+        return -1;
+    }
+    for (i = 0; i < samples; i++)
+    {
+        if (zmod_cycle_run(&dev, NULL, NULL, adc, rmox))
+        {
+            return -1;
+        }
+        dev.delay_ms(1990);
+    }
+    zmod4xxx_sim_detach(&sim);
+    return 0;
+}
+
+int bench_sensors(uint32_t sensors, uint32_t samples, uint32_t threads)
+{
+    std::vector<std::unique_ptr<shard>> shards;
+    std::vector<std::thread> workers;
+    uint8_t adc_c[RSLT_MAX];
+    float rmox_c[RSLT_MAX / 2];
+    uint64_t t0, ns, timers = 0, frame_bytes;
+    uint32_t i;
+
+    for (i = 0; i < threads; i++)
+    {
+        shards.push_back(std::make_unique<shard>());
+    }
+    for (i = 0; i < sensors; i++)
+    {
+        shard &sh = *shards[i % threads];
+        auto n = std::make_unique<node>(sh.ex, i + 1);
+
+        if (n->sensor.read_sensor_info() || n->sensor.prepare())
+        {
+            fprintf(stderr, "sensor %u startup failed\n", i);
+            return -1;
+        }
+        n->sensor.hal().base_us = zmod4xxx_sim_time_us(&n->sim);
+        sh.ex.spawn(run_node(*n, samples));
+        sh.nodes.push_back(std::move(n));
+    }
+    frame_bytes = zmod4xxx::co::frame_stats::live_bytes;
+
+    t0 = now_ns();
+    for (auto &sh : shards)
+    {
+        workers.emplace_back([&s = *sh] { s.timers = s.ex.run(); });
+    }
+    for (auto &w : workers)
+    {
+        w.join();
+    }
+    ns = now_ns() - t0;
+
+    for (auto &sh : shards)
+    {
+        timers += sh->timers;
+        for (auto &n : sh->nodes)
+        {
+            if (n->ret || n->samples != samples)
+            {
+                fprintf(stderr, "a sensor stopped after %u samples, error %d\n",
+                        n->samples, n->ret);
+                return -1;
+            }
+        }
+    }
+
+    const node &first = *shards[0]->nodes[0];
+    if (c_reference(1, samples, adc_c, rmox_c))
+    {
+        fprintf(stderr, "C reference failed\n");
+        return -1;
+    }
+    if (memcmp(first.last.adc.data(), adc_c, sizeof(adc_c)) ||
+        memcmp(first.last.rmox.data(), rmox_c, sizeof(rmox_c)))
+    {
+        fprintf(stderr, "coroutine results differ from C\n");
+        return -1;
+    }
+
+    printf("{\"bench\":\"co_sensors\",\"sensors\":%u,\"threads\":%u,\"samples\":%u,"
+           "\"frame_bytes\":%.1f,\"state_bytes\":%zu,\"thread_stack_bytes\":%u,"
+           "\"ns_per_sample\":%.1f,\"timers_per_sample\":%.2f,\"virtual_s\":%.0f}\n",
+           sensors, threads, samples, (double)frame_bytes / sensors,
+           sizeof(node) - sizeof(zmod4xxx_sim_t), thread_stack_bytes,
+           (double)ns / ((uint64_t)sensors * samples),
+           (double)timers / ((uint64_t)sensors * samples),
+           (double)shards[0]->ex.now_us() / 1e6);
+    return 0;
+}
+
+} /* namespace */
+
+int main(int argc, char **argv)
+{
+    int opt;
+    uint32_t sensors = 500, samples = 1000, threads = 4;
+
+    while ((opt = getopt(argc, argv, "n:s:t:")) != -1)
+    {
+        switch (opt)
+        {
+        case 'n':
+            sensors = (uint32_t)strtoul(optarg, NULL, 0);
+            break;
+        case 's':
+            samples = (uint32_t)strtoul(optarg, NULL, 0);
+            break;
+        case 't':
+            threads = (uint32_t)strtoul(optarg, NULL, 0);
+            break;
+        default:
+            fprintf(stderr, "usage: %s [-n sensors] [-s samples] [-t threads]\n", argv[0]);
+            return 1;
+        }
+    }
+    if (sensors == 0 || samples == 0 || threads == 0 || threads > sensors)
+    {
+        fprintf(stderr, "sensors, samples and threads must be > 0, threads <= sensors\n");
+        return 1;
+    }
+    return bench_sensors(sensors, samples, threads) ? 1 : 0;
+}
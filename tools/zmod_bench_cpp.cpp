@@ -0,0 +1,375 @@
+/*
+ * Copyright (c) 2006-2021, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-19     Sherman      first version
+ * 2026-10-19     Sherman      link the shared status wait of zmod_cycle_run()
+ * 2026-10-19     Sherman      repeat the timed runs, report fastest and slowest
+ */
+
+/*
+ * Host tool: the C++ layer of zmod4xxx.hpp against the C driver.
+ *
+ * Build on Linux from the package root:
+ *   gcc -O2 -std=c99 -DZMOD4XXX_USING_HAL_SIM -Isrc -Ihal -c src/zmod4xxx.c \
+ *       src/zmod4xxx_recover.c src/zmod4xxx_mode.c src/zmod4410_config_iaq2.c \
+ *       src/zmod4xxx_wait.c hal/hal_sim.c
+ *   g++ -O2 -std=c++17 -DZMOD4XXX_USING_HAL_SIM -Isrc -Ihal -Itools \
+ *       tools/zmod_bench_cpp.cpp zmod4xxx.o zmod4xxx_recover.o zmod4xxx_mode.o \
+ *       zmod4410_config_iaq2.o zmod4xxx_wait.o hal_sim.o -o zmod_bench_cpp
+ *
+ * Usage:
+ *   zmod_bench_cpp [-n iterations] [-s samples] [-r rounds]
+ *
+ * Prints one JSON object per benchmark on stdout:
+ *   cpp_cycle    full measurement cycles on the simulated bus, C driver and
+ *                sensor<c_hal> through the same function pointers
+ *   cpp_driver   start, status, results and calc_rmox against an in-memory
+ *                register file, called through function pointers by the C
+ *                driver and inlined into sensor<> in C++
+ * Each is run -r times, 7 by default; c_ns and cpp_ns are the fastest
+ * round and the _max fields the slowest, so a difference smaller than the
+ * spread of a side is noise. cpp_cycle stays within that spread on the
+ * simulated bus, where both paths call the same function pointers; only
+ * cpp_driver, with the HAL inlined, separates the two. The results of both
+ * paths are compared and a difference fails the run.
+ *
+ * Code size is measured outside of this tool, e.g. for a Cortex-M33:
+ *   arm-none-eabi-gcc -Os -mcpu=cortex-m33 -c src/zmod4xxx.c ...; size *.o
+ * against a translation unit that instantiates sensor<> with the board HAL.
+ */
+
+#define _POSIX_C_SOURCE 199309L
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <unistd.h>
+
+#include "zmod4xxx.hpp"
+#include "zmod4xxx_hal.h"
+#include "zmod_cycle.h"
+
+namespace
+{
+
+volatile float sink_f;
+
+uint64_t now_ns()
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+/* a sensor that has always just finished, results from a counter */
+struct reg_file
+{
+    static uint8_t regs[256];
+    static uint32_t n;
+
+    static int8_t read(uint8_t, uint8_t reg, uint8_t *buf, uint8_t len)
+    {
+        if (reg == ZMOD4XXX_ADDR_STATUS)
+        {
+            buf[0] = 0;
+            return 0;
+        }
+        memcpy(buf, &regs[reg], len);
+        regs[0x97 + (n++ & 31)]++;
+        return 0;
+    }
+    static int8_t write(uint8_t, uint8_t reg, uint8_t *buf, uint8_t len)
+    {
+        memcpy(&regs[reg], buf, len);
+        return 0;
+    }
+    static void delay_ms(uint32_t)
+    {
+    }
+};
+
+uint8_t reg_file::regs[256];
+uint32_t reg_file::n;
+
+/* the same register file as a template HAL, all calls visible */
+struct inline_hal
+{
+    int8_t read(uint8_t a, uint8_t reg, uint8_t *buf, uint8_t len)
+    {
+        return reg_file::read(a, reg, buf, len);
+    }
+    int8_t write(uint8_t a, uint8_t reg, uint8_t *buf, uint8_t len)
+    {
+        return reg_file::write(a, reg, buf, len);
+    }
+    void delay_ms(uint32_t ms)
+    {
+        reg_file::delay_ms(ms);
+    }
+};
+
+using cpp_sim = zmod4xxx::sensor<zmod4xxx::c_hal, zmod4xxx::zmod4410::init,
+                                 zmod4xxx::zmod4410::iaq2>;
+using cpp_inline = zmod4xxx::sensor<inline_hal, zmod4xxx::zmod4410::init,
+                                    zmod4xxx::zmod4410::iaq2>;
+
+/* zmod_cycle_run() without the recovery checks, for sensor<> */
+template <class Sensor>
+zmod4xxx_err cpp_cycle_run(Sensor &s, typename Sensor::adc_t &adc, typename Sensor::rmox_t &rmox)
+{
+    zmod4xxx_err ret;
+    uint8_t status;
+    uint32_t polling_counter = 0;
+
+    ret = s.start();
+    if (ret)
+    {
+        return ret;
+    }
+    do
+    {
+        ret = s.status(status);
+        if (ret)
+        {
+            return ret;
+        }
+        polling_counter++;
+        s.hal().delay_ms(ZMOD4XXX_WAIT_POLL_MS);
+    } while ((status & STATUS_SEQUENCER_RUNNING_MASK) &&
+             (polling_counter <= ZMOD4410_IAQ2_COUNTER_LIMIT));
+
+    if (ZMOD4410_IAQ2_COUNTER_LIMIT <= polling_counter)
+    {
+        return ERROR_GAS_TIMEOUT;
+    }
+    ret = s.read_adc(adc);
+    if (ret)
+    {
+        return ret;
+    }
+    s.calc_rmox(adc, rmox);
+    return ZMOD4XXX_OK;
+}
+
+void c_dev_setup(zmod4xxx_dev_t &dev, uint8_t *prod_data)
+{
+    dev.i2c_addr = ZMOD4410_I2C_ADDR;
+    dev.pid = ZMOD4410_PID;
+    dev.init_conf = &zmod_sensor_type[INIT];
+    dev.meas_conf = &zmod_sensor_type[MEASUREMENT];
+    dev.prod_data = prod_data;
+}
+
+/* fastest and slowest of the rounds of one path */
+struct span
+{
+    uint64_t min = UINT64_MAX;
+    uint64_t max = 0;
+
+    void add(uint64_t ns)
+    {
+        min = ns < min ? ns : min;
+        max = ns > max ? ns : max;
+    }
+};
+
+/* one round of full cycles on the simulated bus, C then C++ */
+int cycle_round(uint32_t samples, span &c, span &cpp)
+{
+    zmod4xxx_sim_t sim_c, sim_cpp;
+    zmod4xxx_dev_t dev{}, dev_cpp{};
+    uint8_t prod_data[ZMOD4410_PROD_DATA_LEN];
+    uint8_t adc_c[RSLT_MAX];
+    float rmox_c[RSLT_MAX / 2];
+    cpp_sim::adc_t adc;
+    cpp_sim::rmox_t rmox;
+    uint64_t t0;
+    uint32_t i;
+
+    zmod4xxx_sim_init(&sim_c, ZMOD4410_I2C_ADDR, 1);
+    zmod4xxx_sim_attach(&sim_c, &dev);
+    c_dev_setup(dev, prod_data);
+    if (zmod4xxx_read_sensor_info(&dev) || zmod4xxx_prepare_sensor(&dev))
+    {
+        fprintf(stderr, "C startup failed\n");
+        return -1;
+    }
+    t0 = now_ns();
+    for (i = 0; i < samples; i++)
+    {
+        if (zmod_cycle_run(&dev, NULL, NULL, adc_c, rmox_c))
+        {
+            fprintf(stderr, "C cycle %u failed\n", i);
+            return -1;
+        }
+        dev.delay_ms(1990);
+    }
+    c.add(now_ns() - t0);
+    zmod4xxx_sim_detach(&sim_c);
+
+    /* same seed: the C++ run has to see the same results */
+    zmod4xxx_sim_init(&sim_cpp, ZMOD4410_I2C_ADDR, 1);
+    zmod4xxx_sim_attach(&sim_cpp, &dev_cpp);
+    cpp_sim s{zmod4xxx::c_hal(dev_cpp)};
+    if (s.read_sensor_info() || s.prepare())
+    {
+        fprintf(stderr, "C++ startup failed\n");
+        return -1;
+    }
+    if (memcmp(s.c_dev()->config, dev.config, sizeof(dev.config)) ||
+        s.c_dev()->mox_lr != dev.mox_lr || s.c_dev()->mox_er != dev.mox_er ||
+        s.c_dev()->init_conf != dev.init_conf || s.c_dev()->meas_conf != dev.meas_conf)
+    {
+        fprintf(stderr, "C++ startup differs\n");
+        return -1;
+    }
+    t0 = now_ns();
+    for (i = 0; i < samples; i++)
+    {
+        if (cpp_cycle_run(s, adc, rmox))
+        {
+            fprintf(stderr, "C++ cycle %u failed\n", i);
+            return -1;
+        }
+        s.hal().delay_ms(1990);
+    }
+    cpp.add(now_ns() - t0);
+    zmod4xxx_sim_detach(&sim_cpp);
+
+    if (memcmp(adc.data(), adc_c, sizeof(adc_c)) || memcmp(rmox.data(), rmox_c, sizeof(rmox_c)))
+    {
+        fprintf(stderr, "C++ results differ\n");
+        return -1;
+    }
+    return 0;
+}
+
+int bench_cycle(uint32_t samples, uint32_t rounds)
+{
+    span c, cpp;
+    uint32_t r;
+
+    for (r = 0; r < rounds; r++)
+    {
+        if (cycle_round(samples, c, cpp))
+        {
+            return -1;
+        }
+    }
+    printf("{\"bench\":\"cpp_cycle\",\"count\":%u,\"rounds\":%u,"
+           "\"c_ns\":%.1f,\"c_ns_max\":%.1f,\"cpp_ns\":%.1f,\"cpp_ns_max\":%.1f}\n",
+           samples, rounds, (double)c.min / samples, (double)c.max / samples,
+           (double)cpp.min / samples, (double)cpp.max / samples);
+    return 0;
+}
+
+int bench_driver(uint32_t iterations, uint32_t rounds)
+{
+    zmod4xxx_dev_t dev{};
+    uint8_t prod_data[ZMOD4410_PROD_DATA_LEN];
+    uint8_t adc_c[RSLT_MAX];
+    float rmox_c[RSLT_MAX / 2];
+    cpp_inline::adc_t adc;
+    cpp_inline::rmox_t rmox;
+    cpp_inline s;
+    uint8_t regs[256];
+    span c, cpp;
+    uint64_t t0;
+    uint32_t i, r;
+
+    for (i = 0; i < 256; i++)
+    {
+        reg_file::regs[i] = (uint8_t)(i * 37 + 11);
+    }
+    reg_file::regs[ZMOD4XXX_ADDR_PID] = 0x23;
+    reg_file::regs[ZMOD4XXX_ADDR_PID + 1] = 0x10;
+
+    dev.read = reg_file::read;
+    dev.write = reg_file::write;
+    dev.delay_ms = reg_file::delay_ms;
+    c_dev_setup(dev, prod_data);
+    if (zmod4xxx_read_sensor_info(&dev) || zmod4xxx_prepare_sensor(&dev) ||
+        s.read_sensor_info() || s.prepare())
+    {
+        fprintf(stderr, "register file startup failed\n");
+        return -1;
+    }
+
+    memcpy(regs, reg_file::regs, sizeof(regs));
+    for (r = 0; r < rounds; r++)
+    {
+        memcpy(reg_file::regs, regs, sizeof(regs));
+        reg_file::n = 0;
+        t0 = now_ns();
+        for (i = 0; i < iterations; i++)
+        {
+            zmod_cycle_run(&dev, NULL, NULL, adc_c, rmox_c);
+            sink_f = rmox_c[i & 15];
+        }
+        c.add(now_ns() - t0);
+
+        memcpy(reg_file::regs, regs, sizeof(regs));
+        reg_file::n = 0;
+        t0 = now_ns();
+        for (i = 0; i < iterations; i++)
+        {
+            cpp_cycle_run(s, adc, rmox);
+            sink_f = rmox[i & 15];
+        }
+        cpp.add(now_ns() - t0);
+
+        if (memcmp(rmox.data(), rmox_c, sizeof(rmox_c)))
+        {
+            fprintf(stderr, "C++ results differ\n");
+            return -1;
+        }
+    }
+    printf("{\"bench\":\"cpp_driver\",\"iterations\":%u,\"rounds\":%u,"
+           "\"c_ns\":%.2f,\"c_ns_max\":%.2f,\"cpp_ns\":%.2f,\"cpp_ns_max\":%.2f}\n",
+           iterations, rounds, (double)c.min / iterations, (double)c.max / iterations,
+           (double)cpp.min / iterations, (double)cpp.max / iterations);
+    return 0;
+}
+
+} /* namespace */
+
+int main(int argc, char **argv)
+{
+    int opt;
+    uint32_t iterations = 1000000, samples = 10000, rounds = 7;
+
+    while ((opt = getopt(argc, argv, "n:s:r:")) != -1)
+    {
+        switch (opt)
+        {
+        case 'n':
+            iterations = (uint32_t)strtoul(optarg, NULL, 0);
+            break;
+        case 's':
+            samples = (uint32_t)strtoul(optarg, NULL, 0);
+            break;
+        case 'r':
+            rounds = (uint32_t)strtoul(optarg, NULL, 0);
+            break;
+        default:
+            fprintf(stderr, "usage: %s [-n iterations] [-s samples] [-r rounds]\n", argv[0]);
+            return 1;
+        }
+    }
+    if (iterations == 0 || samples == 0 || rounds == 0)
+    {
+        fprintf(stderr, "iterations, samples and rounds must be > 0\n");
+        return 1;
+    }
+    if (bench_cycle(samples, rounds) || bench_driver(iterations, rounds))
+    {
+        return 1;
+    }
+    return 0;
+}
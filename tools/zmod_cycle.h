@@ -0,0 +1,100 @@
+/*
+ * Copyright (c) 2006-2021, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-19     Sherman      first version
+ * 2026-10-19     Sherman      wait with zmod4xxx_wait_done() like the port
+ */
+
+#ifndef _ZMOD_CYCLE_H
+#define _ZMOD_CYCLE_H
+
+#include "zmod4410_config_iaq2.h"
+#include "zmod4xxx.h"
+#include "zmod4xxx_recover.h"
+#include "zmod4xxx_wait.h"
+
+/**
+ * @brief   One measurement cycle as run by the port without the INT pin
+ * @param   [in] dev pointer to the device
+ * @param   [in,out] wait status wait set up with zmod4xxx_wait_init() as
+ *          the port does; NULL polls every ZMOD4XXX_WAIT_POLL_MS as
+ *          src/demo.c does, the loop the C++ benches compare against
+ * @param   [in,out] rec recovery state, NULL to skip the error event checks
+ * @param   [out] adc_result RSLT_MAX bytes of raw ADC results
+ * @param   [out] rmox RSLT_MAX / 2 MOx resistances
+ * @return  error code
+ * @retval  0 success
+ * @retval  "!= 0" error
+ * @note    Starts the sequencer, waits for it, reads the results and
+ *          checks the error event register, the bus traffic of
+ *          zmod4410_sample() in ports/. The wait before the next cycle is
+ *          left to the caller. ERROR_POR_EVENT and ERROR_ACCESS_CONFLICT
+ *          mean the sensor was reconfigured and the sample is to be
+ *          dropped.
+ */
+static inline zmod4xxx_err zmod_cycle_run(zmod4xxx_dev_t *dev, zmod4xxx_wait_t *wait,
+                                          zmod4xxx_recover_t *rec,
+                                          uint8_t *adc_result, float *rmox)
+{
+    zmod4xxx_err ret;
+    zmod4xxx_stamp_t stamp;
+    uint8_t status;
+    uint32_t polling_counter = 0;
+
+    ret = zmod4xxx_start_measurement(dev);
+    if (ret)
+    {
+        return ret;
+    }
+    if (wait != NULL)
+    {
+        stamp.start_us = wait->clock_us();
+        ret = zmod4xxx_wait_done(dev, wait, &stamp, NULL, NULL);
+    }
+    else
+    {
+        do
+        {
+            ret = zmod4xxx_read_status(dev, &status);
+            if (ret)
+            {
+                return ret;
+            }
+            polling_counter++;
+            dev->delay_ms(ZMOD4XXX_WAIT_POLL_MS);
+        }
+        while ((status & STATUS_SEQUENCER_RUNNING_MASK) &&
+               (polling_counter <= ZMOD4410_IAQ2_COUNTER_LIMIT));
+        if (ZMOD4410_IAQ2_COUNTER_LIMIT <= polling_counter)
+        {
+            ret = ERROR_GAS_TIMEOUT;
+        }
+    }
+
+    if (ret == ERROR_GAS_TIMEOUT && rec != NULL)
+    {
+        ret = zmod4xxx_recover_check(dev, rec);
+        return ret ? ret : ERROR_GAS_TIMEOUT;
+    }
+    if (ret)
+    {
+        return ret;
+    }
+    ret = zmod4xxx_read_adc_result(dev, adc_result);
+    if (ret)
+    {
+        return ret;
+    }
+    ret = zmod4xxx_calc_rmox(dev, adc_result, rmox);
+    if (ret)
+    {
+        return ret;
+    }
+    return rec != NULL ? zmod4xxx_recover_check(dev, rec) : ZMOD4XXX_OK;
+}
+
+#endif /* _ZMOD_CYCLE_H */
@@ -0,0 +1,287 @@
+/*
+ * Copyright (c) 2006-2021, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-19     Sherman      first version
+ * 2026-10-19     Sherman      wait for the status as the port does
+ */
+
+/*
+ * Host tool: fault injection on the simulated bus. Runs the port's
+ * measurement cycle against a script of bus and sensor faults and reports,
+ * per fault, how long it took until the next good sample and how many
+ * samples were lost on the way.
+ *
+ * Build on Linux from the package root:
+ *   gcc -O2 -std=c99 -DZMOD4XXX_USING_HAL_SIM -DZMOD4XXX_USING_RETRY \
+ *       -Isrc -Ihal -Itools tools/zmod_faults.c src/zmod4xxx.c \
+ *       src/zmod4xxx_recover.c src/zmod4xxx_retry.c src/zmod4xxx_wait.c \
+ *       src/zmod4410_config_iaq2.c hal/hal_sim.c -o zmod_faults
+ *
+ * Usage:
+ *   zmod_faults [-f script] [-s samples] [-r seed] [-a attempts] [-N]
+ *
+ * The script has one fault per line, see zmod4xxx_sim_fault_parse():
+ *   60000 nack count=3
+ *   120000 stuck for=5000
+ *   rand truncate rate=200 keep=8
+ * Without -f a built-in scenario with one fault of each kind is used.
+ *
+ * Error events are handled by zmod4xxx_recover_check() as in the port; -N
+ * turns that off to see how the plain driver copes. Bus transactions go
+ * through the port's default retry policy; -a sets the attempts, -a 1
+ * disables retrying.
+ *
+ * A sample is good when the cycle returned no error, the simulated sensor
+ * completed the measurement and the bytes read equal its result registers.
+ * Output is one JSON object per fault followed by a summary object.
+ */
+
+#define _POSIX_C_SOURCE 199309L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "zmod4410_config_iaq2.h"
+#include "zmod4xxx.h"
+#include "zmod4xxx_hal.h"
+#include "zmod4xxx_retry.h"
+#include "zmod_cycle.h"
+
+#define EPISODES_MAX (1024)
+
+struct fault_episode
+{
+    uint8_t type;
+    uint64_t at_us;
+    uint64_t recovered_us; /**< 0 while the fault is not recovered */
+    uint32_t samples_lost;
+};
+
+static const char *const builtin_script[] = {
+    "60000 nack count=3",
+    "120000 stuck for=5000",
+    "180000 conflict",
+    "240000 truncate count=2 keep=8",
+    "300000 stretch for=10000 us=500",
+    "360000 por",
+};
+
+static struct fault_episode episodes[EPISODES_MAX];
+static uint32_t episode_count;
+
+static int load_script(zmod4xxx_sim_t *sim, const char *path)
+{
+    zmod4xxx_sim_fault_t fault;
+    char line[128];
+    uint32_t i, lineno = 0;
+    FILE *fp;
+
+    if (path == NULL)
+    {
+        for (i = 0; i < sizeof(builtin_script) / sizeof(builtin_script[0]); i++)
+        {
+            zmod4xxx_sim_fault_parse(builtin_script[i], &fault);
+            zmod4xxx_sim_fault_add(sim, &fault);
+        }
+        return 0;
+    }
+
+    fp = fopen(path, "r");
+    if (fp == NULL)
+    {
+        perror(path);
+        return -1;
+    }
+    while (fgets(line, sizeof(line), fp) != NULL)
+    {
+        lineno++;
+        if (zmod4xxx_sim_fault_parse(line, &fault))
+        {
+            fprintf(stderr, "%s:%u: syntax error\n", path, lineno);
+            fclose(fp);
+            return -1;
+        }
+        if (fault.type != ZMOD4XXX_SIM_FAULT_TYPE_MAX &&
+            zmod4xxx_sim_fault_add(sim, &fault))
+        {
+            fprintf(stderr, "%s:%u: too many faults\n", path, lineno);
+            fclose(fp);
+            return -1;
+        }
+    }
+    fclose(fp);
+    return 0;
+}
+
+/* open an episode for every fault the simulator triggered since last time */
+static void track_faults(const zmod4xxx_sim_t *sim, uint32_t *seen)
+{
+    while (*seen < sim->stats.faults)
+    {
+        (*seen)++;
+        if (episode_count < EPISODES_MAX)
+        {
+            episodes[episode_count].type = sim->stats.last_fault;
+            episodes[episode_count].at_us = sim->stats.last_fault_us;
+            episode_count++;
+        }
+    }
+}
+
+static int sample_good(const zmod4xxx_sim_t *sim, const zmod4xxx_dev_t *dev,
+                       zmod4xxx_err ret, const uint8_t *adc_result)
+{
+    return ret == ZMOD4XXX_OK && sim->result_valid &&
+           memcmp(adc_result, &sim->regs[dev->meas_conf->r.addr],
+                  dev->meas_conf->r.len) == 0;
+}
+
+int main(int argc, char **argv)
+{
+    int opt;
+    uint32_t i, samples = 300, seed = 1, seen = 0, good = 0, lost = 0;
+    uint32_t unrecovered = 0;
+    const char *script = NULL;
+    zmod4xxx_sim_t sim;
+    zmod4xxx_dev_t dev;
+    zmod4xxx_recover_t rec;
+    zmod4xxx_wait_t wait;
+    zmod4xxx_recover_t *recp = &rec;
+    zmod4xxx_retry_policy_t policy = {
+        ZMOD4XXX_RETRY_ATTEMPTS, ZMOD4XXX_RETRY_BACKOFF_US,
+        ZMOD4XXX_RETRY_BACKOFF_MAX_US, hal_delay_us,
+    };
+    const zmod4xxx_retry_stats_t *retry;
+    uint32_t retries = 0, retry_recovered = 0, retry_failed = 0;
+    uint8_t prod_data[ZMOD4410_PROD_DATA_LEN];
+    uint8_t adc_result[RSLT_MAX];
+    float rmox[RSLT_MAX / 2];
+    zmod4xxx_err ret;
+
+    while ((opt = getopt(argc, argv, "f:s:r:a:N")) != -1)
+    {
+        switch (opt)
+        {
+        case 'f':
+            script = optarg;
+            break;
+        case 's':
+            samples = (uint32_t)strtoul(optarg, NULL, 0);
+            break;
+        case 'r':
+            seed = (uint32_t)strtoul(optarg, NULL, 0);
+            break;
+        case 'a':
+            policy.attempts = (uint8_t)atoi(optarg);
+            break;
+        case 'N':
+            recp = NULL;
+            break;
+        default:
+            fprintf(stderr, "usage: %s [-f script] [-s samples] [-r seed] [-a attempts] [-N]\n",
+                    argv[0]);
+            return 1;
+        }
+    }
+
+    zmod4xxx_sim_init(&sim, ZMOD4410_I2C_ADDR, seed);
+    zmod4xxx_sim_attach(&sim, &dev);
+    dev.pid = ZMOD4410_PID;
+    dev.init_conf = &zmod_sensor_type[INIT];
+    dev.meas_conf = &zmod_sensor_type[MEASUREMENT];
+    dev.prod_data = prod_data;
+    if (zmod4xxx_retry_attach(&dev, &policy))
+    {
+        fprintf(stderr, "attempts must be 1..255\n");
+        return 1;
+    }
+    if (zmod4xxx_read_sensor_info(&dev) || zmod4xxx_prepare_sensor(&dev) ||
+        zmod4xxx_recover_init(&dev, &rec, hal_get_time_ms))
+    {
+        fprintf(stderr, "preparation failed\n");
+        return 1;
+    }
+    zmod4xxx_wait_init(&wait, 0, ZMOD4410_IAQ2_COUNTER_LIMIT * ZMOD4XXX_WAIT_POLL_MS,
+                       hal_get_time_us);
+    /* faults are scheduled from here on */
+    if (load_script(&sim, script))
+    {
+        return 1;
+    }
+
+    for (i = 0; i < samples; i++)
+    {
+        ret = zmod_cycle_run(&dev, &wait, recp, adc_result, rmox);
+        track_faults(&sim, &seen);
+        if (sample_good(&sim, &dev, ret, adc_result))
+        {
+            uint32_t e;
+
+            good++;
+            zmod4xxx_recover_sample(&rec);
+            for (e = 0; e < episode_count; e++)
+            {
+                if (episodes[e].recovered_us == 0)
+                {
+                    episodes[e].recovered_us = zmod4xxx_sim_time_us(&sim);
+                }
+            }
+        }
+        else
+        {
+            uint32_t e;
+
+            lost++;
+            for (e = 0; e < episode_count; e++)
+            {
+                if (episodes[e].recovered_us == 0)
+                {
+                    episodes[e].samples_lost++;
+                }
+            }
+        }
+        /* the sensor framework polls again after the same period on errors */
+        dev.delay_ms(1990);
+    }
+
+    for (i = 0; i < episode_count; i++)
+    {
+        const struct fault_episode *ep = &episodes[i];
+
+        if (ep->recovered_us == 0)
+        {
+            unrecovered++;
+        }
+        printf("{\"fault\":\"%s\",\"at_ms\":%llu,\"recovered\":%s,"
+               "\"recovery_ms\":%lld,\"samples_lost\":%u}\n",
+               zmod4xxx_sim_fault_name(ep->type),
+               (unsigned long long)(ep->at_us / 1000),
+               ep->recovered_us ? "true" : "false",
+               ep->recovered_us ? (long long)((ep->recovered_us - ep->at_us) / 1000)
+                                : -1LL,
+               ep->samples_lost);
+    }
+    retry = zmod4xxx_retry_get(dev.i2c_addr);
+    for (i = 0; retry != NULL && i < ZMOD4XXX_RETRY_OP_MAX; i++)
+    {
+        retries += retry->ops[i].retries;
+        retry_recovered += retry->ops[i].recovered;
+        retry_failed += retry->ops[i].failed;
+    }
+    printf("{\"retry\":{\"attempts\":%u,\"retries\":%u,\"recovered\":%u,"
+           "\"failed\":%u}}\n", policy.attempts, retries, retry_recovered,
+           retry_failed);
+    printf("{\"summary\":{\"samples\":%u,\"good\":%u,\"lost\":%u,"
+           "\"faults\":%u,\"unrecovered\":%u,\"virtual_ms\":%llu,"
+           "\"recoveries\":%u,\"recovery_failures\":%u,\"downtime_ms\":%u}}\n",
+           samples, good, lost, sim.stats.faults, unrecovered,
+           (unsigned long long)(zmod4xxx_sim_time_us(&sim) / 1000),
+           rec.recoveries, rec.failures, rec.downtime_ms);
+    return unrecovered ? 2 : 0;
+}
@@ -0,0 +1,331 @@
+/*
+ * Copyright (c) 2006-2021, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-19     Sherman      first version
+ * 2026-10-19     Sherman      cycle budgets of the learned status wait
+ */
+
+#ifndef _ZMOD_GOLDEN_H
+#define _ZMOD_GOLDEN_H
+
+#include "zmod4410_config_iaq2.h"
+#include "zmod4xxx.h"
+
+/*
+ * Golden vectors of zmod4xxx_calc_rmox() and zmod4xxx_calc_factor(), taken
+ * from the driver as imported from Renesas, and the budgets zmod_bench -c
+ * holds the driver to. The vectors are not to be regenerated to make a
+ * check pass: different output is a different measurement. A budget is
+ * lowered when a change beats it, so the gain is kept.
+ */
+
+#ifndef ZMOD_GOLDEN_ULP
+#define ZMOD_GOLDEN_ULP (0) /**< units in the last place an rmox may be off */
+#endif
+#ifndef ZMOD_BUDGET_CPU
+#define ZMOD_BUDGET_CPU (1.15) /**< driver time over that of the reference copy */
+#endif
+
+/* bus budgets on the simulated ZMOD4410, per startup or cycle */
+#define ZMOD_BUDGET_STARTUP_I2C     (19)
+#define ZMOD_BUDGET_STARTUP_BYTES   (96)
+#define ZMOD_BUDGET_STARTUP_SLEEPS  (5)
+#define ZMOD_BUDGET_CYCLE_I2C       (7)
+#define ZMOD_BUDGET_CYCLE_BYTES     (38)
+#define ZMOD_BUDGET_CYCLE_SLEEPS    (5)
+
+#define ZMOD_GOLDEN_CALIBS  (4)
+#define ZMOD_GOLDEN_FRAMES  (8)
+
+/**
+ * @brief Calibration of a sensor as zmod4xxx_read_sensor_info() and the
+ *        init run leave it in the device
+ */
+typedef struct {
+    uint8_t config[6];
+    uint16_t mox_lr;
+    uint16_t mox_er;
+} zmod_golden_calib_t;
+
+static const zmod_golden_calib_t zmod_golden_calib[ZMOD_GOLDEN_CALIBS] = {
+    /* the simulated sensor */
+    { { 0x1E, 0x8F, 0x24, 0x1B, 0x4C, 0x4E }, 1500, 60000 },
+    /* nothing clamped below, smallest factor */
+    { { 0x01, 0x00, 0x00, 0x00, 0x00, 0x00 }, 0, 65535 },
+    /* a window of one count, largest factor */
+    { { 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF }, 30000, 30001 },
+    { { 0x64, 0x12, 0x30, 0x80, 0x10, 0xF0 }, 800, 40000 },
+};
+
+/* ADC results of IAQ 2nd Gen, 16 big-endian values each */
+static const uint8_t zmod_golden_frame[ZMOD_GOLDEN_FRAMES][RSLT_MAX] = {
+    /* clamp edges of the calibrations */
+    { 0x00, 0x00, 0x00, 0x01, 0x03, 0x1F, 0x03, 0x20,
+      0x03, 0x21, 0x05, 0xDB, 0x05, 0xDC, 0x05, 0xDD,
+      0x75, 0x2F, 0x75, 0x30, 0x75, 0x31, 0x75, 0x32,
+      0x9C, 0x3F, 0x9C, 0x40, 0x9C, 0x41, 0xFF, 0xFF },
+    /* mox_er edges and mid range */
+    { 0xEA, 0x5F, 0xEA, 0x60, 0xEA, 0x61, 0xFF, 0xFE,
+      0xFF, 0xFF, 0x00, 0x02, 0x00, 0x64, 0x03, 0xE8,
+      0x13, 0x88, 0x27, 0x10, 0x3A, 0x98, 0x4E, 0x20,
+      0x61, 0xA8, 0x88, 0xB8, 0xAF, 0xC8, 0xD6, 0xD8 },
+    /* powers of two */
+    { 0x01, 0x00, 0x02, 0x00, 0x04, 0x00, 0x08, 0x00,
+      0x10, 0x00, 0x20, 0x00, 0x40, 0x00, 0x80, 0x00,
+      0x00, 0xFF, 0x01, 0xFF, 0x03, 0xFF, 0x07, 0xFF,
+      0x0F, 0xFF, 0x1F, 0xFF, 0x3F, 0xFF, 0x7F, 0xFF },
+    /* a ramp */
+    { 0x03, 0xE8, 0x13, 0x88, 0x23, 0x28, 0x32, 0xC8,
+      0x42, 0x68, 0x52, 0x08, 0x61, 0xA8, 0x71, 0x48,
+      0x80, 0xE8, 0x90, 0x88, 0xA0, 0x28, 0xAF, 0xC8,
+      0xBF, 0x68, 0xCF, 0x08, 0xDE, 0xA8, 0xEE, 0x48 },
+    /* random */
+    { 0xE1, 0x8B, 0x64, 0x00, 0xF2, 0xFE, 0x8A, 0x12,
+      0x96, 0x46, 0x13, 0x9D, 0x8E, 0x9E, 0x26, 0xE7,
+      0xEE, 0x4A, 0x12, 0xA9, 0xFC, 0x3C, 0x88, 0x78,
+      0x8D, 0x63, 0x06, 0xEA, 0x00, 0x59, 0x57, 0x16 },
+    /* random */
+    { 0xDD, 0x70, 0x52, 0x2D, 0xE6, 0x08, 0x59, 0xD4,
+      0xDC, 0xA4, 0x48, 0x8B, 0xF9, 0xEB, 0x3F, 0x6C,
+      0xA5, 0x37, 0x96, 0x57, 0x21, 0xF7, 0x1F, 0xEF,
+      0x52, 0xC1, 0x44, 0x74, 0xB3, 0x08, 0x48, 0x64 },
+    /* random */
+    { 0x53, 0x2D, 0xE6, 0xA5, 0x10, 0xED, 0x56, 0x62,
+      0x6E, 0x20, 0xCA, 0xDC, 0xF2, 0xD0, 0x13, 0xA4,
+      0xC4, 0x43, 0xA2, 0x49, 0xB9, 0xCE, 0x0F, 0xA5,
+      0x17, 0x68, 0xB5, 0xF2, 0x4E, 0x47, 0xD0, 0xF1 },
+    /* random */
+    { 0x4D, 0x76, 0x47, 0x5C, 0xFA, 0xB2, 0xEA, 0xC1,
+      0xB2, 0x0A, 0xE2, 0x9E, 0x84, 0x77, 0xD7, 0x30,
+      0xA7, 0x56, 0x43, 0x8F, 0x71, 0x3B, 0xFD, 0xB7,
+      0x1F, 0xF5, 0x96, 0x25, 0xA6, 0xBE, 0x15, 0x1D },
+};
+
+/* zmod4xxx_calc_rmox() of every frame, IEEE 754 single precision bits */
+static const uint32_t zmod_golden_rmox[ZMOD_GOLDEN_CALIBS][ZMOD_GOLDEN_FRAMES][RSLT_MAX / 2] = {
+    {
+        { 0x3A83126F, 0x3A83126F, 0x3A83126F, 0x3A83126F,
+          0x3A83126F, 0x3A83126F, 0x00000000, 0x3F0348C8,
+          0x46DEA41A, 0x46DEA800, 0x46DEABE6, 0x46DEAFCD,
+          0x4761919D, 0x47619600, 0x47619A63, 0x501502F9 },
+        { 0x4ED1356F, 0x501502F9, 0x501502F9, 0x501502F9,
+          0x501502F9, 0x3A83126F, 0x3A83126F, 0x3A83126F,
+          0x44EEA2E9, 0x459F6000, 0x460CA000, 0x4658CC00,
+          0x469D5DB7, 0x471D0800, 0x47A9EC00, 0x489CBD00 },
+        { 0x3A83126F, 0x3A83126F, 0x3A83126F, 0x438DD76E,
+          0x44AE2347, 0x4572313C, 0x461FF61C, 0x47068E3D,
+          0x3A83126F, 0x3A83126F, 0x3A83126F, 0x438D948B,
+          0x44AE114F, 0x457226C6, 0x461FF26C, 0x47068BE0 },
+        { 0x3A83126F, 0x44EEA2E9, 0x4589DE1E, 0x45E56367,
+          0x4628F7D0, 0x466A6000, 0x469D5DB7, 0x46CFE9CE,
+          0x4708B800, 0x4734E059, 0x4773A06C, 0x47A9EC00,
+          0x47FD04BA, 0x48578A92, 0x49077F80, 0x501502F9 },
+        { 0x49362DD4, 0x46A432E2, 0x501502F9, 0x4720E134,
+          0x47493A2B, 0x44F028EE, 0x472EA8A5, 0x459E79EF,
+          0x501502F9, 0x44DE8791, 0x501502F9, 0x471C54BF,
+          0x472ACC02, 0x430B1A83, 0x3A83126F, 0x468140A2 },
+        { 0x48F4166A, 0x466B0AEE, 0x49BCFE6B, 0x4688269C,
+          0x48E51358, 0x46412686, 0x501502F9, 0x461DD5D0,
+          0x47870245, 0x47497A95, 0x4583798A, 0x45717F72,
+          0x466DB9EA, 0x4630D5CD, 0x47B75759, 0x46408729 },
+        { 0x466FB28B, 0x49DCAA83, 0x44BED83C, 0x467F0CB8,
+          0x46C4AD99, 0x48372182, 0x501502F9, 0x44F0AB01,
+          0x48125BB7, 0x477E482E, 0x47D914A0, 0x44A7C2B1,
+          0x451BF2F9, 0x47C4C9BD, 0x46597748, 0x4869EDF6 },
+        { 0x4655E548, 0x463C583D, 0x501502F9, 0x501502F9,
+          0x47B3148B, 0x49506B5D, 0x471195BB, 0x489FCF09,
+          0x478D2268, 0x462D5F90, 0x46CFBA58, 0x501502F9,
+          0x4571BE2E, 0x4748BD6B, 0x478B6188, 0x45061CD0 },
+    },
+    {
+        { 0x00000000, 0x3C7A01F4, 0x41457A9F, 0x4145BAAD,
+          0x4145FABB, 0x41BB4508, 0x41BB65C4, 0x41BB867F,
+          0x44530BEA, 0x44530F3D, 0x4453128F, 0x445315E1,
+          0x44C3CC0F, 0x44C3CF47, 0x44C3D27E, 0x501502F9 },
+        { 0x462957E1, 0x4629606F, 0x462968FE, 0x4C79FE0C,
+          0x501502F9, 0x3CFA02EE, 0x3FC39D2D, 0x4177ED6F,
+          0x42A53196, 0x4334110E, 0x43946978, 0x43DB9C7D,
+          0x441A3010, 0x448F4738, 0x4508F617, 0x45A3258B },
+        { 0x407AFBF7, 0x40FBF8EE, 0x417DF8E1, 0x420108C7,
+          0x428555E4, 0x430EDC11, 0x43A6AB89, 0x447A01F4,
+          0x407A0000, 0x40FB79F4, 0x417DB862, 0x4200F821,
+          0x42854D00, 0x430ED6F7, 0x43A6A810, 0x4479FE0C },
+        { 0x4177ED6F, 0x42A53196, 0x431F3184, 0x4377743E,
+          0x43AF21A0, 0x43EBC506, 0x441A3010, 0x4446709A,
+          0x447D92B5, 0x44A214E7, 0x44D0E2A1, 0x4508F617,
+          0x45393693, 0x4584214A, 0x45D0B311, 0x46522BC0 },
+        { 0x45E771DF, 0x442042AB, 0x4691FC2F, 0x44925A5D,
+          0x44B1AC93, 0x42A5F1F0, 0x449D3C32, 0x43333231,
+          0x46524541, 0x429D3F2D, 0x4782F67B, 0x448EB793,
+          0x449A347C, 0x41DE10BE, 0x3FAE1132, 0x4400E4D5 },
+        { 0x45C83CC4, 0x43EC61A4, 0x460A6D57, 0x44072586,
+          0x45C30517, 0x43C5B71C, 0x47209D9C, 0x43A4AB2D,
+          0x44E37D86, 0x44B1DD46, 0x4318F927, 0x430E855B,
+          0x43EED6BA, 0x43B67FF6, 0x4511624B, 0x43C522E8 },
+        { 0x43F0A473, 0x460E275F, 0x428D98C0, 0x43FEA578,
+          0x443CBCA2, 0x456E9AFF, 0x468FE38E, 0x42A63216,
+          0x454D5930, 0x44D8786C, 0x452571D5, 0x42822E2F,
+          0x42C9442D, 0x4519908D, 0x43DC3A68, 0x458AC329 },
+        { 0x43D8EF48, 0x43C13E1E, 0x4738BE08, 0x462CAD39,
+          0x450EBCF7, 0x45F10CD1, 0x44860A31, 0x45A4C8BE,
+          0x44EBEC5A, 0x43B3428C, 0x444647C5, 0x47D938BC,
+          0x430EA3F4, 0x44B14E37, 0x44E985B2, 0x42B3C6F3 },
+    },
+    {
+        { 0x3A83126F, 0x3A83126F, 0x3A83126F, 0x3A83126F,
+          0x3A83126F, 0x3A83126F, 0x3A83126F, 0x3A83126F,
+          0x3A83126F, 0x00000000, 0x501502F9, 0x501502F9,
+          0x501502F9, 0x501502F9, 0x501502F9, 0x501502F9 },
+        { 0x501502F9, 0x501502F9, 0x501502F9, 0x501502F9,
+          0x501502F9, 0x3A83126F, 0x3A83126F, 0x3A83126F,
+          0x3A83126F, 0x3A83126F, 0x3A83126F, 0x3A83126F,
+          0x3A83126F, 0x501502F9, 0x501502F9, 0x501502F9 },
+        { 0x3A83126F, 0x3A83126F, 0x3A83126F, 0x3A83126F,
+          0x3A83126F, 0x3A83126F, 0x3A83126F, 0x501502F9,
+          0x3A83126F, 0x3A83126F, 0x3A83126F, 0x3A83126F,
+          0x3A83126F, 0x3A83126F, 0x3A83126F, 0x501502F9 },
+        { 0x3A83126F, 0x3A83126F, 0x3A83126F, 0x3A83126F,
+          0x3A83126F, 0x3A83126F, 0x3A83126F, 0x3A83126F,
+          0x501502F9, 0x501502F9, 0x501502F9, 0x501502F9,
+          0x501502F9, 0x501502F9, 0x501502F9, 0x501502F9 },
+        { 0x501502F9, 0x3A83126F, 0x501502F9, 0x501502F9,
+          0x501502F9, 0x3A83126F, 0x501502F9, 0x3A83126F,
+          0x501502F9, 0x3A83126F, 0x501502F9, 0x501502F9,
+          0x501502F9, 0x3A83126F, 0x3A83126F, 0x3A83126F },
+        { 0x501502F9, 0x3A83126F, 0x501502F9, 0x3A83126F,
+          0x501502F9, 0x3A83126F, 0x501502F9, 0x3A83126F,
+          0x501502F9, 0x501502F9, 0x3A83126F, 0x3A83126F,
+          0x3A83126F, 0x3A83126F, 0x501502F9, 0x3A83126F },
+        { 0x3A83126F, 0x501502F9, 0x3A83126F, 0x3A83126F,
+          0x3A83126F, 0x501502F9, 0x501502F9, 0x3A83126F,
+          0x501502F9, 0x501502F9, 0x501502F9, 0x3A83126F,
+          0x3A83126F, 0x501502F9, 0x3A83126F, 0x501502F9 },
+        { 0x3A83126F, 0x3A83126F, 0x501502F9, 0x501502F9,
+          0x501502F9, 0x501502F9, 0x501502F9, 0x501502F9,
+          0x501502F9, 0x3A83126F, 0x3A83126F, 0x501502F9,
+          0x3A83126F, 0x501502F9, 0x501502F9, 0x3A83126F },
+    },
+    {
+        { 0x3A83126F, 0x3A83126F, 0x3A83126F, 0x00000000,
+          0x402344FC, 0x44E2F131, 0x44E345D1, 0x44E39A73,
+          0x488E8F1A, 0x488E9400, 0x488E98E7, 0x488E9DCD,
+          0x4F69A4ED, 0x501502F9, 0x501502F9, 0x501502F9 },
+        { 0x501502F9, 0x501502F9, 0x501502F9, 0x501502F9,
+          0x501502F9, 0x3A83126F, 0x3A83126F, 0x44003483,
+          0x463B8000, 0x46EF9555, 0x475DE000, 0x47BB8000,
+          0x481D8D55, 0x4926FE00, 0x501502F9, 0x501502F9 },
+        { 0x3A83126F, 0x3A83126F, 0x440FAD9C, 0x454D85D4,
+          0x460F7025, 0x46B58EE0, 0x4780E294, 0x48D7D66D,
+          0x3A83126F, 0x3A83126F, 0x440F0877, 0x454D5A49,
+          0x460F63FB, 0x46B58720, 0x4780DF11, 0x48D7CD0F },
+        { 0x44003483, 0x463B8000, 0x46CEA73A, 0x4730812F,
+          0x47899164, 0x47CFA5E5, 0x481D8D55, 0x487A5AE9,
+          0x48E09C00, 0x49934C55, 0x501502F9, 0x501502F9,
+          0x501502F9, 0x501502F9, 0x501502F9, 0x501502F9 },
+        { 0x501502F9, 0x48282F8E, 0x501502F9, 0x493538E3,
+          0x4A16462E, 0x463C8CF6, 0x4979CE93, 0x46EE30AA,
+          0x501502F9, 0x46306BAC, 0x501502F9, 0x492492BA,
+          0x49631AF6, 0x451E9464, 0x3A83126F, 0x47ED18F0 },
+        { 0x501502F9, 0x47D06F2C, 0x501502F9, 0x47FEF2FF,
+          0x501502F9, 0x47A1F8D6, 0x501502F9, 0x477DBB65,
+          0x501502F9, 0x4A1807FC, 0x46C5073A, 0x46B50B36,
+          0x47D39C34, 0x47915421, 0x501502F9, 0x47A152AD },
+        { 0x47D5F59D, 0x501502F9, 0x461AC60F, 0x47E8BEEA,
+          0x48628A94, 0x501502F9, 0x501502F9, 0x463CE6B0,
+          0x501502F9, 0x501502F9, 0x501502F9, 0x460B200F,
+          0x466E8BFC, 0x501502F9, 0x47BC3F79, 0x501502F9 },
+        { 0x47B84605, 0x479CFD95, 0x501502F9, 0x501502F9,
+          0x501502F9, 0x501502F9, 0x4904C27E, 0x501502F9,
+          0x501502F9, 0x478DE499, 0x4879F1BE, 0x501502F9,
+          0x46B539AA, 0x4A12F8F6, 0x501502F9, 0x464FFCB0 },
+    },
+};
+
+/* zmod4xxx_calc_factor() of the IAQ 2nd Gen init_conf and meas_conf */
+static const uint8_t zmod_golden_hsp[ZMOD_GOLDEN_CALIBS][2][HSP_MAX * 2] = {
+    {
+        { 0x01, 0x2C, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+          0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 },
+        { 0x01, 0x2C, 0x01, 0xC2, 0x01, 0xF8, 0x02, 0x2E,
+          0x02, 0x64, 0x02, 0x9A, 0x02, 0xD0, 0x03, 0x05 },
+    },
+    {
+        { 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+          0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 },
+        { 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+          0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 },
+    },
+    {
+        { 0x04, 0x6B, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+          0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 },
+        { 0x04, 0x6B, 0x09, 0xA4, 0x0B, 0x81, 0x0D, 0x5E,
+          0x0F, 0x3C, 0x11, 0x19, 0x12, 0xF6, 0x14, 0xD4 },
+    },
+    {
+        { 0x01, 0x31, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+          0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 },
+        { 0x01, 0x31, 0x01, 0xEA, 0x02, 0x2D, 0x02, 0x6F,
+          0x02, 0xB1, 0x02, 0xF3, 0x03, 0x36, 0x03, 0x78 },
+    },
+};
+
+/**
+ * @brief   zmod4xxx_calc_rmox() as imported, the pace for the CPU budget
+ */
+static inline zmod4xxx_err zmod_golden_ref_rmox(zmod4xxx_dev_t *dev, uint8_t *adc_result,
+                                                float *rmox)
+{
+    uint8_t i;
+    uint16_t adc_value = 0;
+    float *p = rmox;
+    float rmox_local = 0;
+
+    for (i = 0; i < dev->meas_conf->r.len; i = i + 2) {
+        adc_value = (((uint16_t)(adc_result[i])) << 8);
+        adc_value |= (adc_result[i + 1]);
+        if (0.0 > (adc_value - dev->mox_lr)) {
+            *p = 1e-3;
+            p++;
+        } else if (0.0 >= (dev->mox_er - adc_value)) {
+            *p = 10e9;
+            p++;
+        } else {
+            rmox_local = dev->config[0] * 1e3 *
+                         (float)(adc_value - dev->mox_lr) /
+                         (float)(dev->mox_er - adc_value);
+            *p = rmox_local;
+            p++;
+        }
+    }
+    return ZMOD4XXX_OK;
+}
+
+/**
+ * @brief   zmod4xxx_calc_factor() as imported, the pace for the CPU budget
+ */
+static inline zmod4xxx_err zmod_golden_ref_factor(const zmod4xxx_conf *conf, uint8_t *hsp,
+                                                  uint8_t *config)
+{
+    int16_t hsp_temp[HSP_MAX];
+    float hspf;
+    uint8_t i;
+
+    for (i = 0; i < conf->h.len; i = i + 2) {
+        hsp_temp[i / 2] =
+            ((conf->h.data_buf[i] << 8) + conf->h.data_buf[i + 1]);
+        hspf = (-((float)config[2] * 256.0F + config[3]) *
+                ((config[4] + 640.0F) * (config[5] + hsp_temp[i / 2]) -
+                 512000.0F)) /
+               12288000.0F;
+
+        hsp[i] = (uint8_t)((uint16_t)hspf >> 8);
+        hsp[i + 1] = (uint8_t)((uint16_t)hspf & 0x00FF);
+    }
+    return ZMOD4XXX_OK;
+}
+
+#endif /* _ZMOD_GOLDEN_H */
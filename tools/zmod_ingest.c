@@ -0,0 +1,673 @@
+/*
+ * Copyright (c) 2006-2021, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-19     Sherman      first version
+ * 2026-10-19     Sherman      warn when a reactor cannot be pinned
+ */
+
+/*
+ * Host tool: gateway ingest service for raw frames of remote nodes.
+ *
+ * Build on Linux from the package root:
+ *   gcc -O2 -std=c11 -pthread -Isrc -Itools tools/zmod_ingest.c \
+ *       src/zmod4xxx.c src/zmod4410_config_iaq2.c -o zmod_ingest
+ *
+ * Usage:
+ *   zmod_ingest [-u path] [-p port] [-j reactors] [-b batch] [-o]
+ *
+ * A node connects over a Unix socket at path or TCP on 127.0.0.1:port and
+ * sends a raw frame log as a stream (see zmod_rawlog.h): the header with its
+ * calibration, then frames until it closes. -o exits when the last node has
+ * closed, for benchmarks; otherwise the service runs until SIGINT or
+ * SIGTERM. Prints one JSON object on stdout at exit.
+ *
+ * Every reactor is a thread pinned to a core with an epoll set of its own;
+ * where the core is not available, e.g. in a cpuset, it runs unpinned with
+ * a warning on stderr.
+ * All of them wait on the listening sockets with EPOLLEXCLUSIVE, and a
+ * connection stays with the reactor that accepted it, so a node's state is
+ * only ever touched by one thread. Complete frames are copied into the
+ * reactor's batch. The batch is converted with zmod4xxx_calc_rmox() against
+ * the calibration of each node and handed to the backend in one call, when
+ * it is full and once per pass of the event loop. Latency is from the read
+ * that completed a frame to the return of the backend.
+ *
+ * The backend here keeps a hash of every node's resistances, which
+ * zmod_loadgen -v computes as well. Only the MOx resistance stage is run:
+ * the IAQ 2nd Gen algorithm ships as Cortex-M33 binaries only.
+ */
+
+#define _GNU_SOURCE
+
+#include <errno.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <pthread.h>
+#include <sched.h>
+#include <signal.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "zmod4410_config_iaq2.h"
+#include "zmod4xxx.h"
+#include "zmod_rawlog.h"
+
+#define RMOX_MAX        (RSLT_MAX / 2)
+#define REACTORS_MAX    (64)
+#define BATCH_MAX       (1024)
+#define EVENTS_MAX      (256)
+#define READ_MAX        (65536)
+#define LAT_RESERVOIR   (65536)
+#define LISTENERS_MAX   (2)
+#define LOOP_MS         (100) /* to notice a stop request */
+
+enum { TAG_LISTENER, TAG_NODE };
+
+struct listener
+{
+    int tag;
+    int fd;
+};
+
+/* one connection, owned by the reactor that accepted it */
+struct node
+{
+    int tag;
+    int fd;
+    uint8_t has_header;
+    uint8_t frame_len;
+    uint16_t part_len;
+    /* a header or a frame cut by the end of a read */
+    uint8_t part[ZMOD_RAWLOG_FRAME_LEN(RSLT_MAX)];
+    uint32_t sensor_id;
+    uint64_t frames;
+    uint32_t hash; /* backend state */
+    zmod4xxx_dev_t dev;
+    zmod4xxx_conf meas_conf;
+};
+
+struct item
+{
+    struct node *node;
+    uint64_t read_ns;
+    uint32_t ts;
+    uint8_t adc[RSLT_MAX];
+};
+
+/* what the backend gets per frame */
+struct ingest_sample
+{
+    struct node *node;
+    uint32_t sensor_id;
+    uint32_t ts;
+    uint8_t channels;
+    float rmox[RMOX_MAX];
+};
+
+typedef void (*ingest_backend_fn)(struct ingest_sample *s, uint32_t n);
+
+struct reactor
+{
+    pthread_t tid;
+    int index;
+    int ep;
+    uint32_t batch_len;
+    struct item items[BATCH_MAX];
+    struct ingest_sample samples[BATCH_MAX];
+    uint8_t buf[READ_MAX];
+    /* statistics */
+    uint64_t nodes;
+    uint64_t rejected;
+    uint64_t frames;
+    uint64_t bytes;
+    uint64_t batches;
+    uint64_t last_ns;
+    uint32_t hash_sum;
+    uint64_t lat_count;
+    uint64_t lat_sum_ns;
+    uint64_t lat_max_ns;
+    uint32_t lat_len;
+    uint32_t lat_rng;
+    uint32_t lat_ns[LAT_RESERVOIR];
+} __attribute__((aligned(64)));
+
+static struct listener listeners[LISTENERS_MAX];
+static int listener_count;
+static struct reactor *reactors;
+static int reactor_count;
+static uint32_t batch_size = 256;
+static int oneshot;
+static ingest_backend_fn backend;
+
+static atomic_int stop;
+static atomic_int live;
+static atomic_int accepted;
+static _Atomic uint64_t first_ns;
+
+static uint64_t now_ns(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+static uint32_t fnv1a(uint32_t h, const void *buf, size_t len)
+{
+    const uint8_t *p = buf;
+
+    while (len--)
+    {
+        h = (h ^ *p++) * 16777619u;
+    }
+    return h;
+}
+
+/* the backend: a hash per node, order within a node included */
+static void backend_hash(struct ingest_sample *s, uint32_t n)
+{
+    uint32_t i;
+
+    for (i = 0; i < n; i++)
+    {
+        s[i].node->hash = fnv1a(s[i].node->hash, s[i].rmox,
+                                s[i].channels * sizeof(float));
+    }
+}
+
+static void lat_add(struct reactor *r, uint64_t ns)
+{
+    uint32_t k;
+
+    r->lat_count++;
+    r->lat_sum_ns += ns;
+    r->lat_max_ns = ns > r->lat_max_ns ? ns : r->lat_max_ns;
+    if (ns > UINT32_MAX)
+    {
+        ns = UINT32_MAX;
+    }
+    /* reservoir sampling, every latency is kept with the same chance */
+    if (r->lat_len < LAT_RESERVOIR)
+    {
+        r->lat_ns[r->lat_len++] = (uint32_t)ns;
+        return;
+    }
+    r->lat_rng ^= r->lat_rng << 13;
+    r->lat_rng ^= r->lat_rng >> 17;
+    r->lat_rng ^= r->lat_rng << 5;
+    k = (uint32_t)(r->lat_rng % r->lat_count);
+    if (k < LAT_RESERVOIR)
+    {
+        r->lat_ns[k] = (uint32_t)ns;
+    }
+}
+
+static void reactor_flush(struct reactor *r)
+{
+    struct ingest_sample *s;
+    struct item *it;
+    uint64_t t;
+    uint32_t i;
+
+    if (r->batch_len == 0)
+    {
+        return;
+    }
+    for (i = 0; i < r->batch_len; i++)
+    {
+        it = &r->items[i];
+        s = &r->samples[i];
+        zmod4xxx_calc_rmox(&it->node->dev, it->adc, s->rmox);
+        s->node = it->node;
+        s->sensor_id = it->node->sensor_id;
+        s->ts = it->ts;
+        s->channels = it->node->frame_len / 2;
+    }
+    backend(r->samples, r->batch_len);
+
+    t = now_ns();
+    for (i = 0; i < r->batch_len; i++)
+    {
+        lat_add(r, t - r->items[i].read_ns);
+    }
+    r->frames += r->batch_len;
+    r->batches++;
+    r->batch_len = 0;
+}
+
+static void frame_add(struct reactor *r, struct node *n, const uint8_t *f, uint64_t read_ns)
+{
+    struct item *it = &r->items[r->batch_len];
+
+    it->node = n;
+    it->read_ns = read_ns;
+    it->ts = zmod_rawlog_get32(f);
+    memcpy(it->adc, f + 4, n->frame_len);
+    n->frames++;
+    if (++r->batch_len == batch_size)
+    {
+        reactor_flush(r);
+    }
+}
+
+static void node_close(struct reactor *r, struct node *n)
+{
+    /* the batch points at the node */
+    reactor_flush(r);
+    epoll_ctl(r->ep, EPOLL_CTL_DEL, n->fd, NULL);
+    close(n->fd);
+    if (n->frames)
+    {
+        r->hash_sum += n->hash;
+    }
+    r->last_ns = now_ns();
+    free(n);
+    atomic_fetch_sub(&live, 1);
+}
+
+/* 0 to keep the connection, -1 if its header is not acceptable */
+static int node_header(struct reactor *r, struct node *n)
+{
+    zmod_rawlog_header_t hdr;
+
+    if (zmod_rawlog_parse_header(n->part, &hdr) ||
+        hdr.frame_len > zmod_sensor_type[MEASUREMENT].r.len || hdr.frame_len & 1)
+    {
+        r->rejected++;
+        return -1;
+    }
+    n->meas_conf = zmod_sensor_type[MEASUREMENT];
+    n->meas_conf.r.len = hdr.frame_len;
+    n->dev.meas_conf = &n->meas_conf;
+    zmod_rawlog_to_dev(&hdr, &n->dev);
+    n->frame_len = hdr.frame_len;
+    n->sensor_id = hdr.sensor_id;
+    n->hash = 2166136261u;
+    n->has_header = 1;
+    return 0;
+}
+
+static void node_read(struct reactor *r, struct node *n)
+{
+    const uint8_t *p = r->buf;
+    ssize_t got;
+    uint64_t t;
+    size_t left, need, take;
+
+    got = read(n->fd, r->buf, sizeof(r->buf));
+    if (got <= 0)
+    {
+        if (got < 0 && (errno == EAGAIN || errno == EINTR))
+        {
+            return;
+        }
+        node_close(r, n);
+        return;
+    }
+    t = now_ns();
+    r->bytes += (uint64_t)got;
+    left = (size_t)got;
+
+    while (left)
+    {
+        need = n->has_header ? ZMOD_RAWLOG_FRAME_LEN(n->frame_len) : ZMOD_RAWLOG_HEADER_LEN;
+        /* whole frames straight from the read buffer */
+        if (n->part_len == 0 && n->has_header && left >= need)
+        {
+            frame_add(r, n, p, t);
+            p += need;
+            left -= need;
+            continue;
+        }
+        take = need - n->part_len < left ? need - n->part_len : left;
+        memcpy(&n->part[n->part_len], p, take);
+        n->part_len = (uint16_t)(n->part_len + take);
+        p += take;
+        left -= take;
+        if (n->part_len < need)
+        {
+            break;
+        }
+        n->part_len = 0;
+        if (!n->has_header)
+        {
+            if (node_header(r, n))
+            {
+                node_close(r, n);
+                return;
+            }
+        }
+        else
+        {
+            frame_add(r, n, n->part, t);
+        }
+    }
+}
+
+static void node_accept(struct reactor *r, struct listener *l)
+{
+    struct epoll_event ev;
+    struct node *n;
+    uint64_t zero = 0;
+    int fd;
+
+    while ((fd = accept4(l->fd, NULL, NULL, SOCK_NONBLOCK | SOCK_CLOEXEC)) >= 0)
+    {
+        n = calloc(1, sizeof(*n));
+        if (n == NULL)
+        {
+            close(fd);
+            r->rejected++;
+            continue;
+        }
+        n->tag = TAG_NODE;
+        n->fd = fd;
+        ev.events = EPOLLIN | EPOLLRDHUP;
+        ev.data.ptr = n;
+        if (epoll_ctl(r->ep, EPOLL_CTL_ADD, fd, &ev))
+        {
+            close(fd);
+            free(n);
+            r->rejected++;
+            continue;
+        }
+        atomic_compare_exchange_strong(&first_ns, &zero, now_ns());
+        atomic_fetch_add(&live, 1);
+        atomic_fetch_add(&accepted, 1);
+        r->nodes++;
+    }
+}
+
+static void *reactor_entry(void *param)
+{
+    struct reactor *r = param;
+    struct epoll_event events[EVENTS_MAX];
+    int i, n, tag;
+
+    while (!atomic_load(&stop))
+    {
+        n = epoll_wait(r->ep, events, EVENTS_MAX, LOOP_MS);
+        for (i = 0; i < n; i++)
+        {
+            tag = *(int *)events[i].data.ptr;
+            if (tag == TAG_LISTENER)
+            {
+                node_accept(r, events[i].data.ptr);
+            }
+            else
+            {
+                node_read(r, events[i].data.ptr);
+            }
+        }
+        reactor_flush(r);
+        if (oneshot && atomic_load(&accepted) && atomic_load(&live) == 0)
+        {
+            atomic_store(&stop, 1);
+        }
+    }
+    return NULL;
+}
+
+static int listen_unix(const char *path)
+{
+    struct sockaddr_un sa;
+    int fd;
+
+    if (strlen(path) >= sizeof(sa.sun_path))
+    {
+        return -1;
+    }
+    memset(&sa, 0, sizeof(sa));
+    sa.sun_family = AF_UNIX;
+    strcpy(sa.sun_path, path);
+    unlink(path);
+    fd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (fd < 0 || bind(fd, (struct sockaddr *)&sa, sizeof(sa)) || listen(fd, SOMAXCONN))
+    {
+        if (fd >= 0)
+        {
+            close(fd);
+        }
+        return -1;
+    }
+    return fd;
+}
+
+static int listen_tcp(uint16_t port)
+{
+    struct sockaddr_in sa;
+    int fd, one = 1;
+
+    memset(&sa, 0, sizeof(sa));
+    sa.sin_family = AF_INET;
+    sa.sin_port = htons(port);
+    sa.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    fd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (fd < 0 || setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one)) ||
+        bind(fd, (struct sockaddr *)&sa, sizeof(sa)) || listen(fd, SOMAXCONN))
+    {
+        if (fd >= 0)
+        {
+            close(fd);
+        }
+        return -1;
+    }
+    return fd;
+}
+
+static int reactor_start(struct reactor *r, int index)
+{
+    struct epoll_event ev;
+    cpu_set_t cpus;
+    long cores = sysconf(_SC_NPROCESSORS_ONLN);
+    long cpu = index % (cores > 0 ? cores : 1);
+    int i, err;
+
+    r->index = index;
+    r->lat_rng = 0x2545F491u + (uint32_t)index;
+    r->ep = epoll_create1(EPOLL_CLOEXEC);
+    if (r->ep < 0)
+    {
+        return -1;
+    }
+    for (i = 0; i < listener_count; i++)
+    {
+        /* one reactor is woken per connection, not all of them */
+        ev.events = EPOLLIN | EPOLLEXCLUSIVE;
+        ev.data.ptr = &listeners[i];
+        if (epoll_ctl(r->ep, EPOLL_CTL_ADD, listeners[i].fd, &ev))
+        {
+            return -1;
+        }
+    }
+    err = pthread_create(&r->tid, NULL, reactor_entry, r);
+    if (err)
+    {
+        errno = err;
+        return -1;
+    }
+    CPU_ZERO(&cpus);
+    CPU_SET(cpu, &cpus);
+    err = pthread_setaffinity_np(r->tid, sizeof(cpus), &cpus);
+    if (err)
+    {
+        /* e.g. a cpuset without that core: the reactor runs, unpinned */
+        fprintf(stderr, "reactor %d: not pinned to CPU %ld: %s\n", index, cpu, strerror(err));
+    }
+    return 0;
+}
+
+static void on_signal(int sig)
+{
+    (void)sig;
+    atomic_store(&stop, 1);
+}
+
+static int lat_cmp(const void *a, const void *b)
+{
+    uint32_t x = *(const uint32_t *)a, y = *(const uint32_t *)b;
+
+    return x < y ? -1 : x > y;
+}
+
+static void report(void)
+{
+    uint64_t nodes = 0, rejected = 0, frames = 0, bytes = 0, batches = 0;
+    uint64_t lat_count = 0, lat_sum = 0, lat_max = 0, last = 0;
+    uint32_t *lat, lat_len = 0, hash = 0;
+    double seconds;
+    int i;
+
+    lat = malloc((size_t)reactor_count * LAT_RESERVOIR * sizeof(uint32_t));
+    for (i = 0; i < reactor_count; i++)
+    {
+        struct reactor *r = &reactors[i];
+
+        nodes += r->nodes;
+        rejected += r->rejected;
+        frames += r->frames;
+        bytes += r->bytes;
+        batches += r->batches;
+        hash += r->hash_sum;
+        lat_count += r->lat_count;
+        lat_sum += r->lat_sum_ns;
+        lat_max = r->lat_max_ns > lat_max ? r->lat_max_ns : lat_max;
+        last = r->last_ns > last ? r->last_ns : last;
+        if (lat != NULL)
+        {
+            memcpy(&lat[lat_len], r->lat_ns, r->lat_len * sizeof(uint32_t));
+            lat_len += r->lat_len;
+        }
+    }
+    if (lat != NULL)
+    {
+        qsort(lat, lat_len, sizeof(uint32_t), lat_cmp);
+    }
+#define LAT_US(q) (lat != NULL && lat_len ? lat[(uint32_t)((lat_len - 1) * (q))] / 1000.0 : 0.0)
+    seconds = last > first_ns ? (last - first_ns) / 1e9 : 0;
+
+    printf("{\"tool\":\"ingest\",\"reactors\":%d,\"batch\":%u,\"nodes\":%llu,"
+           "\"rejected\":%llu,\"frames\":%llu,\"bytes\":%llu,\"frames_per_batch\":%.1f,"
+           "\"seconds\":%.3f,\"frames_per_s\":%.0f,\"lat_mean_us\":%.1f,"
+           "\"lat_p50_us\":%.1f,\"lat_p99_us\":%.1f,\"lat_p999_us\":%.1f,"
+           "\"lat_max_us\":%.1f,\"rmox_hash\":\"0x%08x\",\"nodes_per_reactor\":[",
+           reactor_count, batch_size, (unsigned long long)nodes,
+           (unsigned long long)rejected, (unsigned long long)frames,
+           (unsigned long long)bytes, batches ? (double)frames / batches : 0.0,
+           seconds, seconds > 0 ? frames / seconds : 0.0,
+           lat_count ? lat_sum / 1000.0 / lat_count : 0.0,
+           LAT_US(0.5), LAT_US(0.99), LAT_US(0.999), lat_max / 1000.0, hash);
+#undef LAT_US
+    for (i = 0; i < reactor_count; i++)
+    {
+        printf("%s%llu", i ? "," : "", (unsigned long long)reactors[i].nodes);
+    }
+    printf("]}\n");
+    free(lat);
+}
+
+int main(int argc, char **argv)
+{
+    const char *path = NULL;
+    long port = -1;
+    int opt, i;
+
+    reactor_count = (int)sysconf(_SC_NPROCESSORS_ONLN);
+    while ((opt = getopt(argc, argv, "u:p:j:b:o")) != -1)
+    {
+        switch (opt)
+        {
+        case 'u':
+            path = optarg;
+            break;
+        case 'p':
+            port = strtol(optarg, NULL, 0);
+            break;
+        case 'j':
+            reactor_count = atoi(optarg);
+            break;
+        case 'b':
+            batch_size = (uint32_t)strtoul(optarg, NULL, 0);
+            break;
+        case 'o':
+            oneshot = 1;
+            break;
+        default:
+            fprintf(stderr, "usage: %s [-u path] [-p port] [-j reactors] [-b batch] [-o]\n",
+                    argv[0]);
+            return 1;
+        }
+    }
+    if (path == NULL && port < 0)
+    {
+        path = "/tmp/zmod_ingest.sock";
+    }
+    if (reactor_count < 1 || reactor_count > REACTORS_MAX || batch_size < 1 ||
+        batch_size > BATCH_MAX || port > 65535)
+    {
+        fprintf(stderr, "reactors 1..%d, batch 1..%d, port 0..65535\n",
+                REACTORS_MAX, BATCH_MAX);
+        return 1;
+    }
+    if (path != NULL)
+    {
+        listeners[listener_count].tag = TAG_LISTENER;
+        listeners[listener_count].fd = listen_unix(path);
+        if (listeners[listener_count++].fd < 0)
+        {
+            fprintf(stderr, "cannot listen on %s: %s\n", path, strerror(errno));
+            return 1;
+        }
+    }
+    if (port >= 0)
+    {
+        listeners[listener_count].tag = TAG_LISTENER;
+        listeners[listener_count].fd = listen_tcp((uint16_t)port);
+        if (listeners[listener_count++].fd < 0)
+        {
+            fprintf(stderr, "cannot listen on port %ld: %s\n", port, strerror(errno));
+            return 1;
+        }
+    }
+
+    signal(SIGINT, on_signal);
+    signal(SIGTERM, on_signal);
+    signal(SIGPIPE, SIG_IGN);
+    backend = backend_hash;
+    reactors = aligned_alloc(64, reactor_count * sizeof(*reactors));
+    if (reactors == NULL)
+    {
+        fprintf(stderr, "out of memory\n");
+        return 1;
+    }
+    memset(reactors, 0, reactor_count * sizeof(*reactors));
+    for (i = 0; i < reactor_count; i++)
+    {
+        if (reactor_start(&reactors[i], i))
+        {
+            fprintf(stderr, "reactor %d: %s\n", i, strerror(errno));
+            return 1;
+        }
+    }
+    for (i = 0; i < reactor_count; i++)
+    {
+        pthread_join(reactors[i].tid, NULL);
+    }
+    report();
+    if (path != NULL)
+    {
+        unlink(path);
+    }
+    return 0;
+}
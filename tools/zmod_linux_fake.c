@@ -0,0 +1,409 @@
+/*
+ * Copyright (c) 2006-2021, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-19     Sherman      first version
+ * 2026-10-19     Sherman      link the shared status wait of zmod_cycle_run()
+ */
+
+/*
+ * Host tool: the Linux HAL against an in-process fake of /dev/i2c-N.
+ *
+ * Build on Linux from the package root:
+ *   gcc -O2 -std=c99 -DZMOD4XXX_USING_HAL_LINUX -DZMOD4XXX_SIM_MODEL_ONLY \
+ *       -Isrc -Ihal -Itools tools/zmod_linux_fake.c src/zmod4xxx.c \
+ *       src/zmod4xxx_recover.c src/zmod4xxx_wait.c src/zmod4410_config_iaq2.c \
+ *       hal/hal_sim.c hal/hal_linux.c -o zmod_linux_fake -lm
+ *
+ * Usage:
+ *   zmod_linux_fake [-s samples]
+ *
+ * The fake decodes the I2C_RDWR messages into a simulated ZMOD4410 and runs
+ * a virtual clock that every ioctl advances by its bus time plus
+ * FAKE_IOCTL_NS. Prints one JSON object per line on stdout:
+ *   linux_hal     startup and cycle system calls, unbatched and batched
+ *   linux_period  cycle start times with hal_linux_period()
+ * The samples have to match a run on the simulation HAL, a batched write to
+ * a missing address has to fail at hal_linux_batch_end(), and the periodic
+ * cycles have to start exactly on their timeline; anything else fails the
+ * run.
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <linux/i2c.h>
+#include <linux/i2c-dev.h>
+
+#include "zmod4410_config_iaq2.h"
+#include "zmod4xxx.h"
+#include "zmod4xxx_hal.h"
+#include "hal_sim.h"
+#include "zmod_cycle.h"
+
+#define FAKE_FD         (3)
+#define FAKE_IOCTL_NS   (50000) /* system call and adapter wake-up */
+#define PERIOD_MS       (3000)
+
+typedef struct {
+    zmod4xxx_sim_t sim;
+    uint64_t now_ns;
+    uint64_t bus_ns; /* of the sim at the last ioctl */
+} fake_bus_t;
+
+static fake_bus_t fake;
+
+static int fake_open(void *ctx, const char *path)
+{
+    (void)ctx;
+    (void)path;
+    return FAKE_FD;
+}
+
+static int fake_close(void *ctx, int fd)
+{
+    (void)ctx;
+    return fd == FAKE_FD ? 0 : -1;
+}
+
+static int fake_rdwr(fake_bus_t *f, struct i2c_rdwr_ioctl_data *d)
+{
+    struct i2c_msg *m;
+    uint32_t i;
+    int8_t ret;
+
+    if (d->nmsgs == 0 || d->nmsgs > I2C_RDWR_IOCTL_MAX_MSGS)
+    {
+        errno = EINVAL;
+        return -1;
+    }
+    for (i = 0; i < d->nmsgs; i++)
+    {
+        m = &d->msgs[i];
+        if (m->addr != f->sim.i2c_addr)
+        {
+            errno = ENXIO;
+            return -1;
+        }
+        if (m->flags & I2C_M_RD)
+        {
+            /* the register comes from the write just before it */
+            if (i == 0 || (d->msgs[i - 1].flags & I2C_M_RD) || d->msgs[i - 1].len != 1)
+            {
+                errno = EINVAL;
+                return -1;
+            }
+            ret = zmod4xxx_sim_read(&f->sim, d->msgs[i - 1].buf[0], m->buf, (uint8_t)m->len);
+        }
+        else if (m->len == 0)
+        {
+            errno = EINVAL;
+            return -1;
+        }
+        else if (i + 1 < d->nmsgs && (d->msgs[i + 1].flags & I2C_M_RD) && m->len == 1)
+        {
+            continue;
+        }
+        else
+        {
+            ret = zmod4xxx_sim_write(&f->sim, m->buf[0], m->buf + 1, (uint8_t)(m->len - 1));
+        }
+        if (ret)
+        {
+            errno = EREMOTEIO;
+            return -1;
+        }
+    }
+    return (int)d->nmsgs;
+}
+
+static int fake_ioctl(void *ctx, int fd, unsigned long req, void *arg)
+{
+    fake_bus_t *f = (fake_bus_t *)ctx;
+    int ret;
+
+    if (fd != FAKE_FD)
+    {
+        errno = EBADF;
+        return -1;
+    }
+    if (req == I2C_FUNCS)
+    {
+        *(unsigned long *)arg = I2C_FUNC_I2C;
+        return 0;
+    }
+    if (req != I2C_RDWR)
+    {
+        errno = ENOTTY;
+        return -1;
+    }
+    ret = fake_rdwr(f, (struct i2c_rdwr_ioctl_data *)arg);
+    f->now_ns += FAKE_IOCTL_NS + (f->sim.stats.bus_ns - f->bus_ns);
+    f->bus_ns = f->sim.stats.bus_ns;
+    zmod4xxx_sim_set_time_us(&f->sim, f->now_ns / 1000);
+    return ret;
+}
+
+static uint64_t fake_now_ns(void *ctx)
+{
+    return ((fake_bus_t *)ctx)->now_ns;
+}
+
+static void fake_sleep_until_ns(void *ctx, uint64_t t)
+{
+    fake_bus_t *f = (fake_bus_t *)ctx;
+
+    if (t > f->now_ns)
+    {
+        f->now_ns = t;
+        zmod4xxx_sim_set_time_us(&f->sim, t / 1000);
+    }
+}
+
+static const hal_linux_io_t fake_io =
+{
+    fake_open,
+    fake_close,
+    fake_ioctl,
+    fake_now_ns,
+    fake_sleep_until_ns,
+    &fake,
+};
+
+static uint32_t fnv1a(uint32_t h, const void *buf, size_t len)
+{
+    const uint8_t *p = (const uint8_t *)buf;
+
+    while (len--)
+    {
+        h = (h ^ *p++) * 16777619u;
+    }
+    return h;
+}
+
+static void dev_setup(zmod4xxx_dev_t *dev, uint8_t *prod_data)
+{
+    dev->i2c_addr = ZMOD4410_I2C_ADDR;
+    dev->pid = ZMOD4410_PID;
+    dev->init_conf = &zmod_sensor_type[INIT];
+    dev->meas_conf = &zmod_sensor_type[MEASUREMENT];
+    dev->prod_data = prod_data;
+}
+
+static int startup(zmod4xxx_dev_t *dev)
+{
+    return zmod4xxx_read_sensor_info(dev) || zmod4xxx_prepare_sensor(dev) ? -1 : 0;
+}
+
+/* the same run straight on the simulation HAL, without a bus */
+static int reference(uint32_t samples, uint32_t *hash)
+{
+    zmod4xxx_sim_t sim;
+    zmod4xxx_dev_t dev;
+    uint8_t prod_data[ZMOD4410_PROD_DATA_LEN];
+    uint8_t adc[RSLT_MAX];
+    float rmox[RSLT_MAX / 2];
+    uint32_t i;
+    int ret = 0;
+
+    memset(&dev, 0, sizeof(dev));
+    zmod4xxx_sim_init(&sim, ZMOD4410_I2C_ADDR, 1);
+    zmod4xxx_sim_attach(&sim, &dev);
+    dev_setup(&dev, prod_data);
+    *hash = 2166136261u;
+    ret = startup(&dev);
+    for (i = 0; i < samples && ret == 0; i++)
+    {
+        ret = zmod_cycle_run(&dev, NULL, NULL, adc, rmox) ? -1 : 0;
+        *hash = fnv1a(*hash, adc, sizeof(adc));
+        *hash = fnv1a(*hash, rmox, sizeof(rmox));
+        dev.delay_ms(1990);
+    }
+    zmod4xxx_sim_detach(&sim);
+    return ret;
+}
+
+static void fake_reset(void)
+{
+    memset(&fake, 0, sizeof(fake));
+    zmod4xxx_sim_init(&fake.sim, ZMOD4410_I2C_ADDR, 1);
+}
+
+static int bench_hal(uint32_t samples, int batch, uint32_t ref_hash)
+{
+    zmod4xxx_dev_t dev;
+    uint8_t prod_data[ZMOD4410_PROD_DATA_LEN];
+    uint8_t adc[RSLT_MAX];
+    float rmox[RSLT_MAX / 2];
+    hal_linux_stats_t st0, st;
+    uint64_t t0;
+    uint32_t i, hash = 2166136261u;
+    int ret;
+
+    fake_reset();
+    memset(&dev, 0, sizeof(dev));
+    if (hal_linux_open("/dev/i2c-fake", &fake_io) || init_hardware(&dev))
+    {
+        fprintf(stderr, "fake bus not opened\n");
+        return -1;
+    }
+    dev_setup(&dev, prod_data);
+
+    if (batch)
+    {
+        hal_linux_batch_begin();
+    }
+    ret = startup(&dev);
+    st0 = *hal_linux_stats();
+    t0 = fake.now_ns;
+    for (i = 0; i < samples && ret == 0; i++)
+    {
+        ret = zmod_cycle_run(&dev, NULL, NULL, adc, rmox) ? -1 : 0;
+        hash = fnv1a(hash, adc, sizeof(adc));
+        hash = fnv1a(hash, rmox, sizeof(rmox));
+        dev.delay_ms(1990);
+    }
+    if (batch && hal_linux_batch_end())
+    {
+        ret = -1;
+    }
+    st = *hal_linux_stats();
+    deinit_hardware();
+    if (ret)
+    {
+        fprintf(stderr, "run failed after %u samples\n", i);
+        return -1;
+    }
+    if (hash != ref_hash)
+    {
+        fprintf(stderr, "samples differ from the simulation HAL\n");
+        return -1;
+    }
+
+    printf("{\"bench\":\"linux_hal\",\"batch\":%d,\"samples\":%u,"
+           "\"startup_transfers\":%u,\"startup_ioctls\":%u,"
+           "\"transfers_per_sample\":%.2f,\"ioctls_per_sample\":%.2f,"
+           "\"msgs_per_sample\":%.2f,\"bytes_per_sample\":%.1f,\"cycle_us\":%.1f}\n",
+           batch, samples, st0.transfers, st0.ioctls,
+           (double)(st.transfers - st0.transfers) / samples,
+           (double)(st.ioctls - st0.ioctls) / samples,
+           (double)(st.msgs - st0.msgs) / samples,
+           (double)(st.bytes - st0.bytes) / samples,
+           (double)(fake.now_ns - t0) / 1000.0 / samples);
+    return 0;
+}
+
+/* a queued write to nobody has to fail where the batch ends */
+static int check_deferred(void)
+{
+    zmod4xxx_dev_t dev;
+    uint8_t cmd = 0;
+    int8_t queued, ended;
+
+    fake_reset();
+    memset(&dev, 0, sizeof(dev));
+    if (hal_linux_open("/dev/i2c-fake", &fake_io) || init_hardware(&dev))
+    {
+        return -1;
+    }
+    hal_linux_batch_begin();
+    queued = dev.write(ZMOD4410_I2C_ADDR ^ 1, 0x93, &cmd, 1);
+    ended = hal_linux_batch_end();
+    deinit_hardware();
+    if (queued != ZMOD4XXX_OK || ended != ERROR_I2C || hal_linux_stats()->errors != 1)
+    {
+        fprintf(stderr, "batched write error not reported: %d %d\n", queued, ended);
+        return -1;
+    }
+    return 0;
+}
+
+static int bench_period(uint32_t samples)
+{
+    zmod4xxx_dev_t dev;
+    uint8_t prod_data[ZMOD4410_PROD_DATA_LEN];
+    uint8_t adc[RSLT_MAX];
+    float rmox[RSLT_MAX / 2];
+    uint64_t t0 = 0, off, err_max = 0;
+    uint32_t i;
+
+    fake_reset();
+    memset(&dev, 0, sizeof(dev));
+    if (hal_linux_open("/dev/i2c-fake", &fake_io) || init_hardware(&dev))
+    {
+        return -1;
+    }
+    dev_setup(&dev, prod_data);
+    if (startup(&dev))
+    {
+        return -1;
+    }
+    for (i = 0; i < samples; i++)
+    {
+        if (i == 0)
+        {
+            hal_linux_period(PERIOD_MS);
+            t0 = fake.now_ns;
+        }
+        off = fake.now_ns - t0 - (uint64_t)i * PERIOD_MS * 1000000ULL;
+        err_max = off > err_max ? off : err_max;
+        if (zmod_cycle_run(&dev, NULL, NULL, adc, rmox))
+        {
+            return -1;
+        }
+        hal_linux_period(PERIOD_MS);
+    }
+    deinit_hardware();
+    if (err_max || hal_linux_stats()->overruns)
+    {
+        fprintf(stderr, "periodic cycles left their timeline by %llu ns\n",
+                (unsigned long long)err_max);
+        return -1;
+    }
+    printf("{\"bench\":\"linux_period\",\"samples\":%u,\"period_ms\":%u,"
+           "\"start_err_ns\":%llu,\"overruns\":%u}\n",
+           samples, PERIOD_MS, (unsigned long long)err_max, hal_linux_stats()->overruns);
+    return 0;
+}
+
+int main(int argc, char **argv)
+{
+    int opt;
+    uint32_t samples = 1000, ref_hash;
+
+    while ((opt = getopt(argc, argv, "s:")) != -1)
+    {
+        switch (opt)
+        {
+        case 's':
+            samples = (uint32_t)strtoul(optarg, NULL, 0);
+            break;
+        default:
+            fprintf(stderr, "usage: %s [-s samples]\n", argv[0]);
+            return 1;
+        }
+    }
+    if (samples == 0)
+    {
+        fprintf(stderr, "samples must be > 0\n");
+        return 1;
+    }
+    if (reference(samples, &ref_hash))
+    {
+        fprintf(stderr, "simulation HAL run failed\n");
+        return 1;
+    }
+    if (bench_hal(samples, 0, ref_hash) || bench_hal(samples, 1, ref_hash) ||
+        check_deferred() || bench_period(samples))
+    {
+        return 1;
+    }
+    return 0;
+}
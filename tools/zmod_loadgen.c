@@ -0,0 +1,494 @@
+/*
+ * Copyright (c) 2006-2021, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-19     Sherman      first version
+ */
+
+/*
+ * Host tool: load generator for zmod_ingest, many simulated nodes that send
+ * raw frames.
+ *
+ * Build on Linux from the package root:
+ *   gcc -O2 -std=c11 -pthread -Isrc -Itools tools/zmod_loadgen.c \
+ *       src/zmod4xxx.c src/zmod4410_config_iaq2.c -o zmod_loadgen
+ *
+ * Usage:
+ *   zmod_loadgen [-u path | -p port] [-n nodes] [-f frames] [-r hz] [-j threads] [-v]
+ *
+ * Every node connects, sends a raw frame log header with a calibration of
+ * its own and then frames frames of IAQ 2nd Gen ADC results, and closes.
+ * With -r the frames of a node are paced at hz per node, the nodes spread
+ * evenly over the period; without it they go as fast as the sockets take
+ * them. The nodes are split between threads with an epoll set each.
+ *
+ * Prints one JSON object on stdout. With -v it includes the rmox_hash that
+ * zmod_ingest has to report for the same run: every frame converted with
+ * zmod4xxx_calc_rmox(), hashed per node and summed over the nodes.
+ */
+
+#define _GNU_SOURCE
+
+#include <errno.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <pthread.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/epoll.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "zmod4410_config_iaq2.h"
+#include "zmod4xxx.h"
+#include "zmod_rawlog.h"
+
+#define RMOX_MAX        (RSLT_MAX / 2)
+#define FRAME_SIZE      ZMOD_RAWLOG_FRAME_LEN(RSLT_MAX)
+#define OUT_FRAMES      (16) /* frames written at once in a burst */
+#define THREADS_MAX     (64)
+#define EVENTS_MAX      (256)
+#define NODE_PERIOD_MS  (3000) /* timestamp step of a frame */
+
+struct lnode
+{
+    int fd;
+    uint32_t id;
+    uint32_t sent; /* frames built */
+    uint32_t rng;
+    uint64_t due_ns; /* paced: when the next frame is due */
+    uint16_t out_len;
+    uint16_t out_pos;
+    uint8_t writing; /* EPOLLOUT is armed */
+    uint8_t done;
+    uint8_t out[OUT_FRAMES * FRAME_SIZE];
+    uint16_t level[RMOX_MAX];
+    uint32_t hash;
+    zmod4xxx_dev_t dev;
+};
+
+struct lthread
+{
+    pthread_t tid;
+    int ep;
+    struct lnode *nodes;
+    uint32_t count;
+    uint32_t open;
+    uint32_t next; /* paced: node whose frame is due first */
+    uint64_t frames;
+    uint64_t bytes;
+    uint64_t late_max_ns; /* paced: worst start of a frame after its due time */
+    uint32_t hash_sum;
+    int err;
+};
+
+static const char *sock_path;
+static long sock_port = -1;
+static uint32_t frames_per_node = 100;
+static double rate_hz;
+static int verify;
+static uint64_t start_ns;
+
+static uint64_t now_ns(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+static uint32_t fnv1a(uint32_t h, const void *buf, size_t len)
+{
+    const uint8_t *p = buf;
+
+    while (len--)
+    {
+        h = (h ^ *p++) * 16777619u;
+    }
+    return h;
+}
+
+static uint32_t node_rand(struct lnode *n)
+{
+    n->rng ^= n->rng << 13;
+    n->rng ^= n->rng >> 17;
+    n->rng ^= n->rng << 5;
+    return n->rng;
+}
+
+static int node_connect(void)
+{
+    struct sockaddr_un su;
+    struct sockaddr_in si;
+    int fd;
+
+    if (sock_path != NULL)
+    {
+        memset(&su, 0, sizeof(su));
+        su.sun_family = AF_UNIX;
+        strncpy(su.sun_path, sock_path, sizeof(su.sun_path) - 1);
+        fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        if (fd >= 0 && connect(fd, (struct sockaddr *)&su, sizeof(su)) == 0 &&
+            fcntl(fd, F_SETFL, O_NONBLOCK) == 0)
+        {
+            return fd;
+        }
+    }
+    else
+    {
+        memset(&si, 0, sizeof(si));
+        si.sin_family = AF_INET;
+        si.sin_port = htons((uint16_t)sock_port);
+        si.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        fd = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        if (fd >= 0 && connect(fd, (struct sockaddr *)&si, sizeof(si)) == 0 &&
+            fcntl(fd, F_SETFL, O_NONBLOCK) == 0)
+        {
+            return fd;
+        }
+    }
+    if (fd >= 0)
+    {
+        close(fd);
+    }
+    return -1;
+}
+
+/* a calibration and resistance levels of its own, the header in out */
+static void node_init(struct lnode *n, uint32_t id)
+{
+    zmod_rawlog_header_t hdr;
+    uint8_t i;
+
+    memset(&hdr, 0, sizeof(hdr));
+    n->id = id;
+    n->rng = 0x9E3779B9u ^ (id * 2654435761u);
+    node_rand(n);
+    hdr.frame_len = RSLT_MAX;
+    hdr.pid = ZMOD4410_PID;
+    for (i = 0; i < ZMOD4XXX_LEN_CONF; i++)
+    {
+        hdr.config[i] = (uint8_t)node_rand(n);
+    }
+    hdr.config[0] |= 1;
+    hdr.mox_lr = (uint16_t)(1000 + node_rand(n) % 2000);
+    hdr.mox_er = (uint16_t)(55000 + node_rand(n) % 10000);
+    hdr.sensor_id = id;
+    for (i = 0; i < RMOX_MAX; i++)
+    {
+        n->level[i] = (uint16_t)(hdr.mox_lr + 200 + node_rand(n) % (hdr.mox_er - hdr.mox_lr - 400));
+    }
+    zmod_rawlog_build_header(&hdr, n->out);
+    n->out_len = ZMOD_RAWLOG_HEADER_LEN;
+    n->dev.meas_conf = &zmod_sensor_type[MEASUREMENT];
+    zmod_rawlog_to_dev(&hdr, &n->dev);
+    n->hash = 2166136261u;
+}
+
+/* append one frame to out */
+static void node_frame(struct lnode *n, uint32_t ts)
+{
+    uint8_t *f = &n->out[n->out_len];
+    float rmox[RMOX_MAX];
+    uint16_t v;
+    uint8_t i;
+
+    zmod_rawlog_put32(f, ts);
+    for (i = 0; i < RMOX_MAX; i++)
+    {
+        /* a slow random walk of every channel */
+        n->level[i] = (uint16_t)(n->level[i] + (int)(node_rand(n) % 65) - 32);
+        v = n->level[i];
+        f[4 + 2 * i] = (uint8_t)(v >> 8);
+        f[5 + 2 * i] = (uint8_t)v;
+    }
+    if (verify)
+    {
+        zmod4xxx_calc_rmox(&n->dev, f + 4, rmox);
+        n->hash = fnv1a(n->hash, rmox, sizeof(rmox));
+    }
+    n->out_len = (uint16_t)(n->out_len + FRAME_SIZE);
+    n->sent++;
+}
+
+static void node_done(struct lthread *t, struct lnode *n)
+{
+    epoll_ctl(t->ep, EPOLL_CTL_DEL, n->fd, NULL);
+    close(n->fd);
+    n->done = 1;
+    t->open--;
+    if (n->sent)
+    {
+        t->hash_sum += n->hash;
+    }
+}
+
+static void node_arm(struct lthread *t, struct lnode *n, int on)
+{
+    struct epoll_event ev;
+
+    if (n->writing == on)
+    {
+        return;
+    }
+    ev.events = on ? EPOLLOUT : 0;
+    ev.data.ptr = n;
+    epoll_ctl(t->ep, EPOLL_CTL_MOD, n->fd, &ev);
+    n->writing = (uint8_t)on;
+}
+
+/* write what is queued; in a burst, refill until the socket is full */
+static void node_write(struct lthread *t, struct lnode *n)
+{
+    ssize_t w;
+
+    for (;;)
+    {
+        if (n->out_pos == n->out_len)
+        {
+            n->out_pos = 0;
+            n->out_len = 0;
+            if (rate_hz > 0 || n->sent == frames_per_node)
+            {
+                break;
+            }
+            while (n->sent < frames_per_node && n->out_len + FRAME_SIZE <= (int)sizeof(n->out))
+            {
+                node_frame(n, n->sent * NODE_PERIOD_MS);
+            }
+        }
+        w = write(n->fd, &n->out[n->out_pos], n->out_len - n->out_pos);
+        if (w < 0)
+        {
+            if (errno == EAGAIN)
+            {
+                node_arm(t, n, 1);
+                return;
+            }
+            t->err = errno;
+            node_done(t, n);
+            return;
+        }
+        n->out_pos = (uint16_t)(n->out_pos + w);
+        t->bytes += (uint64_t)w;
+    }
+    node_arm(t, n, 0);
+    if (n->sent == frames_per_node)
+    {
+        node_done(t, n);
+    }
+}
+
+/* paced: send every frame that is due, in due order */
+static uint64_t thread_pace(struct lthread *t)
+{
+    uint64_t period = (uint64_t)(1e9 / rate_hz), now = now_ns(), late;
+    struct lnode *n;
+    uint32_t k;
+
+    for (k = 0; k < t->count; k++)
+    {
+        n = &t->nodes[t->next];
+        if (!n->done && n->sent < frames_per_node)
+        {
+            if (n->due_ns > now)
+            {
+                return n->due_ns - now;
+            }
+            late = now - n->due_ns;
+            t->late_max_ns = late > t->late_max_ns ? late : t->late_max_ns;
+            if (n->out_len + FRAME_SIZE <= (int)sizeof(n->out))
+            {
+                node_frame(n, (uint32_t)((n->due_ns - start_ns) / 1000000));
+                t->frames++;
+            }
+            n->due_ns += period;
+            if (!n->writing)
+            {
+                node_write(t, n);
+            }
+        }
+        t->next = (t->next + 1) % t->count;
+    }
+    return period;
+}
+
+static void *thread_entry(void *param)
+{
+    struct lthread *t = param;
+    struct epoll_event events[EVENTS_MAX];
+    struct epoll_event ev;
+    uint64_t wait_ns;
+    uint32_t i;
+    int n, timeout;
+
+    for (i = 0; i < t->count; i++)
+    {
+        ev.events = 0;
+        ev.data.ptr = &t->nodes[i];
+        epoll_ctl(t->ep, EPOLL_CTL_ADD, t->nodes[i].fd, &ev);
+        if (rate_hz > 0)
+        {
+            /* the nodes of a thread spread evenly over one period */
+            t->nodes[i].due_ns = start_ns + (uint64_t)(1e9 / rate_hz * i / t->count);
+        }
+        node_write(t, &t->nodes[i]);
+    }
+    while (t->open)
+    {
+        timeout = -1;
+        if (rate_hz > 0)
+        {
+            wait_ns = thread_pace(t);
+            timeout = (int)((wait_ns + 999999) / 1000000);
+        }
+        n = epoll_wait(t->ep, events, EVENTS_MAX, timeout);
+        for (i = 0; i < (uint32_t)(n > 0 ? n : 0); i++)
+        {
+            node_write(t, events[i].data.ptr);
+        }
+    }
+    if (rate_hz <= 0)
+    {
+        for (i = 0; i < t->count; i++)
+        {
+            t->frames += t->nodes[i].sent;
+        }
+    }
+    return NULL;
+}
+
+int main(int argc, char **argv)
+{
+    struct lthread *threads;
+    struct rlimit rl;
+    uint32_t nodes = 10000, i, per;
+    uint64_t frames = 0, bytes = 0, late_max = 0, t0, ns;
+    uint32_t hash = 0;
+    int opt, thread_count = 1, k, err = 0;
+
+    while ((opt = getopt(argc, argv, "u:p:n:f:r:j:v")) != -1)
+    {
+        switch (opt)
+        {
+        case 'u':
+            sock_path = optarg;
+            break;
+        case 'p':
+            sock_port = strtol(optarg, NULL, 0);
+            break;
+        case 'n':
+            nodes = (uint32_t)strtoul(optarg, NULL, 0);
+            break;
+        case 'f':
+            frames_per_node = (uint32_t)strtoul(optarg, NULL, 0);
+            break;
+        case 'r':
+            rate_hz = strtod(optarg, NULL);
+            break;
+        case 'j':
+            thread_count = atoi(optarg);
+            break;
+        case 'v':
+            verify = 1;
+            break;
+        default:
+            fprintf(stderr, "usage: %s [-u path | -p port] [-n nodes] [-f frames] "
+                    "[-r hz] [-j threads] [-v]\n", argv[0]);
+            return 1;
+        }
+    }
+    if (sock_path == NULL && sock_port < 0)
+    {
+        sock_path = "/tmp/zmod_ingest.sock";
+    }
+    if (nodes == 0 || thread_count < 1 || thread_count > THREADS_MAX ||
+        (uint32_t)thread_count > nodes || sock_port > 65535)
+    {
+        fprintf(stderr, "nodes > 0, threads 1..%d and <= nodes, port 0..65535\n", THREADS_MAX);
+        return 1;
+    }
+    /* one descriptor per node */
+    if (getrlimit(RLIMIT_NOFILE, &rl) == 0 && rl.rlim_cur < nodes + 64)
+    {
+        rl.rlim_cur = rl.rlim_max < nodes + 64 ? rl.rlim_max : nodes + 64;
+        setrlimit(RLIMIT_NOFILE, &rl);
+    }
+    signal(SIGPIPE, SIG_IGN);
+
+    threads = calloc(thread_count, sizeof(*threads));
+    if (threads == NULL)
+    {
+        fprintf(stderr, "out of memory\n");
+        return 1;
+    }
+    per = (nodes + thread_count - 1) / thread_count;
+    for (k = 0, i = 0; k < thread_count; k++)
+    {
+        struct lthread *t = &threads[k];
+
+        t->count = nodes - i < per ? nodes - i : per;
+        t->nodes = calloc(t->count, sizeof(struct lnode));
+        t->ep = epoll_create1(EPOLL_CLOEXEC);
+        if (t->nodes == NULL || t->ep < 0)
+        {
+            fprintf(stderr, "out of memory\n");
+            return 1;
+        }
+        for (t->open = 0; t->open < t->count; t->open++, i++)
+        {
+            struct lnode *n = &t->nodes[t->open];
+
+            node_init(n, i + 1);
+            n->fd = node_connect();
+            if (n->fd < 0)
+            {
+                fprintf(stderr, "node %u cannot connect: %s\n", i + 1, strerror(errno));
+                return 1;
+            }
+        }
+    }
+
+    t0 = now_ns();
+    start_ns = t0;
+    for (k = 0; k < thread_count; k++)
+    {
+        pthread_create(&threads[k].tid, NULL, thread_entry, &threads[k]);
+    }
+    for (k = 0; k < thread_count; k++)
+    {
+        pthread_join(threads[k].tid, NULL);
+        frames += threads[k].frames;
+        bytes += threads[k].bytes;
+        hash += threads[k].hash_sum;
+        late_max = threads[k].late_max_ns > late_max ? threads[k].late_max_ns : late_max;
+        err = threads[k].err ? threads[k].err : err;
+    }
+    ns = now_ns() - t0;
+
+    printf("{\"tool\":\"loadgen\",\"nodes\":%u,\"threads\":%d,\"rate_hz\":%.3f,"
+           "\"frames\":%llu,\"bytes\":%llu,\"seconds\":%.3f,\"frames_per_s\":%.0f,"
+           "\"mb_per_s\":%.1f,\"late_max_ms\":%.1f",
+           nodes, thread_count, rate_hz, (unsigned long long)frames,
+           (unsigned long long)bytes, ns / 1e9, frames / (ns / 1e9),
+           bytes / (ns / 1e9) / 1e6, late_max / 1e6);
+    if (verify)
+    {
+        printf(",\"rmox_hash\":\"0x%08x\"", hash);
+    }
+    printf("}\n");
+    if (err)
+    {
+        fprintf(stderr, "a node failed: %s\n", strerror(err));
+        return 1;
+    }
+    return 0;
+}
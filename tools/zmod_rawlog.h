@@ -0,0 +1,152 @@
+/*
+ * Copyright (c) 2006-2021, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-19     Sherman      first version
+ */
+
+#ifndef _ZMOD_RAWLOG_H
+#define _ZMOD_RAWLOG_H
+
+#include <stdint.h>
+#include <string.h>
+#include "zmod4xxx.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Raw frame log, one file per sensor. All fields are little-endian.
+ *
+ *   header (32 bytes)
+ *     0   magic "ZRAW"
+ *     4   version
+ *     5   frame_len (bytes of ADC data per frame, 32 for IAQ 2nd Gen)
+ *     6   pid
+ *     8   config[6]
+ *     14  mox_lr
+ *     16  mox_er
+ *     18  prod_data[7]
+ *     25  reserved[3]
+ *     28  sensor_id
+ *
+ *   frames
+ *     0   timestamp in milliseconds
+ *     4   adc[frame_len]
+ */
+
+#define ZMOD_RAWLOG_MAGIC       "ZRAW"
+#define ZMOD_RAWLOG_VERSION     (1)
+#define ZMOD_RAWLOG_HEADER_LEN  (32)
+#define ZMOD_RAWLOG_PROD_LEN    (7)
+#define ZMOD_RAWLOG_FRAME_LEN(n) (4 + (n))
+
+/**
+ * @brief Calibration and identity of the sensor that produced a log
+ */
+typedef struct {
+    uint8_t version;
+    uint8_t frame_len;
+    uint16_t pid;
+    uint8_t config[ZMOD4XXX_LEN_CONF];
+    uint16_t mox_lr;
+    uint16_t mox_er;
+    uint8_t prod_data[ZMOD_RAWLOG_PROD_LEN];
+    uint32_t sensor_id;
+} zmod_rawlog_header_t;
+
+static inline uint16_t zmod_rawlog_get16(const uint8_t *p)
+{
+    return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+static inline uint32_t zmod_rawlog_get32(const uint8_t *p)
+{
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) |
+           ((uint32_t)p[3] << 24);
+}
+
+static inline void zmod_rawlog_put16(uint8_t *p, uint16_t v)
+{
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+}
+
+static inline void zmod_rawlog_put32(uint8_t *p, uint32_t v)
+{
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+    p[2] = (uint8_t)(v >> 16);
+    p[3] = (uint8_t)(v >> 24);
+}
+
+/**
+ * @brief   Parse a log header
+ * @param   [in] buf ZMOD_RAWLOG_HEADER_LEN bytes read from the start of a log
+ * @param   [out] hdr parsed header
+ * @retval  0 success
+ * @retval  -1 not a raw frame log or unsupported version
+ */
+static inline int zmod_rawlog_parse_header(const uint8_t *buf,
+                                           zmod_rawlog_header_t *hdr)
+{
+    if (memcmp(buf, ZMOD_RAWLOG_MAGIC, 4) != 0 ||
+        buf[4] != ZMOD_RAWLOG_VERSION || buf[5] == 0 || buf[5] > RSLT_MAX)
+    {
+        return -1;
+    }
+    hdr->version = buf[4];
+    hdr->frame_len = buf[5];
+    hdr->pid = zmod_rawlog_get16(&buf[6]);
+    memcpy(hdr->config, &buf[8], ZMOD4XXX_LEN_CONF);
+    hdr->mox_lr = zmod_rawlog_get16(&buf[14]);
+    hdr->mox_er = zmod_rawlog_get16(&buf[16]);
+    memcpy(hdr->prod_data, &buf[18], ZMOD_RAWLOG_PROD_LEN);
+    hdr->sensor_id = zmod_rawlog_get32(&buf[28]);
+    return 0;
+}
+
+/**
+ * @brief   Serialize a log header
+ * @param   [in] hdr header to write
+ * @param   [out] buf destination, ZMOD_RAWLOG_HEADER_LEN bytes
+ */
+static inline void zmod_rawlog_build_header(const zmod_rawlog_header_t *hdr,
+                                            uint8_t *buf)
+{
+    memset(buf, 0, ZMOD_RAWLOG_HEADER_LEN);
+    memcpy(buf, ZMOD_RAWLOG_MAGIC, 4);
+    buf[4] = ZMOD_RAWLOG_VERSION;
+    buf[5] = hdr->frame_len;
+    zmod_rawlog_put16(&buf[6], hdr->pid);
+    memcpy(&buf[8], hdr->config, ZMOD4XXX_LEN_CONF);
+    zmod_rawlog_put16(&buf[14], hdr->mox_lr);
+    zmod_rawlog_put16(&buf[16], hdr->mox_er);
+    memcpy(&buf[18], hdr->prod_data, ZMOD_RAWLOG_PROD_LEN);
+    zmod_rawlog_put32(&buf[28], hdr->sensor_id);
+}
+
+/**
+ * @brief   Load the calibration of a log header into a device structure
+ * @param   [in] hdr parsed header
+ * @param   [in,out] dev device; meas_conf must already point to a
+ *          configuration whose result length matches hdr->frame_len
+ */
+static inline void zmod_rawlog_to_dev(const zmod_rawlog_header_t *hdr,
+                                      zmod4xxx_dev_t *dev)
+{
+    dev->pid = hdr->pid;
+    memcpy(dev->config, hdr->config, ZMOD4XXX_LEN_CONF);
+    dev->mox_lr = hdr->mox_lr;
+    dev->mox_er = hdr->mox_er;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _ZMOD_RAWLOG_H */
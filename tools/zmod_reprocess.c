@@ -0,0 +1,478 @@
+/*
+ * Copyright (c) 2006-2021, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-19     Sherman      first version
+ */
+
+/*
+ * Host tool: reprocess raw frame logs (see zmod_rawlog.h) on all cores.
+ *
+ * Build on Linux from the package root:
+ *   gcc -O2 -std=c11 -pthread -Isrc -Itools tools/zmod_reprocess.c \
+ *       src/zmod4xxx.c src/zmod4410_config_iaq2.c -o zmod_reprocess
+ *
+ * Usage:
+ *   zmod_reprocess [-j threads] log...
+ *
+ * Logs are dealt round-robin into one deque per worker. A worker pops from
+ * the tail of its own deque and, once empty, steals from the head of the
+ * others. Each worker keeps its own device structure and buffers, and each
+ * log writes its result into its own slot, so nothing is shared while
+ * processing. Per-sensor summaries are merged on the main thread after all
+ * workers have joined.
+ *
+ * Only the MOx resistance stage (zmod4xxx_calc_rmox()) is run here: the IAQ
+ * 2nd Gen algorithm ships as Cortex-M33 binaries only.
+ */
+
+#include <errno.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "zmod4410_config_iaq2.h"
+#include "zmod4xxx.h"
+#include "zmod_rawlog.h"
+
+#define RMOX_MAX        (RSLT_MAX / 2)
+#define FRAMES_PER_READ (256)
+#define WORKERS_MAX     (256)
+
+struct summary
+{
+    const char *path;
+    int err;
+    uint32_t sensor_id;
+    uint64_t frames;
+    uint32_t first_ms;
+    uint32_t last_ms;
+    uint8_t channels;
+    uint64_t clamp_low;
+    uint64_t clamp_high;
+    double rmox_sum[RMOX_MAX];
+    float rmox_min[RMOX_MAX];
+    float rmox_max[RMOX_MAX];
+};
+
+/* head in the low 32 bits, tail in the high 32 bits */
+struct deque
+{
+    _Atomic uint64_t range;
+    uint32_t *jobs;
+} __attribute__((aligned(64)));
+
+struct worker
+{
+    pthread_t tid;
+    int index;
+    uint64_t done;
+    uint64_t stolen;
+    /* per-thread sensor state */
+    zmod4xxx_dev_t dev;
+    zmod4xxx_conf meas_conf;
+    uint8_t buf[FRAMES_PER_READ * ZMOD_RAWLOG_FRAME_LEN(RSLT_MAX)];
+    float rmox[RMOX_MAX];
+};
+
+static struct deque *deques;
+static struct worker *workers;
+static struct summary *summaries;
+static int worker_count;
+
+static int deque_pop(struct deque *q, uint32_t *job)
+{
+    uint64_t old = atomic_load_explicit(&q->range, memory_order_acquire);
+    uint32_t head, tail;
+
+    do
+    {
+        head = (uint32_t)old;
+        tail = (uint32_t)(old >> 32);
+        if (head == tail)
+        {
+            return 0;
+        }
+    }
+    while (!atomic_compare_exchange_weak_explicit(&q->range, &old,
+            ((uint64_t)(tail - 1) << 32) | head,
+            memory_order_acq_rel, memory_order_acquire));
+
+    *job = q->jobs[tail - 1];
+    return 1;
+}
+
+static int deque_steal(struct deque *q, uint32_t *job)
+{
+    uint64_t old = atomic_load_explicit(&q->range, memory_order_acquire);
+    uint32_t head, tail;
+
+    do
+    {
+        head = (uint32_t)old;
+        tail = (uint32_t)(old >> 32);
+        if (head == tail)
+        {
+            return 0;
+        }
+    }
+    while (!atomic_compare_exchange_weak_explicit(&q->range, &old,
+            ((uint64_t)tail << 32) | (head + 1),
+            memory_order_acq_rel, memory_order_acquire));
+
+    *job = q->jobs[head];
+    return 1;
+}
+
+static void process_frames(struct worker *w, struct summary *s,
+                           const uint8_t *frames, size_t count,
+                           size_t frame_size)
+{
+    size_t n;
+    uint8_t ch;
+    const float clamp_low = 1e-3;
+    const float clamp_high = 10e9;
+
+    for (n = 0; n < count; n++)
+    {
+        const uint8_t *f = frames + n * frame_size;
+        uint32_t ts = zmod_rawlog_get32(f);
+
+        zmod4xxx_calc_rmox(&w->dev, (uint8_t *)f + 4, w->rmox);
+
+        if (s->frames == 0)
+        {
+            s->first_ms = ts;
+            for (ch = 0; ch < s->channels; ch++)
+            {
+                s->rmox_min[ch] = w->rmox[ch];
+                s->rmox_max[ch] = w->rmox[ch];
+            }
+        }
+        s->last_ms = ts;
+        s->frames++;
+
+        for (ch = 0; ch < s->channels; ch++)
+        {
+            float r = w->rmox[ch];
+
+            if (r == clamp_low)
+            {
+                s->clamp_low++;
+            }
+            else if (r == clamp_high)
+            {
+                s->clamp_high++;
+            }
+            s->rmox_sum[ch] += r;
+            if (r < s->rmox_min[ch])
+            {
+                s->rmox_min[ch] = r;
+            }
+            if (r > s->rmox_max[ch])
+            {
+                s->rmox_max[ch] = r;
+            }
+        }
+    }
+}
+
+static void process_log(struct worker *w, struct summary *s)
+{
+    FILE *fp;
+    uint8_t head[ZMOD_RAWLOG_HEADER_LEN];
+    zmod_rawlog_header_t hdr;
+    size_t frame_size, got;
+
+    fp = fopen(s->path, "rb");
+    if (fp == NULL)
+    {
+        s->err = errno;
+        return;
+    }
+    if (fread(head, 1, sizeof(head), fp) != sizeof(head) ||
+        zmod_rawlog_parse_header(head, &hdr) != 0)
+    {
+        s->err = EINVAL;
+        fclose(fp);
+        return;
+    }
+
+    zmod_rawlog_to_dev(&hdr, &w->dev);
+    w->meas_conf.r.len = hdr.frame_len;
+    s->sensor_id = hdr.sensor_id;
+    s->channels = hdr.frame_len / 2;
+    frame_size = ZMOD_RAWLOG_FRAME_LEN(hdr.frame_len);
+
+    while ((got = fread(w->buf, frame_size, FRAMES_PER_READ, fp)) > 0)
+    {
+        process_frames(w, s, w->buf, got, frame_size);
+    }
+    fclose(fp);
+}
+
+static void *worker_entry(void *param)
+{
+    struct worker *w = param;
+    uint32_t job = 0;
+    int victim;
+
+    w->meas_conf = zmod_sensor_type[MEASUREMENT];
+    w->dev.meas_conf = &w->meas_conf;
+
+    for (;;)
+    {
+        if (deque_pop(&deques[w->index], &job))
+        {
+            process_log(w, &summaries[job]);
+            w->done++;
+            continue;
+        }
+
+        /* own deque is empty, walk the others once */
+        for (victim = 1; victim < worker_count; victim++)
+        {
+            if (deque_steal(&deques[(w->index + victim) % worker_count], &job))
+            {
+                break;
+            }
+        }
+        if (victim == worker_count)
+        {
+            break;
+        }
+        process_log(w, &summaries[job]);
+        w->done++;
+        w->stolen++;
+    }
+    return NULL;
+}
+
+static int summary_cmp(const void *a, const void *b)
+{
+    const struct summary *x = a, *y = b;
+
+    if (x->sensor_id != y->sensor_id)
+    {
+        return x->sensor_id < y->sensor_id ? -1 : 1;
+    }
+    return x->first_ms < y->first_ms ? -1 : (x->first_ms > y->first_ms);
+}
+
+/* fold src into dst; both belong to the same sensor */
+static void summary_merge(struct summary *dst, const struct summary *src)
+{
+    uint8_t ch;
+
+    if (src->frames == 0)
+    {
+        return;
+    }
+    if (dst->frames == 0)
+    {
+        *dst = *src;
+        return;
+    }
+    for (ch = 0; ch < dst->channels && ch < src->channels; ch++)
+    {
+        dst->rmox_sum[ch] += src->rmox_sum[ch];
+        if (src->rmox_min[ch] < dst->rmox_min[ch])
+        {
+            dst->rmox_min[ch] = src->rmox_min[ch];
+        }
+        if (src->rmox_max[ch] > dst->rmox_max[ch])
+        {
+            dst->rmox_max[ch] = src->rmox_max[ch];
+        }
+    }
+    if (src->first_ms < dst->first_ms)
+    {
+        dst->first_ms = src->first_ms;
+    }
+    if (src->last_ms > dst->last_ms)
+    {
+        dst->last_ms = src->last_ms;
+    }
+    dst->frames += src->frames;
+    dst->clamp_low += src->clamp_low;
+    dst->clamp_high += src->clamp_high;
+}
+
+static void summary_print(const struct summary *s, int logs)
+{
+    uint8_t ch;
+
+    printf("{\"sensor\":%u,\"logs\":%d,\"frames\":%llu,\"first_ms\":%u,"
+           "\"last_ms\":%u,\"clamp_low\":%llu,\"clamp_high\":%llu,"
+           "\"rmox_mean\":[",
+           s->sensor_id, logs, (unsigned long long)s->frames, s->first_ms,
+           s->last_ms, (unsigned long long)s->clamp_low,
+           (unsigned long long)s->clamp_high);
+    for (ch = 0; ch < s->channels; ch++)
+    {
+        printf("%s%.6g", ch ? "," : "", s->rmox_sum[ch] / (double)s->frames);
+    }
+    printf("],\"rmox_min\":[");
+    for (ch = 0; ch < s->channels; ch++)
+    {
+        printf("%s%.6g", ch ? "," : "", s->rmox_min[ch]);
+    }
+    printf("],\"rmox_max\":[");
+    for (ch = 0; ch < s->channels; ch++)
+    {
+        printf("%s%.6g", ch ? "," : "", s->rmox_max[ch]);
+    }
+    printf("]}\n");
+}
+
+static double now_sec(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+int main(int argc, char **argv)
+{
+    int opt, i, first, logs, err;
+    int job_count, started;
+    uint64_t frames = 0;
+    double start, elapsed;
+    struct summary acc;
+
+    worker_count = (int)sysconf(_SC_NPROCESSORS_ONLN);
+    while ((opt = getopt(argc, argv, "j:")) != -1)
+    {
+        switch (opt)
+        {
+        case 'j':
+            worker_count = atoi(optarg);
+            break;
+        default:
+            fprintf(stderr, "usage: %s [-j threads] log...\n", argv[0]);
+            return 1;
+        }
+    }
+    job_count = argc - optind;
+    if (job_count <= 0)
+    {
+        fprintf(stderr, "usage: %s [-j threads] log...\n", argv[0]);
+        return 1;
+    }
+    if (worker_count < 1)
+    {
+        worker_count = 1;
+    }
+    if (worker_count > WORKERS_MAX)
+    {
+        worker_count = WORKERS_MAX;
+    }
+    if (worker_count > job_count)
+    {
+        worker_count = job_count;
+    }
+
+    summaries = calloc(job_count, sizeof(*summaries));
+    deques = aligned_alloc(64, worker_count * sizeof(*deques));
+    workers = calloc(worker_count, sizeof(*workers));
+    if (summaries == NULL || deques == NULL || workers == NULL)
+    {
+        fprintf(stderr, "out of memory\n");
+        return 1;
+    }
+
+    for (i = 0; i < worker_count; i++)
+    {
+        deques[i].jobs = malloc(((job_count / worker_count) + 1) *
+                                sizeof(uint32_t));
+        if (deques[i].jobs == NULL)
+        {
+            fprintf(stderr, "out of memory\n");
+            return 1;
+        }
+        atomic_init(&deques[i].range, 0);
+    }
+    for (i = 0; i < job_count; i++)
+    {
+        struct deque *q = &deques[i % worker_count];
+        uint32_t tail = (uint32_t)(atomic_load(&q->range) >> 32);
+
+        summaries[i].path = argv[optind + i];
+        q->jobs[tail] = (uint32_t)i;
+        atomic_store(&q->range, (uint64_t)(tail + 1) << 32);
+    }
+
+    /* the deques of workers that did not start are stolen empty by the others */
+    start = now_sec();
+    for (i = 0; i < worker_count; i++)
+    {
+        workers[i].index = i;
+        err = pthread_create(&workers[i].tid, NULL, worker_entry, &workers[i]);
+        if (err)
+        {
+            fprintf(stderr, "pthread_create: %s, %d of %d workers running\n",
+                    strerror(err), i, worker_count);
+            break;
+        }
+    }
+    started = i;
+    if (started == 0)
+    {
+        return 1;
+    }
+    for (i = 0; i < started; i++)
+    {
+        pthread_join(workers[i].tid, NULL);
+    }
+    elapsed = now_sec() - start;
+
+    for (i = 0; i < job_count; i++)
+    {
+        if (summaries[i].err)
+        {
+            fprintf(stderr, "%s: %s\n", summaries[i].path,
+                    strerror(summaries[i].err));
+        }
+        frames += summaries[i].frames;
+    }
+
+    qsort(summaries, job_count, sizeof(*summaries), summary_cmp);
+    for (first = 0; first < job_count; first = i)
+    {
+        memset(&acc, 0, sizeof(acc));
+        acc.sensor_id = summaries[first].sensor_id;
+        for (i = first, logs = 0;
+             i < job_count && summaries[i].sensor_id == summaries[first].sensor_id;
+             i++)
+        {
+            if (summaries[i].err == 0)
+            {
+                summary_merge(&acc, &summaries[i]);
+                logs++;
+            }
+        }
+        if (logs)
+        {
+            summary_print(&acc, logs);
+        }
+    }
+
+    fprintf(stderr, "%d logs, %llu frames, %d threads, %.3f s, %.0f frames/s\n",
+            job_count, (unsigned long long)frames, started, elapsed,
+            elapsed > 0 ? frames / elapsed : 0.0);
+    for (i = 0; i < started; i++)
+    {
+        fprintf(stderr, "  worker %d: %llu logs (%llu stolen)\n", i,
+                (unsigned long long)workers[i].done,
+                (unsigned long long)workers[i].stolen);
+    }
+    return 0;
+}
@@ -0,0 +1,204 @@
+/*
+ * Copyright (c) 2006-2021, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-19     Sherman      first version
+ * 2026-10-19     Sherman      wait for the status as the port does
+ */
+
+/*
+ * Host tool: soak test of the measurement cycle on simulated sensors in
+ * virtual time.
+ *
+ * Build on Linux from the package root:
+ *   gcc -O2 -std=c99 -DZMOD4XXX_USING_HAL_SIM -Isrc -Ihal -Itools \
+ *       tools/zmod_soak.c src/zmod4xxx.c src/zmod4xxx_recover.c \
+ *       src/zmod4xxx_wait.c src/zmod4410_config_iaq2.c hal/hal_sim.c -o zmod_soak
+ *
+ * Usage:
+ *   zmod_soak [-n sensors] [-s samples] [-t trace.json]
+ *
+ * -t needs the trace ring: add -DZMOD4XXX_USING_TRACE src/zmod4xxx_trace.c
+ * to the build. The last ZMOD4XXX_TRACE_SIZE spans are written as Chrome
+ * trace JSON, one process per sensor address.
+ *
+ * Every sensor runs the same cycle as the port without the INT pin: start,
+ * wait for the status with zmod4xxx_wait_done(), read the ADC results,
+ * convert them and wait 1990 ms. Sample timestamps come from hal_get_time_ms(), the clock that
+ * delay_ms advances.
+ */
+
+#define _POSIX_C_SOURCE 199309L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "zmod4410_config_iaq2.h"
+#include "zmod4xxx.h"
+#include "zmod4xxx_hal.h"
+#include "zmod4xxx_trace.h"
+#include "zmod_cycle.h"
+
+#define SENSORS_MAX (100)
+
+struct soak_sensor
+{
+    zmod4xxx_sim_t sim;
+    zmod4xxx_dev_t dev;
+    zmod4xxx_recover_t rec;
+    zmod4xxx_wait_t wait;
+    uint8_t prod_data[ZMOD4410_PROD_DATA_LEN];
+    uint32_t samples;
+    uint32_t errors;
+    uint32_t first_ts;
+    uint32_t last_ts;
+};
+
+static struct soak_sensor sensors[SENSORS_MAX];
+
+static int soak_cycle(struct soak_sensor *s)
+{
+    zmod4xxx_err ret;
+    uint8_t adc_result[RSLT_MAX];
+    float rmox[RSLT_MAX / 2];
+
+    ret = zmod_cycle_run(&s->dev, &s->wait, &s->rec, adc_result, rmox);
+    if (ret)
+    {
+        return ret;
+    }
+
+    s->last_ts = hal_get_time_ms();
+    if (s->samples == 0)
+    {
+        s->first_ts = s->last_ts;
+    }
+    s->samples++;
+    s->dev.delay_ms(1990);
+    return ZMOD4XXX_OK;
+}
+
+static void trace_out(void *ctx, const char *str)
+{
+    fputs(str, (FILE *)ctx);
+}
+
+static double cpu_sec(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+int main(int argc, char **argv)
+{
+    int opt, n, sensor_count = 24;
+    uint32_t i, sample_count = 43200;
+    uint64_t total = 0, errors = 0;
+    double start, cpu;
+    const char *trace_path = NULL;
+    FILE *fp;
+
+    while ((opt = getopt(argc, argv, "n:s:t:")) != -1)
+    {
+        switch (opt)
+        {
+        case 'n':
+            sensor_count = atoi(optarg);
+            break;
+        case 's':
+            sample_count = (uint32_t)strtoul(optarg, NULL, 0);
+            break;
+        case 't':
+            trace_path = optarg;
+            break;
+        default:
+            fprintf(stderr, "usage: %s [-n sensors] [-s samples] [-t trace.json]\n",
+                    argv[0]);
+            return 1;
+        }
+    }
+    if (sensor_count < 1 || sensor_count > SENSORS_MAX)
+    {
+        fprintf(stderr, "sensors must be 1..%d\n", SENSORS_MAX);
+        return 1;
+    }
+
+    start = cpu_sec();
+    zmod4xxx_trace_init(hal_get_time_us);
+    for (n = 0; n < sensor_count; n++)
+    {
+        struct soak_sensor *s = &sensors[n];
+
+        zmod4xxx_sim_init(&s->sim, (uint8_t)(0x08 + n), (uint32_t)n + 1);
+        zmod4xxx_sim_attach(&s->sim, &s->dev);
+        if (trace_path != NULL && n < 4)
+        {
+            (void)zmod4xxx_trace_attach(&s->dev);
+        }
+        s->dev.pid = ZMOD4410_PID;
+        s->dev.init_conf = &zmod_sensor_type[INIT];
+        s->dev.meas_conf = &zmod_sensor_type[MEASUREMENT];
+        s->dev.prod_data = s->prod_data;
+
+        if (zmod4xxx_read_sensor_info(&s->dev) ||
+            zmod4xxx_prepare_sensor(&s->dev) ||
+            zmod4xxx_recover_init(&s->dev, &s->rec, hal_get_time_ms))
+        {
+            fprintf(stderr, "sensor %d: preparation failed\n", n);
+            return 1;
+        }
+        zmod4xxx_wait_init(&s->wait, 0,
+                           ZMOD4410_IAQ2_COUNTER_LIMIT * ZMOD4XXX_WAIT_POLL_MS,
+                           hal_get_time_us);
+    }
+
+    /* interleave the sensors; each one only moves its own clock */
+    for (i = 0; i < sample_count; i++)
+    {
+        for (n = 0; n < sensor_count; n++)
+        {
+            if (soak_cycle(&sensors[n]))
+            {
+                sensors[n].errors++;
+            }
+        }
+    }
+    cpu = cpu_sec() - start;
+
+    for (n = 0; n < sensor_count; n++)
+    {
+        total += sensors[n].samples;
+        errors += sensors[n].errors;
+    }
+    printf("sensors %d, samples %llu, errors %llu\n", sensor_count,
+           (unsigned long long)total, (unsigned long long)errors);
+    printf("virtual span per sensor %.1f h, cpu %.3f s, %.0f samples/s\n",
+           (sensors[0].last_ts - sensors[0].first_ts) / 3600e3, cpu,
+           cpu > 0 ? total / cpu : 0.0);
+    printf("bus per sample: %.2f transactions, %.1f bytes, %.2f sleeps\n",
+           (double)(sensors[0].sim.stats.reads + sensors[0].sim.stats.writes) /
+           sensors[0].samples,
+           (double)(sensors[0].sim.stats.read_bytes + sensors[0].sim.stats.write_bytes) /
+           sensors[0].samples,
+           (double)sensors[0].sim.stats.sleeps / sensors[0].samples);
+
+    if (trace_path != NULL)
+    {
+        fp = fopen(trace_path, "w");
+        if (fp == NULL)
+        {
+            perror(trace_path);
+            return 1;
+        }
+        zmod4xxx_trace_dump_json(trace_out, fp);
+        fclose(fp);
+    }
+    return errors ? 2 : 0;
+}
@@ -0,0 +1,108 @@
+/*
+ * Copyright (c) 2006-2021, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-19     Sherman      first version
+ */
+
+/*
+ * Host tool: decode uplink batch frames (see zmod4xxx_batch.h).
+ *
+ * Build on Linux from the package root:
+ *   gcc -O2 -std=c99 -Isrc tools/zmod_unbatch.c src/zmod4xxx_batch.c \
+ *       -o zmod_unbatch
+ *
+ * Usage:
+ *   zmod_unbatch [file]
+ *
+ * Reads concatenated frames from the file or stdin and prints one JSON
+ * object per sample. Values are printed in the units of the algorithm. A
+ * damaged frame is reported on stderr and skipped byte by byte until the
+ * next valid frame; the exit code is 2 if any was found.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "zmod4xxx_batch.h"
+
+#define UNBATCH_BUF (1 << 17)
+
+static void print_sample(const zmod4xxx_batch_sample_t *s)
+{
+    printf("{\"seq\":%u,\"ts\":%u,\"valid\":%d,\"stabilizing\":%d,\"health\":%d,"
+           "\"iaq\":%.1f,\"tvoc\":%.3f,\"etoh\":%.3f,\"eco2\":%d}\n",
+           s->seq, s->ts, !!(s->flags & ZMOD4XXX_BATCH_F_VALID),
+           !!(s->flags & ZMOD4XXX_BATCH_F_STABILIZING),
+           !!(s->flags & ZMOD4XXX_BATCH_F_HEALTH),
+           s->v[0] / 10.0, s->v[1] / 1000.0, s->v[2] / 1000.0, (int)s->v[3]);
+}
+
+int main(int argc, char **argv)
+{
+    static uint8_t buf[UNBATCH_BUF];
+    zmod4xxx_batch_dec_t dec;
+    zmod4xxx_batch_sample_t s;
+    FILE *fp = stdin;
+    size_t have = 0, got, pos;
+    uint32_t flen;
+    unsigned long frames = 0, samples = 0, skipped = 0;
+    int8_t r;
+
+    if (argc > 1 && (fp = fopen(argv[1], "rb")) == NULL)
+    {
+        perror(argv[1]);
+        return 1;
+    }
+
+    for (;;)
+    {
+        got = fread(buf + have, 1, sizeof(buf) - have, fp);
+        have += got;
+        pos = 0;
+        while (have - pos >= ZMOD4XXX_BATCH_HDR_LEN + 2)
+        {
+            if (zmod4xxx_batch_open(&dec, buf + pos, (uint32_t)(have - pos), &flen))
+            {
+                /* a frame cut off by the end of the buffer is read again */
+                if (buf[pos] == ZMOD4XXX_BATCH_MAGIC && got > 0 &&
+                    (size_t)(buf[pos + 4] | (buf[pos + 5] << 8)) > have - pos)
+                {
+                    break;
+                }
+                pos++;
+                skipped++;
+                continue;
+            }
+            while ((r = zmod4xxx_batch_next(&dec, &s)) == 1)
+            {
+                print_sample(&s);
+                samples++;
+            }
+            if (r < 0)
+            {
+                fprintf(stderr, "frame %lu: bad sample data\n", frames);
+                skipped++;
+            }
+            frames++;
+            pos += flen;
+        }
+        memmove(buf, buf + pos, have - pos);
+        have -= pos;
+        if (got == 0)
+        {
+            break;
+        }
+    }
+    if (fp != stdin)
+    {
+        fclose(fp);
+    }
+    fprintf(stderr, "%lu frames, %lu samples, %lu bytes skipped\n",
+            frames, samples, skipped + (unsigned long)have);
+    return skipped || have ? 2 : 0;
+}
@@ -0,0 +1,83 @@
+/*
+ * Copyright (c) 2006-2021, RT-Thread Development Team
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Change Logs:
+ * Date           Author       Notes
+ * 2026-10-19     Sherman      first version
+ */
+
+/*
+ * Host tool: format uploaded deferred log records (see zmod4xxx_dlog.h).
+ *
+ * Build on Linux from the package root:
+ *   gcc -O2 -std=c99 -DZMOD4XXX_USING_DLOG -Isrc tools/zmod_undlog.c \
+ *       src/zmod4xxx_dlog.c -o zmod_undlog
+ *
+ * Usage:
+ *   zmod_undlog [file]
+ *
+ * Reads records in the form of zmod4xxx_dlog_pack() back to back from the
+ * file or stdin and prints one line per record: timestamp, sequence number
+ * and text. Jumps in the sequence numbers, records overwritten on the
+ * device before they were uploaded, are reported inline; the exit code is
+ * 2 if the input ends in a partial or invalid record.
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "zmod4xxx_dlog.h"
+
+#define UNDLOG_BUF (1 << 16)
+
+int main(int argc, char **argv)
+{
+    static uint8_t buf[UNDLOG_BUF];
+    zmod4xxx_dlog_rec_t rec;
+    FILE *fp = stdin;
+    char line[256];
+    size_t have = 0, got, pos;
+    uint32_t used, next = 0;
+    unsigned long records = 0, lost = 0;
+
+    if (argc > 1 && (fp = fopen(argv[1], "rb")) == NULL)
+    {
+        perror(argv[1]);
+        return 1;
+    }
+
+    for (;;)
+    {
+        got = fread(buf + have, 1, sizeof(buf) - have, fp);
+        have += got;
+        pos = 0;
+        while ((used = zmod4xxx_dlog_unpack(buf + pos, (uint32_t)(have - pos), &rec)) != 0)
+        {
+            if (records && rec.seq != next)
+            {
+                printf("-- %u records lost\n", rec.seq - next);
+                lost += rec.seq - next;
+            }
+            next = rec.seq + 1;
+            zmod4xxx_dlog_format(&rec, line, sizeof(line));
+            printf("[%u] #%u %s\n", rec.ts, rec.seq, line);
+            records++;
+            pos += used;
+        }
+        memmove(buf, buf + pos, have - pos);
+        have -= pos;
+        if (got == 0)
+        {
+            break;
+        }
+    }
+    if (fp != stdin)
+    {
+        fclose(fp);
+    }
+    fprintf(stderr, "%lu records, %lu lost, %lu bytes left over\n",
+            records, lost, (unsigned long)have);
+    return have ? 2 : 0;
+}